@@ -103,11 +103,17 @@ int App::run(int argc, char** argv) {
     std::vector<std::string> target_paths;
     std::string output_path;
     std::string processors_str;
+    std::string stream_format;
 
     app.add_option("-s,--source", source_paths, "Source face image(s)")->excludes("--task-config");
     app.add_option("-t,--target", target_paths, "Target image/video path(s)")
         ->excludes("--task-config");
-    app.add_option("-o,--output", output_path, "Output directory or file path")
+    app.add_option("-o,--output", output_path,
+                   "Output directory or file path (\"-\" streams the video to stdout)")
+        ->excludes("--task-config");
+    app.add_option("--stream-format", stream_format,
+                   "Container of the video streamed with -o - (fmp4/mpegts, default fmp4)")
+        ->check(CLI::IsMember({"fmp4", "mpegts"}))
         ->excludes("--task-config");
     app.add_option("--processors", processors_str,
                    "Comma-separated processor list "
@@ -129,6 +135,17 @@ int App::run(int argc, char** argv) {
     } else if (system_check) {
         exit_code = run_system_check(json_output);
     } else {
+        // When stdout carries the streamed video, everything else (starting with the banner
+        // below) has to go to stderr
+        bool stream_stdout = output_path == "-";
+        if (!config_path.empty()) {
+            auto peek = config::load_task_config(config_path);
+            stream_stdout = peek.is_ok() && peek.value().io.output.is_streaming();
+        }
+        if (stream_stdout) {
+            foundation::infrastructure::logger::Logger::get_instance()->use_stderr_console();
+        }
+
         // 加载 AppConfig
         auto app_config = load_app_config(app_config_path, log_level);
         if (!app_config) {
@@ -176,7 +193,7 @@ int App::run(int argc, char** argv) {
             exit_code = run_pipeline(config_path, *app_config);
         } else if (!source_paths.empty() && !target_paths.empty()) {
             exit_code = run_quick_mode(source_paths, target_paths, output_path, processors_str,
-                                       *app_config);
+                                       stream_format, *app_config);
         } else {
             std::cout << app.help() << '\n';
             exit_code = 0;
@@ -254,7 +271,7 @@ int App::run_pipeline(const std::string& config_path, const config::AppConfig& a
 int App::run_quick_mode(const std::vector<std::string>& source_paths,
                         const std::vector<std::string>& target_paths,
                         const std::string& output_path, const std::string& processors_str,
-                        const config::AppConfig& app_config) {
+                        const std::string& stream_format, const config::AppConfig& app_config) {
     using namespace config;
 
     // 1. 构建 TaskConfig
@@ -265,7 +282,12 @@ int App::run_quick_mode(const std::vector<std::string>& source_paths,
     task_config.io.source_paths = source_paths;
     task_config.io.target_paths = target_paths;
 
-    if (!output_path.empty()) {
+    if (output_path == "-") {
+        // Stream the video to stdout; no result file is written
+        task_config.io.output.path = "./output/";
+        auto format_r = parse_stream_format(stream_format.empty() ? "fmp4" : stream_format);
+        if (format_r) { task_config.io.output.stream_format = format_r.value(); }
+    } else if (!output_path.empty()) {
         task_config.io.output.path = output_path;
     } else {
         // 默认输出目录
@@ -32,6 +32,7 @@ private:
     static int run_quick_mode(const std::vector<std::string>& source_paths,
                               const std::vector<std::string>& target_paths,
                               const std::string& output_path, const std::string& processors_str,
+                              const std::string& stream_format,
                               const config::AppConfig& app_config);
 
     static std::optional<config::AppConfig> load_app_config(const std::string& path,
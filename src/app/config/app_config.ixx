@@ -76,6 +76,16 @@ struct ModelsConfig {
     DownloadStrategy download_strategy = DownloadStrategy::Auto; ///< Policy for model downloading
 };
 
+/**
+ * @brief Persistent source embedding cache configuration
+ * @details Entries are keyed by source image content hash plus recognizer model, so recurring
+ *          source identities skip detection/recognition (and model loading) on later jobs.
+ */
+struct EmbeddingCacheConfig {
+    bool enable = true;                       ///< Enable or disable the embedding cache
+    std::string path = "./.cache/embeddings"; ///< Directory storing cached embeddings
+};
+
 /**
  * @brief Default model names for various tasks
  */
@@ -139,6 +149,7 @@ struct AppConfig {
     LoggingConfig logging;                     ///< Logging settings
     MetricsConfig metrics;                     ///< Metrics collection settings
     ModelsConfig models;                       ///< Model management settings
+    EmbeddingCacheConfig embedding_cache;      ///< Source embedding cache settings
     DefaultModels default_models;              ///< Default model selections
     DefaultTaskSettings default_task_settings; ///< NEW: Default task-specific settings
     std::string temp_directory = "./temp";     ///< Temp file storage
@@ -311,6 +311,33 @@ enum class AudioPolicy : std::uint8_t {
     Skip  ///< Produce silent video without audio
 };
 
+/**
+ * @brief Policy for targets whose file content is identical to an earlier target
+ */
+enum class DedupPolicy : std::uint8_t {
+    Off,  ///< Process every target
+    Copy, ///< Process the content once, copy its result to the other outputs (default)
+    Link  ///< Process the content once, hard-link the other outputs to its result
+};
+
+/**
+ * @brief Container for streaming the video result to stdout
+ */
+enum class StreamFormat : std::uint8_t {
+    None,  ///< Write result files to io.output.path (default)
+    Fmp4,  ///< Fragmented MP4, one fragment per keyframe
+    MpegTs ///< MPEG transport stream
+};
+
+/**
+ * @brief Threading model of the video decoder and encoder
+ */
+enum class CodecThreadType : std::uint8_t {
+    Auto,  ///< Frame and slice threading, as supported by the codec (default)
+    Frame, ///< Frame threading only: highest throughput, a few frames of extra latency
+    Slice  ///< Slice threading only: no extra latency, gains depend on the stream's slices
+};
+
 /**
  * @brief Target face selection strategy
  */
@@ -27,6 +27,7 @@ std::vector<ValidationError> ConfigValidator::validate(const TaskConfig& config)
 
     validate_task_info(config.task_info, errors);
     validate_io(config.io, errors);
+    validate_resource(config.resource, errors);
     validate_face_analysis(config.face_analysis, errors);
     validate_pipeline(config.pipeline, errors);
 
@@ -93,12 +94,21 @@ void ConfigValidator::validate_io(const IOConfig& io, std::vector<ValidationErro
                           "at least one target path"});
     }
 
-    // Validate target paths exist
+    // Validate target paths exist ("-" and "pipe:N" read from a pipe)
     for (size_t i = 0; i < io.target_paths.size(); ++i) {
-        validate_path_exists(io.target_paths[i], std::format("io.target_paths[{}]", i), errors);
+        const auto& target = io.target_paths[i];
+        if (target == "-" || target.starts_with("pipe:")) continue;
+        validate_path_exists(target, std::format("io.target_paths[{}]", i), errors);
     }
 
     validate_output(io.output, errors);
+
+    // stdout carries a single stream
+    if (io.output.is_streaming() && io.target_paths.size() > 1) {
+        errors.push_back({ErrorCode::E202ParameterOutOfRange, "io.target_paths",
+                          std::format("{} targets", io.target_paths.size()),
+                          "a single video target when io.output.stream_format is set"});
+    }
 }
 
 void ConfigValidator::validate_face_analysis(const FaceAnalysisConfig& fa,
@@ -112,6 +122,24 @@ void ConfigValidator::validate_face_analysis(const FaceAnalysisConfig& fa,
                    "face_analysis.face_recognizer.similarity_threshold", errors);
 }
 
+void ConfigValidator::validate_resource(const TaskResourceConfig& resource,
+                                        std::vector<ValidationError>& errors) {
+    // Codec threads: 0 = auto
+    validate_range(resource.decoder_thread_count, 0, 256, "resource.decoder_thread_count",
+                   errors);
+    validate_range(resource.encoder_thread_count, 0, 256, "resource.encoder_thread_count",
+                   errors);
+    // Image batch I/O: 0 = auto
+    validate_range(resource.image_decode_thread_count, 0, 256,
+                   "resource.image_decode_thread_count", errors);
+    validate_range(resource.image_encode_thread_count, 0, 256,
+                   "resource.image_encode_thread_count", errors);
+    validate_range(resource.image_prefetch_count, 0, 1024, "resource.image_prefetch_count",
+                   errors);
+    validate_range(resource.max_concurrent_targets, 1, 64, "resource.max_concurrent_targets",
+                   errors);
+}
+
 void ConfigValidator::validate_output(const OutputConfig& output,
                                       std::vector<ValidationError>& errors) {
     // Output path must not be empty
@@ -183,6 +211,10 @@ void ConfigValidator::validate_step_params(const StepParams& params, const std::
     } else if (step_type == "face_enhancer") {
         if (const auto* p = std::get_if<FaceEnhancerParams>(&params)) {
             validate_range(p->blend_factor, 0.0, 1.0, path_prefix + ".params.blend_factor", errors);
+            validate_range(p->reuse_threshold, 0.0, 255.0, path_prefix + ".params.reuse_threshold",
+                           errors);
+            validate_range(p->reuse_refresh_interval, 1, 100000,
+                           path_prefix + ".params.reuse_refresh_interval", errors);
             if (p->face_selector_mode == FaceSelectorMode::Reference) {
                 if (!p->reference_face_path.has_value() || p->reference_face_path->empty()) {
                     errors.push_back({ErrorCode::E205RequiredFieldMissing,
@@ -198,6 +230,8 @@ void ConfigValidator::validate_step_params(const StepParams& params, const std::
         if (const auto* p = std::get_if<ExpressionRestorerParams>(&params)) {
             validate_range(p->restore_factor, 0.0, 1.0, path_prefix + ".params.restore_factor",
                            errors);
+            validate_range(p->feature_refresh_interval, 0, 100000,
+                           path_prefix + ".params.feature_refresh_interval", errors);
             if (p->face_selector_mode == FaceSelectorMode::Reference) {
                 if (!p->reference_face_path.has_value() || p->reference_face_path->empty()) {
                     errors.push_back({ErrorCode::E205RequiredFieldMissing,
@@ -213,6 +247,9 @@ void ConfigValidator::validate_step_params(const StepParams& params, const std::
         if (const auto* p = std::get_if<FrameEnhancerParams>(&params)) {
             validate_range(p->enhance_factor, 0.0, 1.0, path_prefix + ".params.enhance_factor",
                            errors);
+            if (p->tile_size != 0) {
+                validate_range(p->tile_size, 64, 2048, path_prefix + ".params.tile_size", errors);
+            }
         }
     }
 }
@@ -79,6 +79,9 @@ private:
 
     void validate_output(const OutputConfig& output, std::vector<ValidationError>& errors);
 
+    void validate_resource(const TaskResourceConfig& resource,
+                           std::vector<ValidationError>& errors);
+
     void validate_pipeline(const std::vector<PipelineStep>& steps,
                            std::vector<ValidationError>& errors);
 
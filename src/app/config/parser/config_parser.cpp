@@ -242,6 +242,62 @@ std::string to_string(AudioPolicy value) {
     return "copy";
 }
 
+Result<DedupPolicy> parse_dedup_policy(const std::string& str) {
+    auto lower = detail::ToLower(str);
+    if (lower == "off") return Result<DedupPolicy>::ok(DedupPolicy::Off);
+    if (lower == "copy") return Result<DedupPolicy>::ok(DedupPolicy::Copy);
+    if (lower == "link") return Result<DedupPolicy>::ok(DedupPolicy::Link);
+    return Result<DedupPolicy>::err(ConfigError(ErrorCode::E202ParameterOutOfRange,
+                                                "Invalid dedup_policy: " + str, "dedup_policy"));
+}
+
+std::string to_string(DedupPolicy value) {
+    switch (value) {
+    case DedupPolicy::Off: return "off";
+    case DedupPolicy::Copy: return "copy";
+    case DedupPolicy::Link: return "link";
+    }
+    return "copy";
+}
+
+Result<StreamFormat> parse_stream_format(const std::string& str) {
+    auto lower = detail::ToLower(str);
+    if (lower == "none" || lower.empty()) return Result<StreamFormat>::ok(StreamFormat::None);
+    if (lower == "fmp4") return Result<StreamFormat>::ok(StreamFormat::Fmp4);
+    if (lower == "mpegts") return Result<StreamFormat>::ok(StreamFormat::MpegTs);
+    return Result<StreamFormat>::err(ConfigError(ErrorCode::E202ParameterOutOfRange,
+                                                 "Invalid stream_format: " + str,
+                                                 "stream_format"));
+}
+
+std::string to_string(StreamFormat value) {
+    switch (value) {
+    case StreamFormat::None: return "none";
+    case StreamFormat::Fmp4: return "fmp4";
+    case StreamFormat::MpegTs: return "mpegts";
+    }
+    return "none";
+}
+
+Result<CodecThreadType> parse_codec_thread_type(const std::string& str) {
+    auto lower = detail::ToLower(str);
+    if (lower == "auto") return Result<CodecThreadType>::ok(CodecThreadType::Auto);
+    if (lower == "frame") return Result<CodecThreadType>::ok(CodecThreadType::Frame);
+    if (lower == "slice") return Result<CodecThreadType>::ok(CodecThreadType::Slice);
+    return Result<CodecThreadType>::err(ConfigError(ErrorCode::E202ParameterOutOfRange,
+                                                    "Invalid codec_thread_type: " + str,
+                                                    "codec_thread_type"));
+}
+
+std::string to_string(CodecThreadType value) {
+    switch (value) {
+    case CodecThreadType::Auto: return "auto";
+    case CodecThreadType::Frame: return "frame";
+    case CodecThreadType::Slice: return "slice";
+    }
+    return "auto";
+}
+
 Result<FaceSelectorMode> parse_face_selector_mode(const std::string& str) {
     auto lower = detail::ToLower(str);
     if (lower == "reference") return Result<FaceSelectorMode>::ok(FaceSelectorMode::Reference);
@@ -371,6 +427,12 @@ Result<AppConfig> ParseAppConfigFromJson(const json& j) {
     if (!download_strategy_r) { return Result<AppConfig>::err(download_strategy_r.error()); }
     config.models.download_strategy = download_strategy_r.value();
 
+    // embedding_cache
+    auto embedding_cache_j = detail::GetObject(j, "embedding_cache");
+    config.embedding_cache.enable = detail::GetBool(embedding_cache_j, "enable", true);
+    config.embedding_cache.path =
+        detail::GetString(embedding_cache_j, "path", "./.cache/embeddings");
+
     // default_models
     auto defaults_j = detail::GetObject(j, "default_models");
     config.default_models.face_detector =
@@ -500,6 +562,9 @@ Result<PipelineStep> ParsePipelineStep(const json& step_j) {
         FaceEnhancerParams params;
         params.model = detail::GetString(params_j, "model", "");
         params.blend_factor = detail::GetDouble(params_j, "blend_factor", 0.8);
+        params.temporal_reuse = detail::GetBool(params_j, "temporal_reuse", false);
+        params.reuse_threshold = detail::GetDouble(params_j, "reuse_threshold", 2.0);
+        params.reuse_refresh_interval = detail::GetInt(params_j, "reuse_refresh_interval", 30);
 
         auto mode_str = detail::GetString(params_j, "face_selector_mode", "many");
         auto mode_r = parse_face_selector_mode(mode_str);
@@ -514,6 +579,7 @@ Result<PipelineStep> ParsePipelineStep(const json& step_j) {
         ExpressionRestorerParams params;
         params.model = detail::GetString(params_j, "model", "");
         params.restore_factor = detail::GetDouble(params_j, "restore_factor", 0.8);
+        params.feature_refresh_interval = detail::GetInt(params_j, "feature_refresh_interval", 15);
 
         auto mode_str = detail::GetString(params_j, "face_selector_mode", "many");
         auto mode_r = parse_face_selector_mode(mode_str);
@@ -528,6 +594,8 @@ Result<PipelineStep> ParsePipelineStep(const json& step_j) {
         FrameEnhancerParams params;
         params.model = detail::GetString(params_j, "model", "");
         params.enhance_factor = detail::GetDouble(params_j, "enhance_factor", 0.8);
+        params.tile_size = detail::GetInt(params_j, "tile_size", 0);
+        params.autotune_tiles = detail::GetBool(params_j, "autotune_tiles", true);
         step.params = std::move(params);
     } else {
         return Result<PipelineStep>::err(ConfigError(ErrorCode::E202ParameterOutOfRange,
@@ -581,6 +649,19 @@ Result<TaskConfig> ParseTaskConfigFromJson(const json& j) {
         auto audio_r = parse_audio_policy(audio_str);
         if (audio_r) { config.io.output.audio_policy = audio_r.value(); }
     }
+    config.io.output.smart_render = detail::GetBool(output_j, "smart_render", false);
+
+    auto stream_str = detail::GetString(output_j, "stream_format", "");
+    if (!stream_str.empty()) {
+        auto stream_r = parse_stream_format(stream_str);
+        if (stream_r) { config.io.output.stream_format = stream_r.value(); }
+    }
+
+    auto dedup_str = detail::GetString(output_j, "dedup_policy", "");
+    if (!dedup_str.empty()) {
+        auto dedup_r = parse_dedup_policy(dedup_str);
+        if (dedup_r) { config.io.output.dedup_policy = dedup_r.value(); }
+    }
 
     // resource
     auto resource_j = detail::GetObject(j, "resource");
@@ -596,6 +677,23 @@ Result<TaskConfig> ParseTaskConfigFromJson(const json& j) {
     config.resource.segment_duration_seconds =
         detail::GetInt(resource_j, "segment_duration_seconds", 0);
 
+    config.resource.decoder_thread_count = detail::GetInt(resource_j, "decoder_thread_count", 0);
+    config.resource.encoder_thread_count = detail::GetInt(resource_j, "encoder_thread_count", 0);
+    auto codec_thread_str = detail::GetString(resource_j, "codec_thread_type", "");
+    if (!codec_thread_str.empty()) {
+        auto codec_thread_r = parse_codec_thread_type(codec_thread_str);
+        if (codec_thread_r) { config.resource.codec_thread_type = codec_thread_r.value(); }
+    }
+
+    config.resource.image_decode_thread_count =
+        detail::GetInt(resource_j, "image_decode_thread_count", 0);
+    config.resource.image_encode_thread_count =
+        detail::GetInt(resource_j, "image_encode_thread_count", 0);
+    config.resource.image_prefetch_count = detail::GetInt(resource_j, "image_prefetch_count", 0);
+    config.resource.image_memory_map = detail::GetBool(resource_j, "image_memory_map", true);
+    config.resource.max_concurrent_targets =
+        detail::GetInt(resource_j, "max_concurrent_targets", 1);
+
     // face_analysis
     auto fa_j = detail::GetObject(j, "face_analysis");
 
@@ -606,6 +704,8 @@ Result<TaskConfig> ParseTaskConfigFromJson(const json& j) {
     }
     config.face_analysis.face_detector.score_threshold =
         detail::GetDouble(detector_j, "score_threshold", 0.0);
+    config.face_analysis.face_detector.roi_refine =
+        detail::GetBool(detector_j, "roi_refine", false);
 
     auto landmarker_j = detail::GetObject(fa_j, "face_landmarker");
     config.face_analysis.face_landmarker.model = detail::GetString(landmarker_j, "model", "");
@@ -111,6 +111,18 @@ export namespace config {
 [[nodiscard]] Result<AudioPolicy> parse_audio_policy(const std::string& str);
 [[nodiscard]] std::string to_string(AudioPolicy value);
 
+/// DedupPolicy <-> string
+[[nodiscard]] Result<DedupPolicy> parse_dedup_policy(const std::string& str);
+[[nodiscard]] std::string to_string(DedupPolicy value);
+
+/// StreamFormat <-> string
+[[nodiscard]] Result<StreamFormat> parse_stream_format(const std::string& str);
+[[nodiscard]] std::string to_string(StreamFormat value);
+
+/// CodecThreadType <-> string
+[[nodiscard]] Result<CodecThreadType> parse_codec_thread_type(const std::string& str);
+[[nodiscard]] std::string to_string(CodecThreadType value);
+
 /// FaceSelectorMode <-> string
 [[nodiscard]] Result<FaceSelectorMode> parse_face_selector_mode(const std::string& str);
 [[nodiscard]] std::string to_string(FaceSelectorMode value);
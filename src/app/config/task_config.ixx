@@ -43,6 +43,14 @@ struct OutputConfig {
     int video_quality = 0;     ///< Video encoding quality (0-100)
     ConflictPolicy conflict_policy = ConflictPolicy::Error; ///< Policy for existing files
     AudioPolicy audio_policy = AudioPolicy::Copy;           ///< Policy for audio track
+    bool smart_render = false; ///< Copy source GOPs without processed frames (no re-encode)
+    StreamFormat stream_format = StreamFormat::None; ///< Stream the video result to stdout
+    DedupPolicy dedup_policy = DedupPolicy::Copy;    ///< Targets with identical content
+
+    /**
+     * @brief Check if the result is streamed to stdout instead of written to a file
+     */
+    [[nodiscard]] bool is_streaming() const { return stream_format != StreamFormat::None; }
 };
 
 /**
@@ -63,7 +71,15 @@ struct TaskResourceConfig {
     ExecutionOrder execution_order = ExecutionOrder::Sequential; ///< Media processing order
     MemoryStrategy memory_strategy = MemoryStrategy::Tolerant;   ///< Memory usage priority
     int segment_duration_seconds = 0;                            ///< Video segmenting (0 = off)
-    int max_frames = 0; ///< Max frames to process (0 = all)
+    int max_frames = 0;                                        ///< Max frames to process (0 = all)
+    int decoder_thread_count = 0;                              ///< Video decoder threads (0 = auto)
+    int encoder_thread_count = 0;                              ///< Video encoder threads (0 = auto)
+    CodecThreadType codec_thread_type = CodecThreadType::Auto; ///< Decoder/encoder threading
+    int image_decode_thread_count = 0; ///< Image batch decode threads (0 = auto)
+    int image_encode_thread_count = 0; ///< Image batch encode threads (0 = auto)
+    int image_prefetch_count = 0;      ///< Images decoded ahead of the pipeline (0 = auto)
+    bool image_memory_map = true;      ///< Read image batch inputs through a memory mapping
+    int max_concurrent_targets = 1;    ///< Video targets processed side by side (1 = one by one)
 
     /**
      * @brief Get the effective thread count (handling auto: half of hardware threads)
@@ -74,6 +90,65 @@ struct TaskResourceConfig {
         if (kHw == 0) return 2; // Fallback
         return std::max(1, static_cast<int>(kHw / 2));
     }
+
+    /**
+     * @brief Get the effective decoder thread count
+     * @details Auto: the cores left over by the pipeline workers are shared by the codecs.
+     *          Decoding is far cheaper than encoding, so the decoder gets a quarter of them
+     *          (1-4 threads).
+     */
+    [[nodiscard]] int get_effective_decoder_thread_count() const {
+        if (decoder_thread_count > 0) return decoder_thread_count;
+        return std::clamp(spare_codec_threads() / 4, 1, 4);
+    }
+
+    /**
+     * @brief Get the effective encoder thread count
+     * @details Auto: the spare cores not given to the decoder (1-16 threads; x264/x265 gain
+     *          little beyond that).
+     */
+    [[nodiscard]] int get_effective_encoder_thread_count() const {
+        if (encoder_thread_count > 0) return encoder_thread_count;
+        return std::clamp(spare_codec_threads() - get_effective_decoder_thread_count(), 1, 16);
+    }
+
+    /**
+     * @brief Get the effective image batch decode thread count
+     * @details Auto: like the video decoder, a quarter of the spare cores (1-4 threads).
+     */
+    [[nodiscard]] int get_effective_image_decode_thread_count() const {
+        if (image_decode_thread_count > 0) return image_decode_thread_count;
+        return std::clamp(spare_codec_threads() / 4, 1, 4);
+    }
+
+    /**
+     * @brief Get the effective image batch encode thread count
+     * @details Auto: the spare cores not given to decoding (1-8 threads). PNG and large JPEG
+     *          encodes are the slow end of an image batch.
+     */
+    [[nodiscard]] int get_effective_image_encode_thread_count() const {
+        if (image_encode_thread_count > 0) return image_encode_thread_count;
+        return std::clamp(spare_codec_threads() - get_effective_image_decode_thread_count(), 1, 8);
+    }
+
+    /**
+     * @brief Get the effective number of images decoded ahead of the pipeline
+     * @details Auto: two per decode thread, so every decoder always has work queued.
+     */
+    [[nodiscard]] int get_effective_image_prefetch_count() const {
+        if (image_prefetch_count > 0) return image_prefetch_count;
+        return 2 * get_effective_image_decode_thread_count();
+    }
+
+private:
+    /**
+     * @brief Hardware threads not used by the pipeline workers (at least 2)
+     */
+    [[nodiscard]] int spare_codec_threads() const {
+        const unsigned int kHw = std::thread::hardware_concurrency();
+        const int hw = kHw == 0 ? 4 : static_cast<int>(kHw);
+        return std::max(2, hw - get_effective_thread_count());
+    }
 };
 
 /**
@@ -93,6 +168,9 @@ struct FaceEnhancerParams {
     double blend_factor = 0.8; ///< Face blending factor (0.0-1.0)
     FaceSelectorMode face_selector_mode = FaceSelectorMode::Many; ///< Selection strategy
     std::optional<std::string> reference_face_path;
+    bool temporal_reuse = false;    ///< Reuse the last enhanced crop for near-static faces
+    double reuse_threshold = 2.0;   ///< Max mean abs. difference (0-255) of crop thumbnails
+    int reuse_refresh_interval = 30; ///< Re-enhance each face at least every N frames
 };
 
 /**
@@ -103,6 +181,7 @@ struct ExpressionRestorerParams {
     double restore_factor = 0.8;                                  ///< Restoration factor (0.0-1.0)
     FaceSelectorMode face_selector_mode = FaceSelectorMode::Many; ///< Selection strategy
     std::optional<std::string> reference_face_path;
+    int feature_refresh_interval = 15; ///< Video: re-extract face features every N frames (0: off)
 };
 
 /**
@@ -111,6 +190,8 @@ struct ExpressionRestorerParams {
 struct FrameEnhancerParams {
     std::string model;           ///< Model name identifier
     double enhance_factor = 0.8; ///< Enhancement intensity (0.0-1.0)
+    int tile_size = 0;           ///< Inference tile edge in pixels, 0 = model default (256)
+    bool autotune_tiles = true;  ///< Refine tile size and batching from a calibration run
 };
 
 /**
@@ -135,6 +216,7 @@ struct PipelineStep {
 struct FaceDetectorConfig {
     std::vector<std::string> models = {"yoloface", "retinaface", "scrfd"}; ///< Detector models
     double score_threshold = 0.0;                                          ///< Min confidence
+    bool roi_refine = false;                                               ///< Two-stage detection
 };
 
 /**
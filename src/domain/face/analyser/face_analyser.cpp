@@ -2,6 +2,7 @@ module;
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <algorithm>
 #include <tuple>
 #include <numeric>
@@ -17,6 +18,7 @@ import domain.face.recognizer;
 import domain.face.classifier;
 import domain.face.selector;
 import domain.face.store;
+import domain.face.embedding_index;
 import domain.face.helper;
 import domain.common;
 import foundation.infrastructure.logger;
@@ -50,7 +52,12 @@ public:
 
     void update_options(const Options& options) { apply_options(options); }
 
-    std::vector<Face> get_many_faces(const cv::Mat& vision_frame, FaceAnalysisType type) {
+    [[nodiscard]] FrameKey make_frame_key(const cv::Mat& vision_frame) const {
+        return m_face_store->make_key(vision_frame);
+    }
+
+    std::vector<Face> get_many_faces(const cv::Mat& vision_frame, const FrameKey& frame_key,
+                                     FaceAnalysisType type) {
         ScopedTimer timer("FaceAnalyser::get_many_faces", LogLevel::Debug);
         auto& logger = *Logger::get_instance();
 
@@ -59,12 +66,16 @@ public:
             return {};
         }
 
+        // Hash the frame at most once per call; all store lookups below reuse the key.
+        const FrameKey key = frame_key.empty() ? make_frame_key(vision_frame) : frame_key;
+
         std::vector<DetectionResult> detection_results;
         double detected_angle = 0;
 
-        // 1. Check Cache
-        if (m_face_store->is_contains(vision_frame)) {
-            auto cached_faces = m_face_store->get_faces(vision_frame);
+        // 1. Check Cache (a hit shares the stored vector; faces are copied only when returned)
+        const FacesSnapshot cached_snapshot = m_face_store->get_snapshot(key);
+        if (cached_snapshot) {
+            const auto& cached_faces = *cached_snapshot;
             bool cache_satisfies = true;
 
             if (!cached_faces.empty()) {
@@ -100,7 +111,8 @@ public:
 
         // 2. Run Detector if not recovered from cache
         if (detection_results.empty()) {
-            if (!m_detector) {
+            const auto face_detector = detector();
+            if (!face_detector) {
                 logger.error("FaceAnalyser: Detector not initialized.");
                 return {};
             }
@@ -114,7 +126,9 @@ public:
                     domain::face::helper::rotate_image_90n(vision_frame, frame_to_detect, angle);
                 }
 
-                auto results = m_detector->detect(frame_to_detect);
+                auto results = (angle == 0 && use_roi_refine(vision_frame.size()))
+                                 ? detect_coarse_to_fine(*face_detector, vision_frame)
+                                 : face_detector->detect(frame_to_detect);
 
                 int valid_count = 0;
                 for (const auto& r : results) {
@@ -132,15 +146,15 @@ public:
 
         if (detection_results.empty()) {
             logger.debug("FaceAnalyser: No faces detected.");
-            m_face_store->insert_faces(vision_frame, {});
+            m_face_store->insert_faces(key, {});
             return {};
         }
 
         auto result_faces = create_faces(vision_frame, detection_results, detected_angle, type);
 
         // Merge with cached faces
-        if (!detection_results.empty() && m_face_store->is_contains(vision_frame)) {
-            auto cached_faces = m_face_store->get_faces(vision_frame);
+        if (cached_snapshot) {
+            const auto& cached_faces = *cached_snapshot;
             if (cached_faces.size() == result_faces.size()) {
                 for (size_t i = 0; i < result_faces.size(); ++i) {
                     auto& new_face = result_faces[i];
@@ -167,80 +181,175 @@ public:
             }
         }
 
-        m_face_store->insert_faces(vision_frame, result_faces);
-
         if (result_faces.empty()) return {};
 
+        m_face_store->insert_faces(key, result_faces);
+
         return selector::select_faces(result_faces, m_options.face_selector_options);
     }
 
 private:
+    static std::string detector_path(const Options& opts) {
+        switch (opts.face_detector_options.type) {
+        case DetectorType::Yolo: return opts.model_paths.face_detector_yolo;
+        case DetectorType::SCRFD: return opts.model_paths.face_detector_scrfd;
+        case DetectorType::RetinaFace: return opts.model_paths.face_detector_retina;
+        default: return std::string();
+        }
+    }
+
+    static std::string landmarker_path(const Options& opts) {
+        switch (opts.face_landmarker_options.type) {
+        case LandmarkerType::T2dfan: return opts.model_paths.face_landmarker_2dfan;
+        case LandmarkerType::Peppawutz: return opts.model_paths.face_landmarker_peppawutz;
+        case LandmarkerType::T68By5: return opts.model_paths.face_landmarker_68by5;
+        default: return std::string();
+        }
+    }
+
+    // Models are resolved lazily on first use (see detector() etc.), so that e.g. a run whose
+    // source embeddings come from the embedding cache never loads the recognizer. Here we only
+    // drop the models whose configuration changed.
     void apply_options(const Options& options) {
-        auto registry = FaceModelRegistry::get_instance();
-
-        // Detector
-        auto get_det_path = [](const Options& opts) {
-            switch (opts.face_detector_options.type) {
-            case DetectorType::Yolo: return opts.model_paths.face_detector_yolo;
-            case DetectorType::SCRFD: return opts.model_paths.face_detector_scrfd;
-            case DetectorType::RetinaFace: return opts.model_paths.face_detector_retina;
-            default: return std::string();
-            }
-        };
-        std::string det_path = get_det_path(options);
-        std::string old_det_path = get_det_path(m_options);
+        std::lock_guard lock(m_model_mutex);
+        const bool session_changed =
+            options.inference_session_options != m_options.inference_session_options;
 
-        if (!m_detector
+        if (session_changed
             || options.face_detector_options.type != m_options.face_detector_options.type
-            || det_path != old_det_path
-            || options.inference_session_options != m_options.inference_session_options) {
-            m_detector = registry->get_detector(options.face_detector_options.type, det_path,
-                                                options.inference_session_options);
+            || detector_path(options) != detector_path(m_options)) {
+            m_detector.reset();
         }
 
-        // Landmarker
-        auto get_lm_path = [](const Options& opts) {
-            switch (opts.face_landmarker_options.type) {
-            case LandmarkerType::T2dfan: return opts.model_paths.face_landmarker_2dfan;
-            case LandmarkerType::Peppawutz: return opts.model_paths.face_landmarker_peppawutz;
-            case LandmarkerType::T68By5: return opts.model_paths.face_landmarker_68by5;
-            default: return std::string();
-            }
-        };
-        std::string lm_path = get_lm_path(options);
-        std::string old_lm_path = get_lm_path(m_options);
-
-        if (!m_landmarker
+        if (session_changed
             || options.face_landmarker_options.type != m_options.face_landmarker_options.type
-            || lm_path != old_lm_path
-            || options.inference_session_options != m_options.inference_session_options) {
-            m_landmarker = registry->get_landmarker(options.face_landmarker_options.type, lm_path,
-                                                    options.inference_session_options);
+            || landmarker_path(options) != landmarker_path(m_options)) {
+            m_landmarker.reset();
         }
 
-        // Recognizer
-        if (!m_recognizer || options.face_recognizer_type != m_options.face_recognizer_type
+        if (session_changed || options.face_recognizer_type != m_options.face_recognizer_type
             || options.model_paths.face_recognizer_arcface
-                   != m_options.model_paths.face_recognizer_arcface
-            || options.inference_session_options != m_options.inference_session_options) {
-            m_recognizer = registry->get_recognizer(options.face_recognizer_type,
-                                                    options.model_paths.face_recognizer_arcface,
-                                                    options.inference_session_options);
+                   != m_options.model_paths.face_recognizer_arcface) {
+            m_recognizer.reset();
         }
 
-        // Classifier
-        if (!m_classifier || options.face_classifier_type != m_options.face_classifier_type
+        if (session_changed || options.face_classifier_type != m_options.face_classifier_type
             || options.model_paths.face_classifier_fairface
-                   != m_options.model_paths.face_classifier_fairface
-            || options.inference_session_options != m_options.inference_session_options) {
-            m_classifier = registry->get_classifier(options.face_classifier_type,
-                                                    options.model_paths.face_classifier_fairface,
-                                                    options.inference_session_options);
+                   != m_options.model_paths.face_classifier_fairface) {
+            m_classifier.reset();
         }
 
         m_options = options;
     }
 
+    std::shared_ptr<IFaceDetector> detector() {
+        std::lock_guard lock(m_model_mutex);
+        if (!m_detector) {
+            m_detector = FaceModelRegistry::get_instance()->get_detector(
+                m_options.face_detector_options.type, detector_path(m_options),
+                m_options.inference_session_options);
+        }
+        return m_detector;
+    }
+
+    std::shared_ptr<IFaceLandmarker> landmarker() {
+        std::lock_guard lock(m_model_mutex);
+        if (!m_landmarker) {
+            m_landmarker = FaceModelRegistry::get_instance()->get_landmarker(
+                m_options.face_landmarker_options.type, landmarker_path(m_options),
+                m_options.inference_session_options);
+        }
+        return m_landmarker;
+    }
+
+    std::shared_ptr<FaceRecognizer> recognizer() {
+        std::lock_guard lock(m_model_mutex);
+        if (!m_recognizer) {
+            m_recognizer = FaceModelRegistry::get_instance()->get_recognizer(
+                m_options.face_recognizer_type, m_options.model_paths.face_recognizer_arcface,
+                m_options.inference_session_options);
+        }
+        return m_recognizer;
+    }
+
+    std::shared_ptr<IFaceClassifier> classifier() {
+        std::lock_guard lock(m_model_mutex);
+        if (!m_classifier) {
+            m_classifier = FaceModelRegistry::get_instance()->get_classifier(
+                m_options.face_classifier_type, m_options.model_paths.face_classifier_fairface,
+                m_options.inference_session_options);
+        }
+        return m_classifier;
+    }
+
+    [[nodiscard]] bool use_roi_refine(const cv::Size& frame_size) const {
+        const auto& roi = m_options.face_detector_options.roi_refine;
+        return roi.enabled && std::max(frame_size.width, frame_size.height) >= roi.min_frame_side;
+    }
+
+    /**
+     * @brief Two-stage detection: coarse pass on the whole frame (downscaled by the detector to
+     *        its input size), then re-detection on a full-resolution ROI view around each
+     *        candidate. Candidates whose ROI yields no matching face keep their coarse result.
+     */
+    DetectionResults detect_coarse_to_fine(IFaceDetector& face_detector, const cv::Mat& frame) {
+        const auto& opts = m_options.face_detector_options;
+        auto coarse = face_detector.detect(frame);
+        if (!opts.roi_refine.redetect || coarse.empty()
+            || coarse.size() > opts.roi_refine.max_candidates) {
+            return coarse;
+        }
+
+        std::vector<cv::Rect2f> boxes;
+        std::vector<float> scores;
+        std::vector<size_t> indices;
+        for (size_t i = 0; i < coarse.size(); ++i) {
+            if (coarse[i].score < opts.min_score) continue;
+            boxes.push_back(coarse[i].box);
+            scores.push_back(coarse[i].score);
+            indices.push_back(i);
+        }
+        const auto keep = domain::face::helper::apply_nms(boxes, scores, opts.iou_threshold);
+
+        const cv::Rect frame_rect(0, 0, frame.cols, frame.rows);
+        DetectionResults refined;
+        refined.reserve(keep.size());
+        for (int k : keep) {
+            const auto& candidate = coarse[indices[k]];
+            const float side =
+                std::max(candidate.box.width, candidate.box.height) * opts.roi_refine.roi_scale;
+            const cv::Point2f center = (candidate.box.tl() + candidate.box.br()) * 0.5F;
+            const cv::Rect roi =
+                cv::Rect(cvRound(center.x - side * 0.5F), cvRound(center.y - side * 0.5F),
+                         cvRound(side), cvRound(side))
+                & frame_rect;
+            if (roi.empty()) continue;
+
+            // ROI is a view into the full-resolution frame; nothing is copied or resized here
+            const auto local = face_detector.detect(frame(roi));
+            const cv::Point2f offset(static_cast<float>(roi.x), static_cast<float>(roi.y));
+
+            const DetectionResult* best = nullptr;
+            for (const auto& r : local) {
+                const cv::Point2f local_center = (r.box.tl() + r.box.br()) * 0.5F + offset;
+                if (!candidate.box.contains(local_center)) continue;
+                if (!best || r.score > best->score) best = &r;
+            }
+
+            if (!best || best->score < opts.min_score) {
+                refined.push_back(candidate);
+                continue;
+            }
+
+            DetectionResult result = *best;
+            result.box.x += offset.x;
+            result.box.y += offset.y;
+            for (auto& point : result.landmarks) { point += offset; }
+            refined.push_back(std::move(result));
+        }
+        return refined;
+    }
+
     std::vector<Face> create_faces(const cv::Mat& vision_frame,
                                    const std::vector<DetectionResult>& detection_results,
                                    double detected_angle, FaceAnalysisType type) {
@@ -272,6 +381,15 @@ private:
 
         cv::Size original_size = vision_frame.size();
 
+        // Only resolve the models this analysis type actually needs.
+        const bool want_landmarks = has_flag(type, FaceAnalysisType::Landmark)
+                                 && m_options.face_landmarker_options.min_score > 0;
+        const auto face_landmarker = want_landmarks ? landmarker() : nullptr;
+        const auto face_recognizer =
+            has_flag(type, FaceAnalysisType::Embedding) ? recognizer() : nullptr;
+        const auto face_classifier =
+            has_flag(type, FaceAnalysisType::GenderAge) ? classifier() : nullptr;
+
         std::vector<size_t> original_indices;
         for (size_t i = 0; i < detection_results.size(); ++i) {
             if (detection_results[i].score >= m_options.face_detector_options.min_score) {
@@ -297,16 +415,15 @@ private:
             face.set_kps(kps5_back);
 
             // Landmarking
-            if (has_flag(type, FaceAnalysisType::Landmark)
-                && m_options.face_landmarker_options.min_score > 0 && m_landmarker) {
+            if (face_landmarker) {
                 if (m_options.face_landmarker_options.type == landmarker::LandmarkerType::T68By5) {
-                    auto kps68_back = m_landmarker->expand_68_from_5(kps5_back);
+                    auto kps68_back = face_landmarker->expand_68_from_5(kps5_back);
                     if (!kps68_back.empty()) {
                         face.set_kps(kps68_back);
                         face.set_landmarker_score(1.0f);
                     }
                 } else {
-                    auto lm_res = m_landmarker->detect(rotated_frame, res.box);
+                    auto lm_res = face_landmarker->detect(rotated_frame, res.box);
                     face.set_landmarker_score(lm_res.score);
 
                     if (lm_res.score > m_options.face_landmarker_options.min_score) {
@@ -323,15 +440,15 @@ private:
             auto kps5 = face.get_landmark5();
 
             // Recognition
-            if (has_flag(type, FaceAnalysisType::Embedding) && m_recognizer) {
-                auto [emb, norm_emb] = m_recognizer->recognize(vision_frame, kps5);
+            if (face_recognizer) {
+                auto [emb, norm_emb] = face_recognizer->recognize(vision_frame, kps5);
                 face.set_embedding(emb);
                 face.set_normed_embedding(norm_emb);
             }
 
             // Classification
-            if (has_flag(type, FaceAnalysisType::GenderAge) && m_classifier) {
-                auto class_res = m_classifier->classify(vision_frame, kps5);
+            if (face_classifier) {
+                auto class_res = face_classifier->classify(vision_frame, kps5);
                 face.set_race(class_res.race);
                 face.set_gender(class_res.gender);
                 face.set_age_range(class_res.age);
@@ -349,6 +466,7 @@ private:
     std::shared_ptr<FaceRecognizer> m_recognizer;
     std::shared_ptr<IFaceClassifier> m_classifier;
     std::shared_ptr<FaceStore> m_face_store;
+    std::mutex m_model_mutex; ///< Guards lazy model resolution and option updates
 };
 
 // FaceAnalyser Implementation using PIMPL
@@ -371,7 +489,16 @@ void FaceAnalyser::update_options(const Options& options) {
 }
 
 std::vector<Face> FaceAnalyser::get_many_faces(const cv::Mat& vision_frame, FaceAnalysisType type) {
-    return m_impl->get_many_faces(vision_frame, type);
+    return m_impl->get_many_faces(vision_frame, {}, type);
+}
+
+std::vector<Face> FaceAnalyser::get_many_faces(const cv::Mat& vision_frame,
+                                               const FrameKey& frame_key, FaceAnalysisType type) {
+    return m_impl->get_many_faces(vision_frame, frame_key, type);
+}
+
+FrameKey FaceAnalyser::make_frame_key(const cv::Mat& vision_frame) const {
+    return m_impl->make_frame_key(vision_frame);
 }
 
 Face FaceAnalyser::get_one_face(const cv::Mat& vision_frame, unsigned int position,
@@ -424,13 +551,21 @@ Face FaceAnalyser::get_average_face(const std::vector<Face>& faces) {
 std::vector<Face> FaceAnalyser::find_similar_faces(const std::vector<Face>& reference_faces,
                                                    const cv::Mat& target_vision_frame,
                                                    float face_distance) {
+    return find_similar_faces(embedding_index::EmbeddingIndex::from_faces(reference_faces),
+                              target_vision_frame, face_distance);
+}
+
+std::vector<Face> FaceAnalyser::find_similar_faces(
+    const embedding_index::EmbeddingIndex& reference_index, const cv::Mat& target_vision_frame,
+    float face_distance) {
     std::vector<Face> similar_faces;
-    auto many_faces = get_many_faces(target_vision_frame);
-    if (many_faces.empty()) return similar_faces;
+    if (reference_index.empty()) return similar_faces;
 
-    for (const auto& ref_face : reference_faces) {
-        for (const auto& face : many_faces) {
-            if (compare_face(face, ref_face, face_distance)) { similar_faces.push_back(face); }
+    auto many_faces = get_many_faces(target_vision_frame);
+    for (auto& face : many_faces) {
+        const auto best = reference_index.best_match(face.normed_embedding());
+        if (best && 1.0f - best->similarity < face_distance) {
+            similar_faces.push_back(std::move(face));
         }
     }
     return similar_faces;
@@ -1,4 +1,5 @@
 module;
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -16,6 +17,7 @@ import domain.face.recognizer;
 import domain.face.classifier;
 import domain.face.selector;
 import domain.face.store;
+import domain.face.embedding_index;
 import domain.common;
 import foundation.ai.inference_session;
 
@@ -35,6 +37,21 @@ struct ModelPaths {
     std::string face_classifier_fairface;  ///< Path to FairFace face classifier model
 };
 
+/**
+ * @brief Coarse-to-fine detection for high-resolution frames
+ * @details The detector first runs on the whole frame at its native (low) input resolution; each
+ *          candidate is then re-detected on a full-resolution crop around it, so box and landmark
+ *          precision no longer depend on the frame size and the extra cost scales with the number
+ *          of faces rather than with the frame resolution.
+ */
+struct RoiRefineOptions {
+    bool enabled = false;            ///< Enable two-stage detection
+    int min_frame_side = 1920;       ///< Only frames whose longer side reaches this are refined
+    float roi_scale = 2.0F;          ///< ROI side relative to the candidate's longer side
+    bool redetect = true;            ///< Re-run the detector on each ROI, else keep coarse
+    std::size_t max_candidates = 16; ///< More coarse candidates than this skip refinement
+};
+
 /**
  * @brief Options for face detection
  */
@@ -42,6 +59,7 @@ struct FaceDetectorOptions {
     detector::DetectorType type = detector::DetectorType::Yolo; ///< Preferred detector type
     float min_score = 0.5F;                                     ///< Minimum confidence score
     float iou_threshold = 0.4F;                                 ///< NMS IOU threshold
+    RoiRefineOptions roi_refine;                                ///< Two-stage detection settings
 };
 
 /**
@@ -154,6 +172,23 @@ public:
     std::vector<Face> get_many_faces(const cv::Mat& vision_frame,
                                      FaceAnalysisType type = FaceAnalysisType::All);
 
+    /**
+     * @brief Detect and analyze multiple faces in a frame using a precomputed cache key
+     * @param vision_frame Input image frame
+     * @param frame_key Key from make_frame_key() for @p vision_frame (computed if empty)
+     * @param type Bitmask determining which analysis steps to perform
+     * @return Vector of detected Face objects
+     */
+    std::vector<Face> get_many_faces(const cv::Mat& vision_frame, const store::FrameKey& frame_key,
+                                     FaceAnalysisType type = FaceAnalysisType::All);
+
+    /**
+     * @brief Compute the face store key for a frame
+     * @details Hashing a frame is proportional to its size; compute the key once per frame and
+     *          pass it to get_many_faces() instead of letting every call re-hash the pixels.
+     */
+    [[nodiscard]] store::FrameKey make_frame_key(const cv::Mat& vision_frame) const;
+
     /**
      * @brief Detect and get a single face (based on selection strategy)
      * @param vision_frame Input image frame
@@ -188,6 +223,18 @@ public:
     std::vector<Face> find_similar_faces(const std::vector<Face>& reference_faces,
                                          const cv::Mat& target_vision_frame, float face_distance);
 
+    /**
+     * @brief Find faces similar to a prebuilt reference gallery in a target frame
+     * @details Each detected face is matched against the whole gallery with one batched
+     *          similarity query; build @p reference_index once and reuse it across frames.
+     * @param reference_index Index of reference embeddings
+     * @param target_vision_frame Frame to search in
+     * @param face_distance Similarity threshold (distance)
+     * @return Matching faces in detection order, each at most once
+     */
+    std::vector<Face> find_similar_faces(const embedding_index::EmbeddingIndex& reference_index,
+                                         const cv::Mat& target_vision_frame, float face_distance);
+
     /**
      * @brief Compare two faces for similarity
      * @param face Detected face
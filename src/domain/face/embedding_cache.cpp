@@ -0,0 +1,138 @@
+/**
+ ******************************************************************************
+ * @file           : embedding_cache.cpp
+ * @brief          : Persistent source embedding cache implementation
+ ******************************************************************************
+ */
+
+module;
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <random>
+#include <system_error>
+#include <vector>
+
+module domain.face.embedding_cache;
+
+import domain.face;
+import foundation.infrastructure.crypto;
+
+namespace domain::face::embedding_cache {
+
+namespace {
+
+// File layout: magic | version | face_count | dim | dim x float32 (native byte order)
+constexpr std::array<char, 4> kMagic = {'F', 'F', 'E', 'C'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kMaxDim = 1 << 16; ///< Sanity bound against corrupt files
+
+} // namespace
+
+types::Embedding combine(const std::vector<CachedEmbedding>& entries) {
+    types::Embedding avg;
+    double total_faces = 0.0;
+    for (const auto& entry : entries) {
+        if (entry.empty()) continue;
+        if (avg.empty()) avg.assign(entry.embedding.size(), 0.0f);
+        if (entry.embedding.size() != avg.size()) continue;
+
+        const auto weight = static_cast<float>(entry.face_count);
+        for (size_t i = 0; i < avg.size(); ++i) { avg[i] += entry.embedding[i] * weight; }
+        total_faces += entry.face_count;
+    }
+    if (avg.empty()) return {};
+
+    // Weighted mean, then L2-normalise (matches helper::compute_average_embedding over all faces)
+    double norm = 0.0;
+    for (float& v : avg) {
+        v = static_cast<float>(v / total_faces);
+        norm += static_cast<double>(v) * v;
+    }
+    norm = std::sqrt(norm);
+    if (norm > 1e-6) {
+        for (float& v : avg) v /= static_cast<float>(norm);
+    }
+    return avg;
+}
+
+EmbeddingCache::EmbeddingCache(std::filesystem::path directory) :
+    m_directory(std::move(directory)) {}
+
+std::string EmbeddingCache::make_key(const std::string& content_hash,
+                                     const std::string& analysis_id) {
+    return foundation::infrastructure::crypto::sha1_string(content_hash + "|" + analysis_id);
+}
+
+std::filesystem::path EmbeddingCache::entry_path(const std::string& key) const {
+    return m_directory / (key + ".emb");
+}
+
+std::optional<CachedEmbedding> EmbeddingCache::load(const std::string& key) const {
+    std::ifstream in(entry_path(key), std::ios::binary);
+    if (!in) return std::nullopt;
+
+    std::array<char, 4> magic{};
+    std::uint32_t version = 0;
+    CachedEmbedding entry;
+    std::uint32_t dim = 0;
+
+    in.read(magic.data(), magic.size());
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&entry.face_count), sizeof(entry.face_count));
+    in.read(reinterpret_cast<char*>(&dim), sizeof(dim));
+    if (!in || magic != kMagic || version != kVersion || dim == 0 || dim > kMaxDim) {
+        return std::nullopt;
+    }
+
+    entry.embedding.resize(dim);
+    in.read(reinterpret_cast<char*>(entry.embedding.data()),
+            static_cast<std::streamsize>(dim * sizeof(float)));
+    if (!in || entry.empty()) return std::nullopt;
+    return entry;
+}
+
+bool EmbeddingCache::save(const std::string& key, const CachedEmbedding& entry) const {
+    if (entry.empty()) return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) return false;
+
+    // Write to a uniquely named temp file and rename so readers (possibly in other processes)
+    // never observe a partial entry
+    const auto final_path = entry_path(key);
+    auto temp_path = final_path;
+    temp_path += ".tmp" + std::to_string(std::random_device{}());
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        const auto dim = static_cast<std::uint32_t>(entry.embedding.size());
+        out.write(kMagic.data(), kMagic.size());
+        out.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+        out.write(reinterpret_cast<const char*>(&entry.face_count), sizeof(entry.face_count));
+        out.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+        out.write(reinterpret_cast<const char*>(entry.embedding.data()),
+                  static_cast<std::streamsize>(dim * sizeof(float)));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp_path, final_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace domain::face::embedding_cache
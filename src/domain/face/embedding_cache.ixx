@@ -0,0 +1,86 @@
+/**
+ * @file embedding_cache.ixx
+ * @brief Persistent on-disk cache of source face embeddings
+ * @author CodingRookie
+ * @date 2026-10-18
+ */
+module;
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+export module domain.face.embedding_cache;
+
+import domain.face;
+
+export namespace domain::face::embedding_cache {
+
+/**
+ * @brief Embedding data cached for one source image
+ * @details Stores the mean of the raw embeddings of every face found in the image, so that
+ *          several cached images can be combined with the same result as averaging all their
+ *          faces at once (see combine()).
+ */
+struct CachedEmbedding {
+    types::Embedding embedding;   ///< Mean raw embedding of all faces in the image
+    std::uint32_t face_count = 0; ///< Number of faces averaged into @c embedding
+
+    [[nodiscard]] bool empty() const { return face_count == 0 || embedding.empty(); }
+};
+
+/**
+ * @brief Face-count weighted mean of several cached embeddings, L2-normalised
+ * @return Normed average embedding (empty if no entry has faces)
+ */
+[[nodiscard]] types::Embedding combine(const std::vector<CachedEmbedding>& entries);
+
+/**
+ * @brief File-backed cache of per-image source embeddings
+ * @details Entries are keyed by the image file's content hash plus an identifier of the
+ *          analysis that produced them (models and detector settings), so renamed or copied files
+ *          still hit and a model or settings change never returns stale vectors.
+ *          Each entry is a small binary file written atomically (temp file + rename), which makes
+ *          the cache safe to share between concurrent processes.
+ */
+class EmbeddingCache {
+public:
+    /**
+     * @brief Construct a cache rooted at @p directory (created on first save)
+     */
+    explicit EmbeddingCache(std::filesystem::path directory);
+
+    /**
+     * @brief Build the cache key for an image
+     * @param content_hash Hash of the image file content (e.g. crypto::sha1)
+     * @param analysis_id Identifier of the recognizer and detector models and of every setting
+     *                    that decides which faces are averaged
+     */
+    [[nodiscard]] static std::string make_key(const std::string& content_hash,
+                                              const std::string& analysis_id);
+
+    /**
+     * @brief Load a cached entry
+     * @return Entry, or std::nullopt if missing or unreadable
+     */
+    [[nodiscard]] std::optional<CachedEmbedding> load(const std::string& key) const;
+
+    /**
+     * @brief Persist an entry
+     * @return true if written
+     */
+    bool save(const std::string& key, const CachedEmbedding& entry) const;
+
+    /**
+     * @brief Cache root directory
+     */
+    [[nodiscard]] const std::filesystem::path& directory() const { return m_directory; }
+
+private:
+    std::filesystem::path m_directory;
+
+    [[nodiscard]] std::filesystem::path entry_path(const std::string& key) const;
+};
+
+} // namespace domain::face::embedding_cache
@@ -0,0 +1,194 @@
+/**
+ ******************************************************************************
+ * @file           : embedding_index.cpp
+ * @brief          : Reference embedding similarity index implementation
+ ******************************************************************************
+ */
+
+module;
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+module domain.face.embedding_index;
+
+import domain.face;
+
+namespace domain::face::embedding_index {
+
+namespace {
+
+constexpr std::size_t kAlignmentBytes = 64;
+
+std::size_t padded_stride(std::size_t dim, std::size_t element_size) {
+    const std::size_t per_line = kAlignmentBytes / element_size;
+    return (dim + per_line - 1) / per_line * per_line;
+}
+
+float dot_f32(const float* a, const float* b, std::size_t n) {
+    std::size_t i = 0;
+    float sum = 0.0F;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const std::size_t lanes = cv::VTraits<cv::v_float32>::vlanes();
+    cv::v_float32 acc0 = cv::vx_setzero_f32();
+    cv::v_float32 acc1 = cv::vx_setzero_f32();
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        acc0 = cv::v_fma(cv::vx_load(a + i), cv::vx_load(b + i), acc0);
+        acc1 = cv::v_fma(cv::vx_load(a + i + lanes), cv::vx_load(b + i + lanes), acc1);
+    }
+    for (; i + lanes <= n; i += lanes) {
+        acc0 = cv::v_fma(cv::vx_load(a + i), cv::vx_load(b + i), acc0);
+    }
+    sum = cv::v_reduce_sum(cv::v_add(acc0, acc1));
+    cv::vx_cleanup();
+#endif
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+std::int32_t dot_s8(const std::int8_t* a, const std::int8_t* b, std::size_t n) {
+    std::size_t i = 0;
+    std::int32_t sum = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    // Widen to int16 and use the pairwise multiply-add; |sum| <= dim * 127^2 fits in int32
+    const std::size_t lanes = cv::VTraits<cv::v_int16>::vlanes();
+    cv::v_int32 acc = cv::vx_setzero_s32();
+    for (; i + lanes <= n; i += lanes) {
+        const auto va = cv::vx_load_expand(reinterpret_cast<const schar*>(a + i));
+        const auto vb = cv::vx_load_expand(reinterpret_cast<const schar*>(b + i));
+        acc = cv::v_add(acc, cv::v_dotprod(va, vb));
+    }
+    sum = cv::v_reduce_sum(acc);
+    cv::vx_cleanup();
+#endif
+    for (; i < n; ++i) sum += static_cast<std::int32_t>(a[i]) * b[i];
+    return sum;
+}
+
+/**
+ * @brief Write the L2-normalised @p src into @p dst (already sized and zero-padded)
+ * @return false for a zero vector
+ */
+bool normalise_into(const types::Embedding& src, float* dst) {
+    double norm = 0.0;
+    for (float v : src) norm += static_cast<double>(v) * v;
+    norm = std::sqrt(norm);
+    if (norm <= 1e-6) return false;
+
+    const auto inv = static_cast<float>(1.0 / norm);
+    for (std::size_t i = 0; i < src.size(); ++i) dst[i] = src[i] * inv;
+    return true;
+}
+
+/**
+ * @brief Symmetric int8 quantisation of @p n floats
+ * @return Dequantisation scale (0 for an all-zero input)
+ */
+float quantise_into(const float* src, std::size_t n, std::int8_t* dst) {
+    float max_abs = 0.0F;
+    for (std::size_t i = 0; i < n; ++i) max_abs = std::max(max_abs, std::abs(src[i]));
+    if (max_abs <= 0.0F) return 0.0F;
+
+    const float scale = max_abs / 127.0F;
+    const float inv = 1.0F / scale;
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<std::int8_t>(std::clamp(std::lround(src[i] * inv), -127L, 127L));
+    }
+    return scale;
+}
+
+} // namespace
+
+EmbeddingIndex::EmbeddingIndex(Precision precision) : m_precision(precision) {}
+
+EmbeddingIndex EmbeddingIndex::from_faces(const std::vector<Face>& faces, Precision precision) {
+    EmbeddingIndex index(precision);
+    for (const auto& face : faces) { index.add(face.normed_embedding()); }
+    return index;
+}
+
+bool EmbeddingIndex::add(const types::Embedding& embedding) {
+    if (embedding.empty()) return false;
+    if (m_rows == 0) {
+        m_dim = embedding.size();
+        m_stride = padded_stride(m_dim, m_precision == Precision::Int8 ? 1 : sizeof(float));
+    } else if (embedding.size() != m_dim) {
+        return false;
+    }
+
+    std::vector<float, AlignedAllocator<float>> row(m_stride, 0.0F);
+    if (!normalise_into(embedding, row.data())) return false;
+
+    if (m_precision == Precision::Int8) {
+        m_int8_rows.resize((m_rows + 1) * m_stride, 0);
+        auto* dst = m_int8_rows.data() + m_rows * m_stride;
+        m_scales.push_back(quantise_into(row.data(), m_dim, dst));
+    } else {
+        m_float_rows.insert(m_float_rows.end(), row.begin(), row.end());
+    }
+    ++m_rows;
+    return true;
+}
+
+void EmbeddingIndex::clear() {
+    m_dim = 0;
+    m_stride = 0;
+    m_rows = 0;
+    m_float_rows.clear();
+    m_int8_rows.clear();
+    m_scales.clear();
+}
+
+std::vector<float> EmbeddingIndex::similarities(const types::Embedding& query) const {
+    if (m_rows == 0 || query.size() != m_dim) return {};
+
+    std::vector<float, AlignedAllocator<float>> q(m_stride, 0.0F);
+    std::vector<float> result(m_rows, 0.0F);
+    if (!normalise_into(query, q.data())) return result;
+
+    if (m_precision == Precision::Int8) {
+        std::vector<std::int8_t, AlignedAllocator<std::int8_t>> q8(m_stride, 0);
+        const float q_scale = quantise_into(q.data(), m_dim, q8.data());
+        for (std::size_t r = 0; r < m_rows; ++r) {
+            const auto dot = dot_s8(m_int8_rows.data() + r * m_stride, q8.data(), m_stride);
+            result[r] = static_cast<float>(dot) * m_scales[r] * q_scale;
+        }
+    } else {
+        for (std::size_t r = 0; r < m_rows; ++r) {
+            result[r] = dot_f32(m_float_rows.data() + r * m_stride, q.data(), m_stride);
+        }
+    }
+    return result;
+}
+
+std::vector<Match> EmbeddingIndex::top_k(const types::Embedding& query, std::size_t k) const {
+    const auto sims = similarities(query);
+    if (sims.empty() || k == 0) return {};
+
+    std::vector<std::size_t> order(sims.size());
+    std::iota(order.begin(), order.end(), 0);
+    k = std::min(k, order.size());
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(),
+                      [&](std::size_t a, std::size_t b) { return sims[a] > sims[b]; });
+
+    std::vector<Match> matches;
+    matches.reserve(k);
+    for (std::size_t i = 0; i < k; ++i) matches.push_back({order[i], sims[order[i]]});
+    return matches;
+}
+
+std::optional<Match> EmbeddingIndex::best_match(const types::Embedding& query) const {
+    const auto sims = similarities(query);
+    if (sims.empty()) return std::nullopt;
+
+    const auto it = std::max_element(sims.begin(), sims.end());
+    return Match{static_cast<std::size_t>(it - sims.begin()), *it};
+}
+
+} // namespace domain::face::embedding_index
@@ -0,0 +1,118 @@
+/**
+ * @file embedding_index.ixx
+ * @brief Contiguous similarity index over reference face embeddings
+ * @author CodingRookie
+ * @date 2026-10-18
+ */
+module;
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <vector>
+
+export module domain.face.embedding_index;
+
+import domain.face;
+
+namespace domain::face::embedding_index {
+
+/**
+ * @brief Allocator returning cache-line aligned storage so every index row starts on a SIMD
+ *        register boundary
+ */
+template <typename T> struct AlignedAllocator {
+    using value_type = T;
+    static constexpr std::align_val_t kAlignment{64};
+
+    AlignedAllocator() noexcept = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), kAlignment));
+    }
+    void deallocate(T* p, std::size_t) noexcept { ::operator delete(p, kAlignment); }
+
+    template <typename U> bool operator==(const AlignedAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+} // namespace domain::face::embedding_index
+
+export namespace domain::face::embedding_index {
+
+/**
+ * @brief Storage precision of the index matrix
+ */
+enum class Precision : std::uint8_t {
+    Float32, ///< Exact cosine similarity
+    Int8     ///< Symmetric per-row int8 quantisation (4x smaller, ~1e-2 similarity error)
+};
+
+/**
+ * @brief One similarity search result
+ */
+struct Match {
+    std::size_t index = 0;   ///< Row of the matching reference (insertion order)
+    float similarity = 0.0F; ///< Cosine similarity in [-1, 1]
+};
+
+/**
+ * @brief Reference embedding gallery for batched cosine similarity search
+ * @details Rows are L2-normalised on insertion and stored in one contiguous, 64-byte aligned
+ *          matrix (rows zero-padded to the alignment). A query costs one matrix-vector product
+ *          evaluated with OpenCV universal intrinsics, instead of a per-pair loop over separate
+ *          vectors. Build once per reference set and reuse it for every frame.
+ */
+class EmbeddingIndex {
+public:
+    explicit EmbeddingIndex(Precision precision = Precision::Float32);
+
+    /**
+     * @brief Build an index from the normed embeddings of @p faces
+     * @note Faces without an embedding are skipped, so row indices may differ from face indices
+     */
+    [[nodiscard]] static EmbeddingIndex from_faces(const std::vector<Face>& faces,
+                                                   Precision precision = Precision::Float32);
+
+    /**
+     * @brief Append a reference embedding
+     * @return false if it is empty, has zero norm or its dimension differs from earlier rows
+     */
+    bool add(const types::Embedding& embedding);
+
+    void clear();
+
+    [[nodiscard]] std::size_t size() const { return m_rows; }
+    [[nodiscard]] bool empty() const { return m_rows == 0; }
+    [[nodiscard]] std::size_t dim() const { return m_dim; }
+    [[nodiscard]] Precision precision() const { return m_precision; }
+
+    /**
+     * @brief Cosine similarity of @p query against every row
+     * @return One value per row, or an empty vector if the query does not fit the index
+     */
+    [[nodiscard]] std::vector<float> similarities(const types::Embedding& query) const;
+
+    /**
+     * @brief The @p k most similar rows, best first
+     */
+    [[nodiscard]] std::vector<Match> top_k(const types::Embedding& query, std::size_t k) const;
+
+    /**
+     * @brief The most similar row, if any
+     */
+    [[nodiscard]] std::optional<Match> best_match(const types::Embedding& query) const;
+
+private:
+    Precision m_precision;
+    std::size_t m_dim = 0;
+    std::size_t m_stride = 0; ///< Padded row length in elements
+    std::size_t m_rows = 0;
+    std::vector<float, AlignedAllocator<float>> m_float_rows;
+    std::vector<std::int8_t, AlignedAllocator<std::int8_t>> m_int8_rows;
+    std::vector<float> m_scales; ///< Per-row dequantisation scale (Int8 only)
+};
+
+} // namespace domain::face::embedding_index
@@ -6,6 +6,7 @@ export module domain.face.enhancer;
 export import :api;
 export import :types;
 export import :factory;
+export import :temporal_reuse;
 
 export namespace domain::face::enhancer {
 using EnhancerType = FaceEnhancerFactory::Type;
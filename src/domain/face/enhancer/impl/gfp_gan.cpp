@@ -8,6 +8,7 @@ module;
 
 module domain.face.enhancer;
 import :gfp_gan;
+import foundation.ai.tensor_postprocess;
 
 namespace domain::face::enhancer {
 
@@ -70,29 +71,10 @@ cv::Mat GfpGan::process_output(const std::vector<Ort::Value>& output_tensors) co
     const int output_height = static_cast<int>(outs_shape[2]);
     const int output_width = static_cast<int>(outs_shape[3]);
 
-    const long long channel_step = output_height * output_width;
-    std::vector<cv::Mat> channel_mats(3);
-    channel_mats[2] =
-        cv::Mat(output_height, output_width, CV_32FC1, const_cast<float*>(pdata)).clone(); // R
-    channel_mats[1] =
-        cv::Mat(output_height, output_width, CV_32FC1, const_cast<float*>(pdata + channel_step))
-            .clone(); // G
-    channel_mats[0] =
-        cv::Mat(output_height, output_width, CV_32FC1, const_cast<float*>(pdata + 2 * channel_step))
-            .clone(); // B
-
-    for (auto& mat : channel_mats) {
-        cv::max(mat, -1.0f, mat);
-        cv::min(mat, 1.0f, mat);
-        mat = (mat + 1.0f) * 127.5f;
-        cv::max(mat, 0.0f, mat);
-        cv::min(mat, 255.0f, mat);
-    }
-
-    cv::Mat result_mat;
-    cv::merge(channel_mats, result_mat);
-    result_mat.convertTo(result_mat, CV_8UC3);
-    return result_mat;
+    // RGB planes in [-1, 1]
+    namespace tp = foundation::ai::tensor_postprocess;
+    return tp::planar_to_bgr(pdata, cv::Size(output_width, output_height),
+                             {.range = tp::ValueRange::MinusOneToOne});
 }
 
 cv::Mat GfpGan::apply_enhance(const cv::Mat& cropped_frame) const {
@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file           : temporal_reuse.cpp
+ * @brief          : Temporal reuse of enhanced face crops
+ ******************************************************************************
+ */
+
+module;
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+module domain.face.enhancer;
+import :temporal_reuse;
+import domain.face.helper;
+
+namespace domain::face::enhancer {
+
+namespace {
+
+const cv::Size kThumbnailSize{32, 32};
+
+cv::Mat make_thumbnail(const cv::Mat& crop) {
+    cv::Mat gray;
+    if (crop.channels() == 3) {
+        cv::cvtColor(crop, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = crop;
+    }
+    cv::Mat thumbnail;
+    cv::resize(gray, thumbnail, kThumbnailSize, 0, 0, cv::INTER_AREA);
+    return thumbnail;
+}
+
+double mean_abs_difference(const cv::Mat& a, const cv::Mat& b) {
+    return cv::norm(a, b, cv::NORM_L1) / static_cast<double>(a.total());
+}
+
+} // namespace
+
+cv::Mat TemporalCropCache::get_or_enhance(const cv::Mat& crop, const types::Landmarks& landmarks,
+                                          std::int64_t frame_index,
+                                          const std::function<cv::Mat(const cv::Mat&)>& enhance) {
+    if (crop.empty()) return {};
+    const cv::Mat thumbnail = make_thumbnail(crop);
+    const float radius = helper::track_radius(landmarks);
+
+    {
+        const std::scoped_lock kLock(m_mutex);
+        const auto track = helper::match_track(m_entries, landmarks, radius, &Entry::landmarks);
+        if (track != m_entries.end() && !track->enhanced.empty()
+            && std::abs(frame_index - track->frame_index) < m_options.refresh_interval
+            && mean_abs_difference(thumbnail, track->thumbnail) <= m_options.max_difference) {
+            track->last_used = ++m_tick;
+            ++m_stats.reused;
+            if (m_stats.enhanced > 0) {
+                m_stats.saved_ms += m_inference_ms / static_cast<double>(m_stats.enhanced);
+            }
+            return track->enhanced;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    cv::Mat enhanced = enhance(crop);
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (enhanced.empty()) return enhanced;
+
+    const std::scoped_lock kLock(m_mutex);
+    ++m_stats.enhanced;
+    m_inference_ms += elapsed.count();
+
+    // Same track: refresh its entry; otherwise evict the least recently used
+    auto it = helper::match_track(m_entries, landmarks, radius, &Entry::landmarks);
+    if (it == m_entries.end()) {
+        if (m_entries.size() < m_capacity) {
+            m_entries.emplace_back();
+            it = std::prev(m_entries.end());
+        } else if (!m_entries.empty()) {
+            it = std::ranges::min_element(m_entries, {}, &Entry::last_used);
+        } else {
+            return enhanced;
+        }
+    }
+    *it = {landmarks, thumbnail, enhanced, frame_index, ++m_tick};
+    return enhanced;
+}
+
+TemporalReuseStats TemporalCropCache::stats() const {
+    const std::scoped_lock kLock(m_mutex);
+    return m_stats;
+}
+
+void TemporalCropCache::clear() {
+    const std::scoped_lock kLock(m_mutex);
+    m_entries.clear();
+    m_stats = {};
+    m_inference_ms = 0.0;
+}
+
+} // namespace domain::face::enhancer
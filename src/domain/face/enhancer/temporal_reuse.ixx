@@ -0,0 +1,80 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <opencv2/core.hpp>
+
+export module domain.face.enhancer:temporal_reuse;
+export import domain.face;
+
+export namespace domain::face::enhancer {
+
+/**
+ * @brief When an enhanced crop may be reused for a later frame
+ */
+struct TemporalReuseOptions {
+    double max_difference = 2.0;         ///< Mean abs. difference (0-255) of 32x32 gray thumbnails
+    std::uint32_t refresh_interval = 30; ///< Re-enhance a track at least every N frames
+};
+
+/**
+ * @brief Reuse counters since construction (or the last clear())
+ */
+struct TemporalReuseStats {
+    std::uint64_t reused = 0;   ///< Crops served from a previous enhancement
+    std::uint64_t enhanced = 0; ///< Crops that ran the model
+    double saved_ms = 0.0;      ///< Estimated model time saved: reuses x mean inference time
+
+    [[nodiscard]] double reuse_rate() const {
+        const std::uint64_t total = reused + enhanced;
+        return total == 0 ? 0.0 : static_cast<double>(reused) / static_cast<double>(total);
+    }
+};
+
+/**
+ * @brief Per-track cache of enhanced face crops for near-static faces
+ * @details A track is the nearest cached face by landmarks. Its entry keeps the crop that last
+ *          went through the model (as a downscaled grayscale thumbnail) and the model output.
+ *          A new crop reuses that output while its thumbnail stays within
+ *          TemporalReuseOptions::max_difference of the stored one and fewer than
+ *          refresh_interval frames have passed. Comparing against the crop that was enhanced,
+ *          not the previous frame, keeps slow drift from accumulating. Thread-safe; frames may
+ *          arrive out of order.
+ */
+class TemporalCropCache {
+public:
+    explicit TemporalCropCache(TemporalReuseOptions options = {}, std::size_t capacity = 16) :
+        m_options(options), m_capacity(capacity) {}
+
+    /**
+     * @brief Return the reusable enhanced crop for @p crop, or run @p enhance and cache its result
+     * @param frame_index Position of the frame in the stream (FrameData::sequence_id)
+     */
+    [[nodiscard]] cv::Mat get_or_enhance(const cv::Mat& crop, const types::Landmarks& landmarks,
+                                         std::int64_t frame_index,
+                                         const std::function<cv::Mat(const cv::Mat&)>& enhance);
+
+    [[nodiscard]] TemporalReuseStats stats() const;
+    void clear();
+
+private:
+    struct Entry {
+        types::Landmarks landmarks;
+        cv::Mat thumbnail;
+        cv::Mat enhanced;
+        std::int64_t frame_index = 0;
+        std::uint64_t last_used = 0;
+    };
+
+    TemporalReuseOptions m_options;
+    std::size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::vector<Entry> m_entries;
+    std::uint64_t m_tick = 0;
+    double m_inference_ms = 0.0; ///< Total model time, for the mean used by saved_ms
+    TemporalReuseStats m_stats;
+};
+
+} // namespace domain::face::enhancer
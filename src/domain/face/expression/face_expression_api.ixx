@@ -1,10 +1,13 @@
 module;
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <opencv2/core.hpp>
 
 export module domain.face.expression:api;
 
 import :types;
+import domain.face;
 import foundation.ai.inference_session;
 
 export namespace domain::face::expression {
@@ -35,6 +38,28 @@ public:
     virtual cv::Mat restore_expression(cv::Mat source_crop, cv::Mat target_crop,
                                        float restore_factor) = 0;
 
+    /**
+     * @brief Restore expression for a face that belongs to a track across video frames
+     * @details Implementations may reuse per-track state (e.g. appearance features) between
+     *          frames; the default ignores the track and restores the crop on its own.
+     * @param target_landmarks Target face landmarks in frame coordinates, used to find the track
+     * @param frame_index Index of the frame in the video (frames may arrive out of order)
+     */
+    virtual cv::Mat restore_expression(cv::Mat source_crop, cv::Mat target_crop,
+                                       float restore_factor,
+                                       const types::Landmarks& target_landmarks,
+                                       std::int64_t frame_index) {
+        (void)target_landmarks;
+        (void)frame_index;
+        return restore_expression(std::move(source_crop), std::move(target_crop),
+                                  restore_factor);
+    }
+
+    /**
+     * @brief Cache counters accumulated so far (all zero when the restorer does not cache)
+     */
+    [[nodiscard]] virtual ExpressionCacheStats cache_stats() const { return {}; }
+
     /**
      * @brief Get the expected input size for the model
      * @return cv::Size
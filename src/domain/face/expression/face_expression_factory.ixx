@@ -4,6 +4,7 @@ module;
 export module domain.face.expression:factory;
 
 import :api;
+import :types;
 import :live_portrait;
 import foundation.ai.inference_session;
 
@@ -11,9 +12,11 @@ export namespace domain::face::expression {
 
 /**
  * @brief Factory to create a LivePortrait expression restorer
+ * @param cache_options Per-track feature cache used by track-keyed restores
  */
-[[nodiscard]] std::unique_ptr<IFaceExpressionRestorer> create_live_portrait_restorer() {
-    return std::make_unique<LivePortrait>();
+[[nodiscard]] std::unique_ptr<IFaceExpressionRestorer> create_live_portrait_restorer(
+    const TrackCacheOptions& cache_options = {}) {
+    return std::make_unique<LivePortrait>(cache_options);
 }
 
 } // namespace domain::face::expression
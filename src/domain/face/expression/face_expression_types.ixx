@@ -2,6 +2,8 @@ module;
 #include <opencv2/core.hpp>
 #include <vector>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_set>
 
 export module domain.face.expression:types;
@@ -26,4 +28,31 @@ struct RestoreExpressionInput {
     std::array<int, 4> box_mask_padding{0, 0, 0, 0};
 };
 
+/**
+ * @brief When a face track may reuse its cached appearance features
+ * @details Between keyframes only the motion extractor runs on the target crop; features are
+ *          extracted again once the interval has elapsed or the head pose drifts too far.
+ */
+struct TrackCacheOptions {
+    std::uint32_t refresh_interval{15}; ///< Max frames between extractions (0 disables the cache)
+    float max_pose_change{5.0F};        ///< Max pitch / yaw / roll change (degrees)
+    float max_scale_change{0.05F};      ///< Max relative scale change
+    std::size_t capacity{8};            ///< Tracks kept (about 8 MB of features each)
+};
+
+/**
+ * @brief Cache counters of an expression restorer
+ */
+struct ExpressionCacheStats {
+    std::uint64_t feature_hits{0};         ///< Faces restored with cached appearance features
+    std::uint64_t feature_misses{0};       ///< Faces that ran the feature extractor
+    std::uint64_t source_motion_hits{0};   ///< Source crops whose motion was cached
+    std::uint64_t source_motion_misses{0}; ///< Source crops that ran the motion extractor
+
+    [[nodiscard]] double hit_rate() const {
+        const std::uint64_t total = feature_hits + feature_misses;
+        return total == 0 ? 0.0 : static_cast<double>(feature_hits) / static_cast<double>(total);
+    }
+};
+
 } // namespace domain::face::expression
@@ -1,16 +1,23 @@
 module;
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <format>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <opencv2/opencv.hpp>
 #include <onnxruntime_cxx_api.h>
+#include <xxhash.h>
 
 module domain.face.expression;
 
 import :live_portrait;
+import domain.face.helper;
 import foundation.infrastructure.thread_pool;
 import foundation.ai.inference_session_registry;
+import foundation.ai.tensor_postprocess;
 
 namespace domain::face::expression {
 
@@ -18,6 +25,24 @@ using namespace foundation::ai;
 using namespace foundation::infrastructure::thread_pool;
 using namespace foundation::ai::inference_session;
 
+namespace {
+
+std::uint64_t crop_hash(const cv::Mat& crop) {
+    if (crop.isContinuous()) { return XXH3_64bits(crop.data, crop.total() * crop.elemSize()); }
+    std::uint64_t hash = 0;
+    const size_t row_bytes = static_cast<size_t>(crop.cols) * crop.elemSize();
+    for (int r = 0; r < crop.rows; ++r) {
+        hash = XXH3_64bits_withSeed(crop.ptr<uchar>(r), row_bytes, hash);
+    }
+    return hash;
+}
+
+std::array<float, 4> pose_of(const std::vector<std::vector<float>>& motion) {
+    return {motion[0][0], motion[1][0], motion[2][0], motion[3][0]};
+}
+
+} // namespace
+
 // FeatureExtractor Implementation
 void LivePortrait::FeatureExtractor::load_model(const std::string& path,
                                                 const inference_session::Options& options) {
@@ -161,9 +186,9 @@ cv::Size LivePortrait::Generator::get_output_size() const {
 
 std::tuple<std::vector<float>, std::vector<int64_t>, std::vector<float>, std::vector<int64_t>,
            std::vector<float>, std::vector<int64_t>>
-LivePortrait::Generator::prepare_input(std::vector<float>& feature_volume,
-                                       std::vector<float>& source_motion_points,
-                                       std::vector<float>& target_motion_points) const {
+LivePortrait::Generator::prepare_input(const std::vector<float>& feature_volume,
+                                       const std::vector<float>& source_motion_points,
+                                       const std::vector<float>& target_motion_points) const {
     const std::vector<int64_t> input_feature_shape{1, 32, 16, 64, 64};
     const std::vector<int64_t> input_motion_shape{1, 21, 3};
     // Note: inputs are passed by reference, but we need to return copies/moves if we follow the
@@ -184,34 +209,14 @@ cv::Mat LivePortrait::Generator::process_output(
     const int output_height = static_cast<int>(outs_shape[2]);
     const int output_width = static_cast<int>(outs_shape[3]);
 
-    const int channel_step = output_height * output_width;
-    std::vector<cv::Mat> channel_mats(3);
-    // Create matrices for each channel and scale/clamp values
-    channel_mats[2] =
-        cv::Mat(output_height, output_width, CV_32FC1, const_cast<float*>(output_data))
-            .clone(); // R
-    channel_mats[1] = cv::Mat(output_height, output_width, CV_32FC1,
-                              const_cast<float*>(output_data) + channel_step)
-                          .clone(); // G
-    channel_mats[0] = cv::Mat(output_height, output_width, CV_32FC1,
-                              const_cast<float*>(output_data) + 2 * channel_step)
-                          .clone(); // B
-
-    for (auto& mat : channel_mats) {
-        mat *= 255.f;
-        // Efficient clamping
-        cv::threshold(mat, mat, 0, 0, cv::THRESH_TOZERO);
-        cv::threshold(mat, mat, 255, 255, cv::THRESH_TRUNC);
-    }
-
-    cv::Mat result_mat;
-    cv::merge(channel_mats, result_mat);
-    return result_mat;
+    // RGB planes in [0, 1] -> saturated BGR u8, ready for paste-back
+    return foundation::ai::tensor_postprocess::planar_to_bgr(output_data,
+                                                             cv::Size(output_width, output_height));
 }
 
-cv::Mat LivePortrait::Generator::generate_frame(std::vector<float>& feature_volume,
-                                                std::vector<float>& source_motion_points,
-                                                std::vector<float>& target_motion_points) const {
+cv::Mat LivePortrait::Generator::generate_frame(
+    const std::vector<float>& feature_volume, const std::vector<float>& source_motion_points,
+    const std::vector<float>& target_motion_points) const {
     if (!is_model_loaded()) { throw std::runtime_error("Generator model is not loaded"); }
 
     auto [input_feature, feature_shape, input_source, source_shape, input_target, target_shape] =
@@ -289,6 +294,38 @@ cv::Mat LivePortrait::restore_expression(cv::Mat source_crop, cv::Mat target_cro
     return apply_restore(source_crop, target_crop, restore_factor);
 }
 
+cv::Mat LivePortrait::restore_expression(cv::Mat source_crop, cv::Mat target_crop,
+                                         float restore_factor,
+                                         const types::Landmarks& target_landmarks,
+                                         std::int64_t frame_index) {
+    if (m_cache_options.refresh_interval == 0 || m_cache_options.capacity == 0
+        || target_landmarks.empty()) {
+        return restore_expression(std::move(source_crop), std::move(target_crop), restore_factor);
+    }
+    if (source_crop.empty() || target_crop.empty()) return {};
+
+    if (!m_feature_extractor.is_model_loaded() || !m_motion_extractor.is_model_loaded()
+        || !m_generator.is_model_loaded()) {
+        throw std::runtime_error("LivePortrait models are not loaded!");
+    }
+
+    const cv::Size required_size = get_model_input_size();
+    if (source_crop.size() != required_size) {
+        cv::resize(source_crop, source_crop, required_size);
+    }
+    if (target_crop.size() != required_size) {
+        cv::resize(target_crop, target_crop, required_size);
+    }
+
+    return apply_restore_tracked(source_crop, target_crop, restore_factor, target_landmarks,
+                                 frame_index);
+}
+
+ExpressionCacheStats LivePortrait::cache_stats() const {
+    const std::scoped_lock kLock(m_cache_mutex);
+    return m_cache_stats;
+}
+
 cv::Mat LivePortrait::apply_restore(const cv::Mat& cropped_source_frame,
                                     const cv::Mat& cropped_target_frame,
                                     float restore_factor) const {
@@ -304,51 +341,167 @@ cv::Mat LivePortrait::apply_restore(const cv::Mat& cropped_source_frame,
     auto feature_volume = feature_volume_fu.get();
     auto source_motion = source_motion_fu.get();
 
-    cv::Mat rotation_mat =
-        create_rotation_mat(target_motion[0][0], target_motion[1][0], target_motion[2][0]);
+    // Both keypoint sets use the target pose: "source" drives with the restored expression,
+    // "target" describes the crop the features come from
+    const cv::Mat source_expression_mat =
+        blend_expression(source_motion, target_motion, restore_factor);
+    const cv::Mat target_expression_mat(21, 3, CV_32FC1, target_motion[5].data());
 
-    std::vector<float> source_expression = source_motion[5]; // Copy
-    std::vector<float> target_expression = target_motion[5]; // Ref would be bad if we modify
+    const auto source_motion_vec = motion_points(target_motion, source_expression_mat);
+    const auto target_motion_vec = motion_points(target_motion, target_expression_mat);
 
-    // Swap expressions at specific indices
-    for (auto index : {0, 4, 5, 8, 9}) { source_expression[index] = target_expression[index]; }
+    return m_generator.generate_frame(feature_volume, source_motion_vec, target_motion_vec);
+}
 
-    cv::Mat source_expression_mat(21, 3, CV_32FC1, source_expression.data());
-    cv::Mat target_expression_mat(21, 3, CV_32FC1, target_expression.data());
+cv::Mat LivePortrait::apply_restore_tracked(const cv::Mat& cropped_source_frame,
+                                            const cv::Mat& cropped_target_frame,
+                                            float restore_factor,
+                                            const types::Landmarks& target_landmarks,
+                                            std::int64_t frame_index) {
+    const std::uint64_t source_hash = crop_hash(cropped_source_frame);
+    const float radius = helper::track_radius(target_landmarks);
+
+    // Snapshot of the track, if any: entries may be replaced while the models run
+    std::shared_ptr<const std::vector<float>> features;
+    std::vector<float> keyframe_points;
+    std::array<float, 4> keyframe_pose{};
+    std::int64_t keyframe_index = frame_index;
+    Motion source_motion;
+    {
+        const std::scoped_lock kLock(m_cache_mutex);
+        const auto track =
+            helper::match_track(m_tracks, target_landmarks, radius, &TrackEntry::landmarks);
+        if (track != m_tracks.end()) {
+            if (std::llabs(frame_index - track->keyframe_index)
+                < static_cast<std::int64_t>(m_cache_options.refresh_interval)) {
+                features = track->features;
+                keyframe_points = track->keyframe_points;
+                keyframe_pose = track->keyframe_pose;
+                keyframe_index = track->keyframe_index;
+            }
+            if (track->source_hash == source_hash) { source_motion = track->source_motion; }
+        }
+    }
+    const bool source_cached = !source_motion.empty();
 
-    source_expression_mat =
-        source_expression_mat * restore_factor + target_expression_mat * (1.0f - restore_factor);
-    source_expression_mat = limit_expression(source_expression_mat);
+    auto& pool = ThreadPool::instance();
+    std::future<std::vector<float>> feature_fu;
+    if (!features) {
+        feature_fu =
+            pool.enqueue([&] { return m_feature_extractor.extract_feature(cropped_target_frame); });
+    }
+    std::future<Motion> source_motion_fu;
+    if (!source_cached) {
+        source_motion_fu =
+            pool.enqueue([&] { return m_motion_extractor.extract_motion(cropped_source_frame); });
+    }
 
-    cv::Mat target_translation_mat(21, 3, CV_32FC1);
-    for (int i = 0; i < 21; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            target_translation_mat.at<float>(i, j) = target_motion[4][j];
+    // Pending tasks refer to the crops: never leave while they run
+    Motion target_motion;
+    try {
+        target_motion = m_motion_extractor.extract_motion(cropped_target_frame);
+        if (source_motion_fu.valid()) source_motion = source_motion_fu.get();
+    } catch (...) {
+        if (feature_fu.valid()) feature_fu.wait();
+        if (source_motion_fu.valid()) source_motion_fu.wait();
+        throw;
+    }
+
+    // The cached features only hold while the head stays close to the keyframe pose
+    const std::array<float, 4> pose = pose_of(target_motion);
+    if (features) {
+        const bool pose_drifted =
+            std::abs(pose[0] - keyframe_pose[0]) > m_cache_options.max_pose_change
+            || std::abs(pose[1] - keyframe_pose[1]) > m_cache_options.max_pose_change
+            || std::abs(pose[2] - keyframe_pose[2]) > m_cache_options.max_pose_change
+            || std::abs(pose[3] - keyframe_pose[3])
+                   > m_cache_options.max_scale_change * std::abs(keyframe_pose[3]);
+        if (pose_drifted) {
+            features.reset();
+            keyframe_index = frame_index;
+            feature_fu = pool.enqueue(
+                [&] { return m_feature_extractor.extract_feature(cropped_target_frame); });
         }
     }
-    float target_scale = target_motion[3][0];
 
-    cv::Mat target_motion_points_mat(21, 3, CV_32FC1, target_motion[6].data());
+    const cv::Mat source_expression_mat =
+        blend_expression(source_motion, target_motion, restore_factor);
+    const auto source_motion_vec = motion_points(target_motion, source_expression_mat);
 
-    // Transpose rotation mat
-    cv::Mat rot_t = rotation_mat.t();
+    const bool hit = static_cast<bool>(features);
+    if (!hit) {
+        features = std::make_shared<const std::vector<float>>(feature_fu.get());
+        const cv::Mat target_expression_mat(21, 3, CV_32FC1, target_motion[5].data());
+        keyframe_points = motion_points(target_motion, target_expression_mat);
+    }
 
-    // Source motion calculation
-    cv::Mat source_motion_points =
-        target_scale * (target_motion_points_mat * rot_t + source_expression_mat)
-        + target_translation_mat;
+    {
+        const std::scoped_lock kLock(m_cache_mutex);
+        if (hit) {
+            ++m_cache_stats.feature_hits;
+        } else {
+            ++m_cache_stats.feature_misses;
+        }
+        if (source_cached) {
+            ++m_cache_stats.source_motion_hits;
+        } else {
+            ++m_cache_stats.source_motion_misses;
+        }
 
-    // Target motion calculation (re-using target expression)
-    cv::Mat target_motion_points_res =
-        target_scale * (target_motion_points_mat * rot_t + target_expression_mat)
-        + target_translation_mat;
+        // Same track: update it in place; otherwise take a free slot or the least recently used
+        auto it = helper::match_track(m_tracks, target_landmarks, radius, &TrackEntry::landmarks);
+        if (it == m_tracks.end()) {
+            if (m_tracks.size() < m_cache_options.capacity) {
+                it = m_tracks.emplace(m_tracks.end());
+            } else {
+                it = std::ranges::min_element(m_tracks, {}, &TrackEntry::last_used);
+            }
+            *it = {};
+        }
+        it->landmarks = target_landmarks;
+        it->keyframe_index = keyframe_index;
+        it->keyframe_pose = hit ? keyframe_pose : pose;
+        it->features = features;
+        it->keyframe_points = keyframe_points;
+        it->source_hash = source_hash;
+        it->source_motion = source_motion;
+        it->last_used = ++m_tick;
+    }
 
-    std::vector<float> source_motion_vec(source_motion_points.begin<float>(),
-                                         source_motion_points.end<float>());
-    std::vector<float> target_motion_vec(target_motion_points_res.begin<float>(),
-                                         target_motion_points_res.end<float>());
+    return m_generator.generate_frame(*features, source_motion_vec, keyframe_points);
+}
 
-    return m_generator.generate_frame(feature_volume, source_motion_vec, target_motion_vec);
+cv::Mat LivePortrait::blend_expression(const Motion& source_motion, const Motion& target_motion,
+                                       float restore_factor) {
+    std::vector<float> source_expression = source_motion[5]; // Copy
+    const std::vector<float>& target_expression = target_motion[5];
+
+    // Swap expressions at specific indices
+    for (auto index : {0, 4, 5, 8, 9}) { source_expression[index] = target_expression[index]; }
+
+    const cv::Mat source_expression_mat(21, 3, CV_32FC1, source_expression.data());
+    const cv::Mat target_expression_mat(21, 3, CV_32FC1,
+                                        const_cast<float*>(target_expression.data()));
+
+    const cv::Mat blended =
+        source_expression_mat * restore_factor + target_expression_mat * (1.0f - restore_factor);
+    return limit_expression(blended);
+}
+
+std::vector<float> LivePortrait::motion_points(const Motion& pose_motion,
+                                               const cv::Mat& expression) {
+    const cv::Mat rotation_mat =
+        create_rotation_mat(pose_motion[0][0], pose_motion[1][0], pose_motion[2][0]);
+
+    cv::Mat translation_mat(21, 3, CV_32FC1);
+    for (int i = 0; i < 21; ++i) {
+        for (int j = 0; j < 3; ++j) { translation_mat.at<float>(i, j) = pose_motion[4][j]; }
+    }
+    const float scale = pose_motion[3][0];
+    const cv::Mat points_mat(21, 3, CV_32FC1, const_cast<float*>(pose_motion[6].data()));
+
+    const cv::Mat points = scale * (points_mat * rotation_mat.t() + expression) + translation_mat;
+    return {points.begin<float>(), points.end<float>()};
 }
 
 std::vector<float> LivePortrait::get_input_image_data(const cv::Mat& image, const cv::Size& size) {
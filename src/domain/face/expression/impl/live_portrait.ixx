@@ -1,7 +1,10 @@
 module;
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <opencv2/core.hpp>
 #include <onnxruntime_cxx_api.h>
@@ -10,6 +13,7 @@ export module domain.face.expression:live_portrait;
 
 import :api;
 import :types;
+import domain.face;
 import domain.face.helper;
 import domain.face.masker;
 import foundation.ai.inference_session;
@@ -17,9 +21,17 @@ import foundation.ai.inference_session_registry;
 
 export namespace domain::face::expression {
 
+/**
+ * @brief LivePortrait expression restorer
+ * @details The appearance features of a face are extracted from its target crop. Faces restored
+ *          with a track key keep those features, with the keypoints they were extracted at, in a
+ *          per-track cache; later frames of the track only run the motion extractor until the
+ *          refresh interval elapses or the head pose drifts. The motion of an unchanged source
+ *          crop (static source image) is cached as well.
+ */
 class LivePortrait final : public IFaceExpressionRestorer {
 public:
-    LivePortrait() = default;
+    explicit LivePortrait(TrackCacheOptions cache_options = {}) : m_cache_options(cache_options) {}
     ~LivePortrait() override = default;
 
     void load_model(const std::string& feature_extractor_path,
@@ -29,6 +41,12 @@ public:
     cv::Mat restore_expression(cv::Mat source_crop, cv::Mat target_crop,
                                float restore_factor) override;
 
+    cv::Mat restore_expression(cv::Mat source_crop, cv::Mat target_crop, float restore_factor,
+                               const types::Landmarks& target_landmarks,
+                               std::int64_t frame_index) override;
+
+    [[nodiscard]] ExpressionCacheStats cache_stats() const override;
+
     [[nodiscard]] cv::Size get_model_input_size() const override;
 
 private:
@@ -70,21 +88,38 @@ private:
         void load_model(const std::string& path,
                         const foundation::ai::inference_session::Options& options);
         [[nodiscard]] bool is_model_loaded() const;
-        [[nodiscard]] cv::Mat generate_frame(std::vector<float>& feature_volume,
-                                             std::vector<float>& source_motion_points,
-                                             std::vector<float>& target_motion_points) const;
+        [[nodiscard]] cv::Mat generate_frame(const std::vector<float>& feature_volume,
+                                             const std::vector<float>& source_motion_points,
+                                             const std::vector<float>& target_motion_points) const;
         [[nodiscard]] cv::Size get_output_size() const;
 
         [[nodiscard]] std::tuple<std::vector<float>, std::vector<int64_t>, std::vector<float>,
                                  std::vector<int64_t>, std::vector<float>, std::vector<int64_t>>
-        prepare_input(std::vector<float>& feature_volume, std::vector<float>& source_motion_points,
-                      std::vector<float>& target_motion_points) const;
+        prepare_input(const std::vector<float>& feature_volume,
+                      const std::vector<float>& source_motion_points,
+                      const std::vector<float>& target_motion_points) const;
         [[nodiscard]] cv::Mat process_output(const std::vector<Ort::Value>& output_tensors) const;
 
     private:
         std::shared_ptr<foundation::ai::inference_session::InferenceSession> m_session;
     };
 
+    using Motion = std::vector<std::vector<float>>;
+
+    /**
+     * @brief Cached state of one face track
+     */
+    struct TrackEntry {
+        types::Landmarks landmarks;                         ///< Latest landmarks of the track
+        std::int64_t keyframe_index = 0;                    ///< Frame the features come from
+        std::array<float, 4> keyframe_pose{};               ///< Pitch, yaw, roll, scale
+        std::shared_ptr<const std::vector<float>> features; ///< Appearance feature volume
+        std::vector<float> keyframe_points;                 ///< Keypoints of the features
+        std::uint64_t source_hash = 0;                      ///< Hash of the last source crop
+        Motion source_motion;                               ///< Motion of that source crop
+        std::uint64_t last_used = 0;                        ///< LRU tick
+    };
+
 private:
     FeatureExtractor m_feature_extractor;
     MotionExtractor m_motion_extractor;
@@ -92,12 +127,34 @@ private:
 
     cv::Size m_generator_output_size{512, 512};
 
+    TrackCacheOptions m_cache_options;
+    mutable std::mutex m_cache_mutex;
+    std::vector<TrackEntry> m_tracks;
+    std::uint64_t m_tick = 0;
+    ExpressionCacheStats m_cache_stats;
+
     // Helper functions
     [[nodiscard]] static std::vector<float> get_input_image_data(const cv::Mat& image,
                                                                  const cv::Size& size);
     [[nodiscard]] cv::Mat apply_restore(const cv::Mat& cropped_source_frame,
                                         const cv::Mat& cropped_target_frame,
                                         float restore_factor) const;
+    [[nodiscard]] cv::Mat apply_restore_tracked(const cv::Mat& cropped_source_frame,
+                                                const cv::Mat& cropped_target_frame,
+                                                float restore_factor,
+                                                const types::Landmarks& target_landmarks,
+                                                std::int64_t frame_index);
+    /**
+     * @brief Generator keypoints: the pose of @p pose_motion with @p expression
+     */
+    [[nodiscard]] static std::vector<float> motion_points(const Motion& pose_motion,
+                                                          const cv::Mat& expression);
+    /**
+     * @brief Expression of @p source_motion blended into @p target_motion's
+     */
+    [[nodiscard]] static cv::Mat blend_expression(const Motion& source_motion,
+                                                  const Motion& target_motion,
+                                                  float restore_factor);
     [[nodiscard]] static cv::Mat create_rotation_mat(float pitch, float yaw, float roll);
     [[nodiscard]] static cv::Mat limit_expression(const cv::Mat& expression);
 };
@@ -0,0 +1,173 @@
+/**
+ ******************************************************************************
+ * @file           : face_blend.cpp
+ * @brief          : Fused u8 blend kernel for paste-back and face blending
+ ******************************************************************************
+ */
+
+module;
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/imgproc.hpp>
+
+module domain.face.helper;
+
+namespace domain::face::helper {
+
+namespace {
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+/**
+ * @brief Blend one u8 channel of vlanes(v_uint8) pixels: a * o + (1 - a) * f, rounded
+ * @details Same operation order as the float-plane implementation it replaces, so results
+ *          match it up to float rounding.
+ */
+inline cv::v_uint8 blend_channel(const cv::v_uint8& f, const cv::v_uint8& o,
+                                 const cv::v_float32& a0, const cv::v_float32& a1,
+                                 const cv::v_float32& a2, const cv::v_float32& a3) {
+    const cv::v_float32 one = cv::vx_setall_f32(1.0F);
+
+    cv::v_uint16 f_lo, f_hi, o_lo, o_hi;
+    cv::v_expand(f, f_lo, f_hi);
+    cv::v_expand(o, o_lo, o_hi);
+    cv::v_uint32 f0, f1, f2, f3, o0, o1, o2, o3;
+    cv::v_expand(f_lo, f0, f1);
+    cv::v_expand(f_hi, f2, f3);
+    cv::v_expand(o_lo, o0, o1);
+    cv::v_expand(o_hi, o2, o3);
+
+    auto mix = [&](const cv::v_float32& a, const cv::v_uint32& fv, const cv::v_uint32& ov) {
+        const cv::v_float32 ff = cv::v_cvt_f32(cv::v_reinterpret_as_s32(fv));
+        const cv::v_float32 of = cv::v_cvt_f32(cv::v_reinterpret_as_s32(ov));
+        return cv::v_round(cv::v_add(cv::v_mul(a, of), cv::v_mul(cv::v_sub(one, a), ff)));
+    };
+    const cv::v_uint16 lo = cv::v_pack_u(mix(a0, f0, o0), mix(a1, f1, o1));
+    const cv::v_uint16 hi = cv::v_pack_u(mix(a2, f2, o2), mix(a3, f3, o3));
+    return cv::v_pack(lo, hi);
+}
+#endif
+
+/**
+ * @brief Blend one row of @p width pixels in place; the weight is mask * @p scale
+ */
+template <typename Mask>
+void blend_row(uchar* frame, const uchar* overlay, const Mask* mask, int width, float scale) {
+    int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes8 = cv::VTraits<cv::v_uint8>::vlanes();
+    const int lanes32 = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 zero = cv::vx_setzero_f32();
+    const cv::v_float32 one = cv::vx_setall_f32(1.0F);
+    const cv::v_float32 v_scale = cv::vx_setall_f32(scale);
+
+    for (; x + lanes8 <= width; x += lanes8) {
+        cv::v_float32 a0, a1, a2, a3;
+        if constexpr (std::is_same_v<Mask, float>) {
+            auto clamp = [&](const cv::v_float32& v) {
+                return cv::v_mul(cv::v_min(cv::v_max(v, zero), one), v_scale);
+            };
+            a0 = clamp(cv::vx_load(mask + x));
+            a1 = clamp(cv::vx_load(mask + x + lanes32));
+            a2 = clamp(cv::vx_load(mask + x + 2 * lanes32));
+            a3 = clamp(cv::vx_load(mask + x + 3 * lanes32));
+        } else {
+            cv::v_uint16 m_lo, m_hi;
+            cv::v_expand(cv::vx_load(mask + x), m_lo, m_hi);
+            cv::v_uint32 m0, m1, m2, m3;
+            cv::v_expand(m_lo, m0, m1);
+            cv::v_expand(m_hi, m2, m3);
+            a0 = cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(m0)), v_scale);
+            a1 = cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(m1)), v_scale);
+            a2 = cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(m2)), v_scale);
+            a3 = cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(m3)), v_scale);
+        }
+
+        cv::v_uint8 fb, fg, fr, ob, og, orr;
+        cv::v_load_deinterleave(frame + 3 * x, fb, fg, fr);
+        cv::v_load_deinterleave(overlay + 3 * x, ob, og, orr);
+        cv::v_store_interleave(frame + 3 * x, blend_channel(fb, ob, a0, a1, a2, a3),
+                               blend_channel(fg, og, a0, a1, a2, a3),
+                               blend_channel(fr, orr, a0, a1, a2, a3));
+    }
+    cv::vx_cleanup();
+#endif
+    for (; x < width; ++x) {
+        float a = 0.0F;
+        if constexpr (std::is_same_v<Mask, float>) {
+            a = std::clamp(mask[x], 0.0F, 1.0F) * scale;
+        } else {
+            a = static_cast<float>(mask[x]) * scale;
+        }
+        for (int c = 0; c < 3; ++c) {
+            const auto f = static_cast<float>(frame[3 * x + c]);
+            const auto o = static_cast<float>(overlay[3 * x + c]);
+            frame[3 * x + c] = cv::saturate_cast<uchar>(a * o + (1.0F - a) * f);
+        }
+    }
+}
+
+} // namespace
+
+void blend_frame(cv::Mat& frame, const cv::Mat& overlay, const cv::Mat& mask, float blend) {
+    if (frame.type() != CV_8UC3 || overlay.type() != CV_8UC3
+        || (mask.type() != CV_32FC1 && mask.type() != CV_8UC1)) {
+        throw std::invalid_argument("blend_frame: expected CV_8UC3 images and a 1-channel mask");
+    }
+    if (overlay.size() != frame.size() || mask.size() != frame.size()) {
+        throw std::invalid_argument("blend_frame: frame, overlay and mask sizes differ");
+    }
+
+    blend = std::clamp(blend, 0.0F, 1.0F);
+    if (blend <= 0.0F) return;
+
+    const bool u8_mask = mask.type() == CV_8UC1;
+    const float scale = u8_mask ? blend / 255.0F : blend;
+    for (int y = 0; y < frame.rows; ++y) {
+        if (u8_mask) {
+            blend_row(frame.ptr<uchar>(y), overlay.ptr<uchar>(y), mask.ptr<uchar>(y), frame.cols,
+                      scale);
+        } else {
+            blend_row(frame.ptr<uchar>(y), overlay.ptr<uchar>(y), mask.ptr<float>(y), frame.cols,
+                      scale);
+        }
+    }
+}
+
+void paste_back_into(cv::Mat& frame, const cv::Mat& crop_vision_frame, const cv::Mat& crop_mask,
+                     const cv::Mat& affine_matrix, float blend) {
+    cv::Mat inverse_matrix;
+    cv::invertAffineTransform(affine_matrix, inverse_matrix);
+    inverse_matrix.convertTo(inverse_matrix, CV_64F);
+
+    // Only the frame-space footprint of the crop can receive a non-zero mask
+    const auto crop_w = static_cast<float>(crop_vision_frame.cols);
+    const auto crop_h = static_cast<float>(crop_vision_frame.rows);
+    std::vector<cv::Point2f> corners = {{0, 0}, {crop_w, 0}, {0, crop_h}, {crop_w, crop_h}};
+    cv::transform(corners, corners, inverse_matrix);
+    const cv::Rect footprint = cv::boundingRect(corners);
+    const cv::Rect roi = (footprint + cv::Size(4, 4) - cv::Point(2, 2))
+                       & cv::Rect(0, 0, frame.cols, frame.rows);
+    if (roi.empty()) return;
+
+    cv::Mat roi_matrix = inverse_matrix.clone();
+    roi_matrix.at<double>(0, 2) -= roi.x;
+    roi_matrix.at<double>(1, 2) -= roi.y;
+
+    cv::Mat roi_mask;
+    cv::warpAffine(crop_mask, roi_mask, roi_matrix, roi.size());
+    // Models post-processed to float (0-255) still paste back through the u8 kernel
+    cv::Mat crop_u8 = crop_vision_frame;
+    if (crop_u8.type() != CV_8UC3) { crop_vision_frame.convertTo(crop_u8, CV_8U); }
+    cv::Mat roi_crop;
+    cv::warpAffine(crop_u8, roi_crop, roi_matrix, roi.size(), cv::INTER_LINEAR,
+                   cv::BORDER_REPLICATE);
+
+    cv::Mat frame_roi = frame(roi);
+    blend_frame(frame_roi, roi_crop, roi_mask, blend);
+}
+
+} // namespace domain::face::helper
@@ -0,0 +1,155 @@
+/**
+ ******************************************************************************
+ * @file           : face_color.cpp
+ * @brief          : Lab color transfer and per-track statistics cache
+ ******************************************************************************
+ */
+
+module;
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+module domain.face.helper;
+
+import domain.face;
+
+namespace domain::face::helper {
+
+namespace {
+
+/**
+ * @brief Per-channel mean / standard deviation of an 8-bit 3-channel image in one pass
+ */
+ColorStats lab_stats(const cv::Mat& lab) {
+    std::array<std::uint64_t, 3> sum{};
+    std::array<std::uint64_t, 3> sum_sq{};
+    for (int y = 0; y < lab.rows; ++y) {
+        const uchar* px = lab.ptr<uchar>(y);
+        // Row partial sums fit in 32 bits for any realistic crop width
+        std::array<std::uint32_t, 3> row_sum{};
+        std::array<std::uint64_t, 3> row_sq{};
+        for (int x = 0; x < lab.cols; ++x, px += 3) {
+            for (int c = 0; c < 3; ++c) {
+                row_sum[c] += px[c];
+                row_sq[c] += static_cast<std::uint32_t>(px[c]) * px[c];
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            sum[c] += row_sum[c];
+            sum_sq[c] += row_sq[c];
+        }
+    }
+
+    ColorStats stats;
+    const auto n = static_cast<double>(lab.total());
+    if (n == 0.0) return stats;
+    for (int c = 0; c < 3; ++c) {
+        stats.mean[c] = static_cast<double>(sum[c]) / n;
+        const double variance = static_cast<double>(sum_sq[c]) / n - stats.mean[c] * stats.mean[c];
+        stats.stddev[c] = std::sqrt(std::max(variance, 0.0));
+    }
+    return stats;
+}
+
+cv::Mat make_thumbnail(const cv::Mat& crop) {
+    cv::Mat thumbnail;
+    cv::resize(crop, thumbnail, cv::Size(16, 16), 0, 0, cv::INTER_AREA);
+    return thumbnail;
+}
+
+} // namespace
+
+ColorStats compute_color_stats(const cv::Mat& bgr_crop) {
+    if (bgr_crop.empty()) return {};
+    cv::Mat lab;
+    cv::cvtColor(bgr_crop, lab, cv::COLOR_BGR2Lab);
+    return lab_stats(lab);
+}
+
+cv::Mat apply_color_match(const ColorStats& target_stats, const cv::Mat& swapped_crop) {
+    if (swapped_crop.empty()) return {};
+
+    cv::Mat lab;
+    cv::cvtColor(swapped_crop, lab, cv::COLOR_BGR2Lab);
+    const ColorStats swapped_stats = lab_stats(lab);
+
+    // result = (val - mean_s) * (std_t / std_s) + mean_t, clamped to [0, 255] and rounded:
+    // for 8-bit input this is a per-channel table
+    cv::Mat lut(1, 256, CV_8UC3);
+    auto* table = lut.ptr<cv::Vec3b>();
+    for (int c = 0; c < 3; ++c) {
+        const double scale = (swapped_stats.stddev[c] < 1.0e-5)
+                               ? 1.0
+                               : (target_stats.stddev[c] / swapped_stats.stddev[c]);
+        const double offset = target_stats.mean[c] - swapped_stats.mean[c] * scale;
+        for (int v = 0; v < 256; ++v) {
+            table[v][c] = cv::saturate_cast<uchar>(static_cast<float>(v * scale + offset));
+        }
+    }
+    cv::LUT(lab, lut, lab);
+
+    cv::Mat result_bgr;
+    cv::cvtColor(lab, result_bgr, cv::COLOR_Lab2BGR);
+    return result_bgr;
+}
+
+ColorStats ColorStatsCache::get(const cv::Mat& target_crop, const types::Landmarks& landmarks) {
+    if (target_crop.empty()) return {};
+    const cv::Mat thumbnail = make_thumbnail(target_crop);
+    const float radius = track_radius(landmarks);
+    {
+        const std::scoped_lock kLock(m_mutex);
+        const auto track = match_track(m_entries, landmarks, radius, &Entry::landmarks);
+        if (track != m_entries.end()
+            && cv::norm(thumbnail, track->thumbnail, cv::NORM_L1)
+                       / static_cast<double>(thumbnail.total() * thumbnail.channels())
+                   <= m_max_difference) {
+            track->landmarks = landmarks;
+            track->last_used = ++m_tick;
+            ++m_hits;
+            return track->stats;
+        }
+    }
+
+    const ColorStats stats = compute_color_stats(target_crop);
+
+    const std::scoped_lock kLock(m_mutex);
+    ++m_misses;
+    // Same track with a changed face: replace its entry; otherwise evict the least recently used
+    auto it = match_track(m_entries, landmarks, radius, &Entry::landmarks);
+    if (it == m_entries.end()) {
+        if (m_entries.size() < m_capacity) {
+            m_entries.emplace_back();
+            it = std::prev(m_entries.end());
+        } else if (!m_entries.empty()) {
+            it = std::ranges::min_element(m_entries, {}, &Entry::last_used);
+        } else {
+            return stats;
+        }
+    }
+    *it = {landmarks, thumbnail, stats, ++m_tick};
+    return stats;
+}
+
+void ColorStatsCache::clear() {
+    const std::scoped_lock kLock(m_mutex);
+    m_entries.clear();
+}
+
+std::uint64_t ColorStatsCache::hits() const {
+    const std::scoped_lock kLock(m_mutex);
+    return m_hits;
+}
+
+std::uint64_t ColorStatsCache::misses() const {
+    const std::scoped_lock kLock(m_mutex);
+    return m_misses;
+}
+
+} // namespace domain::face::helper
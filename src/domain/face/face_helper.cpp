@@ -164,37 +164,8 @@ types::Landmarks convert_face_landmark_68_to_5(const types::Landmarks& face_land
 
 cv::Mat paste_back(const cv::Mat& temp_vision_frame, const cv::Mat& crop_vision_frame,
                    const cv::Mat& crop_mask, const cv::Mat& affine_matrix) {
-    cv::Mat inverse_matrix;
-    cv::invertAffineTransform(affine_matrix, inverse_matrix);
-    cv::Mat inverse_mask;
-    const cv::Size temp_size(temp_vision_frame.cols, temp_vision_frame.rows);
-    warpAffine(crop_mask, inverse_mask, inverse_matrix, temp_size);
-    inverse_mask.setTo(0, inverse_mask < 0);
-    inverse_mask.setTo(1, inverse_mask > 1);
-    cv::Mat inverse_vision_frame;
-    warpAffine(crop_vision_frame, inverse_vision_frame, inverse_matrix, temp_size, cv::INTER_LINEAR,
-               cv::BORDER_REPLICATE);
-
-    std::vector<cv::Mat> inverse_vision_frame_bgrs(3);
-    split(inverse_vision_frame, inverse_vision_frame_bgrs);
-    std::vector<cv::Mat> temp_vision_frame_bgrs(3);
-    split(temp_vision_frame, temp_vision_frame_bgrs);
-    for (int c = 0; c < 3; c++) {
-        inverse_vision_frame_bgrs[c].convertTo(inverse_vision_frame_bgrs[c], CV_32FC1);
-        temp_vision_frame_bgrs[c].convertTo(temp_vision_frame_bgrs[c], CV_32FC1);
-    }
-    std::vector<cv::Mat> channel_mats(3);
-
-    channel_mats[0] = inverse_mask.mul(inverse_vision_frame_bgrs[0])
-                    + temp_vision_frame_bgrs[0].mul(1 - inverse_mask);
-    channel_mats[1] = inverse_mask.mul(inverse_vision_frame_bgrs[1])
-                    + temp_vision_frame_bgrs[1].mul(1 - inverse_mask);
-    channel_mats[2] = inverse_mask.mul(inverse_vision_frame_bgrs[2])
-                    + temp_vision_frame_bgrs[2].mul(1 - inverse_mask);
-
-    cv::Mat paste_vision_frame;
-    merge(channel_mats, paste_vision_frame);
-    paste_vision_frame.convertTo(paste_vision_frame, CV_8UC3);
+    cv::Mat paste_vision_frame = temp_vision_frame.clone();
+    paste_back_into(paste_vision_frame, crop_vision_frame, crop_mask, affine_matrix);
     return paste_vision_frame;
 }
 
@@ -417,41 +388,21 @@ void rotate_image_90n(const cv::Mat& src, cv::Mat& dst, int angle) {
                    // If angle==0, simplistic assignment shares data.
 }
 
-cv::Mat apply_color_match(const cv::Mat& target_crop, const cv::Mat& swapped_crop) {
-    if (target_crop.empty() || swapped_crop.empty()) return swapped_crop.clone();
-
-    cv::Mat target_lab, swapped_lab;
-    cv::cvtColor(target_crop, target_lab, cv::COLOR_BGR2Lab);
-    cv::cvtColor(swapped_crop, swapped_lab, cv::COLOR_BGR2Lab);
-
-    cv::Scalar mean_target, std_target;
-    cv::meanStdDev(target_lab, mean_target, std_target);
-
-    cv::Scalar mean_swapped, std_swapped;
-    cv::meanStdDev(swapped_lab, mean_swapped, std_swapped);
-
-    std::vector<cv::Mat> channels_swapped;
-    cv::split(swapped_lab, channels_swapped);
-
-    for (int i = 0; i < 3; ++i) {
-        channels_swapped[i].convertTo(channels_swapped[i], CV_32F);
-
-        // result = (val - mean_s) * (std_t / std_s) + mean_t
-        double scale = (std_swapped[i] < 1.0e-5) ? 1.0 : (std_target[i] / std_swapped[i]);
-        channels_swapped[i] = (channels_swapped[i] - mean_swapped[i]) * scale + mean_target[i];
-
-        cv::threshold(channels_swapped[i], channels_swapped[i], 0, 0, cv::THRESH_TOZERO);
-        cv::threshold(channels_swapped[i], channels_swapped[i], 255, 255, cv::THRESH_TRUNC);
-
-        channels_swapped[i].convertTo(channels_swapped[i], CV_8U);
-    }
+float landmark_distance(const types::Landmarks& a, const types::Landmarks& b) {
+    if (a.size() != b.size() || a.empty()) return std::numeric_limits<float>::max();
+    float total = 0.0F;
+    for (size_t i = 0; i < a.size(); ++i) total += static_cast<float>(cv::norm(a[i] - b[i]));
+    return total / static_cast<float>(a.size());
+}
 
-    cv::Mat result_lab;
-    cv::merge(channels_swapped, result_lab);
+float track_radius(const types::Landmarks& landmarks) {
+    if (landmarks.size() < 2) return 4.0F;
+    return std::max(4.0F, 0.25F * static_cast<float>(cv::norm(landmarks[0] - landmarks[1])));
+}
 
-    cv::Mat result_bgr;
-    cv::cvtColor(result_lab, result_bgr, cv::COLOR_Lab2BGR);
-    return result_bgr;
+cv::Mat apply_color_match(const cv::Mat& target_crop, const cv::Mat& swapped_crop) {
+    if (target_crop.empty() || swapped_crop.empty()) return swapped_crop.clone();
+    return apply_color_match(compute_color_stats(target_crop), swapped_crop);
 }
 
 } // namespace domain::face::helper
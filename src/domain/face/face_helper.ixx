@@ -5,7 +5,11 @@
  * @date 2026-01-27
  */
 module;
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ranges>
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <tuple>
@@ -88,6 +92,31 @@ types::Landmarks convert_face_landmark_68_to_5(const types::Landmarks& face_land
 cv::Mat paste_back(const cv::Mat& temp_vision_frame, const cv::Mat& crop_vision_frame,
                    const cv::Mat& crop_mask, const cv::Mat& affine_matrix);
 
+/**
+ * @brief Paste a processed face crop back onto @p frame in place
+ * @details Only the frame-space footprint of the crop is warped and blended (blend_frame()).
+ * @param frame Frame to modify (CV_8UC3)
+ * @param crop_vision_frame Processed face crop (CV_8UC3)
+ * @param crop_mask Alpha mask in crop space (CV_32FC1 0-1, or CV_8UC1 0-255)
+ * @param affine_matrix Matrix used to warp the crop from the frame
+ * @param blend Global blend factor in [0, 1], folded into the mask (e.g. face_blend / 100)
+ */
+void paste_back_into(cv::Mat& frame, const cv::Mat& crop_vision_frame, const cv::Mat& crop_mask,
+                     const cv::Mat& affine_matrix, float blend = 1.0F);
+
+/**
+ * @brief Blend @p overlay into @p frame in place: frame = a * overlay + (1 - a) * frame
+ * @details a = clamp(mask, 0, 1) * blend for a CV_32FC1 mask, mask / 255 * blend for CV_8UC1.
+ *          One pass over the interleaved u8 pixels (OpenCV universal intrinsics with a scalar
+ *          tail), without intermediate float planes.
+ * @param frame CV_8UC3 image (or ROI) modified in place
+ * @param overlay CV_8UC3 image of the same size
+ * @param mask CV_32FC1 or CV_8UC1 mask of the same size
+ * @param blend Global blend factor in [0, 1]
+ * @throws std::invalid_argument on unsupported types or mismatched sizes
+ */
+void blend_frame(cv::Mat& frame, const cv::Mat& overlay, const cv::Mat& mask, float blend = 1.0F);
+
 /**
  * @brief Create static anchor points for anchor-based detectors (e.g. YOLO, SCRFD)
  */
@@ -172,6 +201,39 @@ cv::Rect2f rotate_box_back(const cv::Rect2f& box, int angle, const cv::Size& ori
  */
 void rotate_image_90n(const cv::Mat& src, cv::Mat& dst, int angle);
 
+/**
+ * @brief Mean distance between corresponding landmarks (float max if the sets do not match)
+ */
+float landmark_distance(const types::Landmarks& a, const types::Landmarks& b);
+
+/**
+ * @brief Landmark distance within which a face belongs to the same track: a quarter of the eye
+ *        distance (at least 4 px), so neighbouring faces never share a track
+ */
+float track_radius(const types::Landmarks& landmarks);
+
+/**
+ * @brief Track of @p tracks whose landmarks are closest to @p landmarks, within @p radius
+ * @details Frame-to-frame face tracking of the per-track caches: a face keeps its track while
+ *          its landmarks move less than @p radius (see track_radius()) from the last frame.
+ * @param landmarks_of Projection from a track entry to its last landmarks
+ * @return Iterator to the matching entry, or the end of @p tracks if none is close enough
+ */
+template <std::ranges::forward_range Tracks, typename Projection>
+auto match_track(Tracks& tracks, const types::Landmarks& landmarks, float radius,
+                 Projection landmarks_of) {
+    auto match = std::ranges::end(tracks);
+    float best = radius;
+    for (auto it = std::ranges::begin(tracks); it != std::ranges::end(tracks); ++it) {
+        const float distance = landmark_distance(std::invoke(landmarks_of, *it), landmarks);
+        if (distance <= best) {
+            best = distance;
+            match = it;
+        }
+    }
+    return match;
+}
+
 /**
  * @brief Apply color matching from target crop to swapped crop (Reinhard Color Transfer in LAB
  * space)
@@ -181,4 +243,68 @@ void rotate_image_90n(const cv::Mat& src, cv::Mat& dst, int angle);
  */
 cv::Mat apply_color_match(const cv::Mat& target_crop, const cv::Mat& swapped_crop);
 
+/**
+ * @brief Per-channel Lab statistics of a crop (population mean / standard deviation)
+ */
+struct ColorStats {
+    std::array<double, 3> mean{};   ///< L, a, b means (8-bit Lab scale)
+    std::array<double, 3> stddev{}; ///< L, a, b standard deviations
+};
+
+/**
+ * @brief Lab statistics of a BGR crop, gathered in a single pass after the color conversion
+ */
+ColorStats compute_color_stats(const cv::Mat& bgr_crop);
+
+/**
+ * @brief Reinhard color transfer with precomputed target statistics
+ * @details The per-channel affine remap and [0, 255] clamp are folded into one 3-channel
+ *          lookup table, so the swapped crop costs two color conversions, one statistics pass
+ *          and one table pass.
+ */
+cv::Mat apply_color_match(const ColorStats& target_stats, const cv::Mat& swapped_crop);
+
+/**
+ * @brief Reuses target-crop color statistics per face track while the face barely changes
+ * @details A track is matched by landmark proximity (match_track()). Its statistics are reused
+ *          while a 16x16 thumbnail of the crop stays within `max_difference` (mean absolute
+ *          difference, 0-255) of the thumbnail they were computed from, which holds for a face
+ *          over consecutive video frames despite compression noise. Drift is measured against
+ *          that thumbnail, so a slowly changing face is recomputed once the change adds up.
+ *          Thread-safe.
+ */
+class ColorStatsCache {
+public:
+    explicit ColorStatsCache(std::size_t capacity = 16, double max_difference = 2.0) :
+        m_capacity(capacity), m_max_difference(max_difference) {}
+
+    /**
+     * @brief Statistics of @p target_crop, from the cache when its track saw a similar crop
+     * @param target_crop Aligned target face crop (BGR)
+     * @param landmarks 5-point landmarks of the face in frame coordinates (track key)
+     */
+    ColorStats get(const cv::Mat& target_crop, const types::Landmarks& landmarks);
+
+    void clear();
+
+    [[nodiscard]] std::uint64_t hits() const;
+    [[nodiscard]] std::uint64_t misses() const;
+
+private:
+    struct Entry {
+        types::Landmarks landmarks;
+        cv::Mat thumbnail; ///< Of the crop the statistics were computed from
+        ColorStats stats;
+        std::uint64_t last_used = 0;
+    };
+
+    mutable std::mutex m_mutex;
+    std::vector<Entry> m_entries;
+    std::size_t m_capacity;
+    double m_max_difference;
+    std::uint64_t m_tick = 0;
+    std::uint64_t m_hits = 0;
+    std::uint64_t m_misses = 0;
+};
+
 } // namespace domain::face::helper
@@ -14,6 +14,7 @@ module;
 module domain.face.selector;
 
 import domain.face;
+import domain.face.embedding_index;
 import domain.common;
 
 namespace domain::face::selector {
@@ -117,7 +118,17 @@ float compute_cosine_similarity(const std::vector<float>& emb1, const std::vecto
 }
 
 std::vector<Face> filter_by_similarity(std::vector<Face> faces, const Options& opts) {
-    if (!opts.reference_face.has_value() || opts.mode != SelectorMode::Reference) return faces;
+    if (opts.mode != SelectorMode::Reference) return faces;
+
+    if (opts.reference_index && !opts.reference_index->empty()) {
+        std::erase_if(faces, [&](const Face& face) {
+            const auto best = opts.reference_index->best_match(face.normed_embedding());
+            return !best || best->similarity < opts.similarity_threshold;
+        });
+        return faces;
+    }
+
+    if (!opts.reference_face.has_value()) return faces;
 
     const auto& ref_emb = opts.reference_face->normed_embedding();
     if (ref_emb.empty()) return faces;
@@ -9,10 +9,12 @@ module;
 #include <vector>
 #include <unordered_set>
 #include <optional>
+#include <memory>
 
 export module domain.face.selector;
 
 import domain.face;
+import domain.face.embedding_index;
 import domain.common;
 
 export namespace domain::face::selector {
@@ -67,6 +69,9 @@ struct Options {
 
     // 相似度筛选参数
     std::optional<Face> reference_face;
+    /// Reference gallery; when set it takes precedence over @c reference_face and a face is kept
+    /// if its best match in the gallery reaches @c similarity_threshold
+    std::shared_ptr<const embedding_index::EmbeddingIndex> reference_index;
     float similarity_threshold = 0.6F;
 };
 
@@ -9,13 +9,19 @@ module;
 #include <shared_mutex>
 #include <opencv2/opencv.hpp>
 #include <openssl/sha.h> // Keep for SHA1 compatibility
+#include <xxhash.h>
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <unordered_map>
 #include <iomanip>
 #include <sstream>
-#include <list>
 #include <utility>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <memory>
 
 module domain.face.store;
 
@@ -33,154 +39,310 @@ static uint64_t fnv1a_hash(const uchar* data, size_t len) {
     return hash;
 }
 
+// Incremental FNV-1a over each row so that non-continuous Mats (ROIs) hash their visible pixels
+static uint64_t fnv1a_hash(const cv::Mat& frame) {
+    if (frame.isContinuous()) { return fnv1a_hash(frame.data, frame.total() * frame.elemSize()); }
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const size_t row_bytes = static_cast<size_t>(frame.cols) * frame.elemSize();
+    for (int r = 0; r < frame.rows; ++r) {
+        const uchar* row = frame.ptr<uchar>(r);
+        for (size_t i = 0; i < row_bytes; ++i) {
+            hash ^= row[i];
+            hash *= 0x100000001b3ULL;
+        }
+    }
+    return hash;
+}
+
+// Seed derived from the frame geometry so that equal bytes in differently shaped frames differ
+static uint64_t geometry_seed(const cv::Mat& frame) {
+    return (static_cast<uint64_t>(frame.rows) << 32) ^ (static_cast<uint64_t>(frame.cols) << 8)
+         ^ static_cast<uint64_t>(frame.type());
+}
+
+static XXH128_hash_t xxh3_hash(const cv::Mat& frame) {
+    const uint64_t seed = geometry_seed(frame);
+    if (frame.isContinuous()) {
+        return XXH3_128bits_withSeed(frame.data, frame.total() * frame.elemSize(), seed);
+    }
+    // Streaming over rows yields the same digest as the one-shot call on a continuous copy
+    const size_t row_bytes = static_cast<size_t>(frame.cols) * frame.elemSize();
+    XXH3_state_t* state = XXH3_createState();
+    XXH3_128bits_reset_withSeed(state, seed);
+    for (int r = 0; r < frame.rows; ++r) {
+        XXH3_128bits_update(state, frame.ptr<uchar>(r), row_bytes);
+    }
+    const XXH128_hash_t hash = XXH3_128bits_digest(state);
+    XXH3_freeState(state);
+    return hash;
+}
+
+static int sampled_row_step(const cv::Mat& frame, size_t sampled_rows) {
+    if (sampled_rows == 0) return 1;
+    return std::max(1, frame.rows / static_cast<int>(std::min<size_t>(sampled_rows, INT32_MAX)));
+}
+
+// XXH3 over every step-th row starting at first_row; each row is contiguous so XXH3 stays on its
+// vectorised path while the number of bytes touched is bounded by the row budget
+static uint64_t sampled_hash(const cv::Mat& frame, int first_row, int step) {
+    const size_t row_bytes = static_cast<size_t>(frame.cols) * frame.elemSize();
+    uint64_t hash = geometry_seed(frame);
+    for (int r = first_row; r < frame.rows; r += step) {
+        hash = XXH3_64bits_withSeed(frame.ptr<uchar>(r), row_bytes, hash);
+    }
+    return hash;
+}
+
+static std::string to_hex(uint64_t value) {
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << value;
+    return oss.str();
+}
+
+namespace {
+
+// Each shard keeps at least this many entries so that small capacities still behave like a
+// single LRU-ordered cache instead of many one-slot caches.
+constexpr size_t kMinEntriesPerShard = 64;
+
+// Take a lock, counting acquisitions that could not proceed immediately
+template <typename Lock>
+void lock_counting(Lock& lock, std::atomic<std::uint64_t>& contentions) {
+    if (!lock.try_lock()) {
+        contentions.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+}
+
+} // namespace
+
 std::shared_ptr<FaceStore> FaceStore::get_instance() {
     static std::shared_ptr<FaceStore> instance = std::make_shared<FaceStore>();
     return instance;
 }
 
-FaceStore::FaceStore(FaceStoreOptions options) : m_options(options) {}
+FaceStore::FaceStore(FaceStoreOptions options) : m_options(options) {
+    size_t shard_count = std::max<size_t>(1, m_options.shard_count);
+    if (m_options.max_capacity > 0) {
+        shard_count = std::clamp<size_t>(m_options.max_capacity / kMinEntriesPerShard, 1,
+                                         shard_count);
+        m_shard_capacity = (m_options.max_capacity + shard_count - 1) / shard_count;
+    }
+
+    m_shards.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) { m_shards.push_back(std::make_unique<Shard>()); }
+}
 
 FaceStore::~FaceStore() {
     clear_faces();
 }
 
-void FaceStore::update_access(const std::string& key) {
-    if (!m_options.enable_lru) return;
+FaceStore::Shard& FaceStore::shard_for(const std::string& key) const {
+    return *m_shards[std::hash<std::string>{}(key) % m_shards.size()];
+}
 
-    // Assumes mutex is locked by caller
-    auto it = m_cache.find(key);
-    if (it != m_cache.end()) {
-        // Move to front of list (MRU)
-        m_lru_list.splice(m_lru_list.begin(), m_lru_list, it->second.lru_iterator);
+FacesSnapshot FaceStore::find(const std::string& key, std::uint64_t verifier) const {
+    auto& shard = shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex, std::defer_lock);
+    lock_counting(lock, m_lock_contentions);
+
+    if (auto it = shard.entries.find(key); it != shard.entries.end()) {
+        const auto& entry = it->second;
+        if (verifier == 0 || entry.verifier == 0 || entry.verifier == verifier) {
+            // The reference bit is the only per-hit bookkeeping; no exclusive lock needed.
+            if (m_options.enable_lru) entry.referenced.store(true, std::memory_order_relaxed);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return entry.faces;
+        }
     }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
 }
 
-void FaceStore::evict_if_needed() {
-    if (!m_options.enable_lru || m_options.max_capacity == 0) return;
+size_t FaceStore::evict_one(Shard& shard) {
+    // Sweep the hand, giving referenced entries a second chance. Terminates within two
+    // revolutions since every inspected entry has its bit cleared.
+    while (true) {
+        if (shard.hand >= shard.clock.size()) shard.hand = 0;
+        auto it = shard.entries.find(shard.clock[shard.hand]);
+        if (it != shard.entries.end()
+            && it->second.referenced.exchange(false, std::memory_order_relaxed)) {
+            ++shard.hand;
+            continue;
+        }
+        if (it != shard.entries.end()) {
+            shard.entries.erase(it);
+            m_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        return shard.hand;
+    }
+}
 
-    while (m_cache.size() >= m_options.max_capacity) {
-        // Evict LRU (back of list)
-        if (m_lru_list.empty()) break;
+void FaceStore::insert(const std::string& key, std::uint64_t verifier, FacesSnapshot faces) {
+    auto& shard = shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex, std::defer_lock);
+    lock_counting(lock, m_lock_contentions);
+    m_insertions.fetch_add(1, std::memory_order_relaxed);
 
-        std::string lru_key = m_lru_list.back();
-        m_lru_list.pop_back();
-        m_cache.erase(lru_key);
+    if (auto it = shard.entries.find(key); it != shard.entries.end()) {
+        it->second.faces = std::move(faces);
+        it->second.verifier = verifier;
+        if (m_options.enable_lru) it->second.referenced.store(true, std::memory_order_relaxed);
+        return;
     }
+
+    const bool full = m_options.enable_lru && m_shard_capacity > 0
+                   && shard.entries.size() >= m_shard_capacity && !shard.clock.empty();
+    if (full) {
+        const size_t slot = evict_one(shard);
+        shard.clock[slot] = key;
+        shard.hand = slot + 1;
+    } else {
+        shard.clock.push_back(key);
+    }
+
+    auto [it, inserted] = shard.entries.try_emplace(key);
+    it->second.faces = std::move(faces);
+    it->second.verifier = verifier;
 }
 
 void FaceStore::insert_faces(const cv::Mat& frame, const std::vector<Face>& faces) {
     if (faces.empty()) { return; }
-    std::string key = get_key(frame);
-
-    std::unique_lock<std::shared_mutex> lock(m_rw_mutex);
+    insert_faces(make_key(frame), faces);
+}
 
-    if (m_cache.contains(key)) {
-        m_cache[key].faces = faces;
-        update_access(key);
-    } else {
-        evict_if_needed();
-        m_lru_list.push_front(key);
-        m_cache[key] = {faces, m_lru_list.begin()};
-    }
+void FaceStore::insert_faces(const FrameKey& key, std::vector<Face> faces) {
+    if (faces.empty() || key.empty()) { return; }
+    insert(key.value, key.verifier, std::make_shared<const std::vector<Face>>(std::move(faces)));
 }
 
 void FaceStore::insert_faces(const std::string& faces_name, const std::vector<Face>& faces) {
     if (faces.empty()) { return; }
-    std::unique_lock<std::shared_mutex> lock(m_rw_mutex);
+    insert(faces_name, 0, std::make_shared<const std::vector<Face>>(faces));
+}
 
-    if (m_cache.contains(faces_name)) {
-        m_cache[faces_name].faces = faces;
-        update_access(faces_name);
-    } else {
-        evict_if_needed();
-        m_lru_list.push_front(faces_name);
-        m_cache[faces_name] = {faces, m_lru_list.begin()};
-    }
+FacesSnapshot FaceStore::get_snapshot(const FrameKey& key) const {
+    return find(key.value, key.verifier);
+}
+
+FacesSnapshot FaceStore::get_snapshot(const std::string& faces_name) const {
+    return find(faces_name, 0);
 }
 
 std::vector<Face> FaceStore::get_faces(const cv::Mat& frame) {
-    std::string key = get_key(frame);
+    return get_faces(make_key(frame));
+}
 
-    if (m_options.enable_lru) {
-        std::unique_lock<std::shared_mutex> lock(m_rw_mutex);
-        if (auto it = m_cache.find(key); it != m_cache.end()) {
-            update_access(key);
-            return it->second.faces;
-        }
-    } else {
-        std::shared_lock<std::shared_mutex> lock(m_rw_mutex);
-        if (auto it = m_cache.find(key); it != m_cache.end()) { return it->second.faces; }
-    }
-    return {};
+std::vector<Face> FaceStore::get_faces(const FrameKey& key) {
+    auto snapshot = get_snapshot(key);
+    return snapshot ? *snapshot : std::vector<Face>{};
 }
 
 std::vector<Face> FaceStore::get_faces(const std::string& faces_name) {
-    if (m_options.enable_lru) {
-        std::unique_lock<std::shared_mutex> lock(m_rw_mutex);
-        if (auto it = m_cache.find(faces_name); it != m_cache.end()) {
-            update_access(faces_name);
-            return it->second.faces;
-        }
-    } else {
-        std::shared_lock<std::shared_mutex> lock(m_rw_mutex);
-        if (auto it = m_cache.find(faces_name); it != m_cache.end()) { return it->second.faces; }
-    }
-    return {};
+    auto snapshot = get_snapshot(faces_name);
+    return snapshot ? *snapshot : std::vector<Face>{};
 }
 
 void FaceStore::clear_faces() {
-    std::unique_lock<std::shared_mutex> lock(m_rw_mutex);
-    m_cache.clear();
-    m_lru_list.clear();
+    for (auto& shard : m_shards) {
+        std::unique_lock<std::shared_mutex> lock(shard->mutex);
+        shard->entries.clear();
+        shard->clock.clear();
+        shard->hand = 0;
+    }
 }
 
 void FaceStore::remove_faces(const std::string& faces_name) {
-    std::unique_lock<std::shared_mutex> lock(m_rw_mutex);
-    if (auto it = m_cache.find(faces_name); it != m_cache.end()) {
-        m_lru_list.erase(it->second.lru_iterator);
-        m_cache.erase(it);
+    auto& shard = shard_for(faces_name);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex, std::defer_lock);
+    lock_counting(lock, m_lock_contentions);
+
+    if (shard.entries.erase(faces_name) == 0) return;
+    if (auto it = std::find(shard.clock.begin(), shard.clock.end(), faces_name);
+        it != shard.clock.end()) {
+        const auto slot = static_cast<size_t>(std::distance(shard.clock.begin(), it));
+        shard.clock.erase(it);
+        if (slot < shard.hand) --shard.hand;
     }
 }
 
 void FaceStore::remove_faces(const cv::Mat& frame) {
-    std::string key = get_key(frame);
-    remove_faces(key);
+    remove_faces(make_key(frame));
+}
+
+void FaceStore::remove_faces(const FrameKey& key) {
+    remove_faces(key.value);
 }
 
 bool FaceStore::is_contains(const cv::Mat& frame) const {
-    std::string key = get_key(frame);
-    std::shared_lock<std::shared_mutex> lock(m_rw_mutex);
-    return m_cache.contains(key);
+    return is_contains(make_key(frame));
+}
+
+bool FaceStore::is_contains(const FrameKey& key) const {
+    auto& shard = shard_for(key.value);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key.value);
+    return it != shard.entries.end()
+        && (key.verifier == 0 || it->second.verifier == 0
+            || it->second.verifier == key.verifier);
 }
 
 bool FaceStore::is_contains(const std::string& faces_name) const {
-    std::shared_lock<std::shared_mutex> lock(m_rw_mutex);
-    return m_cache.contains(faces_name);
+    return is_contains(FrameKey{faces_name, 0});
+}
+
+FaceStoreStats FaceStore::stats() const {
+    FaceStoreStats result;
+    result.hits = m_hits.load(std::memory_order_relaxed);
+    result.misses = m_misses.load(std::memory_order_relaxed);
+    result.insertions = m_insertions.load(std::memory_order_relaxed);
+    result.evictions = m_evictions.load(std::memory_order_relaxed);
+    result.lock_contentions = m_lock_contentions.load(std::memory_order_relaxed);
+    for (const auto& shard : m_shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        result.size += shard->entries.size();
+    }
+    return result;
 }
 
-std::string FaceStore::calculate_hash(const cv::Mat& frame, HashStrategy strategy) {
-    const uchar* data = frame.data;
-    const size_t data_size = frame.total() * frame.elemSize();
+std::string FaceStore::calculate_hash(const cv::Mat& frame, HashStrategy strategy,
+                                      size_t sampled_rows) {
+    if (frame.empty()) return {};
 
-    if (strategy == HashStrategy::FNV1a) {
-        uint64_t hash = fnv1a_hash(data, data_size);
-        std::ostringstream oss;
-        oss << std::hex << std::setw(16) << std::setfill('0') << hash;
-        return oss.str();
-    } else {
-        // SHA1
+    switch (strategy) {
+    case HashStrategy::FNV1a: return to_hex(fnv1a_hash(frame));
+    case HashStrategy::XXH3: {
+        const XXH128_hash_t hash = xxh3_hash(frame);
+        return to_hex(hash.high64) + to_hex(hash.low64);
+    }
+    case HashStrategy::Sampled:
+        return to_hex(sampled_hash(frame, 0, sampled_row_step(frame, sampled_rows)));
+    case HashStrategy::SHA1:
+    default: {
+        const cv::Mat continuous = frame.isContinuous() ? frame : frame.clone();
         unsigned char hash[SHA_DIGEST_LENGTH];
-        SHA1(reinterpret_cast<const unsigned char*>(data), data_size, hash);
+        SHA1(reinterpret_cast<const unsigned char*>(continuous.data),
+             continuous.total() * continuous.elemSize(), hash);
         std::ostringstream oss;
         for (const unsigned char& i : hash) {
             oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(i);
         }
         return oss.str();
     }
+    }
 }
 
-std::string FaceStore::get_key(const cv::Mat& frame) const {
-    return calculate_hash(frame, m_options.hash_strategy);
+FrameKey FaceStore::make_key(const cv::Mat& frame) const {
+    FrameKey key;
+    key.value = calculate_hash(frame, m_options.hash_strategy, m_options.sampled_rows);
+
+    if (m_options.hash_strategy == HashStrategy::Sampled && !frame.empty()) {
+        // Verify with the rows halfway between the sampled ones; when every row was already
+        // sampled there is nothing left to verify against.
+        const int step = sampled_row_step(frame, m_options.sampled_rows);
+        if (step > 1) { key.verifier = sampled_hash(frame, step / 2, step) | 1ULL; }
+    }
+    return key;
 }
 
 } // namespace domain::face::store
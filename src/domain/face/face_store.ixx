@@ -1,16 +1,17 @@
 /**
  * @file face_store.ixx
- * @brief Thread-safe LRU cache for detected faces in frames
+ * @brief Thread-safe sharded CLOCK cache for detected faces in frames
  * @author CodingRookie
  * @date 2026-01-27
  */
 module;
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <shared_mutex>
 #include <vector>
 #include <string>
 #include <unordered_map>
-#include <list>
 #include <utility>
 #include <opencv2/opencv.hpp>
 
@@ -24,23 +25,72 @@ export namespace domain::face::store {
  * @brief Hashing strategy for image frames
  */
 enum class HashStrategy : std::uint8_t {
-    SHA1, ///< cryptographic SHA1 hash (slow, accurate)
-    FNV1a ///< Fast Non-Volatile hash (fast, good for small-medium sets)
+    SHA1,   ///< cryptographic SHA1 hash (slow, accurate)
+    FNV1a,  ///< Fast Non-Volatile hash (fast, good for small-medium sets)
+    XXH3,   ///< SIMD-accelerated XXH3-128 over every byte (fast, accurate)
+    Sampled ///< XXH3 over a strided subset of rows, verified on lookup (fastest)
+};
+
+/**
+ * @brief Precomputed cache key for a frame
+ * @details Computing a key touches the frame's pixels, so callers that query the store several
+ *          times for the same frame should compute it once via FaceStore::make_key() and reuse it.
+ *          For HashStrategy::Sampled, @c verifier fingerprints a second set of rows, halfway
+ *          between the ones hashed into @c value, and is compared on lookup to reject most frames
+ *          that only collide on the sampled rows. Rows covered by neither are not checked, so
+ *          frames that differ only there still share a cache entry.
+ */
+struct FrameKey {
+    std::string value;          ///< Cache key (empty = not computed)
+    std::uint64_t verifier = 0; ///< Secondary fingerprint (0 = no verification)
+
+    [[nodiscard]] bool empty() const { return value.empty(); }
 };
 
 /**
  * @brief Configuration for FaceStore cache
  */
 struct FaceStoreOptions {
-    HashStrategy hash_strategy = HashStrategy::FNV1a; ///< Strategy for key generation
-    size_t max_capacity = 1000;                       ///< Max frames to store (0 = unlimited)
-    bool enable_lru = true;                           ///< Whether to use LRU eviction policy
+    HashStrategy hash_strategy = HashStrategy::XXH3; ///< Strategy for key generation
+    size_t max_capacity = 1000;                      ///< Max frames to store (0 = unlimited)
+    bool enable_lru = true;   ///< Whether to evict with the CLOCK (approximate LRU) policy
+    size_t sampled_rows = 64; ///< Rows hashed per frame by HashStrategy::Sampled
+    size_t shard_count = 16;  ///< Upper bound on independently locked shards
+};
+
+/**
+ * @brief Immutable, shared view of the faces cached for one key
+ * @details Cache hits hand out another reference to the stored vector instead of copying the
+ *          faces (embeddings, masks); the vector is never mutated once published.
+ */
+using FacesSnapshot = std::shared_ptr<const std::vector<Face>>;
+
+/**
+ * @brief Counters describing FaceStore effectiveness since construction
+ */
+struct FaceStoreStats {
+    std::uint64_t hits = 0;             ///< Lookups that returned cached faces
+    std::uint64_t misses = 0;           ///< Lookups that found nothing (or failed verification)
+    std::uint64_t insertions = 0;       ///< Entries inserted or replaced
+    std::uint64_t evictions = 0;        ///< Entries dropped by the CLOCK policy
+    std::uint64_t lock_contentions = 0; ///< Shard lock acquisitions that had to wait
+    std::size_t size = 0;               ///< Entries currently cached
+
+    /**
+     * @brief Fraction of lookups that hit, in [0, 1]
+     */
+    [[nodiscard]] double hit_rate() const {
+        const auto lookups = hits + misses;
+        return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+    }
 };
 
 /**
  * @brief Thread-safe cache for detected face objects
  * @details Uses a hash of the frame content as key to avoid redundant face detection.
- *          Supports singleton access and LRU eviction.
+ *          Keys are spread over independently locked shards; each shard evicts with CLOCK
+ *          (a reference bit per entry swept by a hand), so lookups only take a shared lock.
+ *          Supports singleton access.
  */
 class FaceStore {
 public:
@@ -65,11 +115,21 @@ public:
      */
     void remove_faces(const cv::Mat& frame);
 
+    /**
+     * @brief Remove faces associated with a precomputed frame key
+     */
+    void remove_faces(const FrameKey& key);
+
     /**
      * @brief Insert detected faces for a given frame
      */
     void insert_faces(const cv::Mat& frame, const std::vector<Face>& faces);
 
+    /**
+     * @brief Insert detected faces for a precomputed frame key
+     */
+    void insert_faces(const FrameKey& key, std::vector<Face> faces);
+
     /**
      * @brief Insert faces associated with a specific key name
      */
@@ -86,16 +146,39 @@ public:
      */
     [[nodiscard]] std::vector<Face> get_faces(const cv::Mat& frame);
 
+    /**
+     * @brief Retrieve faces for a precomputed frame key
+     * @return Vector of Face objects, empty if not found or the verifier does not match
+     */
+    [[nodiscard]] std::vector<Face> get_faces(const FrameKey& key);
+
     /**
      * @brief Retrieve faces for a key name
      */
     [[nodiscard]] std::vector<Face> get_faces(const std::string& faces_name);
 
+    /**
+     * @brief Retrieve a shared snapshot of the faces for a precomputed frame key
+     * @return Snapshot, or nullptr if not found or the verifier does not match
+     */
+    [[nodiscard]] FacesSnapshot get_snapshot(const FrameKey& key) const;
+
+    /**
+     * @brief Retrieve a shared snapshot of the faces for a key name
+     * @return Snapshot, or nullptr if not found
+     */
+    [[nodiscard]] FacesSnapshot get_snapshot(const std::string& faces_name) const;
+
     /**
      * @brief Check if faces for a frame are cached
      */
     [[nodiscard]] bool is_contains(const cv::Mat& frame) const;
 
+    /**
+     * @brief Check if faces for a precomputed frame key are cached
+     */
+    [[nodiscard]] bool is_contains(const FrameKey& key) const;
+
     /**
      * @brief Check if faces for a key name are cached
      */
@@ -105,28 +188,52 @@ public:
      * @brief Calculate a unique hash string for an image
      * @param frame Input image
      * @param strategy Hashing algorithm to use
+     * @param sampled_rows Rows hashed when @p strategy is HashStrategy::Sampled
      * @return Unique identifier string
      */
-    [[nodiscard]] static std::string calculate_hash(const cv::Mat& frame, HashStrategy strategy);
+    [[nodiscard]] static std::string calculate_hash(const cv::Mat& frame, HashStrategy strategy,
+                                                    size_t sampled_rows = 64);
 
-private:
-    FaceStoreOptions m_options;
+    /**
+     * @brief Compute the cache key for a frame using this store's options
+     * @param frame Input image
+     * @return Key (and verifier for sampled hashing) to pass to the FrameKey overloads
+     */
+    [[nodiscard]] FrameKey make_key(const cv::Mat& frame) const;
 
-    std::list<std::string> m_lru_list;
+    /**
+     * @brief Snapshot of hit/miss, eviction and contention counters
+     */
+    [[nodiscard]] FaceStoreStats stats() const;
 
-    using AccessIterator = std::list<std::string>::iterator;
+private:
     struct CacheEntry {
-        std::vector<Face> faces;
-        AccessIterator lru_iterator;
+        FacesSnapshot faces;
+        std::uint64_t verifier = 0;
+        mutable std::atomic<bool> referenced{false}; ///< CLOCK reference bit, set on hit
     };
 
-    std::unordered_map<std::string, CacheEntry> m_cache;
-
-    mutable std::shared_mutex m_rw_mutex;
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, CacheEntry> entries;
+        std::vector<std::string> clock; ///< Keys in CLOCK order
+        size_t hand = 0;                ///< Next CLOCK slot to inspect
+    };
 
-    void update_access(const std::string& key);
-    void evict_if_needed();
-    std::string get_key(const cv::Mat& frame) const;
+    FaceStoreOptions m_options;
+    size_t m_shard_capacity = 0; ///< Max entries per shard (0 = unlimited)
+    std::vector<std::unique_ptr<Shard>> m_shards;
+
+    mutable std::atomic<std::uint64_t> m_hits{0};
+    mutable std::atomic<std::uint64_t> m_misses{0};
+    std::atomic<std::uint64_t> m_insertions{0};
+    std::atomic<std::uint64_t> m_evictions{0};
+    mutable std::atomic<std::uint64_t> m_lock_contentions{0};
+
+    [[nodiscard]] Shard& shard_for(const std::string& key) const;
+    [[nodiscard]] FacesSnapshot find(const std::string& key, std::uint64_t verifier) const;
+    void insert(const std::string& key, std::uint64_t verifier, FacesSnapshot faces);
+    [[nodiscard]] size_t evict_one(Shard& shard);
 };
 
 } // namespace domain::face::store
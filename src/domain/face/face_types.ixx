@@ -75,6 +75,8 @@ struct MaskOptions {
     float box_mask_blur = 0.3F; ///< Blur intensity for box mask
     std::array<int, 4> box_mask_padding = {0, 0, 0,
                                            0}; ///< Padding for box mask (top, right, bottom, left)
+
+    bool operator==(const MaskOptions&) const = default;
 };
 
 /**
@@ -7,6 +7,7 @@
 module;
 #include <opencv2/core/mat.hpp>
 #include <unordered_set>
+#include <vector>
 
 export module domain.face.masker:api;
 
@@ -30,6 +31,19 @@ public:
      * @return Single channel mask (CV_8UC1), 255=Occluded, 0=Clear
      */
     [[nodiscard]] virtual cv::Mat create_occlusion_mask(const cv::Mat& crop_vision_frame) = 0;
+
+    /**
+     * @brief Create the occlusion masks of several face crops
+     * @details The default runs the crops one by one; implementations may batch the inference.
+     * @return One mask per crop, in order
+     */
+    [[nodiscard]] virtual std::vector<cv::Mat> create_occlusion_mask_batch(
+        const std::vector<cv::Mat>& crop_vision_frames) {
+        std::vector<cv::Mat> masks;
+        masks.reserve(crop_vision_frames.size());
+        for (const auto& crop : crop_vision_frames) masks.push_back(create_occlusion_mask(crop));
+        return masks;
+    }
 };
 
 /**
@@ -48,6 +62,43 @@ public:
      */
     [[nodiscard]] virtual cv::Mat create_region_mask(
         const cv::Mat& crop_vision_frame, const std::unordered_set<FaceRegion>& regions) = 0;
+
+    /**
+     * @brief Run face parsing once and return the per-pixel class labels
+     * @details Callers needing masks for several region sets (or several pipeline steps) derive
+     *          them with select_regions() instead of re-running the model. Implementations that
+     *          do not support label maps return an empty Mat.
+     * @param crop_vision_frame Input face crop (BGR)
+     * @return Label map (CV_8UC1, crop size), or empty if unsupported
+     */
+    [[nodiscard]] virtual cv::Mat create_region_labels(const cv::Mat& crop_vision_frame) {
+        (void)crop_vision_frame;
+        return {};
+    }
+
+    /**
+     * @brief Label maps of several face crops
+     * @details The default runs the crops one by one; implementations may batch the inference.
+     * @return One label map per crop, in order (empty entries if unsupported)
+     */
+    [[nodiscard]] virtual std::vector<cv::Mat> create_region_labels_batch(
+        const std::vector<cv::Mat>& crop_vision_frames) {
+        std::vector<cv::Mat> labels;
+        labels.reserve(crop_vision_frames.size());
+        for (const auto& crop : crop_vision_frames) labels.push_back(create_region_labels(crop));
+        return labels;
+    }
+
+    /**
+     * @brief Build a region mask from a label map returned by create_region_labels()
+     * @return Single channel mask (CV_8UC1), 255=Selected Region, 0=Other; empty if unsupported
+     */
+    [[nodiscard]] virtual cv::Mat select_regions(
+        const cv::Mat& labels, const std::unordered_set<FaceRegion>& regions) const {
+        (void)labels;
+        (void)regions;
+        return {};
+    }
 };
 
 } // namespace domain::face::masker
@@ -1,4 +1,5 @@
 module;
+#include <cstddef>
 #include <vector>
 #include <iostream>
 #include <algorithm>
@@ -12,6 +13,17 @@ import foundation.ai.inference_session_registry;
 
 namespace {
 
+constexpr int kMaxBatch = 8; ///< Crops per call for models with a dynamic batch dimension
+
+/**
+ * @brief Crops per inference: the model's fixed batch size, or kMaxBatch if it is dynamic
+ */
+int batch_limit(const std::vector<std::vector<int64_t>>& input_node_dims) {
+    if (input_node_dims.empty() || input_node_dims[0].empty()) return 1;
+    const int64_t batch = input_node_dims[0][0];
+    return batch > 0 ? static_cast<int>(batch) : kMaxBatch;
+}
+
 std::pair<std::vector<float>, std::vector<int64_t>> prepare_input(
     const cv::Mat& crop_vision_frame, const std::vector<std::vector<int64_t>>& input_node_dims) {
     if (input_node_dims.empty() || input_node_dims[0].size() < 3) { return {}; }
@@ -49,10 +61,13 @@ std::pair<std::vector<float>, std::vector<int64_t>> prepare_input(
 }
 
 cv::Mat process_output(std::vector<Ort::Value>& output_tensors, cv::Size original_size, int model_h,
-                       int model_w) {
+                       int model_w, std::size_t index = 0) {
     auto& output_tensor = output_tensors[0];
     auto type_info = output_tensor.GetTensorTypeAndShapeInfo();
     auto output_shape = type_info.GetShape();
+    if (!output_shape.empty() && static_cast<int64_t>(index) >= output_shape[0]) {
+        return cv::Mat::zeros(original_size, CV_8UC1);
+    }
 
     // Default to model input dims if output dims are weird, but usually [1, H, W, 1] or [1, H, W]
     int out_h = model_h;
@@ -62,7 +77,8 @@ cv::Mat process_output(std::vector<Ort::Value>& output_tensors, cv::Size origina
         out_w = static_cast<int>(output_shape[2]);
     }
 
-    float* output_buffer = output_tensor.GetTensorMutableData<float>();
+    float* output_buffer = output_tensor.GetTensorMutableData<float>()
+                         + index * static_cast<std::size_t>(out_h) * out_w;
     cv::Mat mask_float(out_h, out_w, CV_32FC1, output_buffer);
 
     // Soft thresholding / Clamping
@@ -124,4 +140,60 @@ cv::Mat OcclusionMasker::create_occlusion_mask(const cv::Mat& crop_vision_frame)
     return process_output(output_tensors, crop_vision_frame.size(), h, w);
 }
 
+std::vector<cv::Mat> OcclusionMasker::create_occlusion_mask_batch(
+    const std::vector<cv::Mat>& crop_vision_frames) {
+    const int limit = m_session ? batch_limit(m_session->get_input_node_dims()) : 1;
+    if (limit <= 1 || crop_vision_frames.size() <= 1 || !m_session->is_model_loaded()) {
+        return IFaceOccluder::create_occlusion_mask_batch(crop_vision_frames);
+    }
+
+    std::vector<cv::Mat> masks(crop_vision_frames.size());
+    const auto input_node_dims = m_session->get_input_node_dims();
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    std::vector<std::size_t> indices;
+    std::vector<float> input_data;
+    std::vector<int64_t> input_shape;
+    auto flush = [&] {
+        input_shape[0] = static_cast<int64_t>(indices.size());
+        std::vector<Ort::Value> input_tensors;
+        input_tensors.push_back(
+            Ort::Value::CreateTensor<float>(memory_info, input_data.data(), input_data.size(),
+                                            input_shape.data(), input_shape.size()));
+        auto output_tensors = m_session->run(input_tensors);
+
+        const int h = static_cast<int>(input_shape[1]);
+        const int w = static_cast<int>(input_shape[2]);
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            const cv::Size size = crop_vision_frames[indices[i]].size();
+            if (output_tensors.empty()) {
+                masks[indices[i]] = cv::Mat::zeros(size, CV_8UC1);
+            } else {
+                masks[indices[i]] = process_output(output_tensors, size, h, w, i);
+            }
+        }
+        indices.clear();
+        input_data.clear();
+    };
+
+    for (std::size_t i = 0; i < crop_vision_frames.size(); ++i) {
+        const cv::Mat& crop = crop_vision_frames[i];
+        if (crop.empty()) {
+            masks[i] = cv::Mat::zeros(crop.size(), CV_8UC1);
+            continue;
+        }
+        auto [data, shape] = prepare_input(crop, input_node_dims);
+        if (data.empty()) {
+            masks[i] = cv::Mat::zeros(crop.size(), CV_8UC1);
+            continue;
+        }
+        input_shape = std::move(shape);
+        input_data.insert(input_data.end(), data.begin(), data.end());
+        indices.push_back(i);
+        if (static_cast<int>(indices.size()) == limit) flush();
+    }
+    if (!indices.empty()) flush();
+    return masks;
+}
+
 } // namespace domain::face::masker
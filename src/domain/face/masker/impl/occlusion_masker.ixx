@@ -40,6 +40,12 @@ public:
      */
     cv::Mat create_occlusion_mask(const cv::Mat& crop_vision_frame) override;
 
+    /**
+     * @brief Occlusion masks of several crops, batched when the model's batch dimension allows
+     */
+    std::vector<cv::Mat> create_occlusion_mask_batch(
+        const std::vector<cv::Mat>& crop_vision_frames) override;
+
 private:
     std::shared_ptr<foundation::ai::inference_session::InferenceSession> m_session;
 };
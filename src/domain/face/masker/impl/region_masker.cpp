@@ -2,9 +2,10 @@ module;
 #include <vector>
 #include <unordered_set>
 #include <algorithm>
-#include <iostream>
-#include <limits>
+#include <array>
+#include <cstdint>
 #include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 #include <onnxruntime_cxx_api.h>
 
 module domain.face.masker;
@@ -41,6 +42,24 @@ static int get_region_id(FaceRegion region) {
 
 namespace {
 
+constexpr int kMaxRegionClasses = 32; ///< Size of the region selection LUT
+constexpr int kArgmaxTile = 256;      ///< Pixels per argmax tile (running max + index in L1)
+constexpr int kMaxBatch = 8;          ///< Crops per call for models with a dynamic batch size
+
+/**
+ * @brief Crops per inference: the model's fixed batch size, or kMaxBatch if it is dynamic
+ */
+int batch_limit(const std::vector<std::vector<int64_t>>& input_node_dims) {
+    if (input_node_dims.empty() || input_node_dims[0].empty()) return 1;
+    const int64_t batch = input_node_dims[0][0];
+    return batch > 0 ? static_cast<int>(batch) : kMaxBatch;
+}
+
+/**
+ * @brief Build the model input in one pass over the (resized) crop
+ * @details Horizontal flip, BGR -> RGB, [-1, 1] normalisation and the HWC -> NCHW split are
+ *          fused into a single loop writing the three planes directly.
+ */
 std::pair<std::vector<float>, std::vector<int64_t>> prepare_region_input(
     const cv::Mat& crop_vision_frame, const std::vector<std::vector<int64_t>>& input_node_dims) {
     if (input_node_dims.empty()) return {};
@@ -53,28 +72,26 @@ std::pair<std::vector<float>, std::vector<int64_t>> prepare_region_input(
         w = static_cast<int>(input_node_dims[0][3]);
     }
 
-    cv::Mat resized;
-    cv::resize(crop_vision_frame, resized, cv::Size(w, h));
-    cv::flip(resized, resized, 1);
-
-    cv::Mat float_img;
-    cv::cvtColor(resized, float_img, cv::COLOR_BGR2RGB);
-    float_img.convertTo(float_img, CV_32FC3, 1.0 / 127.5, -1.0);
-
-    // NCHW Layout construction
-    size_t channel_size = h * w;
-    std::vector<float> input_data(1 * 3 * channel_size);
-    std::vector<cv::Mat> channels(3);
-    cv::split(float_img, channels);
-
-    for (int c = 0; c < 3; ++c) {
-        if (channels[c].isContinuous()) {
-            std::memcpy(input_data.data() + c * channel_size, channels[c].data,
-                        channel_size * sizeof(float));
-        } else {
-            cv::Mat cont = channels[c].clone();
-            std::memcpy(input_data.data() + c * channel_size, cont.data,
-                        channel_size * sizeof(float));
+    cv::Mat resized = crop_vision_frame;
+    if (resized.size() != cv::Size(w, h)) {
+        cv::resize(crop_vision_frame, resized, cv::Size(w, h));
+    }
+
+    const size_t channel_size = static_cast<size_t>(h) * w;
+    std::vector<float> input_data(3 * channel_size);
+    float* red = input_data.data();
+    float* green = red + channel_size;
+    float* blue = green + channel_size;
+
+    constexpr float kScale = 1.0F / 127.5F;
+    for (int y = 0; y < h; ++y) {
+        const uchar* src = resized.ptr<uchar>(y);
+        const size_t row = static_cast<size_t>(y) * w;
+        for (int x = 0; x < w; ++x) {
+            const uchar* px = src + 3 * static_cast<size_t>(w - 1 - x); // mirrored column
+            red[row + x] = static_cast<float>(px[2]) * kScale - 1.0F;
+            green[row + x] = static_cast<float>(px[1]) * kScale - 1.0F;
+            blue[row + x] = static_cast<float>(px[0]) * kScale - 1.0F;
         }
     }
 
@@ -82,50 +99,86 @@ std::pair<std::vector<float>, std::vector<int64_t>> prepare_region_input(
     return {std::move(input_data), std::move(input_shape)};
 }
 
-cv::Mat process_region_output(std::vector<Ort::Value>& output_tensors, cv::Size original_size,
-                              const std::unordered_set<FaceRegion>& regions) {
+/**
+ * @brief Argmax over @p num_classes planes for @p n consecutive pixels
+ * @param planes First class plane, already offset to the first pixel
+ * @param plane_stride Distance between class planes (pixels per plane)
+ * @param best Scratch buffer for the running maximum (@p n floats)
+ * @param index Output class index per pixel (first maximum wins, as in the scalar version)
+ */
+void argmax_tile(const float* planes, size_t plane_stride, int num_classes, int n, float* best,
+                 std::int32_t* index) {
+    std::copy_n(planes, n, best);
+    std::fill_n(index, n, 0);
+
+    for (int c = 1; c < num_classes; ++c) {
+        const float* plane = planes + static_cast<size_t>(c) * plane_stride;
+        int i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+        const cv::v_int32 class_id = cv::vx_setall_s32(c);
+        for (; i + lanes <= n; i += lanes) {
+            const cv::v_float32 value = cv::vx_load(plane + i);
+            const cv::v_float32 current = cv::vx_load(best + i);
+            const cv::v_float32 greater = cv::v_gt(value, current);
+            cv::v_store(best + i, cv::v_select(greater, value, current));
+            cv::v_store(index + i, cv::v_select(cv::v_reinterpret_as_s32(greater), class_id,
+                                                cv::vx_load(index + i)));
+        }
+        cv::vx_cleanup();
+#endif
+        for (; i < n; ++i) {
+            if (plane[i] > best[i]) {
+                best[i] = plane[i];
+                index[i] = c;
+            }
+        }
+    }
+}
+
+cv::Mat process_region_labels(std::vector<Ort::Value>& output_tensors, cv::Size original_size,
+                              std::size_t batch_index = 0) {
     const auto& output_tensor = output_tensors[0];
     auto type_info = output_tensor.GetTensorTypeAndShapeInfo();
     auto output_shape = type_info.GetShape();
 
-    if (output_shape.size() != 4) { return cv::Mat::zeros(original_size, CV_8UC1); }
+    if (output_shape.size() != 4 || static_cast<int64_t>(batch_index) >= output_shape[0]) {
+        return {};
+    }
 
     int num_classes = static_cast<int>(output_shape[1]);
     int out_h = static_cast<int>(output_shape[2]);
     int out_w = static_cast<int>(output_shape[3]);
-
-    const float* output_data = output_tensor.GetTensorData<float>();
-
-    std::unordered_set<int> target_indices;
-    for (auto region : regions) {
-        int id = get_region_id(region);
-        if (id != -1) target_indices.insert(id);
+    if (num_classes <= 0 || num_classes > kMaxRegionClasses || out_h <= 0 || out_w <= 0) {
+        return {};
     }
 
-    cv::Mat mask = cv::Mat::zeros(out_h, out_w, CV_8UC1);
-    int pixels = out_h * out_w;
-
-    for (int i = 0; i < pixels; ++i) {
-        int best_class = 0;
-        float max_val = -std::numeric_limits<float>::infinity();
+    const size_t pixels = static_cast<size_t>(out_h) * out_w;
+    const float* output_data =
+        output_tensor.GetTensorData<float>() + batch_index * num_classes * pixels;
 
-        for (int c = 0; c < num_classes; ++c) {
-            float val = output_data[c * pixels + i];
-            if (val > max_val) {
-                max_val = val;
-                best_class = c;
+    // Walk each row in L1-sized tiles across all class planes; the horizontal flip of the
+    // model input is undone in the label write.
+    std::array<float, kArgmaxTile> best{};
+    std::array<std::int32_t, kArgmaxTile> index{};
+    cv::Mat labels(out_h, out_w, CV_8UC1);
+    for (int y = 0; y < out_h; ++y) {
+        uchar* dst = labels.ptr<uchar>(y);
+        const float* row = output_data + static_cast<size_t>(y) * out_w;
+        for (int x0 = 0; x0 < out_w; x0 += kArgmaxTile) {
+            const int n = std::min(kArgmaxTile, out_w - x0);
+            argmax_tile(row + x0, pixels, num_classes, n, best.data(), index.data());
+            for (int i = 0; i < n; ++i) {
+                dst[out_w - 1 - (x0 + i)] = static_cast<uchar>(index[i]);
             }
         }
-
-        if (target_indices.contains(best_class)) { mask.data[i] = 255; }
     }
 
-    cv::flip(mask, mask, 1);
-    if (mask.size() != original_size) {
-        cv::resize(mask, mask, original_size, 0, 0, cv::INTER_NEAREST);
+    if (labels.size() != original_size) {
+        cv::resize(labels, labels, original_size, 0, 0, cv::INTER_NEAREST);
     }
 
-    return mask;
+    return labels;
 }
 
 } // namespace
@@ -139,14 +192,18 @@ void RegionMasker::load_model(const std::string& model_path,
 
 cv::Mat RegionMasker::create_region_mask(const cv::Mat& crop_vision_frame,
                                          const std::unordered_set<FaceRegion>& regions) {
-    if (!m_session || !m_session->is_model_loaded() || crop_vision_frame.empty()) {
-        return cv::Mat::zeros(crop_vision_frame.size(), CV_8UC1);
-    }
+    cv::Mat labels = create_region_labels(crop_vision_frame);
+    if (labels.empty()) { return cv::Mat::zeros(crop_vision_frame.size(), CV_8UC1); }
+    return select_regions(labels, regions);
+}
+
+cv::Mat RegionMasker::create_region_labels(const cv::Mat& crop_vision_frame) {
+    if (!m_session || !m_session->is_model_loaded() || crop_vision_frame.empty()) { return {}; }
 
     // 1. Prepare Input
     auto [input_data, input_shape] =
         prepare_region_input(crop_vision_frame, m_session->get_input_node_dims());
-    if (input_data.empty()) { return cv::Mat::zeros(crop_vision_frame.size(), CV_8UC1); }
+    if (input_data.empty()) { return {}; }
 
     auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
     std::vector<Ort::Value> input_tensors;
@@ -155,10 +212,76 @@ cv::Mat RegionMasker::create_region_mask(const cv::Mat& crop_vision_frame,
 
     // 2. Run Inference
     auto output_tensors = m_session->run(input_tensors);
-    if (output_tensors.empty()) return cv::Mat::zeros(crop_vision_frame.size(), CV_8UC1);
+    if (output_tensors.empty()) return {};
 
     // 3. Process Output
-    return process_region_output(output_tensors, crop_vision_frame.size(), regions);
+    return process_region_labels(output_tensors, crop_vision_frame.size());
+}
+
+std::vector<cv::Mat> RegionMasker::create_region_labels_batch(
+    const std::vector<cv::Mat>& crop_vision_frames) {
+    const int limit = m_session ? batch_limit(m_session->get_input_node_dims()) : 1;
+    if (limit <= 1 || crop_vision_frames.size() <= 1 || !m_session->is_model_loaded()) {
+        return IFaceRegionMasker::create_region_labels_batch(crop_vision_frames);
+    }
+
+    std::vector<cv::Mat> labels(crop_vision_frames.size());
+    const auto input_node_dims = m_session->get_input_node_dims();
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    std::vector<size_t> indices;
+    std::vector<float> input_data;
+    std::vector<int64_t> input_shape;
+    auto flush = [&] {
+        input_shape[0] = static_cast<int64_t>(indices.size());
+        std::vector<Ort::Value> input_tensors;
+        input_tensors.push_back(
+            Ort::Value::CreateTensor<float>(memory_info, input_data.data(), input_data.size(),
+                                            input_shape.data(), input_shape.size()));
+        auto output_tensors = m_session->run(input_tensors);
+        if (!output_tensors.empty()) {
+            for (size_t i = 0; i < indices.size(); ++i) {
+                labels[indices[i]] = process_region_labels(
+                    output_tensors, crop_vision_frames[indices[i]].size(), i);
+            }
+        }
+        indices.clear();
+        input_data.clear();
+    };
+
+    for (size_t i = 0; i < crop_vision_frames.size(); ++i) {
+        if (crop_vision_frames[i].empty()) continue;
+        auto [data, shape] = prepare_region_input(crop_vision_frames[i], input_node_dims);
+        if (data.empty()) continue;
+        input_shape = std::move(shape);
+        input_data.insert(input_data.end(), data.begin(), data.end());
+        indices.push_back(i);
+        if (static_cast<int>(indices.size()) == limit) flush();
+    }
+    if (!indices.empty()) flush();
+    return labels;
+}
+
+cv::Mat RegionMasker::select_regions(const cv::Mat& labels,
+                                     const std::unordered_set<FaceRegion>& regions) const {
+    if (labels.empty()) { return {}; }
+
+    std::array<uchar, kMaxRegionClasses> lut{};
+    for (auto region : regions) {
+        const int id = get_region_id(region);
+        if (id >= 0 && id < kMaxRegionClasses) lut[id] = 255;
+    }
+
+    // Labels are produced at crop size, so the mask is too
+    cv::Mat mask(labels.size(), CV_8UC1);
+    for (int y = 0; y < labels.rows; ++y) {
+        const uchar* src = labels.ptr<uchar>(y);
+        uchar* dst = mask.ptr<uchar>(y);
+        for (int x = 0; x < labels.cols; ++x) {
+            dst[x] = src[x] < kMaxRegionClasses ? lut[src[x]] : 0;
+        }
+    }
+    return mask;
 }
 
 } // namespace domain::face::masker
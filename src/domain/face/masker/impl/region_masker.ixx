@@ -43,6 +43,23 @@ public:
     cv::Mat create_region_mask(const cv::Mat& crop_vision_frame,
                                const std::unordered_set<FaceRegion>& regions) override;
 
+    /**
+     * @brief Per-pixel BiSeNet class labels (CV_8UC1, crop size)
+     */
+    cv::Mat create_region_labels(const cv::Mat& crop_vision_frame) override;
+
+    /**
+     * @brief Label maps of several crops, batched when the model's batch dimension allows
+     */
+    std::vector<cv::Mat> create_region_labels_batch(
+        const std::vector<cv::Mat>& crop_vision_frames) override;
+
+    /**
+     * @brief Select @p regions from a label map produced by create_region_labels()
+     */
+    cv::Mat select_regions(const cv::Mat& labels,
+                           const std::unordered_set<FaceRegion>& regions) const override;
+
 private:
     std::shared_ptr<foundation::ai::inference_session::InferenceSession> m_session;
 };
@@ -0,0 +1,247 @@
+/**
+ ******************************************************************************
+ * @file           : mask_compositor.cpp
+ * @brief          : Mask composition implementation
+ ******************************************************************************
+ */
+
+module;
+#include <algorithm>
+#include <array>
+#include <future>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+module domain.face.masker;
+import :compositor;
+import foundation.infrastructure.thread_pool;
+
+namespace domain::face::masker {
+
+namespace {
+
+using types::MaskType;
+
+/**
+ * @brief Memoised parameter-only mask
+ */
+struct BoxMaskEntry {
+    cv::Size size;
+    float blur = 0.0F;
+    std::array<int, 4> padding{};
+    bool composed = false; ///< true: final box-only composition (edge blur applied)
+    cv::Mat mask;
+};
+
+constexpr std::size_t kMaxBoxMasks = 64; ///< A handful of (size, options) pairs in practice
+
+std::mutex g_box_mutex;
+std::vector<BoxMaskEntry> g_box_masks;
+
+cv::Mat find_box_mask(const cv::Size& size, float blur, const std::array<int, 4>& padding,
+                      bool composed) {
+    const std::scoped_lock kLock(g_box_mutex);
+    for (const auto& entry : g_box_masks) {
+        if (entry.size == size && entry.blur == blur && entry.padding == padding
+            && entry.composed == composed) {
+            return entry.mask;
+        }
+    }
+    return {};
+}
+
+void store_box_mask(const cv::Size& size, float blur, const std::array<int, 4>& padding,
+                    bool composed, const cv::Mat& mask) {
+    const std::scoped_lock kLock(g_box_mutex);
+    if (g_box_masks.size() >= kMaxBoxMasks) { g_box_masks.clear(); }
+    g_box_masks.push_back({size, blur, padding, composed, mask});
+}
+
+bool has_mask_type(const types::MaskOptions& options, MaskType type) {
+    return std::ranges::find(options.mask_types, type) != options.mask_types.end();
+}
+
+/**
+ * @brief Element-wise minimum of @p masks as CV_32FC1 (0-1) in one row-wise pass
+ * @details CV_8UC1 inputs are scaled by 1/255 on the fly; each output row stays in L1 while
+ *          every mask is folded into it.
+ */
+cv::Mat fuse_min(std::vector<cv::Mat>& masks, const cv::Size& size) {
+    for (auto& mask : masks) {
+        if (mask.depth() != CV_8U && mask.depth() != CV_32F) {
+            mask.convertTo(mask, CV_32F, 1.0 / 255.0);
+        }
+        if (mask.size() != size) { cv::resize(mask, mask, size); }
+    }
+
+    constexpr float kInv255 = 1.0F / 255.0F;
+    cv::Mat fused(size, CV_32FC1);
+    for (int y = 0; y < size.height; ++y) {
+        float* dst = fused.ptr<float>(y);
+        for (std::size_t k = 0; k < masks.size(); ++k) {
+            const cv::Mat& mask = masks[k];
+            if (mask.depth() == CV_8U) {
+                const uchar* src = mask.ptr<uchar>(y);
+                if (k == 0) {
+                    for (int x = 0; x < size.width; ++x) dst[x] = src[x] * kInv255;
+                } else {
+                    for (int x = 0; x < size.width; ++x) {
+                        dst[x] = std::min(dst[x], src[x] * kInv255);
+                    }
+                }
+            } else {
+                const float* src = mask.ptr<float>(y);
+                if (k == 0) {
+                    std::copy_n(src, size.width, dst);
+                } else {
+                    for (int x = 0; x < size.width; ++x) dst[x] = std::min(dst[x], src[x]);
+                }
+            }
+        }
+    }
+    return fused;
+}
+
+/**
+ * @brief Final blur for edge blending (Task 3.3): smooth transitions between combined masks
+ */
+void blur_edges(cv::Mat& mask, const cv::Size& size) {
+    int kernel_size =
+        std::max(3, static_cast<int>(static_cast<float>(size.width) * 0.025F)); // 2.5% of width
+    if (kernel_size % 2 == 0) { kernel_size++; }
+    cv::GaussianBlur(mask, mask, cv::Size(kernel_size, kernel_size), 0);
+}
+
+cv::Mat invert_occlusion(const cv::Mat& occlusion) {
+    // Invert: 255 (occluded) -> 0 (keep original), 0 (clear) -> 255 (swap)
+    cv::Mat inverted;
+    cv::subtract(cv::Scalar(255), occlusion, inverted);
+    return inverted;
+}
+
+} // namespace
+
+cv::Mat MaskCompositor::compose(const CompositionInput& input) {
+    const auto& opts = input.options;
+    const bool box_enabled = has_mask_type(opts, MaskType::Box);
+    const bool occlusion_enabled = has_mask_type(opts, MaskType::Occlusion);
+    const bool region_enabled = has_mask_type(opts, MaskType::Region);
+
+    const bool run_occluder = occlusion_enabled && input.occlusion_mask.empty()
+                           && input.occluder != nullptr && !input.crop_frame.empty();
+    const bool run_region_masker = region_enabled && input.region_mask.empty()
+                                && input.region_masker != nullptr && !input.crop_frame.empty();
+    const bool use_occlusion = run_occluder || (occlusion_enabled && !input.occlusion_mask.empty());
+    const bool use_region = run_region_masker || (region_enabled && !input.region_mask.empty());
+
+    if (!box_enabled && !use_occlusion && !use_region) {
+        // If no mask generated, return full white (swap everything)
+        // Legacy face_helper::paste_back expects CV_32FC1 (0.0-1.0).
+        return cv::Mat::ones(input.size, CV_32FC1);
+    }
+
+    // Box only: the whole result depends on parameters alone
+    if (!use_occlusion && !use_region) {
+        cv::Mat cached =
+            find_box_mask(input.size, opts.box_mask_blur, opts.box_mask_padding, true);
+        if (cached.empty()) {
+            cached = create_box_mask(input.size, opts.box_mask_blur, opts.box_mask_padding);
+            blur_edges(cached, input.size);
+            store_box_mask(input.size, opts.box_mask_blur, opts.box_mask_padding, true, cached);
+        }
+        return cached;
+    }
+
+    // Both models must run: overlap the occluder with the region masker on this thread.
+    // Captures are by value so the task never refers to this stack frame.
+    std::future<cv::Mat> occlusion_future;
+    if (run_occluder && run_region_masker) {
+        auto& pool = foundation::infrastructure::thread_pool::ThreadPool::instance();
+        occlusion_future =
+            pool.enqueue([occluder = input.occluder, crop = input.crop_frame]() -> cv::Mat {
+                return occluder->create_occlusion_mask(crop);
+            });
+    }
+
+    std::vector<cv::Mat> masks;
+    masks.reserve(3);
+
+    if (box_enabled) {
+        cv::Mat box =
+            find_box_mask(input.size, opts.box_mask_blur, opts.box_mask_padding, false);
+        if (box.empty()) {
+            box = create_box_mask(input.size, opts.box_mask_blur, opts.box_mask_padding);
+            store_box_mask(input.size, opts.box_mask_blur, opts.box_mask_padding, false, box);
+        }
+        masks.push_back(box);
+    }
+
+    if (run_region_masker) {
+        const std::unordered_set<types::FaceRegion> kActiveRegions(opts.regions.begin(),
+                                                                   opts.regions.end());
+        masks.push_back(input.region_masker->create_region_mask(input.crop_frame, kActiveRegions));
+    } else if (use_region) {
+        masks.push_back(input.region_mask);
+    }
+
+    if (occlusion_future.valid()) {
+        masks.push_back(invert_occlusion(occlusion_future.get()));
+    } else if (run_occluder) {
+        masks.push_back(invert_occlusion(input.occluder->create_occlusion_mask(input.crop_frame)));
+    } else if (use_occlusion) {
+        masks.push_back(input.occlusion_mask);
+    }
+
+    // Drop empty model outputs (e.g. model not loaded); never fuse into an empty mask
+    std::erase_if(masks, [](const cv::Mat& mask) { return mask.empty(); });
+    if (masks.empty()) { return cv::Mat::ones(input.size, CV_32FC1); }
+
+    cv::Mat final_mask = fuse_min(masks, input.size);
+    blur_edges(final_mask, input.size);
+    return final_mask;
+}
+
+void MaskCompositor::clear_cache() {
+    const std::scoped_lock kLock(g_box_mutex);
+    g_box_masks.clear();
+}
+
+cv::Mat MaskCompositor::create_box_mask(const cv::Size& size, float blur,
+                                        const std::array<int, 4>& padding) {
+    int blur_amount = static_cast<int>(static_cast<float>(size.width) * 0.5F * blur);
+    const int kBlurArea = std::max(blur_amount / 2, 1);
+
+    cv::Mat mask = cv::Mat::ones(size, CV_32FC1);
+
+    const int kPadTop =
+        std::max(kBlurArea, static_cast<int>(static_cast<float>(size.height)
+                                             * static_cast<float>(padding[0]) / 100.0F));
+    const int kPadRight =
+        std::max(kBlurArea, static_cast<int>(static_cast<float>(size.width)
+                                             * static_cast<float>(padding[1]) / 100.0F));
+    const int kPadBot =
+        std::max(kBlurArea, static_cast<int>(static_cast<float>(size.height)
+                                             * static_cast<float>(padding[2]) / 100.0F));
+    const int kPadLeft =
+        std::max(kBlurArea, static_cast<int>(static_cast<float>(size.width)
+                                             * static_cast<float>(padding[3]) / 100.0F));
+
+    // Set borders to 0
+    if (kPadTop > 0) { mask(cv::Rect(0, 0, size.width, kPadTop)) = 0; }
+    if (kPadBot > 0) { mask(cv::Rect(0, size.height - kPadBot, size.width, kPadBot)) = 0; }
+    if (kPadLeft > 0) { mask(cv::Rect(0, 0, kPadLeft, size.height)) = 0; }
+    if (kPadRight > 0) { mask(cv::Rect(size.width - kPadRight, 0, kPadRight, size.height)) = 0; }
+
+    // Blur
+    if (blur_amount > 0) {
+        if (blur_amount % 2 == 0) { blur_amount++; }
+        cv::GaussianBlur(mask, mask, cv::Size(0, 0), blur_amount * 0.25);
+    }
+
+    return mask;
+}
+
+} // namespace domain::face::masker
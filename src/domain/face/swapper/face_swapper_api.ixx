@@ -41,6 +41,24 @@ public:
      */
     virtual cv::Mat swap_face(cv::Mat target_crop, const std::vector<float>& source_embedding) = 0;
 
+    /**
+     * @brief Swap all aligned face crops of a frame with the same source
+     * @details The default swaps the crops one by one; implementations may run them through
+     *          the model as one batch.
+     * @param target_crops Aligned face crops
+     * @param source_embedding Source face embedding
+     * @return Swapped crops, in the order of @p target_crops
+     */
+    virtual std::vector<cv::Mat> swap_face_batch(const std::vector<cv::Mat>& target_crops,
+                                                 const std::vector<float>& source_embedding) {
+        std::vector<cv::Mat> results;
+        results.reserve(target_crops.size());
+        for (const auto& crop : target_crops) {
+            results.push_back(swap_face(crop, source_embedding));
+        }
+        return results;
+    }
+
     /**
      * @brief Get the expected input size for the model
      * @return cv::Size (e.g., 128x128)
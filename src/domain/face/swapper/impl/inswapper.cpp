@@ -3,6 +3,7 @@ module;
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cstddef>
 #include <mutex>
 #include <opencv2/opencv.hpp>
 #include <onnx/onnx_pb.h>
@@ -18,11 +19,17 @@ import :types;
 import :inswapper;
 import domain.face.helper;
 import foundation.ai.inference_session;
+import foundation.ai.tensor_postprocess;
 
 namespace domain::face::swapper {
 
 using namespace domain::face::types;
 using namespace domain::face::helper;
+namespace tensor_postprocess = foundation::ai::tensor_postprocess;
+
+namespace {
+constexpr int kMaxBatch = 8; ///< Faces per call for models with a dynamic batch dimension
+} // namespace
 
 InSwapper::InSwapper() : FaceSwapperImplBase() {}
 
@@ -42,6 +49,14 @@ void InSwapper::init() {
     m_input_height = static_cast<int>(input_dims[0][3]);
     m_size = cv::Size(m_input_width, m_input_height);
 
+    // A fixed batch dimension on any input caps the batch; fully dynamic models take kMaxBatch
+    m_max_batch = kMaxBatch;
+    for (const auto& dims : input_dims) {
+        if (!dims.empty() && dims[0] > 0) {
+            m_max_batch = std::min(m_max_batch, static_cast<int>(dims[0]));
+        }
+    }
+
     // Load ONNX model as a protobuf message for initializer
     onnx::ModelProto modelProto;
     std::ifstream input(get_loaded_model_path(), std::ios::binary);
@@ -100,105 +115,143 @@ cv::Mat InSwapper::swap_face(cv::Mat target_crop, const std::vector<float>& sour
         std::call_once(m_init_flag, [this]() { init(); });
     }
 
-    // Input Size Validation
-    cv::Mat processed_crop = target_crop;
-    if (processed_crop.size() != m_size) { cv::resize(processed_crop, processed_crop, m_size); }
-
     // foundation::infrastructure::logger::ScopedTimer timer("InSwapper::Inference");
-    return apply_swap(source_embedding, processed_crop);
+    auto results = apply_swap(project_embedding(source_embedding), {fit_input(target_crop)});
+    return results.empty() ? cv::Mat() : results.front();
 }
 
-std::tuple<std::vector<float>, std::vector<int64_t>, std::vector<float>, std::vector<int64_t>>
-InSwapper::prepare_input(const domain::face::types::Embedding& source_embedding,
-                         const cv::Mat& cropped_target_frame) const {
-    // 1. Prepare Source Embedding
-    std::vector<float> input_embedding_data;
-    double norm = cv::norm(source_embedding, cv::NORM_L2);
-    size_t lenFeature = source_embedding.size();
-    input_embedding_data.resize(lenFeature);
+std::vector<cv::Mat> InSwapper::swap_face_batch(const std::vector<cv::Mat>& target_crops,
+                                                const std::vector<float>& source_embedding) {
+    std::vector<cv::Mat> results(target_crops.size());
+    if (source_embedding.empty() || target_crops.empty()) { return results; }
 
-    for (size_t i = 0; i < lenFeature; ++i) {
-        double sum = 0.0f;
-        for (size_t j = 0; j < lenFeature; ++j) {
-            // Legacy behavior: M[j * len + i]
-            sum += source_embedding.at(j) * m_initializer_array.at(j * lenFeature + i);
+    if (!is_model_loaded()) { throw std::runtime_error("Model is not loaded!"); }
+    if (m_initializer_array.empty()) {
+        std::call_once(m_init_flag, [this]() { init(); });
+    }
+
+    const std::vector<float> projected = project_embedding(source_embedding);
+
+    // Empty crops keep an empty result and take no batch slot
+    std::vector<std::size_t> indices;
+    std::vector<cv::Mat> batch;
+    auto flush = [&] {
+        auto swapped = apply_swap(projected, batch);
+        for (std::size_t i = 0; i < swapped.size() && i < indices.size(); ++i) {
+            results[indices[i]] = std::move(swapped[i]);
         }
-        input_embedding_data.at(i) = static_cast<float>(sum / norm);
+        indices.clear();
+        batch.clear();
+    };
+    for (std::size_t i = 0; i < target_crops.size(); ++i) {
+        if (target_crops[i].empty()) continue;
+        indices.push_back(i);
+        batch.push_back(fit_input(target_crops[i]));
+        if (static_cast<int>(batch.size()) == m_max_batch) flush();
     }
+    if (!batch.empty()) flush();
+    return results;
+}
 
-    std::vector<int64_t> input_embedding_shape{1,
-                                               static_cast<int64_t>(input_embedding_data.size())};
+cv::Mat InSwapper::fit_input(const cv::Mat& target_crop) const {
+    // Input Size Validation
+    cv::Mat processed_crop = target_crop;
+    if (processed_crop.size() != m_size) { cv::resize(processed_crop, processed_crop, m_size); }
+    return processed_crop;
+}
 
-    // 2. Prepare Target Frame
-    std::vector<cv::Mat> bgrChannels(3);
-    cv::split(cropped_target_frame, bgrChannels);
+std::vector<float> InSwapper::project_embedding(const Embedding& source_embedding) const {
+    const std::scoped_lock kLock(m_projection_mutex);
+    if (!m_projection.empty() && m_projection_source == source_embedding) { return m_projection; }
 
-    // Normalize: (x / 255.0 - mean) / std  => x * (1/(255*std)) - (mean/std)
-    for (int c = 0; c < 3; c++) {
-        bgrChannels[c].convertTo(bgrChannels[c], CV_32FC1, 1.0 / (255.0 * m_standard_deviation[c]),
-                                 -m_mean[c] / m_standard_deviation[c]);
+    const double norm = cv::norm(source_embedding, cv::NORM_L2);
+    const size_t lenFeature = source_embedding.size();
+    if (m_initializer_array.size() < lenFeature * lenFeature) {
+        throw std::runtime_error("Embedding initializer does not match the source embedding.");
+    }
+
+    // Legacy behavior: out[i] = sum_j e[j] * M[j * len + i] / |e|, accumulated row by row
+    std::vector<double> sum(lenFeature, 0.0);
+    for (size_t j = 0; j < lenFeature; ++j) {
+        const double e = source_embedding[j];
+        const float* row = m_initializer_array.data() + j * lenFeature;
+        for (size_t i = 0; i < lenFeature; ++i) { sum[i] += e * row[i]; }
+    }
+
+    m_projection.resize(lenFeature);
+    for (size_t i = 0; i < lenFeature; ++i) {
+        m_projection[i] = static_cast<float>(sum[i] / norm);
     }
+    m_projection_source = source_embedding;
+    return m_projection;
+}
 
-    int imageArea = cropped_target_frame.rows * cropped_target_frame.cols;
-    std::vector<float> input_image_data(3 * imageArea);
-    size_t singleChnSize = imageArea * sizeof(float);
+std::tuple<std::vector<float>, std::vector<int64_t>, std::vector<float>, std::vector<int64_t>>
+InSwapper::prepare_input(const std::vector<float>& projected_embedding,
+                         const std::vector<cv::Mat>& cropped_target_frames) const {
+    const auto count = static_cast<int64_t>(cropped_target_frames.size());
 
-    // CHW format: R, G, B
-    memcpy(input_image_data.data(), (float*)bgrChannels[2].data, singleChnSize);             // R
-    memcpy(input_image_data.data() + imageArea, (float*)bgrChannels[1].data, singleChnSize); // G
-    memcpy(input_image_data.data() + imageArea * 2, (float*)bgrChannels[0].data,
-           singleChnSize); // B
+    // 1. Source embedding, repeated for every face of the batch
+    std::vector<float> input_embedding_data;
+    input_embedding_data.reserve(projected_embedding.size() * cropped_target_frames.size());
+    for (int64_t n = 0; n < count; ++n) {
+        input_embedding_data.insert(input_embedding_data.end(), projected_embedding.begin(),
+                                    projected_embedding.end());
+    }
+    std::vector<int64_t> input_embedding_shape{count,
+                                               static_cast<int64_t>(projected_embedding.size())};
 
-    std::vector<int64_t> input_image_shape = {1, 3, m_input_height, m_input_width};
+    // 2. Target frames, NCHW
+    const size_t imageArea = static_cast<size_t>(m_input_height) * m_input_width;
+    std::vector<float> input_image_data(3 * imageArea * cropped_target_frames.size());
+    std::vector<cv::Mat> bgrChannels(3);
+    for (size_t n = 0; n < cropped_target_frames.size(); ++n) {
+        cv::split(cropped_target_frames[n], bgrChannels);
+        float* planes = input_image_data.data() + n * 3 * imageArea;
+
+        // Normalize: (x / 255.0 - mean) / std  => x * (1/(255*std)) - (mean/std), written
+        // straight into the R, G, B planes
+        for (int c = 0; c < 3; c++) {
+            cv::Mat plane(m_input_height, m_input_width, CV_32FC1, planes + (2 - c) * imageArea);
+            bgrChannels[c].convertTo(plane, CV_32FC1, 1.0 / (255.0 * m_standard_deviation[c]),
+                                     -m_mean[c] / m_standard_deviation[c]);
+        }
+    }
+
+    std::vector<int64_t> input_image_shape = {count, 3, m_input_height, m_input_width};
 
     return std::make_tuple(std::move(input_embedding_data), std::move(input_embedding_shape),
                            std::move(input_image_data), std::move(input_image_shape));
 }
 
-cv::Mat InSwapper::process_output(const std::vector<Ort::Value>& output_tensors) const {
+std::vector<cv::Mat> InSwapper::process_output(const std::vector<Ort::Value>& output_tensors,
+                                               std::size_t count) const {
     if (output_tensors.empty()) return {};
 
-    // Post-process
+    // Post-process: the model output is RGB planes in [0, 1] range
     const float* pdata = output_tensors[0].GetTensorData<float>();
     auto outsShape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
 
-    // Handle dynamic shapes if necessary, but here it's likely fixed 1x3x128x128
+    // Handle dynamic shapes if necessary, but here it's likely fixed Nx3x128x128
     int outputHeight = static_cast<int>(outsShape[2]);
     int outputWidth = static_cast<int>(outsShape[3]);
-    int channelStep = outputHeight * outputWidth;
-    std::vector<cv::Mat> channelMats(3);
-    // Legacy mapping: Plane 0 = R, Plane 2 = B.
-    // Use clone() to ensure we own the data and can modify it
-    channelMats[2] =
-        cv::Mat(outputHeight, outputWidth, CV_32FC1, const_cast<float*>(pdata)).clone(); // R
-    channelMats[1] =
-        cv::Mat(outputHeight, outputWidth, CV_32FC1, const_cast<float*>(pdata) + channelStep)
-            .clone(); // G
-    channelMats[0] =
-        cv::Mat(outputHeight, outputWidth, CV_32FC1, const_cast<float*>(pdata) + 2 * channelStep)
-            .clone(); // B
-
-    // Find Global Min/Max manually (proven to work)
-
-    for (auto& mat : channelMats) {
-        // Simple scaling as the model output is in [0, 1] range.
-        mat *= 255.f;
-
-        // Clamp
-        cv::threshold(mat, mat, 0, 0, cv::THRESH_TOZERO);
-        cv::threshold(mat, mat, 255, 255, cv::THRESH_TRUNC);
-    }
-
-    cv::Mat resultMat;
-    cv::merge(channelMats, resultMat);
-    resultMat.convertTo(resultMat, CV_8UC3);
-    return resultMat;
+    const cv::Size outputSize(outputWidth, outputHeight);
+    count = std::min(count, static_cast<std::size_t>(std::max<int64_t>(outsShape[0], 0)));
+
+    std::vector<cv::Mat> results;
+    results.reserve(count);
+    for (std::size_t n = 0; n < count; ++n) {
+        results.push_back(
+            tensor_postprocess::planar_to_bgr(pdata + n * 3 * outputSize.area(), outputSize));
+    }
+    return results;
 }
 
-cv::Mat InSwapper::apply_swap(const Embedding& source_embedding,
-                              const cv::Mat& cropped_target_frame) const {
+std::vector<cv::Mat> InSwapper::apply_swap(
+    const std::vector<float>& projected_embedding,
+    const std::vector<cv::Mat>& cropped_target_frames) const {
     auto [input_embedding, embedding_shape, input_image, image_shape] =
-        prepare_input(source_embedding, cropped_target_frame);
+        prepare_input(projected_embedding, cropped_target_frames);
 
     std::vector<Ort::Value> inputTensors;
 
@@ -220,7 +273,7 @@ cv::Mat InSwapper::apply_swap(const Embedding& source_embedding,
 
     auto outputTensors = this->run(inputTensors);
 
-    return process_output(outputTensors);
+    return process_output(outputTensors, cropped_target_frames.size());
 }
 
 } // namespace domain::face::swapper
@@ -1,4 +1,5 @@
 module;
+#include <cstddef>
 #include <vector>
 #include <string>
 #include <memory>
@@ -24,29 +25,50 @@ public:
 
     cv::Mat swap_face(cv::Mat target_crop, const std::vector<float>& source_embedding) override;
 
+    /**
+     * @brief Swap all crops in batches of up to the model's batch size (dynamic: 8)
+     */
+    std::vector<cv::Mat> swap_face_batch(const std::vector<cv::Mat>& target_crops,
+                                         const std::vector<float>& source_embedding) override;
+
     [[nodiscard]] cv::Size get_model_input_size() const override { return m_size; }
 
 private:
     void init();
 
+    /**
+     * @brief Source embedding mapped through the model's embedding initializer, cached for the
+     *        last source seen
+     */
+    [[nodiscard]] std::vector<float> project_embedding(
+        const domain::face::types::Embedding& source_embedding) const;
+
     [[nodiscard]] std::tuple<std::vector<float>, std::vector<int64_t>, std::vector<float>,
                              std::vector<int64_t>>
-    prepare_input(const domain::face::types::Embedding& source_embedding,
-                  const cv::Mat& cropped_target_frame) const;
-    [[nodiscard]] cv::Mat process_output(const std::vector<Ort::Value>& output_tensors) const;
+    prepare_input(const std::vector<float>& projected_embedding,
+                  const std::vector<cv::Mat>& cropped_target_frames) const;
+    [[nodiscard]] std::vector<cv::Mat> process_output(
+        const std::vector<Ort::Value>& output_tensors, std::size_t count) const;
 
-    // Helper to orchestrate the swap for a single face
-    [[nodiscard]] cv::Mat apply_swap(const domain::face::types::Embedding& source_embedding,
-                                     const cv::Mat& cropped_target_frame) const;
+    // Helper to orchestrate the swap for one batch of faces
+    [[nodiscard]] std::vector<cv::Mat> apply_swap(
+        const std::vector<float>& projected_embedding,
+        const std::vector<cv::Mat>& cropped_target_frames) const;
+    [[nodiscard]] cv::Mat fit_input(const cv::Mat& target_crop) const;
 
 private:
     cv::Size m_size{0, 0};
     int m_input_width = 0;
     int m_input_height = 0;
+    int m_max_batch = 1; ///< Faces per inference
     std::vector<float> m_mean = {0.0F, 0.0F, 0.0F};
     std::vector<float> m_standard_deviation = {1.0F, 1.0F, 1.0F};
     std::vector<float> m_initializer_array;
     std::once_flag m_init_flag;
+
+    mutable std::mutex m_projection_mutex;
+    mutable domain::face::types::Embedding m_projection_source;
+    mutable std::vector<float> m_projection;
 };
 
 } // namespace domain::face::swapper
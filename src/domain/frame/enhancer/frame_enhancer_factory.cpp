@@ -15,12 +15,14 @@ namespace domain::frame::enhancer {
 
 std::shared_ptr<IFrameEnhancer> FrameEnhancerFactory::create(
     FrameEnhancerType type, const std::string& model_name,
-    const foundation::ai::inference_session::Options& options) {
+    const foundation::ai::inference_session::Options& options, int tile_size_override,
+    bool autotune_tiles) {
     auto repo = domain::ai::model_repository::ModelRepository::get_instance();
     std::string model_path = repo->ensure_model(model_name);
 
     int scale = 4;                             // default
     std::vector<int> tile_size = {256, 16, 8}; // default
+    if (tile_size_override > 0) { tile_size[0] = tile_size_override; }
 
     if (type == FrameEnhancerType::RealEsrGan) {
         if (model_name == "real_esrgan_x2" || model_name == "real_esrgan_x2_fp16") {
@@ -41,7 +43,8 @@ std::shared_ptr<IFrameEnhancer> FrameEnhancerFactory::create(
         return nullptr;
     }
 
-    return std::make_shared<FrameEnhancerImpl>(model_path, options, tile_size, scale);
+    return std::make_shared<FrameEnhancerImpl>(model_path, options, tile_size, scale,
+                                               autotune_tiles);
 }
 
 } // namespace domain::frame::enhancer
@@ -12,9 +12,15 @@ export namespace domain::frame::enhancer {
 
 class FrameEnhancerFactory {
 public:
+    /**
+     * @param tile_size      Inference tile edge in pixels, 0 for the model default (256)
+     * @param autotune_tiles Refine tile size and batching from a calibration run on the first
+     *                       frame; otherwise @p tile_size is used as given
+     */
     static std::shared_ptr<IFrameEnhancer> create(
         FrameEnhancerType type, const std::string& model_name,
-        const foundation::ai::inference_session::Options& options);
+        const foundation::ai::inference_session::Options& options, int tile_size = 0,
+        bool autotune_tiles = true);
 };
 
 } // namespace domain::frame::enhancer
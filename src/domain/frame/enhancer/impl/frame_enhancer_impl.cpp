@@ -1,72 +1,284 @@
 module;
 #include <algorithm>
-#include <iostream>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <future>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <opencv2/opencv.hpp>
 #include <onnxruntime_cxx_api.h>
+#include <tuple>
 #include <vector>
 
 module domain.frame.enhancer;
 
 import :impl;
-import foundation.media.vision;
 import foundation.ai.inference_session;
 import foundation.ai.inference_session_registry;
+import foundation.ai.tensor_postprocess;
+import foundation.infrastructure.logger;
+import foundation.infrastructure.thread_pool;
 
 namespace domain::frame::enhancer {
 
+namespace {
+
+constexpr int kMaxBatch = 4;
+constexpr int kBatchPixelBudget = 4 * 256 * 256; ///< Input pixels per call (4 default tiles)
+
+/**
+ * @brief Tile grid over the padded frame, same geometry as vision::create_tile_frames
+ */
+struct TileGrid {
+    int pad_top_left = 0; ///< pad + overlap
+    int pad_bottom = 0;
+    int pad_right = 0;
+    std::vector<cv::Rect> tiles; ///< Input tiles in padded-frame coordinates
+};
+
+TileGrid make_grid(const cv::Size& frame_size, const std::vector<int>& size) {
+    const int pad = size[1];
+    const int overlap = size[2];
+    const int tile_width = size[0] - 2 * overlap;
+
+    TileGrid grid;
+    grid.pad_top_left = pad + overlap;
+    grid.pad_bottom = pad + overlap + tile_width - ((frame_size.height + 2 * pad) % tile_width);
+    grid.pad_right = pad + overlap + tile_width - ((frame_size.width + 2 * pad) % tile_width);
+
+    const int pad_height = frame_size.height + grid.pad_top_left + grid.pad_bottom;
+    const int pad_width = frame_size.width + grid.pad_top_left + grid.pad_right;
+    for (int row = overlap; row <= pad_height - overlap - tile_width; row += tile_width) {
+        for (int col = overlap; col <= pad_width - overlap - tile_width; col += tile_width) {
+            grid.tiles.emplace_back(col - overlap, row - overlap, size[0], size[0]);
+        }
+    }
+    return grid;
+}
+
+/**
+ * @brief Overlap for an autotuned tile: never below the configured one, and at least the
+ *        default 8 / 256 seam-to-tile ratio
+ */
+std::vector<int> scaled_tile_size(const std::vector<int>& base, int tile) {
+    return {tile, base[1], std::max(base[2], tile / 32)};
+}
+
+/**
+ * @brief Calibrated schedules shared by all enhancers of a session
+ * @details Keyed by session, configured tile size and frame size. The session is held weakly so
+ *          that a new session allocated at the address of an evicted one is not mistaken for it.
+ */
+struct CachedSchedule {
+    std::weak_ptr<foundation::ai::inference_session::InferenceSession> session;
+    FrameEnhancerImpl::TileSchedule schedule;
+};
+using ScheduleKey = std::tuple<const void*, std::vector<int>, int, int>;
+
+std::mutex g_schedule_mutex; ///< Also serializes calibration runs so they do not skew each other
+std::map<ScheduleKey, CachedSchedule> g_schedules;
+
+Ort::Value make_tensor(std::vector<float>& data, const std::vector<int64_t>& shape) {
+    // Use memory info from Ort::MemoryInfo directly since wrapper doesn't expose it
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    return Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape.data(),
+                                           shape.size());
+}
+
+} // namespace
+
 FrameEnhancerImpl::FrameEnhancerImpl(const std::string& model_path,
                                      const foundation::ai::inference_session::Options& options,
-                                     const std::vector<int>& tile_size, int model_scale) :
-    m_tile_size(tile_size), m_model_scale(model_scale) {
+                                     const std::vector<int>& tile_size, int model_scale,
+                                     bool autotune_tiles) :
+    m_model_scale(model_scale), m_autotune_tiles(autotune_tiles), m_schedule{tile_size, 1} {
     m_session =
         foundation::ai::inference_session::InferenceSessionRegistry::get_instance()->get_session(
             model_path, options);
+
+    const auto input_dims = m_session ? m_session->get_input_node_dims()
+                                      : std::vector<std::vector<int64_t>>{};
+    if (!input_dims.empty() && input_dims[0].size() == 4) {
+        const auto& dims = input_dims[0];
+        m_max_batch = dims[0] > 0 ? static_cast<int>(dims[0]) : kMaxBatch;
+        m_fixed_batch = dims[0] > 1;
+        if (dims[2] > 0 && dims[2] == dims[3]) { m_fixed_tile = static_cast<int>(dims[2]); }
+    }
+    m_schedule.batch_size = batch_limit(tile_size[0]);
 }
 
-cv::Mat FrameEnhancerImpl::enhance_frame(const FrameEnhancerInput& input) const {
-    if (input.target_frame.empty()) { return {}; }
+FrameEnhancerImpl::TileSchedule FrameEnhancerImpl::schedule() const {
+    return m_schedule;
+}
+
+int FrameEnhancerImpl::batch_limit(int tile) const {
+    if (m_fixed_batch || m_max_batch <= 1) return m_max_batch;
+    return std::clamp(kBatchPixelBudget / std::max(tile * tile, 1), 1, m_max_batch);
+}
+
+void FrameEnhancerImpl::calibrate(const cv::Size& frame_size) const {
+    const std::vector<int> base = m_schedule.tile_size;
+    const ScheduleKey key{m_session.get(), base, frame_size.width, frame_size.height};
+
+    // Enhancers created later for the same model and frame size (new workers, next target)
+    // take over the schedule instead of calibrating again
+    std::lock_guard lock(g_schedule_mutex);
+    if (const auto it = g_schedules.find(key);
+        it != g_schedules.end() && it->second.session.lock() == m_session) {
+        m_schedule = it->second.schedule;
+        return;
+    }
+
+    std::vector<int> candidates;
+    if (m_fixed_tile > 0) {
+        candidates = {m_fixed_tile};
+    } else {
+        candidates = {base[0] / 2, base[0], base[0] * 3 / 2, base[0] * 2};
+    }
+
+    double best_cost = std::numeric_limits<double>::max();
+    TileSchedule best = m_schedule;
+    for (const int tile : candidates) {
+        const std::vector<int> size = scaled_tile_size(base, tile);
+        if (tile - 2 * size[2] <= 0) continue;
+        const auto tile_count = static_cast<int>(make_grid(frame_size, size).tiles.size());
+
+        std::vector<int> batches{batch_limit(tile)};
+        if (!m_fixed_batch && batches[0] > 1 && tile_count > 1) batches.insert(batches.begin(), 1);
+        for (const int batch : batches) {
+            std::vector<float> data(static_cast<std::size_t>(batch) * 3 * tile * tile, 0.0F);
+            const std::vector<int64_t> shape{batch, 3, tile, tile};
+            std::vector<Ort::Value> inputs;
+            inputs.push_back(make_tensor(data, shape));
 
-    const int temp_width = input.target_frame.cols;
-    const int temp_height = input.target_frame.rows;
+            try {
+                (void)m_session->run(inputs); // Warm-up: first call per shape pays for allocation
+                const auto start = std::chrono::steady_clock::now();
+                (void)m_session->run(inputs);
+                const std::chrono::duration<double> elapsed =
+                    std::chrono::steady_clock::now() - start;
 
-    auto [tile_vision_frames, pad_width, pad_height] =
-        foundation::media::vision::create_tile_frames(input.target_frame, m_tile_size);
+                // Estimated cost of a whole frame with this layout
+                const double cost = elapsed.count() * ((tile_count + batch - 1) / batch);
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best = {size, batch};
+                }
+            } catch (const std::exception&) {
+                // Shape rejected by the model or out of memory: not a candidate
+            }
+        }
+    }
 
-    for (auto& tile_frame : tile_vision_frames) {
-        std::vector<float> input_image_data = get_input_data(tile_frame);
-        std::vector<int64_t> input_shape{1, 3, tile_frame.rows, tile_frame.cols};
+    m_schedule = best;
+    g_schedules[key] = {m_session, best};
+    foundation::infrastructure::logger::Logger::get_instance()->info(
+        std::format("FrameEnhancer tiles: size={} overlap={} batch={}", best.tile_size[0],
+                    best.tile_size[2], best.batch_size));
+}
 
-        // Use memory info from Ort::MemoryInfo directly since wrapper doesn't expose it
-        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+cv::Mat FrameEnhancerImpl::enhance_frame(const FrameEnhancerInput& input) const {
+    if (input.target_frame.empty()) { return {}; }
+    if (m_autotune_tiles) {
+        std::call_once(m_calibrated, [&] { calibrate(input.target_frame.size()); });
+    }
 
-        std::vector<Ort::Value> input_tensors;
-        input_tensors.emplace_back(Ort::Value::CreateTensor<float>(
-            memory_info, input_image_data.data(), input_image_data.size(), input_shape.data(),
-            input_shape.size()));
+    const cv::Mat& frame = input.target_frame;
+    const std::vector<int>& size = m_schedule.tile_size;
+    const int tile = size[0];
+    const int pad = size[1];
+    const int overlap = size[2];
+    const int tile_width = tile - 2 * overlap;
+    const int scale = m_model_scale;
+    const int batch_size = m_schedule.batch_size;
 
-        // Run
-        std::vector<Ort::Value> output_tensors = m_session->run(input_tensors);
+    const TileGrid grid = make_grid(frame.size(), size);
+    cv::Mat padded;
+    cv::copyMakeBorder(frame, padded, grid.pad_top_left, grid.pad_bottom, grid.pad_top_left,
+                       grid.pad_right, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
 
-        if (output_tensors.empty()) continue;
+    // Each tile's interior goes straight into its place on the output canvas
+    cv::Mat output_image = cv::Mat::zeros(frame.rows * scale, frame.cols * scale, CV_8UC3);
+    const cv::Rect frame_rect(0, 0, frame.cols, frame.rows);
+    const std::size_t tile_floats = static_cast<std::size_t>(3) * tile * tile;
+    const std::size_t tile_count = grid.tiles.size();
 
-        const float* output_data = output_tensors[0].GetTensorMutableData<float>();
-        auto type_info = output_tensors[0].GetTensorTypeAndShapeInfo();
-        auto shape = type_info.GetShape();
+    auto prepare = [&](std::size_t first) {
+        const std::size_t count = std::min<std::size_t>(batch_size, tile_count - first);
+        // A model with a fixed batch dimension always receives full (zero-padded) batches
+        std::vector<float> data((m_fixed_batch ? batch_size : count) * tile_floats, 0.0F);
+        for (std::size_t i = 0; i < count; ++i) {
+            get_input_data(padded(grid.tiles[first + i]), data.data() + i * tile_floats);
+        }
+        return data;
+    };
 
-        // shape is usually [1, 3, height, width]
+    auto write = [&](const std::shared_ptr<std::vector<Ort::Value>>& outputs, std::size_t first) {
+        const auto shape = (*outputs)[0].GetTensorTypeAndShapeInfo().GetShape();
         const int output_height = static_cast<int>(shape[2]);
         const int output_width = static_cast<int>(shape[3]);
+        const cv::Size output_size(output_width, output_height);
+        const float* output_data = (*outputs)[0].GetTensorData<float>();
+        const std::size_t count = std::min<std::size_t>(
+            {static_cast<std::size_t>(batch_size), tile_count - first,
+             static_cast<std::size_t>(std::max<int64_t>(shape[0], 0))});
 
-        cv::Mat output_image = get_output_data(output_data, cv::Size(output_width, output_height));
-        tile_frame = std::move(output_image);
-    }
+        for (std::size_t i = 0; i < count; ++i) {
+            // Interior of the tile in frame coordinates, clipped to the frame
+            const cv::Rect& rect = grid.tiles[first + i];
+            const cv::Rect interior(rect.x - pad, rect.y - pad, tile_width, tile_width);
+            const cv::Rect visible = interior & frame_rect;
+            if (visible.empty()) continue;
 
-    cv::Mat output_image = foundation::media::vision::merge_tile_frames(
-        tile_vision_frames, temp_width * m_model_scale, temp_height * m_model_scale,
-        pad_width * m_model_scale, pad_height * m_model_scale,
-        {m_tile_size[0] * m_model_scale, m_tile_size[1] * m_model_scale,
-         m_tile_size[2] * m_model_scale});
+            const cv::Rect source =
+                cv::Rect((overlap + visible.x - interior.x) * scale,
+                         (overlap + visible.y - interior.y) * scale, visible.width * scale,
+                         visible.height * scale)
+                & cv::Rect(cv::Point(), output_size);
+            if (source.empty()) continue;
+            cv::Mat target = output_image(
+                cv::Rect(visible.x * scale, visible.y * scale, source.width, source.height));
+            foundation::ai::tensor_postprocess::planar_to_bgr(
+                output_data + i * 3 * output_size.area(), output_size, source, target);
+        }
+    };
+
+    // Overlap preprocessing of the next batch and postprocessing of the previous one with the
+    // inference of the current batch
+    auto& pool = foundation::infrastructure::thread_pool::ThreadPool::instance();
+    std::future<std::vector<float>> next_input;
+    std::vector<std::future<void>> writes;
+    auto wait_all = [&] {
+        if (next_input.valid()) next_input.wait();
+        for (auto& pending : writes) pending.wait();
+    };
+
+    try {
+        if (tile_count > 0) next_input = pool.enqueue(prepare, std::size_t{0});
+        for (std::size_t first = 0; first < tile_count; first += batch_size) {
+            std::vector<float> input_data = next_input.get();
+            if (first + batch_size < tile_count) {
+                next_input = pool.enqueue(prepare, first + batch_size);
+            }
+
+            const auto batch = static_cast<int64_t>(input_data.size() / tile_floats);
+            const std::vector<int64_t> input_shape{batch, 3, tile, tile};
+            std::vector<Ort::Value> input_tensors;
+            input_tensors.push_back(make_tensor(input_data, input_shape));
+
+            auto outputs =
+                std::make_shared<std::vector<Ort::Value>>(m_session->run(input_tensors));
+            if (outputs->empty()) continue;
+            writes.push_back(pool.enqueue(write, outputs, first));
+        }
+    } catch (...) {
+        wait_all();
+        throw;
+    }
+    for (auto& pending : writes) pending.get();
 
     if (input.blend > 100) {
         output_image = blend_frame(input.target_frame, output_image, 100);
@@ -86,40 +298,16 @@ cv::Mat FrameEnhancerImpl::blend_frame(const cv::Mat& temp_frame, const cv::Mat&
     return result;
 }
 
-std::vector<float> FrameEnhancerImpl::get_input_data(const cv::Mat& frame) {
+void FrameEnhancerImpl::get_input_data(const cv::Mat& frame, float* input_data) {
     std::vector<cv::Mat> bgr_channels(3);
     cv::split(frame, bgr_channels);
-    for (int c = 0; c < 3; c++) {
-        bgr_channels[c].convertTo(bgr_channels[c], CV_32FC1, 1.0 / 255.0);
-    }
-
-    const int image_area = frame.rows * frame.cols;
-    std::vector<float> input_image_data(3 * image_area);
-    const size_t single_chn_size = image_area * sizeof(float);
-    memcpy(input_image_data.data(), (float*)bgr_channels[2].data, single_chn_size); // R
-    memcpy(input_image_data.data() + image_area, (float*)bgr_channels[1].data,
-           single_chn_size); // G
-    memcpy(input_image_data.data() + image_area * 2, (float*)bgr_channels[0].data,
-           single_chn_size); // B
-    return input_image_data;
-}
 
-cv::Mat FrameEnhancerImpl::get_output_data(const float* output_data, const cv::Size& size) {
-    const long long channel_step = size.width * size.height;
-    cv::Mat output_image(size, CV_32FC3);
-
-    auto* output_ptr = output_image.ptr<float>();
-    // #pragma omp parallel for // Removed OMP for now, can add back if needed
-    for (long long i = 0; i < channel_step; ++i) {
-        // B, G, R order for OpenCV
-        output_ptr[i * 3] =
-            std::clamp(output_data[channel_step * 2 + i] * 255.0f, 0.0f, 255.0f); // B
-        output_ptr[i * 3 + 1] =
-            std::clamp(output_data[channel_step + i] * 255.0f, 0.0f, 255.0f);      // G
-        output_ptr[i * 3 + 2] = std::clamp(output_data[i] * 255.0f, 0.0f, 255.0f); // R
+    // Normalise each channel straight into its RGB plane of the batch tensor
+    const std::size_t image_area = static_cast<std::size_t>(frame.rows) * frame.cols;
+    for (int c = 0; c < 3; c++) {
+        cv::Mat plane(frame.size(), CV_32FC1, input_data + (2 - c) * image_area);
+        bgr_channels[c].convertTo(plane, CV_32F, 1.0 / 255.0);
     }
-
-    return output_image;
 }
 
 } // namespace domain::frame::enhancer
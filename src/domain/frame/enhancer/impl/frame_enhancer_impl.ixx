@@ -1,5 +1,6 @@
 module;
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <opencv2/opencv.hpp>
@@ -14,21 +15,49 @@ export namespace domain::frame::enhancer {
 
 class FrameEnhancerImpl : public IFrameEnhancer {
 public:
+    /**
+     * @brief Tile layout used for inference
+     */
+    struct TileSchedule {
+        std::vector<int> tile_size; ///< {tile, pad, overlap} as in create_tile_frames
+        int batch_size = 1;         ///< Tiles per inference call
+    };
+
+    /**
+     * @param autotune_tiles Choose tile size and batch size from a short calibration run on the
+     *                       first frame instead of using @p tile_size as given. The result is
+     *                       cached per session, tile size and frame size, so later enhancers
+     *                       for the same model skip the calibration.
+     */
     FrameEnhancerImpl(const std::string& model_path,
                       const foundation::ai::inference_session::Options& options,
-                      const std::vector<int>& tile_size, int model_scale);
+                      const std::vector<int>& tile_size, int model_scale,
+                      bool autotune_tiles = false);
 
     [[nodiscard]] cv::Mat enhance_frame(const FrameEnhancerInput& input) const override;
 
+    /**
+     * @brief Current schedule; final once the first frame has been enhanced
+     */
+    [[nodiscard]] TileSchedule schedule() const;
+
 private:
-    std::vector<int> m_tile_size;
     int m_model_scale;
+    int m_max_batch = 1;       ///< Largest batch the model input accepts
+    bool m_fixed_batch = false; ///< The model requires exactly m_max_batch tiles per call
+    int m_fixed_tile = 0;      ///< Spatial size required by the model, 0 if dynamic
+    bool m_autotune_tiles;
     std::shared_ptr<foundation::ai::inference_session::InferenceSession> m_session;
 
+    mutable std::once_flag m_calibrated;
+    mutable TileSchedule m_schedule;
+
+    void calibrate(const cv::Size& frame_size) const;
+    [[nodiscard]] int batch_limit(int tile) const;
+
     [[nodiscard]] static cv::Mat blend_frame(const cv::Mat& temp_frame, const cv::Mat& merged_frame,
                                              int blend);
-    [[nodiscard]] static std::vector<float> get_input_data(const cv::Mat& frame);
-    [[nodiscard]] static cv::Mat get_output_data(const float* output_data, const cv::Size& size);
+    static void get_input_data(const cv::Mat& frame, float* input_data);
 };
 
 } // namespace domain::frame::enhancer
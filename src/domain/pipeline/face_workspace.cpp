@@ -0,0 +1,236 @@
+/**
+ ******************************************************************************
+ * @file           : face_workspace.cpp
+ * @brief          : Per-frame face workspace implementation
+ ******************************************************************************
+ */
+
+module;
+#include <algorithm>
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+module domain.pipeline;
+
+import domain.face;
+import domain.face.helper;
+import domain.face.masker;
+
+namespace domain::pipeline {
+
+namespace {
+
+using face::helper::WarpTemplateType;
+
+// Canonical space for mask model inputs: the widest template at the parser's native size
+constexpr WarpTemplateType kMaskTemplate = WarpTemplateType::Ffhq512;
+const cv::Size kMaskSize{512, 512};
+
+bool has_mask_type(const face::types::MaskOptions& options, face::types::MaskType type) {
+    return std::ranges::find(options.mask_types, type) != options.mask_types.end();
+}
+
+/**
+ * @brief Map a mask from the canonical crop into the crop described by @p target_affine
+ */
+cv::Mat transfer_mask(const cv::Mat& mask, const cv::Mat& canonical_affine,
+                      const cv::Mat& target_affine, const cv::Size& target_size) {
+    // target <- frame <- canonical: T * inverse(C), both as 3x3 homogeneous matrices
+    cv::Mat canonical = cv::Mat::eye(3, 3, CV_64F);
+    cv::Mat target = cv::Mat::eye(3, 3, CV_64F);
+    canonical_affine.convertTo(canonical.rowRange(0, 2), CV_64F);
+    target_affine.convertTo(target.rowRange(0, 2), CV_64F);
+    const cv::Mat target_from_canonical = target * canonical.inv();
+
+    cv::Mat result;
+    cv::warpAffine(mask, result, target_from_canonical.rowRange(0, 2), target_size,
+                   cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+    return result;
+}
+
+} // namespace
+
+FaceWorkspace::FaceEntry& FaceWorkspace::face(const face::types::Landmarks& landmarks) {
+    for (auto& entry : m_faces) {
+        if (entry.landmarks == landmarks) return entry;
+    }
+    m_faces.push_back({.landmarks = landmarks});
+    return m_faces.back();
+}
+
+FaceWorkspace::WarpEntry& FaceWorkspace::warp(FaceEntry& entry, const cv::Mat& image,
+                                              WarpTemplateType template_type,
+                                              const cv::Size& size) {
+    auto it = std::ranges::find_if(entry.warps, [&](const WarpEntry& w) {
+        return w.template_type == template_type && w.size == size;
+    });
+    if (it == entry.warps.end()) {
+        WarpEntry warp_entry{template_type, size, {}, {}};
+        warp_entry.affine = face::helper::estimate_matrix_by_face_landmark_5(
+            entry.landmarks, face::helper::get_warp_template(template_type), size);
+        entry.warps.push_back(std::move(warp_entry));
+        it = std::prev(entry.warps.end());
+    }
+
+    if (it->crop.empty()) {
+        // Same sampling as helper::warp_face_by_face_landmarks_5
+        cv::warpAffine(image, it->crop, it->affine, size, cv::INTER_AREA, cv::BORDER_REPLICATE);
+        ++m_stats.warps;
+    }
+    return *it;
+}
+
+FaceWorkspace::Crop FaceWorkspace::crop(const cv::Mat& image,
+                                        const face::types::Landmarks& landmarks,
+                                        WarpTemplateType template_type, const cv::Size& size) {
+    const auto& entry = warp(face(landmarks), image, template_type, size);
+    return {entry.crop, entry.affine};
+}
+
+cv::Mat FaceWorkspace::region_mask(FaceEntry& entry, const cv::Mat& canonical_crop,
+                                   const std::vector<face::types::FaceRegion>& regions,
+                                   face::masker::IFaceRegionMasker& region_masker) {
+    const std::unordered_set<face::types::FaceRegion> active(regions.begin(), regions.end());
+
+    if (!entry.labels_ready) {
+        entry.region_labels = region_masker.create_region_labels(canonical_crop);
+        entry.labels_ready = true;
+        if (!entry.region_labels.empty()) ++m_stats.region_inferences;
+    }
+    if (!entry.region_labels.empty()) {
+        return region_masker.select_regions(entry.region_labels, active);
+    }
+
+    // Masker without label maps: one inference per distinct region set
+    for (const auto& cached : entry.regions) {
+        if (cached.regions == regions) return cached.mask;
+    }
+    cv::Mat mask = region_masker.create_region_mask(canonical_crop, active);
+    ++m_stats.region_inferences;
+    entry.regions.push_back({regions, mask});
+    return mask;
+}
+
+cv::Mat FaceWorkspace::compose_mask(const cv::Mat& image, const face::types::Landmarks& landmarks,
+                                    WarpTemplateType template_type, const cv::Size& size,
+                                    const face::types::MaskOptions& options,
+                                    face::masker::IFaceOccluder* occluder,
+                                    face::masker::IFaceRegionMasker* region_masker) {
+    auto& entry = face(landmarks);
+    for (const auto& cached : entry.composed) {
+        if (cached.template_type == template_type && cached.size == size
+            && cached.options == options) {
+            return cached.mask;
+        }
+    }
+
+    const bool need_occlusion =
+        occluder != nullptr && has_mask_type(options, face::types::MaskType::Occlusion);
+    const bool need_region =
+        region_masker != nullptr && has_mask_type(options, face::types::MaskType::Region);
+
+    face::masker::MaskCompositor::CompositionInput input;
+    input.size = size;
+    input.options = options;
+
+    if (need_occlusion || need_region) {
+        // Copy what we need from the canonical entry: warp() may reallocate entry.warps
+        const auto& canonical_entry = warp(entry, image, kMaskTemplate, kMaskSize);
+        const cv::Mat canonical_crop = canonical_entry.crop;
+        const cv::Mat canonical_affine = canonical_entry.affine;
+        const cv::Mat target_affine = warp(entry, image, template_type, size).affine;
+        const bool same_space = template_type == kMaskTemplate && size == kMaskSize;
+        auto to_target = [&](const cv::Mat& mask) {
+            return same_space ? mask : transfer_mask(mask, canonical_affine, target_affine, size);
+        };
+
+        if (need_occlusion) {
+            if (!entry.occlusion_ready) {
+                const cv::Mat occlusion = occluder->create_occlusion_mask(canonical_crop);
+                cv::subtract(cv::Scalar(255), occlusion, entry.occlusion);
+                entry.occlusion_ready = true;
+                ++m_stats.occlusion_inferences;
+            }
+            input.occlusion_mask = to_target(entry.occlusion);
+        }
+        if (need_region) {
+            input.region_mask =
+                to_target(region_mask(entry, canonical_crop, options.regions, *region_masker));
+        }
+    }
+
+    cv::Mat mask = face::masker::MaskCompositor::compose(input);
+    entry.composed.push_back({template_type, size, options, mask});
+    return mask;
+}
+
+void FaceWorkspace::prepare_masks(const cv::Mat& image,
+                                  const std::vector<face::types::Landmarks>& faces,
+                                  const face::types::MaskOptions& options,
+                                  face::masker::IFaceOccluder* occluder,
+                                  face::masker::IFaceRegionMasker* region_masker) {
+    const bool need_occlusion =
+        occluder != nullptr && has_mask_type(options, face::types::MaskType::Occlusion);
+    const bool need_region =
+        region_masker != nullptr && has_mask_type(options, face::types::MaskType::Region);
+    if (!need_occlusion && !need_region) return;
+
+    // Indices, not references: face() may reallocate m_faces
+    std::vector<std::size_t> occlusion_faces;
+    std::vector<std::size_t> label_faces;
+    std::vector<cv::Mat> occlusion_crops;
+    std::vector<cv::Mat> label_crops;
+    for (const auto& landmarks : faces) {
+        const auto index = static_cast<std::size_t>(&face(landmarks) - m_faces.data());
+        auto& entry = m_faces[index];
+        const bool occlusion = need_occlusion && !entry.occlusion_ready
+                            && std::ranges::find(occlusion_faces, index) == occlusion_faces.end();
+        const bool labels = need_region && !entry.labels_ready
+                         && std::ranges::find(label_faces, index) == label_faces.end();
+        if (!occlusion && !labels) continue;
+
+        const cv::Mat canonical_crop = warp(entry, image, kMaskTemplate, kMaskSize).crop;
+        if (occlusion) {
+            occlusion_faces.push_back(index);
+            occlusion_crops.push_back(canonical_crop);
+        }
+        if (labels) {
+            label_faces.push_back(index);
+            label_crops.push_back(canonical_crop);
+        }
+    }
+
+    if (!occlusion_crops.empty()) {
+        const auto masks = occluder->create_occlusion_mask_batch(occlusion_crops);
+        for (std::size_t i = 0; i < occlusion_faces.size() && i < masks.size(); ++i) {
+            auto& entry = m_faces[occlusion_faces[i]];
+            cv::subtract(cv::Scalar(255), masks[i], entry.occlusion);
+            entry.occlusion_ready = true;
+            ++m_stats.occlusion_inferences;
+        }
+    }
+    if (!label_crops.empty()) {
+        const auto labels = region_masker->create_region_labels_batch(label_crops);
+        for (std::size_t i = 0; i < label_faces.size() && i < labels.size(); ++i) {
+            auto& entry = m_faces[label_faces[i]];
+            entry.region_labels = labels[i];
+            entry.labels_ready = true;
+            if (!entry.region_labels.empty()) ++m_stats.region_inferences;
+        }
+    }
+}
+
+void FaceWorkspace::invalidate_crops() {
+    for (auto& entry : m_faces) {
+        for (auto& warp_entry : entry.warps) { warp_entry.crop.release(); }
+    }
+}
+
+void FaceWorkspace::clear() {
+    m_faces.clear();
+}
+
+} // namespace domain::pipeline
@@ -0,0 +1,138 @@
+/**
+ * @file face_workspace.ixx
+ * @brief Per-frame face geometry, crop and mask cache shared by the face processing steps
+ * @author CodingRookie
+ * @date 2026-10-18
+ */
+module;
+#include <cstddef>
+#include <vector>
+#include <opencv2/core.hpp>
+
+export module domain.pipeline:face_workspace;
+
+import domain.face;
+import domain.face.helper;
+import domain.face.masker;
+
+export namespace domain::pipeline {
+
+/**
+ * @brief Per-frame workspace reused by the swapper, face enhancer and expression steps
+ * @details Faces are identified by their 5-point landmarks. For each face the workspace keeps:
+ *          - the frame -> crop affine matrix per (warp template, crop size);
+ *          - the warped crops, until the frame pixels change (invalidate_crops());
+ *          - the occlusion and face-parsing model outputs, computed once on a canonical
+ *            FFHQ-512 crop and re-warped into every step's crop space;
+ *          - the composed masks per (template, size, mask options).
+ *          Model outputs describe scene geometry and therefore survive paste-back, so every
+ *          face costs at most one occlusion and one region inference per frame however many
+ *          steps are enabled.
+ */
+class FaceWorkspace {
+public:
+    /**
+     * @brief Aligned face crop
+     */
+    struct Crop {
+        cv::Mat frame;  ///< Warped crop (BGR)
+        cv::Mat affine; ///< 2x3 frame -> crop transform
+    };
+
+    /**
+     * @brief Work actually performed through this workspace
+     */
+    struct Stats {
+        std::size_t warps = 0;                ///< Crops warped from the frame
+        std::size_t occlusion_inferences = 0; ///< Occluder model runs
+        std::size_t region_inferences = 0;    ///< Face parsing model runs
+    };
+
+    /**
+     * @brief Get the crop of a face, warping it from @p image only if not cached
+     * @param image Current frame image
+     * @param landmarks 5-point landmarks identifying the face
+     * @param template_type Warp template of the calling step
+     * @param size Crop size of the calling step
+     */
+    Crop crop(const cv::Mat& image, const face::types::Landmarks& landmarks,
+              face::helper::WarpTemplateType template_type, const cv::Size& size);
+
+    /**
+     * @brief Composed mask (CV_32FC1, @p size) for the crop of a face
+     * @details Occlusion and region masks come from the per-face cache; the models run only on
+     *          the first request for the face in this frame.
+     */
+    cv::Mat compose_mask(const cv::Mat& image, const face::types::Landmarks& landmarks,
+                         face::helper::WarpTemplateType template_type, const cv::Size& size,
+                         const face::types::MaskOptions& options,
+                         face::masker::IFaceOccluder* occluder,
+                         face::masker::IFaceRegionMasker* region_masker);
+
+    /**
+     * @brief Run the occlusion and face parsing models for all @p faces at once
+     * @details Faces whose model outputs are already cached are skipped; the others go through
+     *          each model as one batch, so the compose_mask() calls that follow only combine
+     *          cached outputs.
+     */
+    void prepare_masks(const cv::Mat& image, const std::vector<face::types::Landmarks>& faces,
+                       const face::types::MaskOptions& options,
+                       face::masker::IFaceOccluder* occluder,
+                       face::masker::IFaceRegionMasker* region_masker);
+
+    /**
+     * @brief Drop the cached crops after the frame pixels changed (e.g. paste-back)
+     * @details Affine matrices and mask model outputs stay valid.
+     */
+    void invalidate_crops();
+
+    /**
+     * @brief Drop everything (frame geometry changed, e.g. after frame upscaling)
+     */
+    void clear();
+
+    [[nodiscard]] const Stats& stats() const { return m_stats; }
+
+private:
+    struct WarpEntry {
+        face::helper::WarpTemplateType template_type;
+        cv::Size size;
+        cv::Mat affine;
+        cv::Mat crop; ///< Empty after invalidate_crops()
+    };
+
+    struct ComposedEntry {
+        face::helper::WarpTemplateType template_type;
+        cv::Size size;
+        face::types::MaskOptions options;
+        cv::Mat mask;
+    };
+
+    struct RegionEntry {
+        std::vector<face::types::FaceRegion> regions;
+        cv::Mat mask; ///< Canonical crop space
+    };
+
+    struct FaceEntry {
+        face::types::Landmarks landmarks;
+        std::vector<WarpEntry> warps;
+        std::vector<ComposedEntry> composed;
+        bool occlusion_ready = false;
+        cv::Mat occlusion; ///< Inverted occlusion mask, canonical crop space
+        bool labels_ready = false;
+        cv::Mat region_labels;            ///< Face parsing labels, canonical crop space
+        std::vector<RegionEntry> regions; ///< Per region set, for maskers without label maps
+    };
+
+    FaceEntry& face(const face::types::Landmarks& landmarks);
+    WarpEntry& warp(FaceEntry& entry, const cv::Mat& image,
+                    face::helper::WarpTemplateType template_type, const cv::Size& size);
+    cv::Mat region_mask(FaceEntry& entry, const cv::Mat& canonical_crop,
+                        const std::vector<face::types::FaceRegion>& regions,
+                        face::masker::IFaceRegionMasker& region_masker);
+
+    std::vector<FaceEntry> m_faces;
+    Stats m_stats;
+};
+
+} // namespace domain::pipeline
@@ -6,6 +6,7 @@
  */
 export module domain.pipeline;
 
+export import :face_workspace;
 export import :types;
 export import :queue;
 export import :api;
@@ -71,8 +71,9 @@ std::shared_ptr<IFrameProcessor> FaceEnhancerAdapter::create(const void* ptr) {
     }
     std::string path =
         ctx->enhancer_model_path.empty() ? "default_model" : ctx->enhancer_model_path;
-    return std::shared_ptr<IFrameProcessor>(new FaceEnhancerAdapter(
-        ctx->face_enhancer, path, ctx->inference_options, ctx->occluder, ctx->region_masker));
+    return std::shared_ptr<IFrameProcessor>(
+        new FaceEnhancerAdapter(ctx->face_enhancer, path, ctx->inference_options, ctx->occluder,
+                                ctx->region_masker, ctx->enhancer_reuse));
 }
 
 std::shared_ptr<IFrameProcessor> ExpressionAdapter::create(const void* ptr) {
@@ -1,4 +1,6 @@
 module;
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <map>
 #include <string>
@@ -7,6 +9,7 @@ module;
 #include <vector>
 #include <iostream>
 #include <mutex>
+#include <numeric>
 #include <format>
 
 /**
@@ -29,6 +32,7 @@ import domain.face.helper;
 import domain.face.masker;
 import foundation.ai.inference_session;
 import foundation.infrastructure.logger;
+import foundation.infrastructure.thread_pool;
 
 export namespace domain::pipeline {
 
@@ -111,36 +115,66 @@ public:
                 auto& input = frame.swap_input.value();
                 if (input.target_faces_landmarks.empty() || !input.source_embedding) return;
 
-                cv::Mat working_frame = frame.image;
-
-                for (const auto& landmarks : input.target_faces_landmarks) {
-                    // 1. Warp / Crop
-                    auto [crop_frame, affine_matrix] = face::helper::warp_face_by_face_landmarks_5(
-                        working_frame, landmarks, m_template_type, m_input_size);
-
-                    // 2. Inference
-                    const cv::Mat kSwappedCrop =
-                        m_swapper->swap_face(crop_frame, *input.source_embedding);
-
-                    // 3. Color Match (Task 3.3)
-                    const cv::Mat kMatchedCrop =
-                        face::helper::apply_color_match(crop_frame, kSwappedCrop);
-
-                    // 4. Compose Mask
-                    face::masker::MaskCompositor::CompositionInput mask_input;
-                    mask_input.size = m_input_size;
-                    mask_input.options = input.mask_options;
-                    mask_input.crop_frame = crop_frame;
-                    mask_input.occluder = m_occluder.get();
-                    mask_input.region_masker = m_region_masker.get();
-
-                    const cv::Mat kComposedMask = face::masker::MaskCompositor::compose(mask_input);
+                // Private copy: frame.image may share its buffer (e.g. expression source frame)
+                cv::Mat working_frame = frame.image.clone();
+                auto& workspace = frame.face_workspace;
+                const auto& faces = input.target_faces_landmarks;
+
+                // 1. Warp / Crop every face from the unmodified frame (shared with the other
+                //    face steps of this frame)
+                std::vector<cv::Mat> crops;
+                std::vector<cv::Mat> affines;
+                crops.reserve(faces.size());
+                affines.reserve(faces.size());
+                for (const auto& landmarks : faces) {
+                    auto [crop_frame, affine_matrix] =
+                        workspace.crop(working_frame, landmarks, m_template_type, m_input_size);
+                    crops.push_back(std::move(crop_frame));
+                    affines.push_back(std::move(affine_matrix));
+                }
 
-                    // 5. Paste back
-                    working_frame = face::helper::paste_back(working_frame, kMatchedCrop,
-                                                             kComposedMask, affine_matrix);
+                // 2. One swap inference for all faces, overlapped with the mask models below.
+                //    Captures are by value so the task never refers to this stack frame.
+                auto swapped_future =
+                    foundation::infrastructure::thread_pool::ThreadPool::instance().enqueue(
+                        [swapper = m_swapper, crops, embedding = input.source_embedding] {
+                            return swapper->swap_face_batch(crops, *embedding);
+                        });
+
+                // 3. Masks: occlusion / parsing models batched over all faces, then composed
+                std::vector<cv::Mat> masks;
+                try {
+                    workspace.prepare_masks(working_frame, faces, input.mask_options,
+                                            m_occluder.get(), m_region_masker.get());
+                    masks.reserve(faces.size());
+                    for (const auto& landmarks : faces) {
+                        masks.push_back(workspace.compose_mask(
+                            working_frame, landmarks, m_template_type, m_input_size,
+                            input.mask_options, m_occluder.get(), m_region_masker.get()));
+                    }
+                } catch (...) {
+                    swapped_future.wait();
+                    throw;
+                }
+                const std::vector<cv::Mat> swapped = swapped_future.get();
+
+                // 4. Color match (Task 3.3, target statistics reused per face track) and paste
+                //    back. Where faces overlap the larger (closer) face ends on top: faces are
+                //    pasted by ascending eye distance, ties in detection order.
+                std::vector<size_t> order(faces.size());
+                std::iota(order.begin(), order.end(), size_t{0});
+                std::ranges::stable_sort(order, {},
+                                         [&](size_t i) { return eye_distance(faces[i]); });
+                for (const size_t i : order) {
+                    if (i >= swapped.size() || swapped[i].empty()) continue;
+                    const cv::Mat kMatchedCrop = face::helper::apply_color_match(
+                        m_color_stats.get(crops[i], faces[i]), swapped[i]);
+                    face::helper::paste_back_into(working_frame, kMatchedCrop, masks[i],
+                                                  affines[i]);
                 }
+                workspace.invalidate_crops();
                 frame.image = working_frame;
+                frame.modified = true;
 
             } catch (const std::exception& e) {
                 foundation::infrastructure::logger::Logger::get_instance()->error(
@@ -150,6 +184,11 @@ public:
     }
 
 private:
+    static float eye_distance(const face::types::Landmarks& landmarks) {
+        if (landmarks.size() < 2) return 0.0F;
+        return static_cast<float>(cv::norm(landmarks[0] - landmarks[1]));
+    }
+
     std::shared_ptr<face::swapper::IFaceSwapper> m_swapper;
     std::string m_model_path;
     foundation::ai::inference_session::Options m_options;
@@ -158,6 +197,7 @@ private:
 
     std::shared_ptr<face::masker::IFaceOccluder> m_occluder;
     std::shared_ptr<face::masker::IFaceRegionMasker> m_region_masker;
+    face::helper::ColorStatsCache m_color_stats;
 
     cv::Size m_input_size{128, 128}; // Default, updated on load
     domain::face::helper::WarpTemplateType m_template_type =
@@ -191,10 +231,11 @@ private:
         std::shared_ptr<face::enhancer::IFaceEnhancer> enhancer, std::string model_path,
         foundation::ai::inference_session::Options options,
         std::shared_ptr<face::masker::IFaceOccluder> occluder = nullptr,
-        std::shared_ptr<face::masker::IFaceRegionMasker> region_masker = nullptr) :
+        std::shared_ptr<face::masker::IFaceRegionMasker> region_masker = nullptr,
+        std::shared_ptr<face::enhancer::TemporalCropCache> reuse = nullptr) :
         m_enhancer(std::move(enhancer)), m_model_path(std::move(model_path)),
         m_options(std::move(options)), m_occluder(std::move(occluder)),
-        m_region_masker(std::move(region_masker)) {}
+        m_region_masker(std::move(region_masker)), m_reuse(std::move(reuse)) {}
 
 public:
     ~FaceEnhancerAdapter() override = default;
@@ -239,42 +280,47 @@ public:
                 auto& input = frame.enhance_input.value();
                 if (input.target_faces_landmarks.empty()) return;
 
-                cv::Mat working_frame = frame.image.clone();
+                // face_blend is folded into the per-pixel mask of the fused paste-back
+                if (input.face_blend == 0) return;
+                const float kBlend =
+                    static_cast<float>(std::min<std::uint16_t>(input.face_blend, 100)) / 100.0F;
 
+                // 1. Warp: all crops come from the unmodified frame.image
+                auto& workspace = frame.face_workspace;
+                std::vector<FaceWorkspace::Crop> crops;
+                crops.reserve(input.target_faces_landmarks.size());
                 for (const auto& landmarks : input.target_faces_landmarks) {
-                    // 1. Warp
-                    auto [crop_frame, affine_matrix] = face::helper::warp_face_by_face_landmarks_5(
-                        frame.image, landmarks, m_template_type, m_input_size);
+                    crops.push_back(
+                        workspace.crop(frame.image, landmarks, m_template_type, m_input_size));
+                }
 
-                    // 2. Inference
-                    const cv::Mat kEnhancedCrop = m_enhancer->enhance_face(crop_frame);
+                cv::Mat working_frame = frame.image.clone();
+                for (size_t i = 0; i < crops.size(); ++i) {
+                    // 2. Inference, or the previous result for a face that has not changed
+                    const cv::Mat kEnhancedCrop =
+                        m_reuse ? m_reuse->get_or_enhance(
+                                      crops[i].frame, input.target_faces_landmarks[i],
+                                      frame.sequence_id,
+                                      [this](const cv::Mat& crop) {
+                                          return m_enhancer->enhance_face(crop);
+                                      })
+                                : m_enhancer->enhance_face(crops[i].frame);
 
                     if (kEnhancedCrop.empty()) continue;
 
                     // 3. Compose Mask
-                    face::masker::MaskCompositor::CompositionInput mask_input;
-                    mask_input.size = m_input_size;
-                    mask_input.options = input.mask_options;
-                    mask_input.crop_frame = crop_frame;
-                    mask_input.occluder = m_occluder.get();
-                    mask_input.region_masker = m_region_masker.get();
-
-                    const cv::Mat kComposedMask = face::masker::MaskCompositor::compose(mask_input);
-
-                    // 4. Paste back
-                    working_frame = face::helper::paste_back(working_frame, kEnhancedCrop,
-                                                             kComposedMask, affine_matrix);
+                    const cv::Mat kComposedMask = workspace.compose_mask(
+                        frame.image, input.target_faces_landmarks[i], m_template_type,
+                        m_input_size, input.mask_options, m_occluder.get(),
+                        m_region_masker.get());
+
+                    // 4. Paste back with the global face blend
+                    face::helper::paste_back_into(working_frame, kEnhancedCrop, kComposedMask,
+                                                  crops[i].affine, kBlend);
                 }
-
-                // Global Face Blend
-                if (input.face_blend >= 100) {
-                    frame.image = working_frame;
-                } else if (input.face_blend > 0) {
-                    const double kAlpha = input.face_blend / 100.0;
-                    cv::addWeighted(working_frame, kAlpha, frame.image, 1.0 - kAlpha, 0.0,
-                                    frame.image);
-                }
-                // if 0, do nothing
+                frame.image = working_frame;
+                frame.modified = true;
+                workspace.invalidate_crops();
 
             } catch (const std::exception& e) {
                 foundation::infrastructure::logger::Logger::get_instance()->error(
@@ -292,6 +338,7 @@ private:
 
     std::shared_ptr<face::masker::IFaceOccluder> m_occluder;
     std::shared_ptr<face::masker::IFaceRegionMasker> m_region_masker;
+    std::shared_ptr<face::enhancer::TemporalCropCache> m_reuse;
 
     cv::Size m_input_size{512, 512}; // Default, updated on load
     domain::face::helper::WarpTemplateType m_template_type =
@@ -373,7 +420,8 @@ public:
                 if (input.source_frame.empty()) return;
                 if (input.target_landmarks.empty() || input.source_landmarks.empty()) return;
 
-                cv::Mat working_frame = frame.image;
+                // Private copy: source_frame may share frame.image's buffer
+                cv::Mat working_frame = frame.image.clone();
                 const size_t kCount =
                     std::min(input.target_landmarks.size(), input.source_landmarks.size());
 
@@ -383,37 +431,34 @@ public:
                         input.source_frame, input.source_landmarks[i], m_template_type, m_size);
 
                     // 2. Warp Target
-                    auto [target_crop, target_affine] = face::helper::warp_face_by_face_landmarks_5(
+                    const auto [target_crop, target_affine] = frame.face_workspace.crop(
                         working_frame, input.target_landmarks[i], m_template_type, m_size);
 
-                    // 3. Inference
+                    // 3. Inference (appearance features may be reused along the face track)
                     const cv::Mat kRestoredCrop = m_restorer->restore_expression(
-                        source_crop, target_crop, input.restore_factor);
+                        source_crop, target_crop, input.restore_factor, input.target_landmarks[i],
+                        frame.sequence_id);
 
                     if (kRestoredCrop.empty()) continue;
 
                     // 4. Compose Mask
-                    face::masker::MaskCompositor::CompositionInput mask_input;
-                    mask_input.size = m_size;
-
                     // Construct options from input fields
                     domain::face::types::MaskOptions opts;
                     opts.mask_types.assign(input.mask_types.begin(), input.mask_types.end());
                     opts.box_mask_blur = input.box_mask_blur;
                     opts.box_mask_padding = input.box_mask_padding;
 
-                    mask_input.options = opts;
-                    mask_input.crop_frame = target_crop;
-                    mask_input.occluder = m_occluder.get();
-                    mask_input.region_masker = m_region_masker.get();
-
-                    const cv::Mat kComposedMask = face::masker::MaskCompositor::compose(mask_input);
+                    const cv::Mat kComposedMask = frame.face_workspace.compose_mask(
+                        working_frame, input.target_landmarks[i], m_template_type, m_size, opts,
+                        m_occluder.get(), m_region_masker.get());
 
                     // 5. Paste back
-                    working_frame = face::helper::paste_back(working_frame, kRestoredCrop,
-                                                             kComposedMask, target_affine);
+                    face::helper::paste_back_into(working_frame, kRestoredCrop, kComposedMask,
+                                                  target_affine);
+                    frame.face_workspace.invalidate_crops();
                 }
                 frame.image = working_frame;
+                frame.modified = true;
 
             } catch (const std::exception& e) {
                 foundation::infrastructure::logger::Logger::get_instance()->error(
@@ -510,6 +555,9 @@ public:
         }
 
         frame.image = m_enhancer->enhance_frame(input);
+        frame.modified = true;
+        // Upscaling changes the frame geometry: cached affines and masks no longer apply
+        frame.face_workspace.clear();
     }
 
 private:
@@ -25,6 +25,9 @@ struct PipelineContext {
     std::shared_ptr<domain::face::masker::IFaceOccluder> occluder;
     std::shared_ptr<domain::face::masker::IFaceRegionMasker> region_masker;
 
+    // Temporal reuse of enhanced face crops (optional, null = always enhance)
+    std::shared_ptr<domain::face::enhancer::TemporalCropCache> enhancer_reuse;
+
     // Frame enhancer factory
     std::function<std::shared_ptr<domain::frame::enhancer::IFrameEnhancer>()>
         frame_enhancer_factory;
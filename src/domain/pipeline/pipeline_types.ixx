@@ -15,7 +15,10 @@ module;
 
 export module domain.pipeline:types;
 
+import :face_workspace;
+
 import domain.face; // For domain::face::Face
+import domain.face.store;
 import domain.face.swapper;
 import domain.face.enhancer;
 import domain.face.expression;
@@ -30,6 +33,11 @@ struct FrameData {
     std::int64_t sequence_id = 0; ///< Sequential frame number (0-based)
     double timestamp_ms = 0.0;    ///< Presentation timestamp in milliseconds
     cv::Mat image;                ///< Current frame image data (BGR)
+    bool modified = false;        ///< A processor changed @c image (unset: still the source)
+
+    /// Face store key of the original @c image, computed once by the analysis step and reused
+    /// for every cache lookup of this frame (empty until computed)
+    domain::face::store::FrameKey frame_key;
 
     // Optimized Metadata (Strongly Typed)
     // Avoid std::any for high-frequency data
@@ -42,6 +50,9 @@ struct FrameData {
     std::optional<domain::face::enhancer::EnhanceInput> enhance_input;
     std::optional<domain::face::expression::RestoreExpressionInput> expression_input;
 
+    /// Crops and mask model outputs shared by the face steps of this frame
+    FaceWorkspace face_workspace;
+
     /**
      * @brief Intermediate results shared between processors
      * @details Example: Key "landmarks" might contain face keypoints from a detector.
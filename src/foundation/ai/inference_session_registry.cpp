@@ -88,4 +88,8 @@ size_t InferenceSessionRegistry::cleanup_expired() {
     return m_pool.cleanup_expired();
 }
 
+size_t InferenceSessionRegistry::size() const {
+    return m_pool.size();
+}
+
 } // namespace foundation::ai::inference_session
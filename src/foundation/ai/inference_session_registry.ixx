@@ -58,6 +58,11 @@ public:
      */
     size_t cleanup_expired();
 
+    /**
+     * @brief Number of cached sessions.
+     */
+    [[nodiscard]] size_t size() const;
+
     /**
      * @brief Preload a session into the registry.
      * @details This can be used for pre-loading models or injecting mock sessions for testing.
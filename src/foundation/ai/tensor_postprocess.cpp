@@ -0,0 +1,84 @@
+/**
+ * @file tensor_postprocess.cpp
+ * @brief Implementation of the planar float to BGR u8 conversion
+ */
+
+module;
+#include <cstddef>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+module foundation.ai.tensor_postprocess;
+
+namespace foundation::ai::tensor_postprocess {
+
+namespace {
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+/**
+ * @brief Map vlanes(v_uint8) floats of one plane to saturated u8
+ */
+inline cv::v_uint8 to_u8(const float* src, const cv::v_float32& scale,
+                         const cv::v_float32& offset) {
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_int32 q0 = cv::v_round(cv::v_fma(cv::vx_load(src), scale, offset));
+    const cv::v_int32 q1 = cv::v_round(cv::v_fma(cv::vx_load(src + lanes), scale, offset));
+    const cv::v_int32 q2 = cv::v_round(cv::v_fma(cv::vx_load(src + 2 * lanes), scale, offset));
+    const cv::v_int32 q3 = cv::v_round(cv::v_fma(cv::vx_load(src + 3 * lanes), scale, offset));
+    // Saturating packs clamp to [0, 255]
+    return cv::v_pack(cv::v_pack_u(q0, q1), cv::v_pack_u(q2, q3));
+}
+#endif
+
+} // namespace
+
+void planar_to_bgr(const float* planes, const cv::Size& size, const cv::Rect& region,
+                   cv::Mat& dst, const PlanarOptions& options) {
+    const cv::Rect roi = region & cv::Rect(cv::Point(), size);
+    dst.create(roi.size(), CV_8UC3);
+    if (planes == nullptr || roi.empty()) return;
+
+    const float scale = options.range == ValueRange::MinusOneToOne ? 127.5F : 255.0F;
+    const float offset = options.range == ValueRange::MinusOneToOne ? 127.5F : 0.0F;
+
+    const std::size_t plane_size = static_cast<std::size_t>(size.area());
+    const bool rgb = options.order == PlaneOrder::RGB;
+    const float* blue = planes + (rgb ? 2 : 0) * plane_size;
+    const float* green = planes + plane_size;
+    const float* red = planes + (rgb ? 0 : 2) * plane_size;
+
+    for (int y = 0; y < roi.height; ++y) {
+        const std::size_t row = static_cast<std::size_t>(roi.y + y) * size.width + roi.x;
+        uchar* out = dst.ptr<uchar>(y);
+        int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        const int lanes8 = cv::VTraits<cv::v_uint8>::vlanes();
+        const cv::v_float32 v_scale = cv::vx_setall_f32(scale);
+        const cv::v_float32 v_offset = cv::vx_setall_f32(offset);
+        for (; x + lanes8 <= roi.width; x += lanes8) {
+            cv::v_store_interleave(out + 3 * x, to_u8(blue + row + x, v_scale, v_offset),
+                                   to_u8(green + row + x, v_scale, v_offset),
+                                   to_u8(red + row + x, v_scale, v_offset));
+        }
+        cv::vx_cleanup();
+#endif
+        for (; x < roi.width; ++x) {
+            out[3 * x] = cv::saturate_cast<uchar>(blue[row + x] * scale + offset);
+            out[3 * x + 1] = cv::saturate_cast<uchar>(green[row + x] * scale + offset);
+            out[3 * x + 2] = cv::saturate_cast<uchar>(red[row + x] * scale + offset);
+        }
+    }
+}
+
+void planar_to_bgr(const float* planes, const cv::Size& size, cv::Mat& dst,
+                   const PlanarOptions& options) {
+    planar_to_bgr(planes, size, cv::Rect(cv::Point(), size), dst, options);
+}
+
+cv::Mat planar_to_bgr(const float* planes, const cv::Size& size, const PlanarOptions& options) {
+    cv::Mat dst;
+    planar_to_bgr(planes, size, dst, options);
+    return dst;
+}
+
+} // namespace foundation::ai::tensor_postprocess
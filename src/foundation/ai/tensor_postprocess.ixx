@@ -0,0 +1,62 @@
+/**
+ * @file tensor_postprocess.ixx
+ * @brief Conversion of planar float model outputs to interleaved 8-bit images
+ */
+
+module;
+#include <cstdint>
+#include <opencv2/core.hpp>
+
+export module foundation.ai.tensor_postprocess;
+
+export namespace foundation::ai::tensor_postprocess {
+
+/**
+ * @brief Value range of the model output
+ */
+enum class ValueRange : std::uint8_t {
+    ZeroToOne,    ///< [0, 1] -> v * 255
+    MinusOneToOne ///< [-1, 1] -> (v + 1) * 127.5
+};
+
+/**
+ * @brief Order of the three planes in the output tensor
+ */
+enum class PlaneOrder : std::uint8_t {
+    RGB, ///< Plane 0 = R (most generative models)
+    BGR  ///< Plane 0 = B
+};
+
+struct PlanarOptions {
+    ValueRange range = ValueRange::ZeroToOne;
+    PlaneOrder order = PlaneOrder::RGB;
+};
+
+/**
+ * @brief Write a 3-plane float tensor (CHW) as interleaved, saturated 8-bit BGR
+ * @details One vectorised pass: range mapping, rounding, clamping to [0, 255] and the channel
+ *          reorder are fused, with no intermediate planes.
+ * @param planes First of 3 * size.area() floats
+ * @param size Spatial size of each plane
+ * @param dst Destination; only (re)allocated if it is not already CV_8UC3 of @p size, so
+ *            pooled buffers are reused
+ * @param options Value range and plane order of the tensor
+ */
+void planar_to_bgr(const float* planes, const cv::Size& size, cv::Mat& dst,
+                   const PlanarOptions& options = {});
+
+/**
+ * @brief Convert only @p region of the planes, e.g. a tile without its overlap border
+ * @details @p dst receives region.size() pixels; pass a ROI of a larger canvas to write the
+ *          result in place.
+ */
+void planar_to_bgr(const float* planes, const cv::Size& size, const cv::Rect& region,
+                   cv::Mat& dst, const PlanarOptions& options = {});
+
+/**
+ * @brief Allocating overload of planar_to_bgr()
+ */
+[[nodiscard]] cv::Mat planar_to_bgr(const float* planes, const cv::Size& size,
+                                    const PlanarOptions& options = {});
+
+} // namespace foundation::ai::tensor_postprocess
@@ -24,7 +24,8 @@ std::string combined_sha1(const std::unordered_set<std::string>& file_paths);
 /**
  * @brief Calculate SHA1 hash of multiple files concurrently
  * @param file_paths Set of file paths to hash
- * @return Vector of SHA1 hash strings
+ * @return Vector of SHA1 hash strings, one per path in ascending (std::sort) path order; the
+ *         hash of a file that cannot be read is empty
  */
 std::vector<std::string> sha1_batch(const std::unordered_set<std::string>& file_paths);
 
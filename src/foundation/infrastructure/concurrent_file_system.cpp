@@ -4,6 +4,7 @@ module;
 #include <vector>
 #include <string>
 #include <functional>
+#include <future>
 
 module foundation.infrastructure.concurrent_file_system;
 
@@ -20,18 +21,26 @@ void remove_files(const std::vector<std::string>& paths) {
 }
 
 void copy_files(const std::vector<std::string>& sources,
-                const std::vector<std::string>& destinations) {
+                const std::vector<std::string>& destinations, bool hard_link) {
     if (sources.size() != destinations.size()) {
         // Handle error: sizes must match
         return;
     }
     auto& pool = foundation::infrastructure::thread_pool::ThreadPool::instance();
+    std::vector<std::future<void>> pending;
+    pending.reserve(sources.size());
     for (size_t i = 0; i < sources.size(); ++i) {
         std::string src = sources[i];
         std::string dst = destinations[i];
-        pool.enqueue(
-            [src, dst]() { foundation::infrastructure::file_system::copy_file(src, dst); });
+        pending.push_back(pool.enqueue([src, dst, hard_link]() {
+            if (hard_link) {
+                foundation::infrastructure::file_system::link_or_copy_file(src, dst);
+            } else {
+                foundation::infrastructure::file_system::copy_file(src, dst);
+            }
+        }));
     }
+    for (auto& task : pending) task.wait();
 }
 
 } // namespace foundation::infrastructure::concurrent_file_system
@@ -21,9 +21,12 @@ void remove_files(const std::vector<std::string>& paths);
 
 /**
  * @brief Copy multiple files concurrently to destinations
+ * @details Returns once every file has been copied.
  * @param sources A vector of source file paths
  * @param destinations A vector of destination file paths (must match sources size)
+ * @param hard_link Hard-link each destination to its source where the file system allows it
+ *                  (see file_system::link_or_copy_file)
  */
 void copy_files(const std::vector<std::string>& sources,
-                const std::vector<std::string>& destinations);
+                const std::vector<std::string>& destinations, bool hard_link = false);
 } // namespace foundation::infrastructure::concurrent_file_system
@@ -29,10 +29,16 @@ public:
 
     std::recursive_mutex& mutex();
 
+    // Console output goes to stderr while stdout carries data (e.g. a streamed video)
+    void set_use_stderr(bool use_stderr) { m_use_stderr = use_stderr; }
+    bool uses_stderr() const { return m_use_stderr; }
+    std::ostream& out() const { return m_use_stderr ? std::cerr : std::cout; }
+
 private:
     ConsoleManager() = default;
     std::recursive_mutex m_mutex;
     IProgressController* m_active_controller{nullptr};
+    std::atomic<bool> m_use_stderr{false};
 };
 
 class ScopedSuspend {
@@ -4,9 +4,15 @@ module;
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <utility>
 
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 module foundation.infrastructure.file_system;
@@ -32,6 +38,18 @@ void copy_file(const std::string& source, const std::string& destination) {
                                std::filesystem::copy_options::overwrite_existing, ec);
 }
 
+void link_or_copy_file(const std::string& source, const std::string& destination) {
+    if (source.empty() || destination.empty()) {
+        throw std::invalid_argument("Source or destination path is empty");
+    }
+    std::error_code ec;
+    if (std::filesystem::equivalent(source, destination, ec)) return;
+    std::filesystem::remove(destination, ec);
+    ec.clear();
+    std::filesystem::create_hard_link(source, destination, ec);
+    if (ec) copy_file(source, destination);
+}
+
 void copy_files(const std::vector<std::string>& sources, const std::string& destination) {
     if (sources.empty() || destination.empty()) {
         throw std::invalid_argument("Sources or destination path is empty");
@@ -115,4 +133,78 @@ std::string utf8_to_sys_default_local(const std::string& str) {
 #endif
 }
 
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+void MappedFile::release() noexcept {
+    if (m_data == nullptr) return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+std::optional<MappedFile> MappedFile::open(const std::string& path) {
+    if (!is_file(path)) return std::nullopt;
+
+    MappedFile mapped;
+#ifdef _WIN32
+    const std::filesystem::path native(path);
+    HANDLE file = CreateFileW(native.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return std::nullopt;
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0) {
+        CloseHandle(file);
+        return std::nullopt;
+    }
+    // The view keeps the mapping (and the file) alive after both handles are closed
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) return std::nullopt;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr) return std::nullopt;
+
+    mapped.m_data = static_cast<const unsigned char*>(view);
+    mapped.m_size = static_cast<std::size_t>(file_size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return std::nullopt;
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return std::nullopt;
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    // The mapping stays valid after the descriptor is closed
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return std::nullopt;
+    posix_madvise(view, size, POSIX_MADV_SEQUENTIAL);
+
+    mapped.m_data = static_cast<const unsigned char*>(view);
+    mapped.m_size = size;
+#endif
+    return mapped;
+}
+
 } // namespace foundation::infrastructure::file_system
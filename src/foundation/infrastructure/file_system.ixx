@@ -1,4 +1,6 @@
 module;
+#include <cstddef>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -40,6 +42,15 @@ inline void copy(const std::string& source, const std::string& destination) {
     copy_file(source, destination);
 }
 
+/**
+ * @brief Hard-link destination to source, copying the file where a link is not possible
+ * @details An existing destination is replaced. Links fail across file systems and on some
+ *          file systems (e.g. FAT); the copy fallback makes the result the same either way.
+ * @param source The source file path
+ * @param destination The destination file path
+ */
+void link_or_copy_file(const std::string& source, const std::string& destination);
+
 /**
  * @brief Copy multiple files to a destination directory
  * @param sources A vector of source file paths
@@ -131,4 +142,36 @@ inline void create_dir(const std::string& path) {
  */
 [[nodiscard]] std::string utf8_to_sys_default_local(const std::string& str);
 
+/**
+ * @brief Read-only memory mapping of a whole file
+ * @details The pages are loaded on first access, so decoders such as `cv::imdecode` read the
+ *          file contents without an intermediate buffer. Move-only; unmapped on destruction.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Map the file at @p path
+     * @return The mapping, or std::nullopt if the file cannot be opened, is empty or is not a
+     *         regular file
+     */
+    [[nodiscard]] static std::optional<MappedFile> open(const std::string& path);
+
+    [[nodiscard]] const unsigned char* data() const { return m_data; } ///< First mapped byte
+    [[nodiscard]] std::size_t size() const { return m_size; }          ///< Mapped bytes
+
+private:
+    void release() noexcept;
+
+    const unsigned char* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
 } // namespace foundation::infrastructure::file_system
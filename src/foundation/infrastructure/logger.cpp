@@ -58,6 +58,17 @@ bool Logger::is_initialized() noexcept {
     return get_instance()->m_initialized;
 }
 
+void Logger::use_stderr_console() {
+    console::ConsoleManager::instance().set_use_stderr(true);
+    if (!m_logger) return;
+    for (auto& sink : m_logger->sinks()) {
+        if (!std::dynamic_pointer_cast<spdlog::sinks::stdout_color_sink_mt>(sink)) continue;
+        auto stderr_sink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+        stderr_sink->set_level(sink->level());
+        sink = stderr_sink;
+    }
+}
+
 Logger::Logger() {
     // Default initialization (can be overridden by initialize)
     // We set up a basic console sink initially so we don't crash if used before initialize
@@ -76,7 +87,12 @@ void Logger::setup_sinks() {
         std::vector<spdlog::sink_ptr> sinks;
 
         // 1. Console Sink (always enabled)
-        auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        spdlog::sink_ptr console_sink;
+        if (console::ConsoleManager::instance().uses_stderr()) {
+            console_sink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+        } else {
+            console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        }
         console_sink->set_level(to_spdlog_level(m_config.level));
         sinks.push_back(console_sink);
 
@@ -41,6 +41,13 @@ public:
      */
     static bool is_initialized() noexcept;
 
+    /**
+     * @brief Move console logging from stdout to stderr
+     * @details For runs that write data to stdout. Call before work starts: sinks are swapped
+     *          without synchronising with concurrent logging.
+     */
+    void use_stderr_console();
+
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     Logger(Logger&&) = delete;
@@ -68,7 +68,8 @@ struct ProgressBar::Impl {
         int width = get_terminal_width();
         if (width <= 0) width = 80;
 
-        std::cout << "\r" << content << "\033[K" << std::flush;
+        foundation::infrastructure::console::ConsoleManager::instance().out()
+            << "\r" << content << "\033[K" << std::flush;
     }
 };
 
@@ -136,7 +137,8 @@ void ProgressBar::mark_as_completed() {
 }
 
 void ProgressBar::suspend() {
-    std::cout << "\033[2K\r" << std::flush;
+    auto& out = foundation::infrastructure::console::ConsoleManager::instance().out();
+    out << "\033[2K\r" << std::flush;
 }
 
 void ProgressBar::resume() {
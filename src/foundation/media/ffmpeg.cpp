@@ -45,6 +45,23 @@ struct AVFormatContextDeleter {
 using FormatCtxPtr = std::unique_ptr<AVFormatContext, AVFormatContextDeleter>;
 } // namespace
 
+int thread_type_flags(const std::string& threadType) {
+    if (threadType == "frame") return FF_THREAD_FRAME;
+    if (threadType == "slice") return FF_THREAD_SLICE;
+    return FF_THREAD_FRAME | FF_THREAD_SLICE;
+}
+
+std::string stream_url(const std::string& path, bool output) {
+    if (path == "-") return output ? "pipe:1" : "pipe:0";
+    return path;
+}
+
+bool is_stream_path(const std::string& path) {
+    if (path == "-" || path.starts_with("pipe:")) return true;
+    std::error_code ec;
+    return std::filesystem::is_fifo(path, ec);
+}
+
 bool is_video(const std::string& videoPath) {
     if (foundation::media::vision::is_image(videoPath)) { return false; }
 
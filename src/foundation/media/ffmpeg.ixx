@@ -15,6 +15,7 @@ module;
 
 export module foundation.media.ffmpeg;
 export import :remuxer;
+export import :seek_index;
 
 namespace foundation::media::ffmpeg {
 
@@ -48,11 +49,13 @@ public:
     int maxBFrames = 2;                  ///< Maximum number of B-frames
 
     // Advanced Config
-    std::string tune;    ///< FFmpeg tune setting
-    std::string profile; ///< H.264 profile
-    std::string level;   ///< H.264 level
-    std::string hwAccel; ///< Hardware acceleration strategy
-    int threadCount = 0; ///< Number of encoding threads (0 = auto)
+    std::string tune;       ///< FFmpeg tune setting
+    std::string profile;    ///< H.264 profile
+    std::string level;      ///< H.264 level
+    std::string hwAccel;    ///< Hardware acceleration strategy
+    int threadCount = 0;    ///< Number of encoding threads (0 = auto)
+    std::string threadType; ///< "frame", "slice", or "auto"/empty (both, as the codec supports)
+    std::string containerFormat; ///< Muxer name (e.g. "mp4", "mpegts"; empty = from the path)
 
     std::unordered_map<std::string, std::string>
         extraOptions; ///< Additional codec-specific options
@@ -60,6 +63,23 @@ public:
     int64_t frameCount = 0; ///< Total number of frames (if available)
 };
 
+/**
+ * @brief FF_THREAD_* flags for a thread type name ("frame", "slice", empty = both)
+ */
+int thread_type_flags(const std::string& threadType);
+
+/**
+ * @brief FFmpeg URL for @p path: "-" becomes stdin ("pipe:0") or stdout ("pipe:1")
+ */
+std::string stream_url(const std::string& path, bool output);
+
+/**
+ * @brief Check if @p path is a pipe: "-" (stdin/stdout), "pipe:N" or a named FIFO
+ * @details A pipe can only be read once, front to back: it cannot be probed before it is
+ *          opened, seeked, indexed or reopened.
+ */
+export bool is_stream_path(const std::string& path);
+
 /**
  * @brief Check if a file is a valid video format
  * @param videoPath Path to the file
@@ -97,7 +117,7 @@ export class VideoReader {
 public:
     /**
      * @brief Construct a new Video Reader
-     * @param videoPath Path to the source video file
+     * @param videoPath Path to the source video file, or "-" / a FIFO to read a stream
      */
     explicit VideoReader(const std::string& videoPath);
     ~VideoReader();
@@ -108,6 +128,13 @@ public:
     VideoReader(VideoReader&&) noexcept;
     VideoReader& operator=(VideoReader&&) noexcept;
 
+    /**
+     * @brief Configure decoder threading; takes effect on the next open()
+     * @param threadCount Decoder threads (0 = FFmpeg auto, one per core)
+     * @param threadType "frame", "slice", or "auto"/empty (both, as the codec supports)
+     */
+    void set_decoder_threads(int threadCount, const std::string& threadType = "");
+
     /**
      * @brief Open the video file for reading
      * @return true if successful, false otherwise
@@ -165,7 +192,8 @@ export class VideoWriter {
 public:
     /**
      * @brief Construct a new Video Writer
-     * @param outputPath Path where the output video will be saved
+     * @param outputPath Path where the output video will be saved; "-" or a FIFO streams it
+     *                   (MP4 is then fragmented, see is_stream_path())
      * @param params Encoding configuration
      */
     VideoWriter(const std::string& outputPath, const VideoParams& params);
@@ -185,8 +213,10 @@ public:
 
     /**
      * @brief Close the file and finalize encoding
+     * @return false if a frame, an audio packet or the trailer could not be written, so the
+     *         file is incomplete
      */
-    void close();
+    bool close();
 
     /**
      * @brief Check if the writer is currently open
@@ -196,9 +226,12 @@ public:
     /**
      * @brief Encode and write a single frame
      * @param frame BGR format image to encode
-     * @return true if successful
+     * @param modified false if @p frame is the unchanged source frame; with smart render,
+     *                 GOPs made only of such frames are copied instead of encoded
+     * @return false if the writer is not open or writing an earlier frame or audio packet
+     *         failed (frames are encoded asynchronously)
      */
-    bool write_frame(const cv::Mat& frame);
+    bool write_frame(const cv::Mat& frame, bool modified = true);
 
     /**
      * @brief Get the number of frames successfully written
@@ -207,9 +240,40 @@ public:
 
     /**
      * @brief Set the audio source to copy audio from
+     * @details Must be called before open(). The first audio stream of the source is
+     *          stream-copied into the output and interleaved with the encoded video by
+     *          timestamp, so the file is written in a single pass. Audio past the end of the
+     *          written video is dropped. If the source has no audio, or the container cannot
+     *          hold its codec, the output is written without audio.
      * @param sourceVideoPath Path to the video file containing the audio track
+     * @param startTimeMs Source time (ms) that maps to the first written frame
+     */
+    void set_audio_source(const std::string& sourceVideoPath, double startTimeMs = 0.0);
+
+    /**
+     * @brief Check if the opened output carries a copied audio stream
+     */
+    [[nodiscard]] bool has_audio() const;
+
+    /**
+     * @brief Copy unmodified GOPs from the source video instead of re-encoding them
+     * @details Must be called before open(). Frames are written in source order starting at
+     *          @p firstFrame. A source GOP whose frames were all written unmodified is
+     *          stream-copied; the other GOPs are re-encoded with the source's codec (libx264 or
+     *          libx265), profile, level, pixel format and timestamps, as self-contained closed
+     *          GOPs. MP4/MOV outputs use the avc3/hev1 sample entries of streams with in-band
+     *          parameter sets. Holds at most one GOP of unmodified frames. Needs a closed-GOP
+     *          H.264/HEVC source of the output frame size; otherwise open() logs why and
+     *          encodes every frame.
+     * @param sourceVideoPath Video the written frames were decoded from
+     * @param firstFrame Source index of the first written frame
+     */
+    void enable_smart_render(const std::string& sourceVideoPath, std::int64_t firstFrame = 0);
+
+    /**
+     * @brief Check if the opened output uses smart render
      */
-    void set_audio_source(const std::string& sourceVideoPath);
+    [[nodiscard]] bool is_smart_render() const;
 
 private:
     struct Impl;
@@ -7,6 +7,7 @@
 
 module;
 
+#include <algorithm>
 #include <cstdint>
 #if defined(__clang__)
 #include <foundation/infrastructure/opencv_workaround.hpp>
@@ -14,6 +15,7 @@ module;
 #include <opencv2/opencv.hpp>
 #include <string>
 #include <vector>
+#include <optional>
 #include <iostream>
 #include <format>
 #include <filesystem>
@@ -54,6 +56,7 @@ struct VideoReader::Impl {
     AVPacket* packet = nullptr;
     int video_stream_index = -1;
     bool is_open = false;
+    bool is_stream = false; ///< Reading a pipe: no seeking, no seek index
     std::atomic<int64_t> current_pts = 0;
     double time_base = 0.0;
     int frame_count = 0;
@@ -61,6 +64,9 @@ struct VideoReader::Impl {
     int width = 0;
     int height = 0;
     int64_t duration_ms = 0;
+    std::optional<SeekIndex> seek_index; ///< Loaded on open, built on first seek if missing
+    int decoder_threads = 0;             ///< 0 = FFmpeg auto
+    std::string decoder_thread_type;
 
     // Async support
     ConcurrentQueue<cv::Mat> frame_queue{32}; // Max 32 frames buffer
@@ -106,6 +112,7 @@ struct VideoReader::Impl {
             avformat_close_input(&format_ctx);
             format_ctx = nullptr;
         }
+        seek_index.reset();
         is_open = false;
     }
 
@@ -269,7 +276,10 @@ struct VideoReader::Impl {
     bool open() {
         cleanup();
 
-        if (avformat_open_input(&format_ctx, video_path.c_str(), nullptr, nullptr) < 0) {
+        is_stream = is_stream_path(video_path);
+        if (avformat_open_input(&format_ctx, stream_url(video_path, false).c_str(), nullptr,
+                                nullptr)
+            < 0) {
             Logger::get_instance()->error(
                 std::format("VideoReader: Failed to open input file: {}", video_path));
             return false;
@@ -318,9 +328,10 @@ struct VideoReader::Impl {
             return false;
         }
 
-        // Enable multithreading for decoding if CPU allows
-        // ffmpeg usually handles this internally if configured
-        codec_ctx->thread_count = 0; // 0 means auto
+        // Frame threading pipelines whole frames across threads; slice threading splits each
+        // frame (only for streams encoded with several slices)
+        codec_ctx->thread_count = decoder_threads; // 0 means auto
+        codec_ctx->thread_type = thread_type_flags(decoder_thread_type);
 
         if (avcodec_open2(codec_ctx, codec, nullptr) < 0) {
             Logger::get_instance()->error("VideoReader: Failed to open codec");
@@ -383,6 +394,9 @@ struct VideoReader::Impl {
             duration_ms = static_cast<int64_t>(video_stream->duration * time_base * 1000);
         }
 
+        // A cached seek index gives the exact frame count for free
+        if (!is_stream) { use_seek_index(SeekIndex::load(video_path)); }
+
         is_open = true;
 
         // Start async decoding
@@ -402,27 +416,56 @@ struct VideoReader::Impl {
         return {};
     }
 
-    bool seek(int64_t frame_index) {
-        if (!is_open || frame_index < 0) { return false; }
+    void use_seek_index(std::optional<SeekIndex> index) {
+        if (!index || index->stream_index() != video_stream_index) return;
+        seek_index = std::move(index);
+        frame_count = static_cast<int>(seek_index->frame_count());
+    }
 
-        // Calculate target timestamp in stream time base
-        // frame_index / fps = seconds
-        // seconds / time_base = stream units
-        int64_t target_ts = static_cast<int64_t>((double)frame_index / fps / time_base);
+    bool seek(int64_t frame_index) {
+        // Frames already read from a pipe are gone
+        if (!is_open || frame_index < 0 || is_stream) { return false; }
 
         stop_decoding();
 
+        if (!seek_index) { use_seek_index(SeekIndex::load_or_build(video_path)); }
+
+        // With the index, the exact target timestamp and its keyframe are known; otherwise both
+        // are estimated from the frame rate and the demuxer looks the keyframe up
+        int64_t target_ts = static_cast<int64_t>((double)frame_index / fps / time_base);
+        int64_t keyframe_ts = target_ts;
+        int max_frames_to_skip = 1000; // Safety break
+        const bool exact = seek_index.has_value();
+        if (exact) {
+            const auto pts = seek_index->frame_pts(frame_index);
+            if (!pts) {
+                start_decoding();
+                return false;
+            }
+            target_ts = *pts;
+            const int64_t keyframe = std::max<int64_t>(seek_index->keyframe_before(frame_index), 0);
+            keyframe_ts = *seek_index->frame_pts(keyframe);
+            // Frames up to the target plus slack for reordered frames ahead of the keyframe
+            max_frames_to_skip = static_cast<int>(frame_index - keyframe) + 64;
+        }
+
         avcodec_flush_buffers(codec_ctx);
 
-        if (av_seek_frame(format_ctx, video_stream_index, target_ts, AVSEEK_FLAG_BACKWARD) < 0) {
+        if (av_seek_frame(format_ctx, video_stream_index, keyframe_ts, AVSEEK_FLAG_BACKWARD) < 0) {
             Logger::get_instance()->error("VideoReader: Seek failed");
             start_decoding();
             return false;
         }
 
-        // Synchronous precise seek
+        auto reached = [&](int64_t ts) {
+            if (exact) return ts >= target_ts;
+            const int64_t current_frame = static_cast<int64_t>(ts * time_base * fps + 0.5);
+            return current_frame >= frame_index;
+        };
+
+        // Synchronous precise seek. Frames before the target are dropped without conversion,
+        // and with an exact target the decoder skips non-reference frames entirely.
         bool found = false;
-        int max_frames_to_skip = 1000; // Safety break
         int frames_skipped = 0;
 
         while (!found && frames_skipped < max_frames_to_skip) {
@@ -430,20 +473,16 @@ struct VideoReader::Impl {
             if (ret < 0) break;
 
             if (packet->stream_index == video_stream_index) {
+                const bool before_target = exact && packet->pts != AV_NOPTS_VALUE
+                                        && packet->pts < target_ts;
+                codec_ctx->skip_frame = before_target ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+
                 if (avcodec_send_packet(codec_ctx, packet) == 0) {
                     while (avcodec_receive_frame(codec_ctx, frame) == 0) {
                         int64_t current_ts = frame->best_effort_timestamp;
                         if (current_ts == AV_NOPTS_VALUE) current_ts = frame->pts;
 
-                        double current_sec = current_ts * time_base;
-                        int64_t current_frame = static_cast<int64_t>(current_sec * fps + 0.5);
-
-                        if (current_frame >= frame_index) {
-                            // PERFORMANCE NOTE: sws_scale and the subsequent memcpy are the main
-                            // bottlenecks in the reader's producer loop.
-                            // Future Optimization:
-                            // 1. Use zero-copy wrapping if alignment allows.
-                            // 2. Multithreaded scaling or HW acceleration.
+                        if (reached(current_ts)) {
                             sws_scale(sws_ctx, frame->data, frame->linesize, 0, height,
                                       frame_bgr->data, frame_bgr->linesize);
                             cv::Mat mat(height, width, CV_8UC3);
@@ -466,6 +505,7 @@ struct VideoReader::Impl {
             }
             av_packet_unref(packet);
         }
+        codec_ctx->skip_frame = AVDISCARD_DEFAULT;
 
         start_decoding();
         return found;
@@ -497,6 +537,10 @@ VideoReader::~VideoReader() = default;
 VideoReader::VideoReader(VideoReader&&) noexcept = default;
 VideoReader& VideoReader::operator=(VideoReader&&) noexcept = default;
 
+void VideoReader::set_decoder_threads(int threadCount, const std::string& threadType) {
+    impl_->decoder_threads = std::max(threadCount, 0);
+    impl_->decoder_thread_type = threadType;
+}
 bool VideoReader::open() {
     return impl_->open();
 }
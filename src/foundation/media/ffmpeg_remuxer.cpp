@@ -9,6 +9,7 @@ module;
 #include <algorithm>
 #include <memory>
 #include <format>
+#include <cstdint>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -199,4 +200,136 @@ bool Remuxer::merge_av(const std::string& video_path, const std::string& audio_p
     return true;
 }
 
+bool Remuxer::concat(const std::vector<std::string>& segment_paths,
+                     const std::string& output_path) {
+    if (segment_paths.empty()) return false;
+
+    FormatContextPtr out_ctx;
+    avformat_alloc_output_context2(&out_ctx.ptr, nullptr, nullptr, output_path.c_str());
+    if (!out_ctx.ptr) {
+        Logger::get_instance()->error("[FFmpegRemuxer::concat] Failed to create output context");
+        return false;
+    }
+    out_ctx.is_output = true;
+
+    auto free_packet = [](AVPacket* packet) { av_packet_free(&packet); };
+    std::unique_ptr<AVPacket, decltype(free_packet)> pkt(av_packet_alloc(), free_packet);
+    if (!pkt) return false;
+
+    int out_video_stream_idx = -1;
+    std::vector<int64_t> last_dts; // Per output stream, output time base
+    int64_t offset = 0;            // Start of the current segment (AV_TIME_BASE units)
+
+    for (size_t segment = 0; segment < segment_paths.size(); ++segment) {
+        const std::string& path = segment_paths[segment];
+        FormatContextPtr in_ctx;
+        if (avformat_open_input(&in_ctx.ptr, path.c_str(), nullptr, nullptr) < 0
+            || avformat_find_stream_info(in_ctx.ptr, nullptr) < 0) {
+            Logger::get_instance()->error(
+                std::format("[FFmpegRemuxer::concat] Failed to open segment: {}", path));
+            return false;
+        }
+
+        // The first segment defines the output streams: its video stream and audio streams
+        if (segment == 0) {
+            for (unsigned int i = 0; i < in_ctx.ptr->nb_streams; i++) {
+                AVStream* in_stream = in_ctx.ptr->streams[i];
+                const auto type = in_stream->codecpar->codec_type;
+                if (type == AVMEDIA_TYPE_VIDEO && out_video_stream_idx != -1) continue;
+                if (type != AVMEDIA_TYPE_VIDEO && type != AVMEDIA_TYPE_AUDIO) continue;
+
+                AVStream* out_stream = avformat_new_stream(out_ctx.ptr, nullptr);
+                if (!out_stream) return false;
+                if (avcodec_parameters_copy(out_stream->codecpar, in_stream->codecpar) < 0) {
+                    return false;
+                }
+                out_stream->codecpar->codec_tag = 0;
+                out_stream->time_base = in_stream->time_base;
+                if (type == AVMEDIA_TYPE_VIDEO) out_video_stream_idx = out_stream->index;
+            }
+            if (out_video_stream_idx == -1) {
+                Logger::get_instance()->error(
+                    std::format("[FFmpegRemuxer::concat] No video stream in segment: {}", path));
+                return false;
+            }
+
+            if (!(out_ctx.ptr->oformat->flags & AVFMT_NOFILE)) {
+                if (avio_open(&out_ctx.ptr->pb, output_path.c_str(), AVIO_FLAG_WRITE) < 0) {
+                    Logger::get_instance()->error(
+                        "[FFmpegRemuxer::concat] Failed to open output file");
+                    return false;
+                }
+            }
+            if (avformat_write_header(out_ctx.ptr, nullptr) < 0) return false;
+            last_dts.assign(out_ctx.ptr->nb_streams, AV_NOPTS_VALUE);
+        }
+
+        // The n-th output stream of a media type takes the n-th input stream of that type
+        std::vector<int> stream_mapping(in_ctx.ptr->nb_streams, -1);
+        std::vector<bool> used(in_ctx.ptr->nb_streams, false);
+        for (unsigned int o = 0; o < out_ctx.ptr->nb_streams; o++) {
+            const auto type = out_ctx.ptr->streams[o]->codecpar->codec_type;
+            for (unsigned int i = 0; i < in_ctx.ptr->nb_streams; i++) {
+                if (used[i] || in_ctx.ptr->streams[i]->codecpar->codec_type != type) continue;
+                used[i] = true;
+                stream_mapping[i] = static_cast<int>(o);
+                break;
+            }
+        }
+
+        const int64_t start =
+            in_ctx.ptr->start_time == AV_NOPTS_VALUE ? 0 : in_ctx.ptr->start_time;
+        int64_t segment_end = 0; // End of the segment's video (AV_TIME_BASE units)
+
+        while (av_read_frame(in_ctx.ptr, pkt.get()) >= 0) {
+            const int out_index = stream_mapping[pkt->stream_index];
+            if (out_index < 0) {
+                av_packet_unref(pkt.get());
+                continue;
+            }
+            AVStream* in_stream = in_ctx.ptr->streams[pkt->stream_index];
+            AVStream* out_stream = out_ctx.ptr->streams[out_index];
+
+            if (out_index == out_video_stream_idx && pkt->pts != AV_NOPTS_VALUE) {
+                segment_end = std::max(segment_end, av_rescale_q(pkt->pts + pkt->duration,
+                                                                 in_stream->time_base,
+                                                                 AV_TIME_BASE_Q)
+                                                        - start);
+            }
+
+            const int64_t shift =
+                av_rescale_q(offset - start, AV_TIME_BASE_Q, in_stream->time_base);
+            if (pkt->pts != AV_NOPTS_VALUE) pkt->pts += shift;
+            if (pkt->dts != AV_NOPTS_VALUE) pkt->dts += shift;
+            av_packet_rescale_ts(pkt.get(), in_stream->time_base, out_stream->time_base);
+
+            // Rounding at the joins must not make decode timestamps go backwards
+            int64_t& last = last_dts[out_index];
+            if (pkt->dts != AV_NOPTS_VALUE) {
+                if (last != AV_NOPTS_VALUE && pkt->dts <= last) {
+                    pkt->dts = last + 1;
+                    if (pkt->pts != AV_NOPTS_VALUE && pkt->pts < pkt->dts) pkt->pts = pkt->dts;
+                }
+                last = pkt->dts;
+            }
+            pkt->pos = -1;
+            pkt->stream_index = out_index;
+
+            if (av_interleaved_write_frame(out_ctx.ptr, pkt.get()) < 0) {
+                Logger::get_instance()->error(
+                    std::format("[FFmpegRemuxer::concat] Failed to write packet from {}", path));
+                return false;
+            }
+        }
+
+        if (segment_end <= 0 && in_ctx.ptr->duration != AV_NOPTS_VALUE) {
+            segment_end = in_ctx.ptr->duration;
+        }
+        offset += segment_end;
+    }
+
+    av_write_trailer(out_ctx.ptr);
+    return true;
+}
+
 } // namespace foundation::media::ffmpeg
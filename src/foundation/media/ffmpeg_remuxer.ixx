@@ -26,6 +26,18 @@ public:
      */
     static bool merge_av(const std::string& video_path, const std::string& audio_path,
                          const std::string& output_path);
+
+    /**
+     * @brief Joins segment files into one file without re-encoding
+     * @details The streams of the first segment are copied from every segment in turn, each
+     *          one shifted to start where the video of the previous one ended. The segments
+     *          must be encoded with the same parameters (e.g. consecutive parts of one render).
+     * @param segment_paths Segment files in playback order
+     * @param output_path Path to the output file (container chosen from its extension)
+     * @return true if successful
+     */
+    static bool concat(const std::vector<std::string>& segment_paths,
+                       const std::string& output_path);
 };
 
 } // namespace foundation::media::ffmpeg
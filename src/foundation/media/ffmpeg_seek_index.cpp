@@ -0,0 +1,349 @@
+/**
+ * ******************************************************************************
+ * @file           : ffmpeg_seek_index.cpp
+ * @brief          : SeekIndex implementation (packet scan and sidecar cache)
+ * ******************************************************************************
+ */
+
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <xxhash.h>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+module foundation.media.ffmpeg;
+import :seek_index;
+import foundation.infrastructure.logger;
+
+namespace foundation::media::ffmpeg {
+
+using foundation::infrastructure::logger::Logger;
+
+namespace {
+
+constexpr std::array<char, 4> kMagic{'F', 'F', 'S', 'I'};
+constexpr std::uint32_t kVersion = 2;
+constexpr std::uintmax_t kHashSpan = 1 << 20; ///< Bytes hashed at each end of the file
+
+/**
+ * @brief Identity of a video file: a sidecar is only valid for the same key
+ */
+struct FileKey {
+    std::uint64_t size = 0;
+    std::int64_t mtime = 0;
+    std::uint64_t hash = 0; ///< XXH3 of the first and last kHashSpan bytes
+
+    bool operator==(const FileKey&) const = default;
+};
+
+std::optional<FileKey> file_key(const std::string& path) {
+    std::error_code ec;
+    FileKey key;
+    key.size = std::filesystem::file_size(path, ec);
+    if (ec) return std::nullopt;
+    key.mtime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+    if (ec) return std::nullopt;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return std::nullopt;
+    std::vector<char> buffer(static_cast<std::size_t>(std::min(key.size, kHashSpan)));
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    key.hash = XXH3_64bits(buffer.data(), static_cast<std::size_t>(file.gcount()));
+    if (key.size > kHashSpan) {
+        const std::uintmax_t tail = std::min(key.size - kHashSpan, kHashSpan);
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(key.size - tail));
+        file.read(buffer.data(), static_cast<std::streamsize>(tail));
+        key.hash = XXH3_64bits_withSeed(buffer.data(), static_cast<std::size_t>(file.gcount()),
+                                        key.hash);
+    }
+    return key;
+}
+
+// Timestamps are stored as zigzag varint deltas: one or two bytes per frame for a constant
+// frame rate instead of eight
+
+void put_varint(std::vector<std::uint8_t>& out, std::int64_t value) {
+    auto zigzag =
+        (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    while (zigzag >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(zigzag));
+}
+
+bool get_varint(const std::uint8_t*& cursor, const std::uint8_t* end, std::int64_t& value) {
+    std::uint64_t zigzag = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor == end) return false;
+        const std::uint8_t byte = *cursor++;
+        zigzag |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            value =
+                static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void put_deltas(std::vector<std::uint8_t>& out, const std::vector<std::int64_t>& values) {
+    std::int64_t previous = 0;
+    for (const std::int64_t value : values) {
+        put_varint(out, value - previous);
+        previous = value;
+    }
+}
+
+bool get_deltas(const std::uint8_t*& cursor, const std::uint8_t* end, std::size_t count,
+                std::vector<std::int64_t>& values) {
+    values.resize(count);
+    std::int64_t previous = 0;
+    for (auto& value : values) {
+        std::int64_t delta = 0;
+        if (!get_varint(cursor, end, delta)) return false;
+        value = previous + delta;
+        previous = value;
+    }
+    return true;
+}
+
+/**
+ * @brief Fixed-size sidecar header (native byte order; the cache never leaves the machine)
+ */
+struct SidecarHeader {
+    std::array<char, 4> magic = kMagic;
+    std::uint32_t version = kVersion;
+    FileKey key;
+    std::int32_t stream_index = -1;
+    std::int32_t time_base_num = 0;
+    std::int32_t time_base_den = 1;
+    std::uint8_t open_gops = 0;
+    std::int64_t decode_delay = 0;
+    std::uint64_t frame_count = 0;
+    std::uint64_t keyframe_count = 0;
+};
+
+} // namespace
+
+SeekIndex::SeekIndex(int stream_index, int time_base_num, int time_base_den,
+                     std::vector<std::int64_t> frame_pts, std::vector<std::int64_t> keyframes,
+                     bool open_gops, std::int64_t decode_delay) :
+    m_stream_index(stream_index), m_time_base_num(time_base_num), m_time_base_den(time_base_den),
+    m_frame_pts(std::move(frame_pts)), m_keyframes(std::move(keyframes)), m_open_gops(open_gops),
+    m_decode_delay(decode_delay) {}
+
+std::optional<SeekIndex> SeekIndex::build(const std::string& video_path) {
+    AVFormatContext* format_ctx = nullptr;
+    if (avformat_open_input(&format_ctx, video_path.c_str(), nullptr, nullptr) < 0) {
+        return std::nullopt;
+    }
+    struct CloseInput {
+        AVFormatContext*& ctx;
+        ~CloseInput() { avformat_close_input(&ctx); }
+    } close_input{format_ctx};
+
+    if (avformat_find_stream_info(format_ctx, nullptr) < 0) return std::nullopt;
+
+    // Same stream selection as VideoReader
+    int stream_index = -1;
+    for (unsigned int i = 0; i < format_ctx->nb_streams; i++) {
+        if (stream_index < 0
+            && format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+            stream_index = static_cast<int>(i);
+        } else {
+            format_ctx->streams[i]->discard = AVDISCARD_ALL; // Demuxer skips their payloads
+        }
+    }
+    if (stream_index < 0) return std::nullopt;
+
+    std::vector<std::int64_t> frame_pts;
+    std::vector<std::int64_t> keyframe_pts;
+    AVPacket* packet = av_packet_alloc();
+    if (!packet) return std::nullopt;
+
+    bool complete = true;
+    bool open_gops = false;
+    std::int64_t decode_delay = 0;
+    std::int64_t gop_pts = AV_NOPTS_VALUE; ///< Keyframe of the GOP being read (decode order)
+    while (av_read_frame(format_ctx, packet) >= 0) {
+        if (packet->stream_index == stream_index && !(packet->flags & AV_PKT_FLAG_DISCARD)) {
+            const std::int64_t pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+            if (pts == AV_NOPTS_VALUE) {
+                complete = false;
+            } else {
+                frame_pts.push_back(pts);
+                if (packet->flags & AV_PKT_FLAG_KEY) {
+                    keyframe_pts.push_back(pts);
+                    gop_pts = pts;
+                    if (packet->dts != AV_NOPTS_VALUE) {
+                        decode_delay = std::max(decode_delay, pts - packet->dts);
+                    }
+                } else if (gop_pts != AV_NOPTS_VALUE && pts < gop_pts) {
+                    open_gops = true; // Leading picture of an open GOP
+                }
+            }
+        }
+        av_packet_unref(packet);
+        if (!complete) break;
+    }
+    av_packet_free(&packet);
+
+    if (!complete || frame_pts.empty()) {
+        Logger::get_instance()->debug(
+            std::format("SeekIndex: '{}' has no usable packet timestamps", video_path));
+        return std::nullopt;
+    }
+
+    // Packets arrive in decode order; frames are numbered in presentation order
+    std::ranges::sort(frame_pts);
+    std::vector<std::int64_t> keyframes;
+    keyframes.reserve(keyframe_pts.size());
+    for (const std::int64_t pts : keyframe_pts) {
+        keyframes.push_back(std::ranges::lower_bound(frame_pts, pts) - frame_pts.begin());
+    }
+    std::ranges::sort(keyframes);
+
+    const AVRational time_base = format_ctx->streams[stream_index]->time_base;
+    return SeekIndex(stream_index, time_base.num, time_base.den, std::move(frame_pts),
+                     std::move(keyframes), open_gops, decode_delay);
+}
+
+std::optional<SeekIndex> SeekIndex::load(const std::string& video_path) {
+    const auto key = file_key(video_path);
+    if (!key) return std::nullopt;
+
+    std::ifstream file(sidecar_path(video_path), std::ios::binary);
+    if (!file) return std::nullopt;
+
+    SidecarHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != kMagic || header.version != kVersion || !(header.key == *key)) {
+        return std::nullopt;
+    }
+
+    const std::vector<std::uint8_t> payload((std::istreambuf_iterator<char>(file)),
+                                            std::istreambuf_iterator<char>());
+    const std::uint8_t* cursor = payload.data();
+    const std::uint8_t* end = cursor + payload.size();
+    std::vector<std::int64_t> frame_pts;
+    std::vector<std::int64_t> keyframes;
+    if (!get_deltas(cursor, end, header.frame_count, frame_pts)
+        || !get_deltas(cursor, end, header.keyframe_count, keyframes)) {
+        return std::nullopt;
+    }
+    return SeekIndex(header.stream_index, header.time_base_num, header.time_base_den,
+                     std::move(frame_pts), std::move(keyframes), header.open_gops != 0,
+                     header.decode_delay);
+}
+
+std::optional<SeekIndex> SeekIndex::load_or_build(const std::string& video_path) {
+    if (auto index = load(video_path)) return index;
+
+    auto index = build(video_path);
+    if (index && !index->save(video_path)) {
+        Logger::get_instance()->debug(std::format(
+            "SeekIndex: Could not write '{}', index kept in memory", sidecar_path(video_path)));
+    }
+    return index;
+}
+
+bool SeekIndex::save(const std::string& video_path) const {
+    const auto key = file_key(video_path);
+    if (!key) return false;
+
+    SidecarHeader header;
+    header.key = *key;
+    header.stream_index = m_stream_index;
+    header.time_base_num = m_time_base_num;
+    header.time_base_den = m_time_base_den;
+    header.open_gops = m_open_gops ? 1 : 0;
+    header.decode_delay = m_decode_delay;
+    header.frame_count = m_frame_pts.size();
+    header.keyframe_count = m_keyframes.size();
+
+    std::vector<std::uint8_t> payload;
+    payload.reserve(m_frame_pts.size() * 2 + m_keyframes.size() * 2);
+    put_deltas(payload, m_frame_pts);
+    put_deltas(payload, m_keyframes);
+
+    // Write then rename, so a concurrent reader never sees a partial sidecar
+    const std::string path = sidecar_path(video_path);
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(payload.data()),
+                   static_cast<std::streamsize>(payload.size()));
+        if (!file) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) std::filesystem::remove(temp_path, ec);
+    return !ec;
+}
+
+std::string SeekIndex::sidecar_path(const std::string& video_path) {
+    return video_path + ".seekidx";
+}
+
+std::int64_t SeekIndex::frame_count() const {
+    return static_cast<std::int64_t>(m_frame_pts.size());
+}
+int SeekIndex::stream_index() const {
+    return m_stream_index;
+}
+int SeekIndex::time_base_num() const {
+    return m_time_base_num;
+}
+int SeekIndex::time_base_den() const {
+    return m_time_base_den;
+}
+bool SeekIndex::has_open_gops() const {
+    return m_open_gops;
+}
+std::int64_t SeekIndex::decode_delay() const {
+    return m_decode_delay;
+}
+
+std::optional<std::int64_t> SeekIndex::frame_pts(std::int64_t frame_index) const {
+    if (frame_index < 0 || frame_index >= frame_count()) return std::nullopt;
+    return m_frame_pts[static_cast<std::size_t>(frame_index)];
+}
+
+std::int64_t SeekIndex::keyframe_before(std::int64_t frame_index) const {
+    const auto it = std::ranges::upper_bound(m_keyframes, frame_index);
+    return it == m_keyframes.begin() ? -1 : *std::prev(it);
+}
+
+std::int64_t SeekIndex::frame_at_pts(std::int64_t pts) const {
+    return std::ranges::lower_bound(m_frame_pts, pts) - m_frame_pts.begin();
+}
+
+const std::vector<std::int64_t>& SeekIndex::keyframes() const {
+    return m_keyframes;
+}
+
+} // namespace foundation::media::ffmpeg
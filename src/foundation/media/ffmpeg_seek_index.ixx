@@ -0,0 +1,105 @@
+/**
+ * @file ffmpeg_seek_index.ixx
+ * @brief Frame-accurate seek index for video files, cached in a sidecar file
+ * @author CodingRookie
+ * @date 2026-01-27
+ */
+module;
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+export module foundation.media.ffmpeg:seek_index;
+
+namespace foundation::media::ffmpeg {
+
+/**
+ * @brief Presentation timestamps and keyframe positions of a video stream
+ * @details Built by reading packet headers only (nothing is decoded) and cached next to the
+ *          video as `<video>.seekidx`. The sidecar is keyed by file size, modification time and
+ *          a hash of the head and tail of the file, so a changed video is re-indexed.
+ */
+export class SeekIndex {
+public:
+    SeekIndex() = default;
+
+    /**
+     * @brief Construct from already known timestamps
+     * @param stream_index Index of the indexed video stream in the container
+     * @param time_base_num Stream time base numerator
+     * @param time_base_den Stream time base denominator
+     * @param frame_pts Frame timestamps in presentation order (sorted ascending)
+     * @param keyframes Frame indices of the keyframes (sorted ascending)
+     * @param open_gops Whether any frame is presented before the keyframe it is decoded after
+     * @param decode_delay Largest pts - dts of a keyframe packet (stream time base)
+     */
+    SeekIndex(int stream_index, int time_base_num, int time_base_den,
+              std::vector<std::int64_t> frame_pts, std::vector<std::int64_t> keyframes,
+              bool open_gops = false, std::int64_t decode_delay = 0);
+
+    /**
+     * @brief Scan the packet headers of the first video stream of @p video_path
+     */
+    static std::optional<SeekIndex> build(const std::string& video_path);
+
+    /**
+     * @brief Load the sidecar of @p video_path if it is present and still matches the file
+     */
+    static std::optional<SeekIndex> load(const std::string& video_path);
+
+    /**
+     * @brief Load the sidecar, or build the index and write the sidecar
+     * @details A sidecar that cannot be written (e.g. read-only directory) is not an error.
+     */
+    static std::optional<SeekIndex> load_or_build(const std::string& video_path);
+
+    /**
+     * @brief Write the sidecar for @p video_path
+     * @return true if the sidecar was written
+     */
+    bool save(const std::string& video_path) const;
+
+    /**
+     * @brief Path of the sidecar file of @p video_path
+     */
+    static std::string sidecar_path(const std::string& video_path);
+
+    [[nodiscard]] std::int64_t frame_count() const;  ///< Number of indexed frames
+    [[nodiscard]] int stream_index() const;          ///< Indexed stream in the container
+    [[nodiscard]] int time_base_num() const;         ///< Stream time base numerator
+    [[nodiscard]] int time_base_den() const;         ///< Stream time base denominator
+    [[nodiscard]] bool has_open_gops() const;        ///< GOPs reference their predecessor
+    [[nodiscard]] std::int64_t decode_delay() const; ///< Keyframe pts - dts (stream time base)
+
+    /**
+     * @brief Presentation timestamp of frame @p frame_index, if it exists
+     */
+    [[nodiscard]] std::optional<std::int64_t> frame_pts(std::int64_t frame_index) const;
+
+    /**
+     * @brief Index of the last keyframe at or before @p frame_index (-1 if there is none)
+     */
+    [[nodiscard]] std::int64_t keyframe_before(std::int64_t frame_index) const;
+
+    /**
+     * @brief Index of the first frame whose timestamp is not before @p pts
+     */
+    [[nodiscard]] std::int64_t frame_at_pts(std::int64_t pts) const;
+
+    /**
+     * @brief Frame indices of all keyframes, ascending
+     */
+    [[nodiscard]] const std::vector<std::int64_t>& keyframes() const;
+
+private:
+    int m_stream_index = -1;
+    int m_time_base_num = 0;
+    int m_time_base_den = 1;
+    std::vector<std::int64_t> m_frame_pts; ///< Presentation order
+    std::vector<std::int64_t> m_keyframes; ///< Frame indices
+    bool m_open_gops = false;
+    std::int64_t m_decode_delay = 0;
+};
+
+} // namespace foundation::media::ffmpeg
@@ -7,6 +7,7 @@
 
 module;
 
+#include <algorithm>
 #include <cstdint>
 #if defined(__clang__)
 #include <foundation/infrastructure/opencv_workaround.hpp>
@@ -14,6 +15,9 @@ module;
 #include <opencv2/opencv.hpp>
 #include <string>
 #include <vector>
+#include <optional>
+#include <limits>
+#include <utility>
 #include <iostream>
 #include <format>
 #include <filesystem>
@@ -24,6 +28,7 @@ module;
 
 extern "C" {
 #include <libavcodec/avcodec.h>
+#include <libavcodec/bsf.h>
 #include <libavformat/avformat.h>
 #include <libswscale/swscale.h>
 #include <libavutil/imgutils.h>
@@ -46,8 +51,17 @@ using namespace foundation::infrastructure::logger;
 // ============================================================================
 
 struct VideoWriter::Impl {
+    /**
+     * @brief Frame queued for encoding
+     */
+    struct PendingFrame {
+        cv::Mat image;
+        bool modified = true; ///< false: identical to the source frame (smart render)
+    };
+
     std::string output_path;
     std::string audio_source_path;
+    double audio_start_ms = 0.0;
     VideoParams params;
     AVFormatContext* format_ctx = nullptr;
     AVCodecContext* codec_ctx = nullptr;
@@ -56,11 +70,45 @@ struct VideoWriter::Impl {
     AVPacket* packet = nullptr;
     AVStream* video_stream = nullptr;
     bool is_open = false;
+    std::atomic<bool> write_failed = false; ///< A packet could not be encoded or muxed
     std::atomic<int> written_frame_count = 0;
     int64_t next_pts = 0;
 
+    // Audio passthrough: packets are copied from the source as the video catches up with them
+    AVFormatContext* audio_input_ctx = nullptr;
+    AVStream* audio_stream = nullptr;
+    AVPacket* audio_packet = nullptr; ///< Read-ahead packet not yet due for writing
+    int audio_input_index = -1;
+    int64_t audio_offset = 0;         ///< Source timestamp of output time zero (input time base)
+    bool audio_pending = false;
+    bool audio_eof = false;
+    bool audio_trim = false;          ///< Drop packets ending before audio_offset
+
+    // Smart render: GOPs without modified frames are copied from the source bitstream, the
+    // others are re-encoded with in-band parameter sets so both kinds can be spliced
+    std::string smart_source_path;
+    int64_t smart_first_frame = 0;           ///< Source index of the first written frame
+    bool smart_render = false;               ///< Active for the opened output
+    std::optional<SeekIndex> smart_index;
+    AVFormatContext* source_ctx = nullptr;
+    AVStream* source_stream = nullptr;
+    AVBSFContext* annexb_bsf = nullptr;      ///< Copied packets to Annex B with parameter sets
+    AVPacket* source_packet = nullptr;       ///< Read-ahead packet of the next GOP
+    bool source_pending = false;
+    bool source_eof = false;
+    const AVCodec* smart_codec = nullptr;
+    std::vector<PendingFrame> gop_frames;    ///< Unmodified frames of the current GOP so far
+    int64_t gop_first_frame = 0;             ///< Source index of the current GOP's first frame
+    int64_t gop_received = 0;                ///< Frames of the current GOP received so far
+    bool gop_encoding = false;               ///< Current GOP is being re-encoded
+    int64_t next_source_frame = 0;
+    int64_t video_ts_offset = 0;             ///< Source pts of the first written frame
+    int64_t last_video_dts = AV_NOPTS_VALUE; ///< Last written video dts (output time base)
+    int64_t copied_frames = 0;
+    int64_t copied_gops = 0;
+
     // Async support
-    ConcurrentQueue<cv::Mat> frame_queue{32};
+    ConcurrentQueue<PendingFrame> frame_queue{32};
     std::thread encoding_thread;
     std::atomic<bool> is_encoding = false;
     std::atomic<bool> stop_requested = false; // Graceful stop
@@ -69,7 +117,11 @@ struct VideoWriter::Impl {
 
     ~Impl() { cleanup(); }
 
-    void cleanup() {
+    /**
+     * @brief Finish and close the output
+     * @return false if any packet or the trailer of the opened output could not be written
+     */
+    bool cleanup() {
         if (is_encoding) { stop_encoding_and_wait(); }
 
         if (is_open && format_ctx && format_ctx->pb) {
@@ -85,10 +137,13 @@ struct VideoWriter::Impl {
 
             // We should ensure av_write_trailer is called.
             // It's safer to call it if header was written.
-            if (is_open) { // Assuming header was written if is_open is true
-                av_write_trailer(format_ctx);
+            if (is_open && av_write_trailer(format_ctx) < 0) {
+                Logger::get_instance()->error("VideoWriter: Failed to write trailer");
+                write_failed = true;
             }
         }
+        close_audio_input();
+        close_smart_source();
 
         if (sws_ctx) {
             sws_freeContext(sws_ctx);
@@ -107,12 +162,16 @@ struct VideoWriter::Impl {
             codec_ctx = nullptr;
         }
         if (format_ctx) {
-            if (format_ctx->pb) { avio_closep(&format_ctx->pb); }
+            if (format_ctx->pb && avio_closep(&format_ctx->pb) < 0 && is_open) {
+                Logger::get_instance()->error("VideoWriter: Failed to close output file");
+                write_failed = true;
+            }
             avformat_free_context(format_ctx);
             format_ctx = nullptr;
         }
         video_stream = nullptr;
         is_open = false;
+        return !write_failed;
     }
 
     void start_encoding() {
@@ -153,21 +212,188 @@ struct VideoWriter::Impl {
 
     void encoding_loop() {
         while (true) {
-            auto mat_opt = frame_queue.pop();
+            auto pending_opt = frame_queue.pop();
 
-            if (!mat_opt) {
+            if (!pending_opt) {
                 // Queue shutdown and empty -> we are done
                 break;
             }
 
-            process_frame(*mat_opt);
+            if (smart_render) {
+                process_smart_frame(std::move(*pending_opt));
+            } else {
+                process_frame(pending_opt->image);
+            }
         }
 
         // After queue is drained, flush encoder
-        flush_encoder();
+        if (smart_render) {
+            finish_gop();
+            close_encoder();
+            Logger::get_instance()->info(std::format(
+                "VideoWriter: Smart render copied {} of {} frames ({} GOPs) from the source",
+                copied_frames, next_source_frame - smart_first_frame, copied_gops));
+        } else {
+            flush_encoder();
+        }
+        // Remaining audio up to the end of the last frame
+        if (audio_stream) {
+            const auto [end_ts, end_time_base] = video_end();
+            write_audio_until(end_ts, end_time_base);
+        }
+    }
+
+    /**
+     * @brief End of the written video (timestamp and its time base)
+     */
+    std::pair<int64_t, AVRational> video_end() const {
+        if (!smart_render) return {next_pts, codec_ctx->time_base};
+
+        const AVRational time_base = source_stream->time_base;
+        const int64_t frame_count = smart_index->frame_count();
+        int64_t end = 0;
+        if (next_source_frame < frame_count) {
+            end = *smart_index->frame_pts(next_source_frame);
+        } else if (frame_count > 0) {
+            const int64_t last = *smart_index->frame_pts(frame_count - 1);
+            end = frame_count > 1 ? 2 * last - *smart_index->frame_pts(frame_count - 2) : last;
+        }
+        return {end - video_ts_offset, time_base};
+    }
+
+    /**
+     * @brief Open the audio source and add a stream-copy output stream for it
+     * @details Runs before the header is written. A missing or incompatible audio track leaves
+     *          the output video-only.
+     * @return false only if the output stream was added but could not be set up
+     */
+    bool open_audio_input() {
+        if (audio_source_path.empty()) return true;
+
+        auto skip_audio = [&](const std::string& reason) {
+            Logger::get_instance()->warn(std::format(
+                "VideoWriter: {} in '{}', writing video without audio", reason,
+                audio_source_path));
+            close_audio_input();
+        };
+
+        if (avformat_open_input(&audio_input_ctx, audio_source_path.c_str(), nullptr, nullptr)
+                < 0
+            || avformat_find_stream_info(audio_input_ctx, nullptr) < 0) {
+            skip_audio("Cannot read audio source");
+            return true;
+        }
+        audio_input_index =
+            av_find_best_stream(audio_input_ctx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+        if (audio_input_index < 0) {
+            skip_audio("No audio stream");
+            return true;
+        }
+
+        AVStream* in_stream = audio_input_ctx->streams[audio_input_index];
+        if (avformat_query_codec(format_ctx->oformat, in_stream->codecpar->codec_id,
+                                 FF_COMPLIANCE_NORMAL)
+            == 0) {
+            skip_audio(std::format("Audio codec '{}' not supported by the output container",
+                                   avcodec_get_name(in_stream->codecpar->codec_id)));
+            return true;
+        }
+
+        audio_stream = avformat_new_stream(format_ctx, nullptr);
+        audio_packet = av_packet_alloc();
+        if (!audio_stream || !audio_packet
+            || avcodec_parameters_copy(audio_stream->codecpar, in_stream->codecpar) < 0) {
+            Logger::get_instance()->error("VideoWriter: Failed to create audio stream");
+            return false;
+        }
+        audio_stream->codecpar->codec_tag = 0;
+        audio_stream->time_base = in_stream->time_base;
+
+        // Output time zero is the source start, shifted to the first written frame on resume.
+        // Smart render keeps source video timestamps, so zero is the first frame's timestamp.
+        int64_t start_us = static_cast<int64_t>(audio_start_ms * 1000.0);
+        if (audio_input_ctx->start_time != AV_NOPTS_VALUE) {
+            start_us += audio_input_ctx->start_time;
+        }
+        if (smart_render) {
+            start_us = av_rescale_q(video_ts_offset, source_stream->time_base, AV_TIME_BASE_Q);
+        }
+        audio_offset = av_rescale_q(start_us, AV_TIME_BASE_Q, in_stream->time_base);
+        audio_trim = audio_start_ms > 0.0 || (smart_render && smart_first_frame > 0);
+        if (audio_trim) {
+            av_seek_frame(audio_input_ctx, audio_input_index, audio_offset, AVSEEK_FLAG_BACKWARD);
+        }
+        return true;
+    }
+
+    void close_audio_input() {
+        if (audio_packet) { av_packet_free(&audio_packet); }
+        if (audio_input_ctx) { avformat_close_input(&audio_input_ctx); }
+        // The output stream itself is owned (and freed) by format_ctx
+        audio_stream = nullptr;
+        audio_input_index = -1;
+        audio_offset = 0;
+        audio_pending = false;
+        audio_eof = false;
+        audio_trim = false;
     }
 
-    void process_frame(const cv::Mat& mat) {
+    /**
+     * @brief Copy source audio packets whose timestamp is not after @p ts (in @p time_base)
+     * @details Called from the encoding thread before each video packet, so the muxer only
+     *          ever buffers about one video packet's worth of audio for interleaving.
+     */
+    void write_audio_until(int64_t ts, AVRational time_base) {
+        const AVRational in_time_base = audio_input_ctx->streams[audio_input_index]->time_base;
+        while (!audio_eof) {
+            if (!audio_pending) {
+                if (av_read_frame(audio_input_ctx, audio_packet) < 0) {
+                    audio_eof = true;
+                    break;
+                }
+                if (audio_packet->stream_index != audio_input_index) {
+                    av_packet_unref(audio_packet);
+                    continue;
+                }
+                audio_pending = true;
+            }
+
+            const int64_t packet_ts =
+                audio_packet->dts != AV_NOPTS_VALUE ? audio_packet->dts : audio_packet->pts;
+            const bool before_start =
+                audio_trim && packet_ts + audio_packet->duration <= audio_offset;
+            if (packet_ts == AV_NOPTS_VALUE || before_start) {
+                av_packet_unref(audio_packet);
+                audio_pending = false;
+                continue;
+            }
+            if (av_compare_ts(packet_ts - audio_offset, in_time_base, ts, time_base) > 0) break;
+
+            if (audio_packet->pts != AV_NOPTS_VALUE) { audio_packet->pts -= audio_offset; }
+            if (audio_packet->dts != AV_NOPTS_VALUE) { audio_packet->dts -= audio_offset; }
+            av_packet_rescale_ts(audio_packet, in_time_base, audio_stream->time_base);
+            audio_packet->stream_index = audio_stream->index;
+            audio_packet->pos = -1;
+
+            const int ret = av_interleaved_write_frame(format_ctx, audio_packet);
+            audio_pending = false;
+            if (ret < 0) {
+                // The rest of the audio would be missing: the output is incomplete
+                Logger::get_instance()->error("VideoWriter: Error writing audio packet");
+                write_failed = true;
+                audio_eof = true;
+            }
+        }
+    }
+
+    void process_frame(const cv::Mat& mat) { encode_image(mat, next_pts++, false); }
+
+    /**
+     * @brief Convert and encode one frame
+     * @param pts Timestamp in the encoder time base
+     * @param force_keyframe Start a new (closed) GOP with this frame
+     */
+    void encode_image(const cv::Mat& mat, int64_t pts, bool force_keyframe) {
         if (mat.empty() || mat.cols != codec_ctx->width || mat.rows != codec_ctx->height) {
             Logger::get_instance()->error("VideoWriter: Invalid frame dimensions");
             return;
@@ -185,12 +411,14 @@ struct VideoWriter::Impl {
         sws_scale(sws_ctx, src_data, src_linesize, 0, codec_ctx->height, frame->data,
                   frame->linesize);
 
-        frame->pts = next_pts++;
+        frame->pts = pts;
+        frame->pict_type = force_keyframe ? AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_NONE;
 
         // Encode frame
         int ret = avcodec_send_frame(codec_ctx, frame);
         if (ret < 0) {
             Logger::get_instance()->error("VideoWriter: Error sending frame to encoder");
+            write_failed = true;
             return;
         }
 
@@ -211,35 +439,393 @@ struct VideoWriter::Impl {
             if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) { break; }
             if (ret < 0) {
                 Logger::get_instance()->error("VideoWriter: Error receiving packet from encoder");
+                write_failed = true;
                 break;
             }
 
-            av_packet_rescale_ts(packet, codec_ctx->time_base, video_stream->time_base);
-            packet->stream_index = video_stream->index;
+            if (smart_render && packet->pts != AV_NOPTS_VALUE) {
+                // Encoded without B-frames (dts == pts): take over the source's decode delay so
+                // that copied GOPs after this one continue its dts (see write_video_packet)
+                packet->dts = packet->pts - smart_index->decode_delay();
+                packet->pts -= video_ts_offset;
+                packet->dts -= video_ts_offset;
+            }
 
-            ret = av_interleaved_write_frame(format_ctx, packet);
-            av_packet_unref(packet);
+            ret = write_video_packet(packet, codec_ctx->time_base);
             if (ret < 0) {
                 Logger::get_instance()->error("VideoWriter: Error writing packet");
+                write_failed = true;
                 break;
             }
         }
     }
 
-    bool open() {
-        // Cleanup strictly implies closing previous, but here we just ensure clean state
-        // cleanup(); // Called by caller (VideoWriter::open -> impl->open) usually? No, impl->open
-        // calls cleanup. Let's call cleanup at start of open to be safe. But wait, open() logic
-        // below sets is_open=true. cleanup() checks is_open.
+    /**
+     * @brief Interleave due audio, then write (and release) one video packet
+     */
+    int write_video_packet(AVPacket* video_packet, AVRational time_base) {
+        av_packet_rescale_ts(video_packet, time_base, video_stream->time_base);
+        video_packet->stream_index = video_stream->index;
+        video_packet->pos = -1;
+        if (smart_render && video_packet->dts != AV_NOPTS_VALUE) {
+            // The decode delay is the largest of all keyframes, so a re-encoded GOP after a
+            // copied one with a smaller delay could start before its last dts: move it up
+            if (last_video_dts != AV_NOPTS_VALUE && video_packet->dts <= last_video_dts) {
+                video_packet->dts = last_video_dts + 1;
+            }
+            last_video_dts = video_packet->dts;
+        }
+        if (audio_stream && video_packet->dts != AV_NOPTS_VALUE) {
+            write_audio_until(video_packet->dts, video_stream->time_base);
+        }
 
-        if (is_open) cleanup();
+        const int ret = av_interleaved_write_frame(format_ctx, video_packet);
+        av_packet_unref(video_packet);
+        return ret;
+    }
 
-        if (avformat_alloc_output_context2(&format_ctx, nullptr, nullptr, output_path.c_str())
-            < 0) {
-            Logger::get_instance()->error("VideoWriter: Failed to allocate output context");
+    /**
+     * @brief Set up smart render for the output being opened
+     * @details Requires a closed-GOP H.264/HEVC source of the output frame size, a muxer that
+     *          accepts the source codec and the matching x264/x265 encoder. Otherwise the reason
+     *          is logged and every frame is encoded as usual.
+     * @return true if smart render is active
+     */
+    bool open_smart_source() {
+        auto fallback = [&](const std::string& reason) {
+            Logger::get_instance()->warn(std::format(
+                "VideoWriter: Smart render disabled ({}), encoding every frame", reason));
+            close_smart_source();
             return false;
+        };
+
+        smart_index = SeekIndex::load_or_build(smart_source_path);
+        if (!smart_index || smart_index->frame_count() <= smart_first_frame) {
+            return fallback("source cannot be indexed");
+        }
+        if (smart_index->has_open_gops()) { return fallback("source has open GOPs"); }
+
+        if (avformat_open_input(&source_ctx, smart_source_path.c_str(), nullptr, nullptr) < 0
+            || avformat_find_stream_info(source_ctx, nullptr) < 0
+            || smart_index->stream_index() >= static_cast<int>(source_ctx->nb_streams)) {
+            return fallback("source cannot be read");
+        }
+        source_stream = source_ctx->streams[smart_index->stream_index()];
+        const AVCodecParameters* source_par = source_stream->codecpar;
+
+        if (source_par->width != static_cast<int>(params.width)
+            || source_par->height != static_cast<int>(params.height)) {
+            return fallback("frame size differs from the source");
+        }
+        const bool is_hevc = source_par->codec_id == AV_CODEC_ID_HEVC;
+        if (source_par->codec_id != AV_CODEC_ID_H264 && !is_hevc) {
+            return fallback(std::format("source codec '{}' is not H.264 or HEVC",
+                                        avcodec_get_name(source_par->codec_id)));
+        }
+        if (avformat_query_codec(format_ctx->oformat, source_par->codec_id, FF_COMPLIANCE_NORMAL)
+            != 1) {
+            return fallback("output container cannot hold the source codec");
+        }
+        smart_codec = avcodec_find_encoder_by_name(is_hevc ? "libx265" : "libx264");
+        if (!smart_codec) { return fallback("no libx264/libx265 encoder"); }
+
+        // Copied packets get in-band parameter sets, like the re-encoded ones
+        const AVBitStreamFilter* filter =
+            av_bsf_get_by_name(is_hevc ? "hevc_mp4toannexb" : "h264_mp4toannexb");
+        if (!filter || av_bsf_alloc(filter, &annexb_bsf) < 0
+            || avcodec_parameters_copy(annexb_bsf->par_in, source_par) < 0) {
+            return fallback("bitstream filter unavailable");
+        }
+        annexb_bsf->time_base_in = source_stream->time_base;
+        if (av_bsf_init(annexb_bsf) < 0) { return fallback("bitstream filter unavailable"); }
+
+        source_packet = av_packet_alloc();
+        if (!source_packet) { return fallback("out of memory"); }
+        if (!open_gop_encoder()) {
+            return fallback(std::format("{} rejects the source format", smart_codec->name));
+        }
+
+        const int64_t first_key = smart_index->keyframe_before(smart_first_frame);
+        if (first_key > 0) {
+            av_seek_frame(source_ctx, source_stream->index, *smart_index->frame_pts(first_key),
+                          AVSEEK_FLAG_BACKWARD);
+        }
+        video_ts_offset = *smart_index->frame_pts(smart_first_frame);
+        next_source_frame = smart_first_frame;
+        gop_first_frame = smart_first_frame;
+        return true;
+    }
+
+    void close_smart_source() {
+        if (annexb_bsf) { av_bsf_free(&annexb_bsf); }
+        if (source_packet) { av_packet_free(&source_packet); }
+        if (source_ctx) { avformat_close_input(&source_ctx); }
+        source_stream = nullptr;
+        smart_codec = nullptr;
+        smart_index.reset();
+        smart_render = false;
+        source_pending = false;
+        source_eof = false;
+        gop_frames.clear();
+        gop_received = 0;
+        gop_encoding = false;
+        video_ts_offset = 0;
+        copied_frames = 0;
+        copied_gops = 0;
+    }
+
+    /**
+     * @brief Open the encoder for a run of re-encoded GOPs
+     * @details Encodes in the source format, profile, level and time base without B-frames.
+     *          Each GOP starts with a forced IDR frame that repeats the parameter sets, so it
+     *          decodes on its own next to copied GOPs.
+     */
+    bool open_gop_encoder() {
+        codec_ctx = avcodec_alloc_context3(smart_codec);
+        if (!codec_ctx) return false;
+
+        const AVCodecParameters* source_par = source_stream->codecpar;
+        codec_ctx->width = source_par->width;
+        codec_ctx->height = source_par->height;
+        codec_ctx->pix_fmt = static_cast<AVPixelFormat>(source_par->format);
+        codec_ctx->sample_aspect_ratio = source_par->sample_aspect_ratio;
+        codec_ctx->color_range = source_par->color_range;
+        codec_ctx->color_primaries = source_par->color_primaries;
+        codec_ctx->color_trc = source_par->color_trc;
+        codec_ctx->colorspace = source_par->color_space;
+        codec_ctx->time_base = source_stream->time_base;
+        codec_ctx->framerate = source_stream->avg_frame_rate;
+        codec_ctx->gop_size = params.gopSize;
+        codec_ctx->max_b_frames = 0;
+        if (params.threadCount > 0) { codec_ctx->thread_count = params.threadCount; }
+        codec_ctx->thread_type = thread_type_flags(params.threadType);
+        apply_encoder_options(smart_codec->name);
+
+        // Players set up their decoder from the sample entry of the copied source stream:
+        // re-encoded GOPs keep its profile and level (which bounds the reference frames)
+        const bool is_hevc = source_par->codec_id == AV_CODEC_ID_HEVC;
+        const std::string profile = source_profile_name(source_par);
+        if (!profile.empty()) {
+            av_opt_set(codec_ctx->priv_data, "profile", profile.c_str(), 0);
+        }
+        if (source_par->level > 0) { codec_ctx->level = source_par->level; }
+
+        const char* params_key = is_hevc ? "x265-params" : "x264-params";
+        uint8_t* user_params = nullptr;
+        av_opt_get(codec_ctx->priv_data, params_key, 0, &user_params);
+        std::string encoder_params = "repeat-headers=1";
+        if (is_hevc && source_par->level > 0) {
+            // general_level_idc is 30 times the level; x265 ignores AVCodecContext::level
+            encoder_params += std::format(":level-idc={:.1f}", source_par->level / 30.0);
+        }
+        if (user_params && *user_params) {
+            encoder_params = std::format("{}:{}", reinterpret_cast<char*>(user_params),
+                                         encoder_params);
+        }
+        av_free(user_params);
+        av_opt_set(codec_ctx->priv_data, params_key, encoder_params.c_str(), 0);
+        av_opt_set(codec_ctx->priv_data, "forced-idr", "1", 0);
+
+        if (avcodec_open2(codec_ctx, smart_codec, nullptr) < 0) {
+            avcodec_free_context(&codec_ctx);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief x264/x265 profile name of the source stream (empty if it has no equivalent)
+     */
+    static std::string source_profile_name(const AVCodecParameters* par) {
+        if (par->codec_id == AV_CODEC_ID_HEVC) {
+            switch (par->profile) {
+            case AV_PROFILE_HEVC_MAIN: return "main";
+            case AV_PROFILE_HEVC_MAIN_10: return "main10";
+            case AV_PROFILE_HEVC_MAIN_STILL_PICTURE: return "mainstillpicture";
+            default: return "";
+            }
+        }
+        switch (par->profile) {
+        case AV_PROFILE_H264_BASELINE:
+        case AV_PROFILE_H264_CONSTRAINED_BASELINE: return "baseline";
+        case AV_PROFILE_H264_MAIN: return "main";
+        case AV_PROFILE_H264_HIGH: return "high";
+        case AV_PROFILE_H264_HIGH_10: return "high10";
+        case AV_PROFILE_H264_HIGH_422: return "high422";
+        case AV_PROFILE_H264_HIGH_444_PREDICTIVE: return "high444";
+        default: return "";
+        }
+    }
+
+    /**
+     * @brief Drain and free the GOP encoder
+     */
+    void close_encoder() {
+        if (!codec_ctx) return;
+        flush_encoder();
+        avcodec_free_context(&codec_ctx);
+    }
+
+    void process_smart_frame(PendingFrame pending) {
+        const int64_t index = next_source_frame;
+        if (index >= smart_index->frame_count()) {
+            if (index == smart_index->frame_count()) {
+                Logger::get_instance()->warn(
+                    "VideoWriter: More frames than the source, dropping the rest");
+            }
+            ++next_source_frame;
+            return;
+        }
+        if (gop_received > 0 && smart_index->keyframe_before(index) == index) { finish_gop(); }
+
+        const bool modified = pending.modified;
+        gop_frames.push_back(std::move(pending));
+        ++gop_received;
+        ++next_source_frame;
+        // Once a GOP has to be re-encoded its frames need not be held back any more
+        if (gop_encoding || modified) {
+            gop_encoding = true;
+            encode_gop_frames();
+        }
+    }
+
+    /**
+     * @brief Send the held frames of the current GOP to the encoder
+     */
+    void encode_gop_frames() {
+        if (!codec_ctx && !open_gop_encoder()) {
+            Logger::get_instance()->error("VideoWriter: Failed to open encoder");
+            gop_frames.clear();
+            return;
+        }
+        int64_t index = next_source_frame - static_cast<int64_t>(gop_frames.size());
+        for (const auto& pending : gop_frames) {
+            encode_image(pending.image, *smart_index->frame_pts(index), index == gop_first_frame);
+            ++index;
+        }
+        gop_frames.clear();
+    }
+
+    /**
+     * @brief Complete the current GOP: copy it from the source if it is whole and unmodified
+     */
+    void finish_gop() {
+        if (!gop_frames.empty() && !copy_source_gop()) { encode_gop_frames(); }
+        gop_frames.clear();
+        gop_received = 0;
+        gop_encoding = false;
+        gop_first_frame = next_source_frame;
+    }
+
+    bool copy_source_gop() {
+        const int64_t frame_count = smart_index->frame_count();
+        const auto& keyframes = smart_index->keyframes();
+        const auto next_key = std::ranges::upper_bound(keyframes, gop_first_frame);
+        const int64_t gop_end = next_key == keyframes.end() ? frame_count : *next_key;
+        if (smart_index->keyframe_before(gop_first_frame) != gop_first_frame
+            || gop_first_frame + gop_received != gop_end) {
+            return false; // Partial GOP (resume point or end of the processed range)
+        }
+
+        // Closed GOPs: every packet of this GOP precedes the next keyframe in decode order
+        const int64_t start_pts = *smart_index->frame_pts(gop_first_frame);
+        const int64_t end_pts = gop_end < frame_count ? *smart_index->frame_pts(gop_end)
+                                                      : std::numeric_limits<int64_t>::max();
+        std::vector<AVPacket*> packets;
+        bool copyable = true;
+        while (!source_eof) {
+            if (!source_pending) {
+                if (av_read_frame(source_ctx, source_packet) < 0) {
+                    source_eof = true;
+                    break;
+                }
+                if (source_packet->stream_index != source_stream->index) {
+                    av_packet_unref(source_packet);
+                    continue;
+                }
+                source_pending = true;
+            }
+            if (source_packet->pts != AV_NOPTS_VALUE && source_packet->pts >= end_pts) break;
+            if (source_packet->pts == AV_NOPTS_VALUE || source_packet->pts >= start_pts) {
+                copyable = copyable && source_packet->pts != AV_NOPTS_VALUE
+                        && !(source_packet->flags & AV_PKT_FLAG_DISCARD);
+                AVPacket* copy = av_packet_alloc();
+                if (copy) {
+                    av_packet_move_ref(copy, source_packet);
+                    packets.push_back(copy);
+                }
+            }
+            av_packet_unref(source_packet);
+            source_pending = false;
+        }
+
+        copyable = copyable && static_cast<int64_t>(packets.size()) == gop_received;
+        if (copyable) {
+            close_encoder();
+            for (AVPacket* copy : packets) {
+                if (av_bsf_send_packet(annexb_bsf, copy) < 0) {
+                    Logger::get_instance()->error("VideoWriter: Bitstream filter failed");
+                    write_failed = true;
+                    break;
+                }
+                while (av_bsf_receive_packet(annexb_bsf, packet) == 0) {
+                    packet->pts -= video_ts_offset;
+                    if (packet->dts != AV_NOPTS_VALUE) { packet->dts -= video_ts_offset; }
+                    if (write_video_packet(packet, source_stream->time_base) < 0) {
+                        Logger::get_instance()->error("VideoWriter: Error writing packet");
+                        write_failed = true;
+                    }
+                }
+            }
+            copied_frames += gop_received;
+            ++copied_gops;
+        }
+        for (AVPacket* copy : packets) av_packet_free(&copy);
+        return copyable;
+    }
+
+    /**
+     * @brief Rate control and user options shared by both encoding paths
+     */
+    void apply_encoder_options(const std::string& codec_name) {
+        // Bitrate Control vs CRF
+        bool use_bitrate = params.bitRate > 0;
+        if (use_bitrate) {
+            codec_ctx->bit_rate = params.bitRate;
+            if (params.maxBitRate > 0) { codec_ctx->rc_max_rate = params.maxBitRate; }
+            if (params.bufSize > 0) { codec_ctx->rc_buffer_size = params.bufSize; }
+        } else {
+            // Set quality (CRF for x264/x265) if bitrate is not set
+            if (codec_name == "libx264" || codec_name == "libx265") {
+                int crf = static_cast<int>(51 - params.quality * 0.51);
+                av_opt_set(codec_ctx->priv_data, "crf", std::to_string(crf).c_str(), 0);
+            }
         }
 
+        // Common options
+        if (!params.preset.empty()) {
+            av_opt_set(codec_ctx->priv_data, "preset", params.preset.c_str(), 0);
+        }
+        if (!params.tune.empty()) {
+            av_opt_set(codec_ctx->priv_data, "tune", params.tune.c_str(), 0);
+        }
+        if (!params.profile.empty()) {
+            av_opt_set(codec_ctx->priv_data, "profile", params.profile.c_str(), 0);
+        }
+        if (!params.level.empty()) {
+            av_opt_set(codec_ctx->priv_data, "level", params.level.c_str(), 0);
+        }
+
+        // Extra Options
+        for (const auto& [key, value] : params.extraOptions) {
+            av_opt_set(codec_ctx->priv_data, key.c_str(), value.c_str(), 0);
+        }
+    }
+
+    /**
+     * @brief Open the encoder and add its output stream
+     */
+    bool open_encoder_stream() {
         // Find encoder
         std::string codec_name = params.videoCodec.empty() ? "libx264" : params.videoCodec;
         const AVCodec* codec = avcodec_find_encoder_by_name(codec_name.c_str());
@@ -291,39 +877,9 @@ struct VideoWriter::Impl {
         codec_ctx->max_b_frames = params.maxBFrames;
 
         if (params.threadCount > 0) { codec_ctx->thread_count = params.threadCount; }
+        codec_ctx->thread_type = thread_type_flags(params.threadType);
 
-        // Bitrate Control vs CRF
-        bool use_bitrate = params.bitRate > 0;
-        if (use_bitrate) {
-            codec_ctx->bit_rate = params.bitRate;
-            if (params.maxBitRate > 0) { codec_ctx->rc_max_rate = params.maxBitRate; }
-            if (params.bufSize > 0) { codec_ctx->rc_buffer_size = params.bufSize; }
-        } else {
-            // Set quality (CRF for x264/x265) if bitrate is not set
-            if (codec_name == "libx264" || codec_name == "libx265") {
-                int crf = static_cast<int>(51 - params.quality * 0.51);
-                av_opt_set(codec_ctx->priv_data, "crf", std::to_string(crf).c_str(), 0);
-            }
-        }
-
-        // Common options
-        if (!params.preset.empty()) {
-            av_opt_set(codec_ctx->priv_data, "preset", params.preset.c_str(), 0);
-        }
-        if (!params.tune.empty()) {
-            av_opt_set(codec_ctx->priv_data, "tune", params.tune.c_str(), 0);
-        }
-        if (!params.profile.empty()) {
-            av_opt_set(codec_ctx->priv_data, "profile", params.profile.c_str(), 0);
-        }
-        if (!params.level.empty()) {
-            av_opt_set(codec_ctx->priv_data, "level", params.level.c_str(), 0);
-        }
-
-        // Extra Options
-        for (const auto& [key, value] : params.extraOptions) {
-            av_opt_set(codec_ctx->priv_data, key.c_str(), value.c_str(), 0);
-        }
+        apply_encoder_options(codec_name);
 
         if (format_ctx->oformat->flags & AVFMT_GLOBALHEADER) {
             codec_ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
@@ -342,9 +898,61 @@ struct VideoWriter::Impl {
         }
 
         video_stream->time_base = codec_ctx->time_base;
+        return true;
+    }
+
+    /**
+     * @brief Add the output stream for smart render, carrying the source codec parameters
+     */
+    bool open_copy_stream() {
+        video_stream = avformat_new_stream(format_ctx, nullptr);
+        if (!video_stream
+            || avcodec_parameters_copy(video_stream->codecpar, annexb_bsf->par_out) < 0) {
+            Logger::get_instance()->error("VideoWriter: Failed to create stream");
+            cleanup();
+            return false;
+        }
+        // Both copied and re-encoded GOPs carry their parameter sets in-band: where the muxer
+        // knows them, use the sample entries that tell players to take those (avc3 / hev1)
+        const AVCodecID codec_id = video_stream->codecpar->codec_id;
+        const uint32_t inband_tag =
+            codec_id == AV_CODEC_ID_HEVC ? MKTAG('h', 'e', 'v', '1') : MKTAG('a', 'v', 'c', '3');
+        const bool tag_supported = format_ctx->oformat->codec_tag
+                                && av_codec_get_id(format_ctx->oformat->codec_tag, inband_tag)
+                                       == codec_id;
+        video_stream->codecpar->codec_tag = tag_supported ? inband_tag : 0;
+        video_stream->time_base = source_stream->time_base;
+        video_stream->avg_frame_rate = source_stream->avg_frame_rate;
+        return true;
+    }
+
+    bool open() {
+        // Cleanup strictly implies closing previous, but here we just ensure clean state
+        // cleanup(); // Called by caller (VideoWriter::open -> impl->open) usually? No, impl->open
+        // calls cleanup. Let's call cleanup at start of open to be safe. But wait, open() logic
+        // below sets is_open=true. cleanup() checks is_open.
+
+        if (is_open) cleanup();
+
+        const std::string url = stream_url(output_path, true);
+        const char* format_name =
+            params.containerFormat.empty() ? nullptr : params.containerFormat.c_str();
+        if (avformat_alloc_output_context2(&format_ctx, nullptr, format_name, url.c_str()) < 0) {
+            Logger::get_instance()->error("VideoWriter: Failed to allocate output context");
+            return false;
+        }
+
+        // Smart render copies the source bitstream, so the stream takes the source codec
+        smart_render = !smart_source_path.empty() && open_smart_source();
+        if (!(smart_render ? open_copy_stream() : open_encoder_stream())) { return false; }
+
+        if (!open_audio_input()) {
+            cleanup();
+            return false;
+        }
 
         if (!(format_ctx->oformat->flags & AVFMT_NOFILE)) {
-            if (avio_open(&format_ctx->pb, output_path.c_str(), AVIO_FLAG_WRITE) < 0) {
+            if (avio_open(&format_ctx->pb, url.c_str(), AVIO_FLAG_WRITE) < 0) {
                 Logger::get_instance()->error(
                     std::format("VideoWriter: Failed to open output file: {}", output_path));
                 cleanup();
@@ -352,7 +960,20 @@ struct VideoWriter::Impl {
             }
         }
 
-        if (avformat_write_header(format_ctx, nullptr) < 0) {
+        // A pipe cannot be seeked back to finish the header: MP4 goes out as self-contained
+        // fragments, and every packet is handed on as soon as it is muxed
+        AVDictionary* muxer_options = nullptr;
+        if (is_stream_path(output_path)) {
+            format_ctx->flush_packets = 1;
+            const std::string muxer = format_ctx->oformat->name;
+            if (muxer.find("mp4") != std::string::npos || muxer.find("mov") != std::string::npos) {
+                av_dict_set(&muxer_options, "movflags",
+                            "frag_keyframe+empty_moov+default_base_moof", 0);
+            }
+        }
+        const int header_ret = avformat_write_header(format_ctx, &muxer_options);
+        av_dict_free(&muxer_options);
+        if (header_ret < 0) {
             Logger::get_instance()->error("VideoWriter: Failed to write header");
             cleanup();
             return false;
@@ -382,6 +1003,8 @@ struct VideoWriter::Impl {
         }
 
         is_open = true;
+        write_failed = false;
+        last_video_dts = AV_NOPTS_VALUE;
         written_frame_count = 0;
         next_pts = 0;
 
@@ -389,10 +1012,10 @@ struct VideoWriter::Impl {
         return true;
     }
 
-    bool write_frame(const cv::Mat& mat) {
-        if (!is_open) { return false; }
+    bool write_frame(const cv::Mat& mat, bool modified) {
+        if (!is_open || write_failed) { return false; }
 
-        frame_queue.push(mat.clone());
+        frame_queue.push({mat.clone(), modified});
         written_frame_count++; // Increment here to satisfy test expectation of submitted frames
         return true;
     }
@@ -411,21 +1034,34 @@ VideoWriter& VideoWriter::operator=(VideoWriter&&) noexcept = default;
 bool VideoWriter::open() {
     return impl_->open();
 }
-void VideoWriter::close() {
-    impl_->cleanup();
+bool VideoWriter::close() {
+    return impl_->cleanup();
 }
 bool VideoWriter::is_opened() const {
     return impl_->is_open;
 }
-bool VideoWriter::write_frame(const cv::Mat& frame) {
-    return impl_->write_frame(frame);
+bool VideoWriter::write_frame(const cv::Mat& frame, bool modified) {
+    return impl_->write_frame(frame, modified);
 }
 int VideoWriter::get_written_frame_count() const {
     return impl_->written_frame_count;
 }
 
-void VideoWriter::set_audio_source(const std::string& sourceVideoPath) {
+void VideoWriter::set_audio_source(const std::string& sourceVideoPath, double startTimeMs) {
     impl_->audio_source_path = sourceVideoPath;
+    impl_->audio_start_ms = startTimeMs;
+}
+bool VideoWriter::has_audio() const {
+    return impl_->audio_stream != nullptr;
+}
+
+void VideoWriter::enable_smart_render(const std::string& sourceVideoPath,
+                                      std::int64_t firstFrame) {
+    impl_->smart_source_path = sourceVideoPath;
+    impl_->smart_first_frame = firstFrame;
+}
+bool VideoWriter::is_smart_render() const {
+    return impl_->smart_render;
 }
 
 } // namespace foundation::media::ffmpeg
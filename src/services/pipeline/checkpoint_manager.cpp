@@ -25,8 +25,8 @@ using foundation::infrastructure::logger::Logger;
 
 // JSON serialization helpers
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(CheckpointData, task_id, config_hash, last_completed_frame,
-                                   total_frames, output_path, output_file_size, created_at,
-                                   updated_at, version, checksum)
+                                   total_frames, output_path, output_file_size, segments,
+                                   created_at, updated_at, version, checksum)
 
 CheckpointManager::CheckpointManager(const std::filesystem::path& checkpoint_dir) :
     m_checkpoint_dir(checkpoint_dir),
@@ -214,6 +214,7 @@ std::string CheckpointManager::calculate_checksum(const CheckpointData& data) co
     j["total_frames"] = data.total_frames;
     j["output_path"] = data.output_path;
     j["output_file_size"] = data.output_file_size;
+    j["segments"] = data.segments;
     j["created_at"] = data.created_at;
     j["updated_at"] = data.updated_at;
     j["version"] = data.version;
@@ -37,8 +37,9 @@ struct CheckpointData {
     // ─────────────────────────────────────────────────────────────────────────
     // Output Tracking
     // ─────────────────────────────────────────────────────────────────────────
-    std::string output_path;      ///< Current output file path
-    int64_t output_file_size = 0; ///< Size of partial output file (optional validation)
+    std::string output_path;           ///< Current output file path
+    int64_t output_file_size = 0;      ///< Size of partial output file (optional validation)
+    std::vector<std::string> segments; ///< Closed output segments up to last_completed_frame
 
     // ─────────────────────────────────────────────────────────────────────────
     // Metadata
@@ -108,6 +108,48 @@ void MetricsCollector::record_gpu_memory(int64_t usage_mb) {
     m_gpu_sample_count++;
 }
 
+void MetricsCollector::set_counter(const std::string& name, double value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters[name] = value;
+}
+
+void MetricsCollector::add_counter(const std::string& name, double delta) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters[name] += delta;
+}
+
+void MetricsCollector::merge(const MetricsCollector& other) {
+    if (&other == this) return;
+    std::scoped_lock lock(m_mutex, other.m_mutex);
+
+    m_summary.total_frames += other.m_summary.total_frames;
+    m_summary.processed_frames += other.m_summary.processed_frames;
+    m_summary.failed_frames += other.m_summary.failed_frames;
+    m_summary.skipped_frames += other.m_summary.skipped_frames;
+
+    for (const auto& [name, samples] : other.m_step_samples) {
+        auto& merged = m_step_samples[name];
+        merged.insert(merged.end(), samples.begin(), samples.end());
+    }
+
+    // Sample timestamps are relative to the start of their own collector
+    const auto offset =
+        std::chrono::duration_cast<std::chrono::milliseconds>(other.m_start_time - m_start_time)
+            .count();
+    for (const auto& sample : other.m_gpu_samples) {
+        m_gpu_samples.push_back({sample.timestamp_ms + offset, sample.usage_mb});
+    }
+    std::ranges::sort(m_gpu_samples, {}, &GpuMemorySample::timestamp_ms);
+    m_gpu_peak_mb = std::max(m_gpu_peak_mb, other.m_gpu_peak_mb);
+    m_gpu_sum_mb += other.m_gpu_sum_mb;
+    m_gpu_sample_count += other.m_gpu_sample_count;
+
+    for (const auto& [name, value] : other.m_counters) {
+        if (name.ends_with("rate")) continue;
+        m_counters[name] += value;
+    }
+}
+
 std::string MetricsCollector::to_json() const {
     auto metrics = get_metrics();
 
@@ -144,6 +186,10 @@ std::string MetricsCollector::to_json() const {
             {{"timestamp_ms", sample.timestamp_ms}, {"usage_mb", sample.usage_mb}});
     }
 
+    // Named counters
+    j["counters"] = json::object();
+    for (const auto& [name, value] : metrics.counters) { j["counters"][name] = value; }
+
     return j.dump(2); // Pretty print
 }
 
@@ -170,6 +216,8 @@ TaskMetrics MetricsCollector::get_metrics() const {
     m.gpu_memory.avg_mb = m_gpu_sample_count > 0 ? m_gpu_sum_mb / m_gpu_sample_count : 0;
     m.gpu_memory.samples = m_gpu_samples;
 
+    m.counters = m_counters;
+
     return m;
 }
 
@@ -10,6 +10,7 @@ module;
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <chrono>
 #include <filesystem>
 #include <mutex>
@@ -75,6 +76,7 @@ struct TaskMetrics {
     ProcessingSummary summary;
     std::vector<StepLatency> step_latency;
     GpuMemoryStats gpu_memory;
+    std::map<std::string, double> counters; ///< Named counters, e.g. "face_store.hit_rate"
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -162,6 +164,33 @@ public:
      */
     void record_gpu_memory(int64_t usage_mb);
 
+    // ─────────────────────────────────────────────────────────────────────────
+    // Named Counters
+    // ─────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Set a named counter, replacing any previous value
+     * @param name Dotted counter name (e.g., "face_store.hits")
+     */
+    void set_counter(const std::string& name, double value);
+
+    /**
+     * @brief Add to a named counter (starting from 0 if unset)
+     */
+    void add_counter(const std::string& name, double delta);
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // Aggregation
+    // ─────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Add the frames, step samples, GPU samples and counters of @p other
+     * @details Used for the summary of several targets processed side by side. Counters are
+     *          summed, except ratios (names ending in "rate"), which cannot be combined from
+     *          the values alone and are left out. Duration stays that of this collector.
+     */
+    void merge(const MetricsCollector& other);
+
     // ─────────────────────────────────────────────────────────────────────────
     // Export
     // ─────────────────────────────────────────────────────────────────────────
@@ -206,6 +235,9 @@ private:
     int64_t m_gpu_sum_mb = 0;
     int64_t m_gpu_sample_count = 0;
 
+    // Named counters
+    std::map<std::string, double> m_counters;
+
     // ─────────────────────────────────────────────────────────────────────────
     // Internal Helpers
     // ─────────────────────────────────────────────────────────────────────────
@@ -13,6 +13,11 @@ module;
 #include <iostream>
 #include <variant>
 #include <algorithm>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <map>
+#include <mutex>
 #include <opencv2/opencv.hpp>
 
 module services.pipeline.runner;
@@ -28,14 +33,20 @@ import domain.face.recognizer;
 import domain.face.masker;
 import domain.face.analyser;
 import domain.face.helper;
+import domain.face.store;
+import domain.face.embedding_cache;
 import domain.ai.model_repository;
 import foundation.ai.inference_session;
+import foundation.ai.inference_session_registry;
 import foundation.media.ffmpeg;
 import foundation.infrastructure.logger;
+import foundation.infrastructure.crypto;
+import foundation.infrastructure.concurrent_file_system;
 import foundation.infrastructure.scoped_timer;
 
 import services.pipeline.processors.face_analysis;
 import services.pipeline.metrics;
+import services.pipeline.scheduler;
 import :types;
 import :video;
 import :image;
@@ -150,8 +161,9 @@ private:
     std::atomic<bool> m_cancelled;
     std::shared_ptr<domain::ai::model_repository::ModelRepository> m_model_repo;
     std::shared_ptr<domain::face::analyser::FaceAnalyser> m_face_analyser;
+    domain::face::analyser::Options m_face_analyser_options;
     Options m_inference_options;
-    std::unique_ptr<MetricsCollector> m_metrics_collector;
+    TargetDedupPlan m_dedup; ///< Targets of the current task with identical content
 
     std::shared_ptr<domain::face::analyser::FaceAnalyser> GetFaceAnalyser() {
         if (!m_face_analyser) {
@@ -166,10 +178,25 @@ private:
                 domain::face::recognizer::FaceRecognizerType::ArcFaceW600kR50;
 
             m_face_analyser = std::make_shared<domain::face::analyser::FaceAnalyser>(opts);
+            m_face_analyser_options = opts;
         }
         return m_face_analyser;
     }
 
+    /**
+     * @brief Apply the per-task face analysis settings to the shared analyser
+     * @note Only touches options that do not select models, so no model is reloaded
+     */
+    void ApplyTaskAnalysisOptions(const config::TaskConfig& task_config) {
+        auto analyser = GetFaceAnalyser();
+        auto& roi_refine = m_face_analyser_options.face_detector_options.roi_refine;
+        const bool enabled = task_config.face_analysis.face_detector.roi_refine;
+        if (roi_refine.enabled == enabled) return;
+
+        roi_refine.enabled = enabled;
+        analyser->update_options(m_face_analyser_options);
+    }
+
     config::Result<void, config::ConfigError> ExecuteTask(const config::TaskConfig& task_config,
                                                           ProgressCallback progress_callback) {
         if (task_config.io.target_paths.empty()) {
@@ -183,6 +210,7 @@ private:
         context.model_repo = m_model_repo;
         context.inference_options = m_inference_options;
         context.face_analyser = GetFaceAnalyser();
+        ApplyTaskAnalysisOptions(task_config);
 
         if (!task_config.io.source_paths.empty()) {
             auto embed_result = LoadSourceEmbeddings(task_config.io.source_paths);
@@ -207,7 +235,9 @@ private:
         for (const auto& target_path : task_config.io.target_paths) {
             if (m_cancelled) break;
 
-            if (!fs::exists(target_path)) {
+            // Pipes ("-", "pipe:N") are only opened by the video reader
+            if (!foundation::media::ffmpeg::is_stream_path(target_path)
+                && !fs::exists(target_path)) {
                 return config::Result<void, config::ConfigError>::err(
                     config::ConfigError(config::ErrorCode::E402VideoOpenFailed,
                                         "Target file not found: " + target_path));
@@ -215,12 +245,41 @@ private:
             valid_targets.push_back(target_path);
         }
 
-        // 2. Sort into images and videos
+        // Identical files are processed once; their other outputs are materialised at the end
+        m_dedup = {};
+        if (task_config.io.output.dedup_policy != config::DedupPolicy::Off
+            && !task_config.io.output.is_streaming() && valid_targets.size() > 1 && !m_cancelled) {
+            m_dedup = plan_target_dedup(valid_targets);
+            if (m_dedup.duplicate_count() > 0) {
+                Logger::get_instance()->info(std::format(
+                    "[PipelineRunner] {} duplicate target(s) share content with another target "
+                    "and are not processed again ({:.1f} MB)",
+                    m_dedup.duplicate_count(),
+                    static_cast<double>(m_dedup.saved_bytes()) / (1024.0 * 1024.0)));
+                valid_targets = m_dedup.unique_targets;
+            }
+        }
+
+        // 2. Sort into images and videos (probing would consume a pipe: it is taken as video)
         auto is_video_pred = [](const std::string& path) {
-            return foundation::media::ffmpeg::is_video(path);
+            return foundation::media::ffmpeg::is_stream_path(path)
+                || foundation::media::ffmpeg::is_video(path);
         };
 
         auto sorted_targets = sort_targets_by_type(valid_targets, is_video_pred);
+        if (task_config.io.output.is_streaming() && !sorted_targets.images.empty()) {
+            return config::Result<void, config::ConfigError>::err(config::ConfigError(
+                config::ErrorCode::E202ParameterOutOfRange,
+                "Streaming output needs a video target", "io.output.stream_format"));
+        }
+
+        if (UseStepMajorOrder(task_config)) {
+            auto res = ExecuteStepMajor(sorted_targets, task_config, progress_callback, context,
+                                        add_processors);
+            if (!res) return res;
+            if (!m_cancelled) MaterializeDuplicates(task_config, sorted_targets);
+            return config::Result<void, config::ConfigError>::ok();
+        }
 
         // 3. Process All Images as a single batch (Priority 1)
         if (!sorted_targets.images.empty() && !m_cancelled) {
@@ -229,112 +288,641 @@ private:
             if (!res) return res;
         }
 
-        // 4. Process Videos sequentially (Priority 2)
-        for (const auto& video_path : sorted_targets.videos) {
-            if (m_cancelled) break;
+        // 4. Process Videos (Priority 2)
+        if (!sorted_targets.videos.empty() && !m_cancelled) {
+            auto res = ProcessVideoTargets(sorted_targets.videos, task_config, progress_callback,
+                                           context, add_processors);
+            if (!res) return res;
+        }
 
-            auto result = ProcessVideoTarget(video_path, task_config, progress_callback, context,
-                                             add_processors);
-            if (!result) return result;
+        if (!m_cancelled) MaterializeDuplicates(task_config, sorted_targets);
+
+        return config::Result<void, config::ConfigError>::ok();
+    }
+
+    /**
+     * @brief Enabled pipeline steps grouped into the stages ExecuteStepMajor() runs one by one
+     * @details The expression restorer restores the expression of the original target frame,
+     *          which only the first stage sees. So every step up to the last expression_restorer
+     *          shares the first stage (run per frame as in sequential order); the remaining steps
+     *          are a stage each.
+     */
+    static std::vector<std::vector<config::PipelineStep>> StepMajorStages(
+        const config::TaskConfig& task_config) {
+        std::vector<config::PipelineStep> steps;
+        for (const auto& step : task_config.pipeline) {
+            if (step.enabled) steps.push_back(step);
+        }
+
+        size_t first_stage_end = 1;
+        for (size_t i = 0; i < steps.size(); ++i) {
+            if (steps[i].step == "expression_restorer") first_stage_end = i + 1;
         }
 
+        std::vector<std::vector<config::PipelineStep>> stages;
+        for (size_t i = 0; i < steps.size();) {
+            const size_t end = i == 0 ? first_stage_end : i + 1;
+            stages.emplace_back(steps.begin() + static_cast<std::ptrdiff_t>(i),
+                                steps.begin() + static_cast<std::ptrdiff_t>(end));
+            i = end;
+        }
+        return stages;
+    }
+
+    /**
+     * @brief Whether the task runs step-major (ExecutionOrder::Batch with several stages)
+     */
+    static bool UseStepMajorOrder(const config::TaskConfig& task_config) {
+        if (task_config.resource.execution_order != config::ExecutionOrder::Batch) return false;
+        const auto steps = std::ranges::count_if(task_config.pipeline,
+                                                 [](const auto& step) { return step.enabled; });
+        if (steps < 2) return false; // Nothing to separate: same as sequential
+        if (StepMajorStages(task_config).size() < 2) {
+            Logger::get_instance()->info("[PipelineRunner] Expression restorer needs the original "
+                                         "frames: execution_order batch runs sequentially");
+            return false;
+        }
+        if (task_config.io.output.is_streaming()) {
+            Logger::get_instance()->info(
+                "[PipelineRunner] Streaming output: execution_order batch runs sequentially");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief ExecutionOrder::Batch: run each pipeline stage over every target before the next
+     * @details Stages are single steps, except that the steps up to an expression_restorer run
+     *          together (see StepMajorStages()). Only the processors (and models) of one stage
+     *          exist at a time. Each stage reads the previous stage's results, which are spilled
+     *          losslessly to a per-task directory under temp_directory (PNG images,
+     *          FFV1/Matroska videos with the source audio) and deleted once the next stage has
+     *          consumed them (a directory left by a crashed run is removed first). In strict
+     *          memory mode the session registry is emptied between stages, so peak memory is
+     *          that of the largest stage rather than the sum of all models. Resume and
+     *          smart_render are per-file features of sequential order and are not used here.
+     */
+    config::Result<void, config::ConfigError> ExecuteStepMajor(
+        const SortedTargets& targets, const config::TaskConfig& task_config,
+        ProgressCallback progress_callback, ProcessorContext& context,
+        std::function<config::Result<void, config::ConfigError>(
+            std::shared_ptr<Pipeline>, const config::TaskConfig&, ProcessorContext&)>
+            add_processors) {
+        namespace fs = std::filesystem;
+
+        const auto stages = StepMajorStages(task_config);
+
+        const fs::path work_dir =
+            fs::path(m_app_config.temp_directory) / ("batch_" + task_config.task_info.id);
+        auto remove_work_dir = [&] {
+            std::error_code ignored;
+            fs::remove_all(work_dir, ignored);
+        };
+
+        // Current input of each target; targets whose step produced no result drop out
+        struct StagedTarget {
+            std::string original;
+            std::string input;
+        };
+        std::vector<StagedTarget> images;
+        std::vector<StagedTarget> videos;
+        for (const auto& path : targets.images) images.push_back({path, path});
+        for (const auto& path : targets.videos) videos.push_back({path, path});
+
+        auto metrics = BeginMetrics(task_config, context);
+        const auto store_before = domain::face::store::FaceStore::get_instance()->stats();
+
+        remove_work_dir(); // Results left behind by a run of this task that crashed
+
+        for (size_t i = 0; i < stages.size() && !m_cancelled; ++i) {
+            const bool last = i + 1 == stages.size();
+            const fs::path step_dir = work_dir / std::format("step{}", i);
+            std::error_code ec;
+            if (!last && !fs::create_directories(step_dir, ec) && ec) {
+                remove_work_dir();
+                return config::Result<void, config::ConfigError>::err(config::ConfigError(
+                    config::ErrorCode::E406OutputWriteFailed,
+                    "Failed to create intermediate directory: " + step_dir.string()));
+            }
+
+            config::TaskConfig step_config = task_config;
+            step_config.pipeline = stages[i];
+            step_config.task_info.enable_resume = false;
+            step_config.io.output.smart_render = false;
+            if (i > 0) step_config.resource.max_frames = 0; // Already applied by the first step
+
+            std::string names;
+            for (const auto& step : stages[i]) names += (names.empty() ? "" : ", ") + step.step;
+            Logger::get_instance()->info(
+                std::format("[PipelineRunner] Batch order: step {}/{} ({}) over {} target(s)",
+                            i + 1, stages.size(), names, images.size() + videos.size()));
+
+            auto result_path = [&](size_t index, const std::string& original, const char* ext) {
+                const auto name = std::format("{}_{}{}", index, fs::path(original).stem().string(),
+                                              ext);
+                return (step_dir / name).string();
+            };
+
+            if (!images.empty() && !m_cancelled) {
+                std::vector<std::string> inputs;
+                std::vector<std::string> outputs;
+                for (size_t k = 0; k < images.size(); ++k) {
+                    inputs.push_back(images[k].input);
+                    outputs.push_back(
+                        last ? ImageProcessingHelper::GenerateOutputPath(images[k].original,
+                                                                         task_config)
+                             : result_path(k, images[k].original, ".png"));
+                }
+                context.video_target = false;
+                auto res = ImageProcessingHelper::ProcessBatch(inputs, step_config,
+                                                               progress_callback, context,
+                                                               add_processors, m_cancelled,
+                                                               outputs);
+                if (!res) {
+                    remove_work_dir();
+                    return res;
+                }
+                for (size_t k = 0; k < images.size(); ++k) images[k].input = outputs[k];
+            }
+
+            for (size_t k = 0; k < videos.size() && !m_cancelled; ++k) {
+                StepOutput output;
+                output.intermediate = !last;
+                output.path = last ? VideoProcessingHelper::GenerateOutputPath(videos[k].original,
+                                                                               task_config)
+                                   : result_path(k, videos[k].original, ".mkv");
+                context.video_target = true;
+                auto res = VideoProcessingHelper::ProcessVideo(videos[k].input, step_config,
+                                                               progress_callback, context,
+                                                               add_processors, m_cancelled,
+                                                               output);
+                if (!res) {
+                    remove_work_dir();
+                    return res;
+                }
+                videos[k].input = output.path;
+            }
+
+            // An image that failed to decode has no result for the next step
+            std::erase_if(images, [](const StagedTarget& t) { return !fs::exists(t.input); });
+
+            if (i > 0) fs::remove_all(work_dir / std::format("step{}", i - 1), ec);
+
+            // Processors the step left in the context would keep their sessions alive
+            context.enhancer_reuse.reset();
+            context.expression_restorer.reset();
+            if (task_config.resource.memory_strategy == config::MemoryStrategy::Strict) {
+                // The step's pipeline is gone: drop the sessions only it used
+                InferenceSessionRegistry::get_instance()->clear();
+            }
+        }
+        remove_work_dir();
+
+        if (metrics) {
+            RecordFaceStoreMetrics(*metrics, store_before);
+            std::vector<std::string> all_targets = targets.images;
+            all_targets.insert(all_targets.end(), targets.videos.begin(), targets.videos.end());
+            RecordDedupMetrics(*metrics, all_targets);
+            metrics->set_counter("batch_order.stages", static_cast<double>(stages.size()));
+
+            const std::string first =
+                targets.images.empty() ? targets.videos.front() : targets.images.front();
+            ExportMetrics(*metrics, fs::path(first).stem().string() + "_batch");
+        }
+
+        if (m_cancelled) {
+            return config::Result<void, config::ConfigError>::err(
+                config::ConfigError(config::ErrorCode::E407TaskCancelled, "Task cancelled"));
+        }
         return config::Result<void, config::ConfigError>::ok();
     }
 
+    /**
+     * @brief Create a metrics collector for the next report (nullptr if metrics are disabled)
+     */
+    std::unique_ptr<MetricsCollector> MakeMetrics(const config::TaskConfig& task_config) const {
+        if (!m_app_config.metrics.enable) return nullptr;
+        auto metrics = std::make_unique<MetricsCollector>(task_config.task_info.id);
+        metrics->set_gpu_sample_interval(
+            std::chrono::milliseconds(m_app_config.metrics.gpu_sample_interval_ms));
+        return metrics;
+    }
+
+    /**
+     * @brief Create the collector of the next report and hand it to the processors of @p context
+     */
+    std::unique_ptr<MetricsCollector> BeginMetrics(const config::TaskConfig& task_config,
+                                                   ProcessorContext& context) const {
+        auto metrics = MakeMetrics(task_config);
+        context.metrics_collector = metrics.get();
+        return metrics;
+    }
+
+    /**
+     * @brief Export @p metrics as `<report stem>_<name><report extension>`
+     */
+    void ExportMetrics(MetricsCollector& metrics, const std::string& name) const {
+        namespace fs = std::filesystem;
+        fs::path report_path(m_app_config.metrics.report_path);
+        std::string stem = report_path.stem().string();
+        std::string ext = report_path.extension().string();
+        metrics.export_json(report_path.parent_path() / (stem + "_" + name + ext));
+    }
+
+    /**
+     * @brief Give every duplicate target the output of the target it duplicates
+     */
+    void MaterializeDuplicates(const config::TaskConfig& task_config,
+                               const SortedTargets& sorted_targets) {
+        if (m_dedup.duplicates.empty()) return;
+        namespace fs = std::filesystem;
+
+        std::vector<std::string> sources;
+        std::vector<std::string> destinations;
+        for (const auto& [target, group] : m_dedup.duplicates) {
+            const bool is_video = std::ranges::find(sorted_targets.videos, target)
+                               != sorted_targets.videos.end();
+            auto output_path = [&](const std::string& path) {
+                return is_video ? VideoProcessingHelper::GenerateOutputPath(path, task_config)
+                                : ImageProcessingHelper::GenerateOutputPath(path, task_config);
+            };
+
+            const std::string source = output_path(target);
+            if (!fs::exists(source)) {
+                // e.g. an image that failed to decode: its duplicates have no result either
+                Logger::get_instance()->warn("No result to share with duplicates of: " + target);
+                continue;
+            }
+            for (const auto& duplicate : group.targets) {
+                std::string destination = output_path(duplicate);
+                if (destination == source) continue; // Same target listed twice
+                sources.push_back(source);
+                destinations.push_back(std::move(destination));
+            }
+        }
+
+        foundation::infrastructure::concurrent_file_system::copy_files(
+            sources, destinations,
+            task_config.io.output.dedup_policy == config::DedupPolicy::Link);
+
+        for (const auto& destination : destinations) {
+            if (!fs::exists(destination)) {
+                Logger::get_instance()->warn("Failed to write duplicate result: " + destination);
+            }
+        }
+    }
+
+    /**
+     * @brief Export the number of duplicates of @p targets and the input bytes they saved
+     */
+    void RecordDedupMetrics(MetricsCollector& metrics, const std::vector<std::string>& targets) {
+        if (m_dedup.duplicates.empty()) return;
+
+        std::size_t duplicates = 0;
+        std::uintmax_t saved_bytes = 0;
+        for (const auto& target : targets) {
+            const auto it = m_dedup.duplicates.find(target);
+            if (it == m_dedup.duplicates.end()) continue;
+            duplicates += it->second.targets.size();
+            saved_bytes += it->second.file_size * it->second.targets.size();
+        }
+        metrics.set_counter("dedup.duplicate_targets", static_cast<double>(duplicates));
+        metrics.set_counter("dedup.saved_bytes", static_cast<double>(saved_bytes));
+    }
+
     config::Result<void, config::ConfigError> ProcessImageBatch(
         const std::vector<std::string>& batch, const config::TaskConfig& task_config,
         ProgressCallback progress_callback, ProcessorContext& context,
         std::function<config::Result<void, config::ConfigError>(
             std::shared_ptr<Pipeline>, const config::TaskConfig&, ProcessorContext&)>
             add_processors) {
-        if (m_app_config.metrics.enable) {
-            m_metrics_collector = std::make_unique<MetricsCollector>(task_config.task_info.id);
-            m_metrics_collector->set_gpu_sample_interval(
-                std::chrono::milliseconds(m_app_config.metrics.gpu_sample_interval_ms));
-            context.metrics_collector = m_metrics_collector.get();
-        } else {
-            context.metrics_collector = nullptr;
-        }
+        auto metrics = BeginMetrics(task_config, context);
+        context.video_target = false;
 
+        const auto store_before = domain::face::store::FaceStore::get_instance()->stats();
         auto result = ImageProcessingHelper::ProcessBatch(batch, task_config, progress_callback,
                                                           context, add_processors, m_cancelled);
 
-        if (m_metrics_collector && m_app_config.metrics.enable && !batch.empty()) {
-            namespace fs = std::filesystem;
-            fs::path report_path(m_app_config.metrics.report_path);
-            std::string batch_name = fs::path(batch[0]).stem().string() + "_batch";
+        if (metrics && !batch.empty()) {
+            RecordFaceStoreMetrics(*metrics, store_before);
+            RecordDedupMetrics(*metrics, batch);
+            ExportMetrics(*metrics, std::filesystem::path(batch[0]).stem().string() + "_batch");
+        }
+        context.metrics_collector = nullptr; // Dies with this call
+        return result;
+    }
+
+    /**
+     * @brief Process the video targets, up to resource.max_concurrent_targets at a time
+     */
+    config::Result<void, config::ConfigError> ProcessVideoTargets(
+        const std::vector<std::string>& videos, const config::TaskConfig& task_config,
+        ProgressCallback progress_callback, ProcessorContext& context,
+        std::function<config::Result<void, config::ConfigError>(
+            std::shared_ptr<Pipeline>, const config::TaskConfig&, ProcessorContext&)>
+            add_processors) {
+        if (task_config.resource.max_concurrent_targets > 1 && videos.size() > 1) {
+            return ProcessVideoTargetsConcurrently(videos, task_config, progress_callback, context,
+                                                   add_processors);
+        }
 
-            std::string stem = report_path.stem().string();
-            std::string ext = report_path.extension().string();
-            fs::path final_path = report_path.parent_path() / (stem + "_" + batch_name + ext);
+        for (const auto& video_path : videos) {
+            if (m_cancelled) break;
 
-            m_metrics_collector->export_json(final_path);
+            auto result = ProcessVideoTarget(video_path, task_config, progress_callback, context,
+                                             add_processors);
+            if (!result) return result;
         }
-        return result;
+        return config::Result<void, config::ConfigError>::ok();
     }
 
-    config::Result<void, config::ConfigError> ProcessVideoTarget(
-        const std::string& target_path, const config::TaskConfig& task_config,
+    /**
+     * @brief Process several video targets side by side (TargetScheduler)
+     * @details Each video runs its own pipeline, reader and writer, sized by its share of the
+     *          task's worker and codec threads. All pipelines use the same face analyser and get
+     *          their model sessions from InferenceSessionRegistry, so each model is loaded once.
+     *          Progress is reported summed over the running videos. A failed video is logged and
+     *          does not stop the others; the task fails with the first error once all are done.
+     *          Resume is not used: the task's single checkpoint cannot track several videos.
+     */
+    config::Result<void, config::ConfigError> ProcessVideoTargetsConcurrently(
+        const std::vector<std::string>& videos, const config::TaskConfig& task_config,
         ProgressCallback progress_callback, ProcessorContext& context,
         std::function<config::Result<void, config::ConfigError>(
             std::shared_ptr<Pipeline>, const config::TaskConfig&, ProcessorContext&)>
             add_processors) {
-        if (m_app_config.metrics.enable) {
-            m_metrics_collector = std::make_unique<MetricsCollector>(task_config.task_info.id);
-            m_metrics_collector->set_gpu_sample_interval(
-                std::chrono::milliseconds(m_app_config.metrics.gpu_sample_interval_ms));
-            context.metrics_collector = m_metrics_collector.get();
-        } else {
-            context.metrics_collector = nullptr;
+        namespace fs = std::filesystem;
+        const auto& resource = task_config.resource;
+        const TargetScheduler scheduler(
+            {.max_concurrent = static_cast<size_t>(resource.max_concurrent_targets),
+             .worker_threads = resource.get_effective_thread_count(),
+             .decoder_threads = resource.get_effective_decoder_thread_count(),
+             .encoder_threads = resource.get_effective_encoder_thread_count()});
+
+        Logger::get_instance()->info(
+            std::format("[PipelineRunner] Processing {} videos, up to {} at a time",
+                        videos.size(), resource.max_concurrent_targets));
+        if (task_config.task_info.enable_resume) {
+            Logger::get_instance()->info(
+                "[PipelineRunner] Resume is not used while several videos run at once");
         }
 
-        auto result = VideoProcessingHelper::ProcessVideo(
-            target_path, task_config, progress_callback, context, add_processors, m_cancelled);
+        auto summary = MakeMetrics(task_config);
+        const auto store_before = domain::face::store::FaceStore::get_instance()->stats();
+
+        // Progress of every video seen so far, reported as one sum
+        std::mutex progress_mutex;
+        std::map<std::string, TaskProgress> progress_by_target;
+        auto report_progress = [&](const std::string& target, const TaskProgress& progress) {
+            if (!progress_callback) return;
+            std::lock_guard lock(progress_mutex);
+            progress_by_target[target] = progress;
+
+            TaskProgress total{progress.task_id, 0, 0, "processing", 0.0};
+            for (const auto& [path, entry] : progress_by_target) {
+                total.current_frame += entry.current_frame;
+                total.total_frames += entry.total_frames;
+                total.fps += entry.fps;
+            }
+            progress_callback(total);
+        };
 
-        if (m_metrics_collector && m_app_config.metrics.enable) {
-            namespace fs = std::filesystem;
-            fs::path report_path(m_app_config.metrics.report_path);
-            fs::path target(target_path);
+        auto job = [&](const std::string& target, const TargetBudget& budget) {
+            config::TaskConfig job_config = task_config;
+            job_config.task_info.enable_resume = false;
+            job_config.resource.thread_count = budget.worker_threads;
+            job_config.resource.decoder_thread_count = budget.decoder_threads;
+            job_config.resource.encoder_thread_count = budget.encoder_threads;
+
+            // Own metrics collector and per-pipeline caches; analyser and embedding are shared
+            ProcessorContext job_context = context;
+            return ProcessVideoTarget(
+                target, job_config,
+                [&](const TaskProgress& progress) { report_progress(target, progress); },
+                job_context, add_processors, summary.get());
+        };
+        const auto outcomes = scheduler.run(videos, job, m_cancelled);
+
+        std::optional<config::ConfigError> first_error;
+        size_t failed = 0;
+        std::chrono::milliseconds busy{0};
+        for (const auto& outcome : outcomes) {
+            busy += outcome.duration;
+            if (!outcome.error) continue;
+            ++failed;
+            Logger::get_instance()->error(std::format("[PipelineRunner] Video failed: {} ({})",
+                                                      outcome.target, outcome.error->formatted()));
+            if (!first_error) first_error = outcome.error;
+        }
 
-            std::string stem = report_path.stem().string();
-            std::string ext = report_path.extension().string();
-            std::string target_stem = target.stem().string();
+        if (summary) {
+            // Per-video reports leave FaceStore counters out while videos run together
+            RecordFaceStoreMetrics(*summary, store_before);
+            RecordDedupMetrics(*summary, videos);
+            summary->set_counter("scheduler.targets", static_cast<double>(videos.size()));
+            summary->set_counter("scheduler.failed_targets", static_cast<double>(failed));
+            summary->set_counter("scheduler.max_concurrent",
+                                 static_cast<double>(resource.max_concurrent_targets));
+            summary->set_counter("scheduler.busy_ms", static_cast<double>(busy.count()));
+            ExportMetrics(*summary, fs::path(videos.front()).stem().string() + "_videos");
+        }
 
-            fs::path final_path = report_path.parent_path() / (stem + "_" + target_stem + ext);
-            m_metrics_collector->export_json(final_path);
+        if (first_error) {
+            if (failed > 1) {
+                first_error->message = std::format("{} of {} videos failed, first: {}", failed,
+                                                   videos.size(), first_error->message);
+            }
+            return config::Result<void, config::ConfigError>::err(*first_error);
         }
+        if (m_cancelled) {
+            return config::Result<void, config::ConfigError>::err(
+                config::ConfigError(config::ErrorCode::E407TaskCancelled, "Task cancelled"));
+        }
+        return config::Result<void, config::ConfigError>::ok();
+    }
+
+    config::Result<void, config::ConfigError> ProcessVideoTarget(
+        const std::string& target_path, const config::TaskConfig& task_config,
+        ProgressCallback progress_callback, ProcessorContext& context,
+        std::function<config::Result<void, config::ConfigError>(
+            std::shared_ptr<Pipeline>, const config::TaskConfig&, ProcessorContext&)>
+            add_processors,
+        MetricsCollector* summary = nullptr) {
+        auto metrics = BeginMetrics(task_config, context);
+        context.video_target = true;
+
+        const auto store_before = domain::face::store::FaceStore::get_instance()->stats();
+        auto result = VideoProcessingHelper::ProcessVideo(
+            target_path, task_config, progress_callback, context, add_processors, m_cancelled);
+
+        if (metrics) {
+            // The FaceStore is shared: with a summary, other videos run at the same time and its
+            // counters are only meaningful for all of them together (see the summary report)
+            if (!summary) RecordFaceStoreMetrics(*metrics, store_before);
+            RecordEnhancerReuseMetrics(*metrics, context);
+            RecordExpressionCacheMetrics(*metrics, context);
+            RecordDedupMetrics(*metrics, {target_path});
+            if (summary) summary->merge(*metrics);
+            ExportMetrics(*metrics, std::filesystem::path(target_path).stem().string());
+        }
+        context.metrics_collector = nullptr; // Dies with this call
         return result;
     }
 
+    /**
+     * @brief Export the FaceStore counters accumulated since @p before to the metrics report
+     */
+    void RecordFaceStoreMetrics(MetricsCollector& metrics,
+                                const domain::face::store::FaceStoreStats& before) {
+        auto delta = domain::face::store::FaceStore::get_instance()->stats();
+        delta.hits -= before.hits;
+        delta.misses -= before.misses;
+        delta.insertions -= before.insertions;
+        delta.evictions -= before.evictions;
+        delta.lock_contentions -= before.lock_contentions;
+
+        metrics.set_counter("face_store.hits", static_cast<double>(delta.hits));
+        metrics.set_counter("face_store.misses", static_cast<double>(delta.misses));
+        metrics.set_counter("face_store.hit_rate", delta.hit_rate());
+        metrics.set_counter("face_store.insertions", static_cast<double>(delta.insertions));
+        metrics.set_counter("face_store.evictions", static_cast<double>(delta.evictions));
+        metrics.set_counter("face_store.lock_contentions",
+                            static_cast<double>(delta.lock_contentions));
+        metrics.set_counter("face_store.size", static_cast<double>(delta.size));
+    }
+
+    /**
+     * @brief Export the face_enhancer temporal reuse counters to the metrics report
+     */
+    void RecordEnhancerReuseMetrics(MetricsCollector& metrics, const ProcessorContext& context) {
+        if (!context.enhancer_reuse) return;
+
+        const auto stats = context.enhancer_reuse->stats();
+        metrics.set_counter("face_enhancer.reused", static_cast<double>(stats.reused));
+        metrics.set_counter("face_enhancer.enhanced", static_cast<double>(stats.enhanced));
+        metrics.set_counter("face_enhancer.reuse_rate", stats.reuse_rate());
+        metrics.set_counter("face_enhancer.saved_ms", stats.saved_ms);
+    }
+
+    /**
+     * @brief Export the expression_restorer feature / motion cache counters to the metrics report
+     */
+    void RecordExpressionCacheMetrics(MetricsCollector& metrics,
+                                      const ProcessorContext& context) {
+        if (!context.expression_restorer) return;
+
+        const auto stats = context.expression_restorer->cache_stats();
+        metrics.set_counter("expression_restorer.feature_hits",
+                            static_cast<double>(stats.feature_hits));
+        metrics.set_counter("expression_restorer.feature_misses",
+                            static_cast<double>(stats.feature_misses));
+        metrics.set_counter("expression_restorer.feature_hit_rate", stats.hit_rate());
+        metrics.set_counter("expression_restorer.source_motion_hits",
+                            static_cast<double>(stats.source_motion_hits));
+        metrics.set_counter("expression_restorer.source_motion_misses",
+                            static_cast<double>(stats.source_motion_misses));
+    }
+
+    /**
+     * @brief Identifier of everything besides the image that decides a cached source embedding
+     * @details Recognizer and detector models plus the detector settings (score and NMS
+     *          thresholds, ROI refinement), which select the faces that are averaged. Must be
+     *          called after ApplyTaskAnalysisOptions() for the task.
+     */
+    std::string SourceAnalysisId() const {
+        const auto& detector = m_face_analyser_options.face_detector_options;
+        const auto& roi = detector.roi_refine;
+        return std::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}",
+                           m_app_config.default_models.face_recognizer,
+                           m_app_config.default_models.face_detector,
+                           static_cast<int>(detector.type), detector.min_score,
+                           detector.iou_threshold, roi.enabled, roi.min_frame_side, roi.roi_scale,
+                           roi.redetect, roi.max_candidates,
+                           static_cast<int>(m_face_analyser_options.face_recognizer_type));
+    }
+
+    /**
+     * @brief Compute the averaged, normed source embedding
+     * @details Per-image results are looked up in the persistent embedding cache first (keyed by
+     *          file content hash + SourceAnalysisId()). Only misses decode the image and run the
+     *          analyser, whose models load lazily, so an all-hit job never loads detection or
+     *          recognition models for its sources.
+     */
     config::Result<std::vector<float>, config::ConfigError> LoadSourceEmbeddings(
         const std::vector<std::string>& source_paths) {
-        std::vector<domain::face::Face> all_faces;
-        auto analyser = GetFaceAnalyser();
-        if (!analyser) {
-            return config::Result<std::vector<float>, config::ConfigError>::err(config::ConfigError(
-                config::ErrorCode::E100SystemError, "Failed to create FaceAnalyser"));
+        namespace embedding_cache = domain::face::embedding_cache;
+
+        std::optional<embedding_cache::EmbeddingCache> cache;
+        if (m_app_config.embedding_cache.enable) {
+            cache.emplace(m_app_config.embedding_cache.path);
         }
 
+        std::vector<embedding_cache::CachedEmbedding> entries;
+        entries.reserve(source_paths.size());
+        size_t cache_hits = 0;
+        const std::string analysis_id = cache ? SourceAnalysisId() : std::string{};
+
         for (const auto& path : source_paths) {
+            std::string key;
+            if (cache) {
+                try {
+                    key = embedding_cache::EmbeddingCache::make_key(
+                        foundation::infrastructure::crypto::sha1(path), analysis_id);
+                } catch (const std::exception& e) {
+                    Logger::get_instance()->warn(
+                        std::format("Failed to hash source image {}: {}", path, e.what()));
+                }
+                if (!key.empty()) {
+                    if (auto cached = cache->load(key)) {
+                        ++cache_hits;
+                        entries.push_back(std::move(*cached));
+                        continue;
+                    }
+                }
+            }
+
             cv::Mat source_img = cv::imread(path);
             if (source_img.empty()) {
                 Logger::get_instance()->warn("Failed to load source image: " + path);
                 continue;
             }
 
+            auto analyser = GetFaceAnalyser();
+            if (!analyser) {
+                return config::Result<std::vector<float>, config::ConfigError>::err(
+                    config::ConfigError(config::ErrorCode::E100SystemError,
+                                        "Failed to create FaceAnalyser"));
+            }
+
             auto faces = analyser->get_many_faces(
                 source_img, domain::face::analyser::FaceAnalysisType::Detection
                                 | domain::face::analyser::FaceAnalysisType::Embedding);
+            if (faces.empty()) continue;
+
+            // Store the plain mean so entries combine exactly like averaging all faces at once
+            std::vector<std::vector<float>> embeddings;
+            embeddings.reserve(faces.size());
+            for (const auto& face : faces) { embeddings.push_back(face.embedding()); }
+
+            embedding_cache::CachedEmbedding entry;
+            entry.embedding = domain::face::helper::calc_average_embedding(embeddings);
+            entry.face_count = static_cast<std::uint32_t>(faces.size());
+            if (cache && !key.empty()) { cache->save(key, entry); }
+            entries.push_back(std::move(entry));
+        }
 
-            if (!faces.empty()) { all_faces.insert(all_faces.end(), faces.begin(), faces.end()); }
+        if (cache) {
+            Logger::get_instance()->info(
+                std::format("[PipelineRunner] Source embedding cache: {}/{} hits", cache_hits,
+                            source_paths.size()));
         }
 
-        if (all_faces.empty()) {
+        auto avg_embedding = embedding_cache::combine(entries);
+        if (avg_embedding.empty()) {
             return config::Result<std::vector<float>, config::ConfigError>::err(config::ConfigError(
                 config::ErrorCode::E403NoFaceDetected, "No face detected in source images"));
         }
 
-        auto avg_embedding = domain::face::helper::compute_average_embedding(all_faces);
         return config::Result<std::vector<float>, config::ConfigError>::ok(avg_embedding);
     }
 
@@ -406,18 +994,36 @@ private:
                         domain_ctx.face_enhancer->load_model(model_path, context.inference_options);
                         domain_ctx.enhancer_model_path = model_path;
                     }
+
+                    const auto* params = std::get_if<config::FaceEnhancerParams>(&step.params);
+                    if (params != nullptr && params->temporal_reuse) {
+                        domain::face::enhancer::TemporalReuseOptions reuse;
+                        reuse.max_difference = params->reuse_threshold;
+                        reuse.refresh_interval =
+                            static_cast<std::uint32_t>(std::max(params->reuse_refresh_interval, 1));
+                        domain_ctx.enhancer_reuse =
+                            std::make_shared<domain::face::enhancer::TemporalCropCache>(reuse);
+                    }
+                    context.enhancer_reuse = domain_ctx.enhancer_reuse;
                 }
             } else if (step.step == "expression_restorer") {
                 needs_face_detection = true;
                 reqs.need_expression_data = true;
                 if (!domain_ctx.restorer) {
-                    domain_ctx.restorer = domain::face::expression::create_live_portrait_restorer();
-
                     std::string model_name = "live_portrait";
+                    // Features are only reused along face tracks of a video
+                    domain::face::expression::TrackCacheOptions cache_options;
+                    cache_options.refresh_interval = 0;
                     if (const auto* params =
                             std::get_if<config::ExpressionRestorerParams>(&step.params)) {
                         if (!params->model.empty()) { model_name = params->model; }
+                        if (context.video_target) {
+                            cache_options.refresh_interval = static_cast<std::uint32_t>(
+                                std::max(params->feature_refresh_interval, 0));
+                        }
                     }
+                    domain_ctx.restorer =
+                        domain::face::expression::create_live_portrait_restorer(cache_options);
 
                     // Live Portrait requires 3 models: feature, motion, generator
                     auto feature_path =
@@ -439,12 +1045,17 @@ private:
                         domain_ctx.expression_generator_path = gen_path;
                     }
                 }
+                context.expression_restorer = domain_ctx.restorer;
             } else if (step.step == "frame_enhancer") {
                 if (!domain_ctx.frame_enhancer_factory) {
                     std::string model_name = "real_esrgan_x4_plus";
+                    int tile_size = 0;
+                    bool autotune_tiles = true;
                     if (const auto* params =
                             std::get_if<config::FrameEnhancerParams>(&step.params)) {
                         if (!params->model.empty()) { model_name = params->model; }
+                        tile_size = params->tile_size;
+                        autotune_tiles = params->autotune_tiles;
                     }
 
                     // Eagerly resolve model path
@@ -462,7 +1073,8 @@ private:
                     // Capture context.inference_options by value to avoid lifetime issues
                     auto options = context.inference_options;
                     // Capture resolved model_path instead of using m_model_repo inside lambda
-                    domain_ctx.frame_enhancer_factory = [model_name, model_path, options]() {
+                    domain_ctx.frame_enhancer_factory = [model_name, model_path, options,
+                                                         tile_size, autotune_tiles]() {
                         auto type = domain::frame::enhancer::FrameEnhancerType::RealEsrGan;
                         if (model_name.find("hat") != std::string::npos) {
                             type = domain::frame::enhancer::FrameEnhancerType::RealHatGan;
@@ -472,7 +1084,7 @@ private:
                         // Note: Must pass model_name (key) not model_path, as factory derives scale
                         // from name.
                         return domain::frame::enhancer::FrameEnhancerFactory::create(
-                            type, model_name, options);
+                            type, model_name, options, tile_size, autotune_tiles);
                     };
                 }
             }
@@ -61,8 +61,9 @@ public:
         std::unique_ptr<ScopedStepTimer> timer;
         if (m_metrics) { timer = std::make_unique<ScopedStepTimer>(*m_metrics, "face_analysis"); }
 
+        if (frame.frame_key.empty()) { frame.frame_key = m_analyser->make_frame_key(frame.image); }
         auto faces = m_analyser->get_many_faces(
-            frame.image, domain::face::analyser::FaceAnalysisType::Detection);
+            frame.image, frame.frame_key, domain::face::analyser::FaceAnalysisType::Detection);
 
         if (faces.empty()) {
             // [E403] 必须记录 WARN 日志 (design.md Section 5.3.2)
@@ -8,10 +8,17 @@ module;
 #include <string>
 #include <vector>
 #include <memory>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <thread>
 #include <iostream>
 #include <filesystem>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <condition_variable>
 #include <opencv2/opencv.hpp>
 
 export module services.pipeline.runner:image;
@@ -19,6 +26,8 @@ export module services.pipeline.runner:image;
 import domain.pipeline;
 import domain.ai.model_repository;
 import foundation.ai.inference_session;
+import foundation.infrastructure.concurrent_queue;
+import foundation.infrastructure.file_system;
 import foundation.infrastructure.logger;
 import foundation.infrastructure.scoped_timer;
 import :types;
@@ -56,7 +65,7 @@ public:
         ScopedTimer timer("ImageProcessingHelper::ProcessImage",
                           std::format("target={}", target_path));
 
-        cv::Mat image = cv::imread(target_path);
+        cv::Mat image = DecodeImage(target_path, task_config.resource.image_memory_map);
         if (image.empty()) {
             timer.set_result("error:load_failed");
             return config::Result<void, config::ConfigError>::err(config::ConfigError(
@@ -121,6 +130,7 @@ public:
      * @param context Processing context (models, sessions, etc.)
      * @param add_processors_func Function to populate the pipeline with processors
      * @param cancelled Atomic flag to signal cancellation
+     * @param output_paths Explicit result file per target (empty = derived from io.output)
      * @return Result object indicating success or failure
      */
     static config::Result<void, config::ConfigError> ProcessBatch(
@@ -129,13 +139,18 @@ public:
         std::function<config::Result<void, config::ConfigError>(
             std::shared_ptr<Pipeline>, const config::TaskConfig&, ProcessorContext&)>
             add_processors_func,
-        std::atomic<bool>& cancelled) {
+        std::atomic<bool>& cancelled, const std::vector<std::string>& output_paths = {}) {
         using foundation::infrastructure::ScopedTimer;
 
         ScopedTimer timer("ImageProcessingHelper::ProcessBatch",
                           std::format("count={}", target_paths.size()));
 
         if (target_paths.empty()) { return config::Result<void, config::ConfigError>::ok(); }
+        if (!output_paths.empty() && output_paths.size() != target_paths.size()) {
+            timer.set_result("error:output_paths");
+            return config::Result<void, config::ConfigError>::err(config::ConfigError(
+                config::ErrorCode::E400RuntimeError, "One output path per target is required"));
+        }
 
         // 1. Setup Pipeline
         PipelineConfig pipeline_config;
@@ -161,40 +176,49 @@ public:
             context.metrics_collector->set_total_frames(target_paths.size());
         }
 
+        const auto& resource = task_config.resource;
+        const size_t total_images = target_paths.size();
+        const size_t decode_threads =
+            std::min<size_t>(resource.get_effective_image_decode_thread_count(), total_images);
+        const size_t encode_threads =
+            std::min<size_t>(resource.get_effective_image_encode_thread_count(), total_images);
+        const auto prefetch = static_cast<size_t>(resource.get_effective_image_prefetch_count());
+
         std::atomic<bool> writer_error = false;
         std::string writer_error_msg;
-
-        // 2. Writer Thread
-        std::thread writer_thread([&]() {
-            int processed_count = 0;
-            size_t total_images = target_paths.size();
-            auto start_time = std::chrono::steady_clock::now();
-
-            TaskProgress progress;
-            progress.task_id = task_config.task_info.id;
-            progress.total_frames = total_images;
-            progress.current_step = "processing";
-
-            while (true) {
-                auto result_opt = pipeline->pop_frame();
-                if (!result_opt) break;
-                if (result_opt->is_end_of_stream) break;
-
-                size_t index = result_opt->sequence_id;
-                if (index >= target_paths.size()) {
-                    writer_error = true;
-                    writer_error_msg = "Invalid sequence ID received";
-                    break;
-                }
-
-                auto output_path = GenerateOutputPath(target_paths[index], task_config);
-                if (!cv::imwrite(output_path, result_opt->image)) {
-                    writer_error = true;
-                    writer_error_msg = "Failed to write output image: " + output_path;
+        std::mutex writer_mutex; // Guards writer_error_msg, metrics and progress
+
+        // 2. Encode Pool: outputs are encoded and written in parallel, each to its own path
+        struct EncodeJob {
+            size_t index = 0;
+            cv::Mat image;
+        };
+        foundation::infrastructure::ConcurrentQueue<EncodeJob> encode_queue(2 * encode_threads);
+
+        int processed_count = 0;
+        const auto start_time = std::chrono::steady_clock::now();
+        TaskProgress progress;
+        progress.task_id = task_config.task_info.id;
+        progress.total_frames = total_images;
+        progress.current_step = "processing";
+
+        auto encode_worker = [&]() {
+            while (auto job = encode_queue.pop()) {
+                if (writer_error) continue; // Drain without writing
+
+                auto output_path = output_paths.empty()
+                                     ? GenerateOutputPath(target_paths[job->index], task_config)
+                                     : output_paths[job->index];
+                const bool written = cv::imwrite(output_path, job->image);
+
+                std::lock_guard lock(writer_mutex);
+                if (!written) {
+                    if (!writer_error.exchange(true)) {
+                        writer_error_msg = "Failed to write output image: " + output_path;
+                    }
                     if (context.metrics_collector) context.metrics_collector->record_frame_failed();
-                    break;
+                    continue;
                 }
-
                 if (context.metrics_collector) context.metrics_collector->record_frame_completed();
 
                 processed_count++;
@@ -209,45 +233,103 @@ public:
                     progress_callback(progress);
                 }
             }
+        };
+        std::vector<std::thread> encoders;
+        for (size_t i = 0; i < encode_threads; ++i) encoders.emplace_back(encode_worker);
+
+        // 3. Writer Thread: hands pipeline results to the encode pool
+        std::thread writer_thread([&]() {
+            while (true) {
+                auto result_opt = pipeline->pop_frame();
+                if (!result_opt) break;
+                if (result_opt->is_end_of_stream) break;
+
+                size_t index = result_opt->sequence_id;
+                if (index >= total_images) {
+                    std::lock_guard lock(writer_mutex);
+                    writer_error = true;
+                    writer_error_msg = "Invalid sequence ID received";
+                    break;
+                }
+                if (writer_error) continue; // Keep draining so the reader never blocks
+                encode_queue.push({index, std::move(result_opt->image)});
+            }
+            encode_queue.shutdown();
         });
 
-        // 3. Reader Loop
+        // 4. Decode Pool: up to `prefetch` images are decoded ahead of the pipeline; they are
+        //    collected by index so frames still enter the pipeline in target order
+        std::mutex decode_mutex;
+        std::condition_variable decode_cv;
+        std::map<size_t, cv::Mat> decoded; // Empty Mat = failed to load
+        size_t consumed = 0;
+        bool stop_decoding = false;
+        std::atomic<size_t> next_decode = 0;
+
+        auto decode_worker = [&]() {
+            while (true) {
+                const size_t index = next_decode.fetch_add(1);
+                if (index >= total_images) return;
+                {
+                    std::unique_lock lock(decode_mutex);
+                    decode_cv.wait(lock,
+                                   [&] { return stop_decoding || index < consumed + prefetch; });
+                    if (stop_decoding) return;
+                }
+                cv::Mat image = DecodeImage(target_paths[index], resource.image_memory_map);
+                {
+                    std::lock_guard lock(decode_mutex);
+                    decoded.emplace(index, std::move(image));
+                }
+                decode_cv.notify_all();
+            }
+        };
+        std::vector<std::thread> decoders;
+        for (size_t i = 0; i < decode_threads; ++i) decoders.emplace_back(decode_worker);
+
+        auto take_decoded = [&](size_t index) -> std::optional<cv::Mat> {
+            std::unique_lock lock(decode_mutex);
+            while (!decoded.contains(index)) {
+                // `cancelled` is set from outside without a notification: poll it
+                if (cancelled || writer_error) return std::nullopt;
+                decode_cv.wait_for(lock, std::chrono::milliseconds(50));
+            }
+            auto node = decoded.extract(index);
+            consumed = index + 1;
+            lock.unlock();
+            decode_cv.notify_all();
+            return std::move(node.mapped());
+        };
+
+        // 5. Reader Loop: sequence_id is the index into target_paths, so a file that fails to
+        //    load still takes its index; it simply produces no output.
         size_t seq_id = 0;
-        for (const auto& path : target_paths) {
+        for (; seq_id < total_images; ++seq_id) {
             if (cancelled || writer_error) break;
 
-            cv::Mat image = cv::imread(path);
-            if (image.empty()) {
-                // Log warning but continue? Or fail?
-                // For batch processing, maybe skip and warn is better than failing entire batch.
-                // But let's log error.
-                Logger::get_instance()->warn("Failed to load image in batch: " + path);
-                // We must ensure sequence_id alignment or handle missing frames.
-                // If we skip pushing, the consumer won't get this sequence_id.
-                // But consumer uses sequence_id to map to output path.
-                // So if we skip, we just don't produce output for this one.
-                // But we need to keep processed_count correct?
-                // Let's just skip it.
+            auto image = take_decoded(seq_id);
+            if (!image) break;
+            if (image->empty()) {
+                Logger::get_instance()->warn("Failed to load image in batch: "
+                                             + target_paths[seq_id]);
+                std::lock_guard lock(writer_mutex);
                 if (context.metrics_collector) context.metrics_collector->record_frame_failed();
-                seq_id++; // Increment anyway to keep index sync? No, if we use seq_id as index into
-                          // target_paths.
-                // If we use seq_id as index, we MUST push something or the index will be wrong?
-                // Wait, if I use `data.sequence_id = seq_id`, and `seq_id` iterates 0..N.
-                // If I skip `imread`, and don't push, then `pop_frame` will never get that
-                // `sequence_id`. That's fine, consumer just processes what it gets. BUT
-                // `target_paths[index]` access depends on `sequence_id` being the index in
-                // `target_paths`. So `seq_id` MUST match the loop index.
                 continue;
             }
 
             FrameData data;
             data.sequence_id = seq_id;
-            data.image = image;
+            data.image = std::move(*image);
             data.source_embedding = shared_source_embedding;
             pipeline->push_frame(std::move(data));
+        }
 
-            seq_id++;
+        {
+            std::lock_guard lock(decode_mutex);
+            stop_decoding = true;
         }
+        decode_cv.notify_all();
+        for (auto& decoder : decoders) decoder.join();
 
         FrameData eos;
         eos.is_end_of_stream = true;
@@ -255,6 +337,7 @@ public:
         pipeline->push_frame(std::move(eos));
 
         if (writer_thread.joinable()) { writer_thread.join(); }
+        for (auto& encoder : encoders) encoder.join();
 
         pipeline->stop();
 
@@ -274,9 +357,9 @@ public:
         return config::Result<void, config::ConfigError>::ok();
     }
 
-private:
     /**
      * @brief Generate output file path based on task configuration
+     * @details Also used by the runner to place the outputs of deduplicated targets.
      */
     static std::string GenerateOutputPath(const std::string& input_path,
                                           const config::TaskConfig& task_config) {
@@ -293,6 +376,24 @@ private:
         }
         return (output_dir / (filename + ext)).string();
     }
+
+private:
+    /**
+     * @brief Load an image, decoding it straight from a memory mapping when @p memory_map is set
+     * @return The image, or an empty Mat if it cannot be loaded
+     */
+    static cv::Mat DecodeImage(const std::string& path, bool memory_map) {
+        if (memory_map) {
+            auto mapped = foundation::infrastructure::file_system::MappedFile::open(path);
+            if (mapped && mapped->size() <= static_cast<size_t>(std::numeric_limits<int>::max())) {
+                // imdecode only reads the buffer; the Mat header does not copy it
+                const cv::Mat bytes(1, static_cast<int>(mapped->size()), CV_8UC1,
+                                    const_cast<unsigned char*>(mapped->data()));
+                return cv::imdecode(bytes, cv::IMREAD_COLOR);
+            }
+        }
+        return cv::imread(path);
+    }
 };
 
 } // namespace services::pipeline
@@ -21,6 +21,8 @@ import domain.pipeline; // Imports domain::pipeline::FrameData
 import domain.ai.model_repository;
 import domain.face.masker;
 import domain.face.analyser;
+import domain.face.enhancer;
+import domain.face.expression;
 import foundation.ai.inference_session;
 import services.pipeline.metrics;
 
@@ -60,6 +62,19 @@ struct ProcessorContext {
     foundation::ai::inference_session::Options
         inference_options;                         ///< Configuration for ONNX inference
     MetricsCollector* metrics_collector = nullptr; ///< Performance metrics collector
+    std::shared_ptr<domain::face::enhancer::TemporalCropCache>
+        enhancer_reuse; ///< Enhanced-crop reuse of the face_enhancer step, if enabled
+    std::shared_ptr<domain::face::expression::IFaceExpressionRestorer>
+        expression_restorer;   ///< Restorer of the expression_restorer step, if any
+    bool video_target = false; ///< Frames are consecutive video frames (enables track caches)
+};
+
+/**
+ * @brief Explicit result file of a video runner call (step-major execution)
+ */
+struct StepOutput {
+    std::string path;          ///< Result file ("" = derived from the target and io.output)
+    bool intermediate = false; ///< Lossless result read back by the next step (FFV1/Matroska)
 };
 
 } // namespace services::pipeline
@@ -13,6 +13,9 @@ module;
 #include <thread>
 #include <chrono>
 #include <iostream>
+#include <cmath>
+#include <format>
+#include <optional>
 #include <opencv2/opencv.hpp>
 
 export module services.pipeline.runner:video;
@@ -29,6 +32,7 @@ import services.pipeline.checkpoint;
 import services.pipeline.metrics;
 import :types;
 import config.types;
+import config.parser;
 import config.task; // Import TaskConfig
 
 namespace services::pipeline {
@@ -37,6 +41,117 @@ using namespace domain::pipeline;
 using namespace foundation::infrastructure::logger;
 using namespace config; // Use config namespace for TaskConfig etc.
 
+/**
+ * @brief Checkpointed video output, written as a sequence of closed segment files
+ * @details Each segment is a complete, independently decodable file of the output format in
+ *          `.<output name>.segments/` next to the output. A segment is registered in the
+ *          checkpoint once it is closed, so a resumed run keeps every registered segment and
+ *          renders only the frames after them. The output file is made by joining the
+ *          segments without re-encoding (a single segment is just renamed).
+ */
+class SegmentedOutput {
+public:
+    /**
+     * @param output_path Final output file
+     * @param segment_frames Frames per segment (the last one may be shorter)
+     * @param checkpoint Checkpoint to update when a segment is closed
+     * @param ckpt_mgr Manager that persists @p checkpoint
+     */
+    SegmentedOutput(std::string output_path, int64_t segment_frames, CheckpointData checkpoint,
+                    CheckpointManager& ckpt_mgr) :
+        m_output_path(std::move(output_path)),
+        m_segment_frames(std::max<int64_t>(segment_frames, 1)), m_checkpoint(std::move(checkpoint)),
+        m_ckpt_mgr(ckpt_mgr) {
+        namespace fs = std::filesystem;
+        const fs::path output(m_output_path);
+        m_directory = output.parent_path() / ("." + output.filename().string() + ".segments");
+        m_checkpoint.output_path = m_output_path;
+    }
+
+    /**
+     * @brief Take over the segments of an interrupted run
+     * @return false (and nothing is kept) unless the checkpoint belongs to this output and all
+     *         of its segments still exist
+     */
+    bool restore(const CheckpointData& saved) {
+        namespace fs = std::filesystem;
+        if (saved.output_path != m_output_path || saved.segments.empty()) return false;
+        for (const auto& segment : saved.segments) {
+            if (!fs::exists(segment)) return false;
+        }
+        m_segments = saved.segments;
+        return true;
+    }
+
+    /**
+     * @brief Path of the next segment file (creates the segment directory)
+     */
+    std::string next_path() {
+        std::error_code ec;
+        std::filesystem::create_directories(m_directory, ec);
+        const auto ext = std::filesystem::path(m_output_path).extension().string();
+        return (m_directory / std::format("{:05}{}", m_segments.size(), ext)).string();
+    }
+
+    /**
+     * @brief Whether a segment holding @p frames frames is complete
+     */
+    [[nodiscard]] bool full(int64_t frames) const { return frames >= m_segment_frames; }
+
+    /**
+     * @brief Register the segment just closed at @p path, ending at source frame @p last_frame
+     */
+    void add(const std::string& path, int64_t last_frame) {
+        m_segments.push_back(path);
+        m_checkpoint.segments = m_segments;
+        m_checkpoint.last_completed_frame = last_frame;
+        m_ckpt_mgr.force_save(m_checkpoint);
+    }
+
+    /**
+     * @brief Join the segments into the output file and delete them
+     */
+    bool finish() {
+        namespace fs = std::filesystem;
+        if (m_segments.empty()) return false;
+
+        bool joined = false;
+        std::error_code ec;
+        if (m_segments.size() == 1) {
+            fs::rename(m_segments.front(), m_output_path, ec);
+            joined = !ec;
+        }
+        if (!joined) {
+            joined = foundation::media::ffmpeg::Remuxer::concat(m_segments, m_output_path);
+        }
+        if (!joined) {
+            fs::remove(m_output_path, ec);
+            return false;
+        }
+        discard();
+        return true;
+    }
+
+    /**
+     * @brief Delete the segment files
+     */
+    void discard() {
+        std::error_code ec;
+        std::filesystem::remove_all(m_directory, ec);
+        m_segments.clear();
+    }
+
+    [[nodiscard]] size_t segment_count() const { return m_segments.size(); }
+
+private:
+    std::string m_output_path;
+    std::filesystem::path m_directory;
+    int64_t m_segment_frames;
+    std::vector<std::string> m_segments; ///< Closed segments, in order
+    CheckpointData m_checkpoint;
+    CheckpointManager& m_ckpt_mgr;
+};
+
 /**
  * @brief Helper class for video processing tasks
  */
@@ -50,6 +165,7 @@ public:
      * @param context Processing context (models, sessions, etc.)
      * @param add_processors_func Function to populate the pipeline with processors
      * @param cancelled Atomic flag to signal cancellation
+     * @param step_output Explicit result file, e.g. an intermediate of step-major execution
      * @return Result object indicating success or failure
      */
     static config::Result<void, config::ConfigError> ProcessVideo(
@@ -58,7 +174,7 @@ public:
         std::function<config::Result<void, config::ConfigError>(
             std::shared_ptr<Pipeline>, const config::TaskConfig&, ProcessorContext&)>
             add_processors_func,
-        std::atomic<bool>& cancelled) {
+        std::atomic<bool>& cancelled, const StepOutput& step_output = {}) {
         using namespace foundation::media::ffmpeg;
         using foundation::infrastructure::ScopedTimer;
 
@@ -68,11 +184,13 @@ public:
         if (task_config.resource.memory_strategy == config::MemoryStrategy::Strict) {
             Logger::get_instance()->info("Running in Strict Mode with enhanced I/O optimization");
             return ProcessVideoStrict(target_path, task_config, progress_callback, context,
-                                      add_processors_func, cancelled);
+                                      add_processors_func, cancelled, step_output);
         }
 
         // 1. Open Reader
         VideoReader reader(target_path);
+        reader.set_decoder_threads(task_config.resource.get_effective_decoder_thread_count(),
+                                   config::to_string(task_config.resource.codec_thread_type));
         if (!reader.open()) {
             auto err = config::ConfigError(config::ErrorCode::E402VideoOpenFailed,
                                            std::format("Failed to open video: {}", target_path),
@@ -81,34 +199,31 @@ public:
             return config::Result<void, config::ConfigError>::err(err);
         }
 
+        // 2. Prepare Output
+        std::string output_path = step_output.path;
+        if (output_path.empty()) {
+            output_path = task_config.io.output.is_streaming()
+                            ? std::string("-")
+                            : GenerateOutputPath(target_path, task_config);
+        }
+
         int64_t start_frame = 0;
         int64_t total_frames = reader.get_frame_count();
         std::unique_ptr<CheckpointManager> ckpt_mgr;
-        std::string config_hash;
+        std::optional<SegmentedOutput> segments;
 
-        // Try to resume if enabled
-        if (task_config.task_info.enable_resume) {
+        // Resumable output is written in checkpointed segments
+        if (task_config.task_info.enable_resume && IsStreaming(target_path, task_config)) {
+            Logger::get_instance()->info(
+                "[VideoRunner] Streaming: checkpointing and resume are disabled");
+        } else if (task_config.task_info.enable_resume) {
             ckpt_mgr = std::make_unique<CheckpointManager>("./checkpoints");
-            config_hash = CalculateConfigHash(task_config);
-
-            if (auto saved = ckpt_mgr->load(task_config.task_info.id, config_hash)) {
-                start_frame = saved->last_completed_frame + 1;
-
-                if (start_frame >= total_frames) {
-                    Logger::get_instance()->info(
-                        "[VideoRunner] Task already completed, nothing to resume");
-                    ckpt_mgr->cleanup(task_config.task_info.id);
-                    return config::Result<void, config::ConfigError>::ok();
-                }
-
-                if (!reader.seek(start_frame)) {
-                    Logger::get_instance()->warn(
-                        "[VideoRunner] Seek failed, starting from beginning");
-                    start_frame = 0;
-                } else {
-                    Logger::get_instance()->info(std::format(
-                        "[VideoRunner] Resuming from frame {}/{}", start_frame, total_frames));
-                }
+            start_frame =
+                BeginSegmentedOutput(task_config, output_path, reader, *ckpt_mgr, segments);
+            if (total_frames > 0 && start_frame >= total_frames) {
+                Logger::get_instance()->info(
+                    "[VideoRunner] All frames already rendered, joining the segments");
+                return FinishSegmentedOutput(*segments, *ckpt_mgr, task_config);
             }
         }
 
@@ -116,12 +231,15 @@ public:
             context.metrics_collector->set_total_frames(total_frames);
         }
 
-        // 2. Prepare Output
-        std::string output_path = GenerateOutputPath(target_path, task_config);
-        std::string video_output_path = output_path;
-        bool needs_muxing = (task_config.io.output.audio_policy == config::AudioPolicy::Copy);
-
-        if (needs_muxing) { video_output_path = output_path + ".temp.mp4"; }
+        // Audio is stream-copied by the writer while encoding: the output is written once
+        // A piped target is read once, so its audio cannot be copied by a second reader
+        const bool stream_input = is_stream_path(target_path);
+        const bool copy_audio =
+            (task_config.io.output.audio_policy == config::AudioPolicy::Copy) && !stream_input;
+        if (stream_input && task_config.io.output.audio_policy == config::AudioPolicy::Copy) {
+            Logger::get_instance()->warn("[VideoRunner] Piped target: output has no audio");
+        }
+        const double source_fps = reader.get_fps();
 
         // 3. Open Writer
         VideoParams video_params;
@@ -134,8 +252,12 @@ public:
         if (task_config.io.output.video_quality > 0) {
             video_params.quality = task_config.io.output.video_quality;
         }
+        video_params.threadCount = task_config.resource.get_effective_encoder_thread_count();
+        video_params.threadType = config::to_string(task_config.resource.codec_thread_type);
+        video_params.containerFormat = StreamContainerName(task_config.io.output.stream_format);
+        if (step_output.intermediate) { UseIntermediateFormat(video_params); }
 
-        VideoWriter writer(video_output_path, video_params);
+        VideoWriter writer(output_path, video_params);
 
         // 4. Setup Pipeline
         PipelineConfig pipeline_config;
@@ -176,6 +298,9 @@ public:
 
         std::atomic<bool> writer_error = false;
         std::string writer_error_msg;
+        int64_t next_frame = start_frame; // Source index of the next written frame
+        int64_t segment_frames = 0;       // Frames in the open segment
+        std::string file_path;            // File the writer has open (output or segment)
 
         // 5. Writer Thread
         std::thread writer_thread([&]() {
@@ -197,7 +322,14 @@ public:
                     VideoParams actual_params = video_params;
                     actual_params.width = result_opt->image.cols;
                     actual_params.height = result_opt->image.rows;
-                    writer = VideoWriter(video_output_path, actual_params);
+                    file_path = segments ? segments->next_path() : output_path;
+                    writer = VideoWriter(file_path, actual_params);
+                    if (copy_audio) {
+                        writer.set_audio_source(target_path, FrameTimeMs(next_frame, source_fps));
+                    }
+                    if (task_config.io.output.smart_render && !stream_input) {
+                        writer.enable_smart_render(target_path, next_frame);
+                    }
                     if (!writer.open()) {
                         writer_error = true;
                         writer_error_msg = "Failed to open writer";
@@ -205,7 +337,7 @@ public:
                     }
                 }
 
-                if (!writer.write_frame(result_opt->image)) {
+                if (!writer.write_frame(result_opt->image, result_opt->modified)) {
                     writer_error = true;
                     writer_error_msg = "Failed to write frame";
                     if (context.metrics_collector) context.metrics_collector->record_frame_failed();
@@ -214,6 +346,17 @@ public:
 
                 if (context.metrics_collector) context.metrics_collector->record_frame_completed();
 
+                ++next_frame;
+                if (segments && segments->full(++segment_frames)) {
+                    if (!writer.close()) {
+                        writer_error = true;
+                        writer_error_msg = "Failed to finish segment: " + file_path;
+                        break;
+                    }
+                    segments->add(file_path, next_frame - 1);
+                    segment_frames = 0;
+                }
+
                 frame_count++;
                 if (progress_callback) {
                     auto now = std::chrono::steady_clock::now();
@@ -221,7 +364,7 @@ public:
                     double fps =
                         (elapsed > 0.0) ? (static_cast<double>(frame_count) / elapsed) : 0.0;
 
-                    progress.current_frame = frame_count;
+                    progress.current_frame = start_frame + frame_count;
                     progress.fps = fps;
                     progress_callback(progress);
                 }
@@ -255,19 +398,6 @@ public:
                     context.metrics_collector->record_gpu_memory(mem_info->used_mb);
                 }
             }
-
-            // Save checkpoint periodically (every 30s)
-            // Optimization: Only construct and call save every 100 frames to reduce per-frame
-            // overhead
-            if (ckpt_mgr && seq_id % 100 == 0) {
-                CheckpointData ckpt;
-                ckpt.task_id = task_config.task_info.id;
-                ckpt.config_hash = config_hash;
-                ckpt.last_completed_frame = seq_id - 1;
-                ckpt.total_frames = total_frames;
-                ckpt.output_path = output_path;
-                ckpt_mgr->save(ckpt);
-            }
         }
 
         FrameData eos;
@@ -285,13 +415,26 @@ public:
         }
 
         pipeline->stop();
-        writer.close();
+        if (!writer.close() && !writer_error) {
+            writer_error = true;
+            writer_error_msg = "Failed to finish output: " + file_path;
+        }
         reader.close();
 
+        // The open segment is complete up to the last written frame, also when cancelled
+        if (segments && segment_frames > 0 && !writer_error) {
+            segments->add(file_path, next_frame - 1);
+        }
+
         if (cancelled) {
-            std::filesystem::remove(video_output_path);
-            if (needs_muxing && std::filesystem::exists(output_path))
+            if (segments) {
+                Logger::get_instance()->info(
+                    std::format("[VideoRunner] Cancelled: {} segment(s) kept for resume",
+                                segments->segment_count()));
+            } else if (!task_config.io.output.is_streaming()
+                       && std::filesystem::exists(output_path)) {
                 std::filesystem::remove(output_path);
+            }
             timer.set_result("cancelled");
             return config::Result<void, config::ConfigError>::err(
                 config::ConfigError(config::ErrorCode::E407TaskCancelled, "Task cancelled"));
@@ -303,27 +446,41 @@ public:
                 config::ConfigError(config::ErrorCode::E406OutputWriteFailed, writer_error_msg));
         }
 
-        // Cleanup checkpoint on success
-        if (ckpt_mgr) { ckpt_mgr->cleanup(task_config.task_info.id); }
-
-        // 7. Muxing
-        if (needs_muxing) {
-            if (Remuxer::merge_av(video_output_path, target_path, output_path)) {
-                std::filesystem::remove(video_output_path);
-            } else {
-                Logger::get_instance()->error(
-                    config::ConfigError(config::ErrorCode::E406OutputWriteFailed,
-                                        "Failed to mux audio")
-                        .formatted());
-                if (std::filesystem::exists(output_path)) std::filesystem::remove(output_path);
-                std::filesystem::rename(video_output_path, output_path);
-            }
+        if (segments) {
+            auto result = FinishSegmentedOutput(*segments, *ckpt_mgr, task_config);
+            timer.set_result(result ? "success" : "error:join_failed");
+            return result;
         }
 
         timer.set_result("success");
         return config::Result<void, config::ConfigError>::ok();
     }
 
+    /**
+     * @brief Generate output file path based on task configuration
+     * @details Also used by the runner to place the outputs of deduplicated targets.
+     */
+    static std::string GenerateOutputPath(const std::string& input_path,
+                                          const config::TaskConfig& task_config) {
+        namespace fs = std::filesystem;
+        fs::path input(input_path);
+        fs::path output_dir = task_config.io.output.path;
+        if (!fs::exists(output_dir)) fs::create_directories(output_dir);
+
+        std::string stem = input.stem().string();
+        std::string ext = input.extension().string();
+        if (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp") {
+            ext = "." + task_config.io.output.image_format;
+        }
+        // A pipe's name says nothing about its container
+        if (foundation::media::ffmpeg::is_stream_path(input_path)) {
+            if (input_path == "-" || input_path.starts_with("pipe:")) stem = "stream";
+            ext = ".mp4";
+        }
+        std::string filename = task_config.io.output.prefix + stem + task_config.io.output.suffix;
+        return (output_dir / (filename + ext)).string();
+    }
+
 private:
     /**
      * @brief Process video in strict mode (optimized for low memory usage)
@@ -334,7 +491,7 @@ private:
         std::function<config::Result<void, config::ConfigError>(
             std::shared_ptr<Pipeline>, const config::TaskConfig&, ProcessorContext&)>
             add_processors_func,
-        std::atomic<bool>& cancelled) {
+        std::atomic<bool>& cancelled, const StepOutput& step_output) {
         using namespace foundation::media::ffmpeg;
         using foundation::infrastructure::ScopedTimer;
 
@@ -342,52 +499,52 @@ private:
                           std::format("target={}", target_path));
 
         VideoReader reader(target_path);
+        reader.set_decoder_threads(task_config.resource.get_effective_decoder_thread_count(),
+                                   config::to_string(task_config.resource.codec_thread_type));
         if (!reader.open()) {
             timer.set_result("error:open_failed");
             return config::Result<void, config::ConfigError>::err(config::ConfigError(
                 config::ErrorCode::E402VideoOpenFailed, "Failed to open video: " + target_path));
         }
 
+        std::string output_path = step_output.path;
+        if (output_path.empty()) {
+            output_path = task_config.io.output.is_streaming()
+                            ? std::string("-")
+                            : GenerateOutputPath(target_path, task_config);
+        }
+
         int64_t start_frame = 0;
         int64_t total_frames = reader.get_frame_count();
         std::unique_ptr<CheckpointManager> ckpt_mgr;
-        std::string config_hash;
+        std::optional<SegmentedOutput> segments;
 
-        // Try to resume if enabled
-        if (task_config.task_info.enable_resume) {
+        // Resumable output is written in checkpointed segments
+        if (task_config.task_info.enable_resume && IsStreaming(target_path, task_config)) {
+            Logger::get_instance()->info(
+                "[VideoRunner] Streaming: checkpointing and resume are disabled");
+        } else if (task_config.task_info.enable_resume) {
             ckpt_mgr = std::make_unique<CheckpointManager>("./checkpoints");
-            config_hash = CalculateConfigHash(task_config);
-
-            if (auto saved = ckpt_mgr->load(task_config.task_info.id, config_hash)) {
-                start_frame = saved->last_completed_frame + 1;
-
-                if (start_frame >= total_frames) {
-                    Logger::get_instance()->info(
-                        "[VideoRunnerStrict] Task already completed, nothing to resume");
-                    ckpt_mgr->cleanup(task_config.task_info.id);
-                    return config::Result<void, config::ConfigError>::ok();
-                }
-
-                if (!reader.seek(start_frame)) {
-                    Logger::get_instance()->warn(
-                        "[VideoRunnerStrict] Seek failed, starting from beginning");
-                    start_frame = 0;
-                } else {
-                    Logger::get_instance()->info(
-                        std::format("[VideoRunnerStrict] Resuming from frame {}/{}", start_frame,
-                                    total_frames));
-                }
+            start_frame =
+                BeginSegmentedOutput(task_config, output_path, reader, *ckpt_mgr, segments);
+            if (total_frames > 0 && start_frame >= total_frames) {
+                Logger::get_instance()->info(
+                    "[VideoRunnerStrict] All frames already rendered, joining the segments");
+                return FinishSegmentedOutput(*segments, *ckpt_mgr, task_config);
             }
         }
 
         if (context.metrics_collector) {
             context.metrics_collector->set_total_frames(total_frames);
         }
-
-        std::string output_path = GenerateOutputPath(target_path, task_config);
-        std::string video_output_path = output_path;
-        bool needs_muxing = (task_config.io.output.audio_policy == config::AudioPolicy::Copy);
-        if (needs_muxing) { video_output_path = output_path + ".temp.mp4"; }
+        // A piped target is read once, so its audio cannot be copied by a second reader
+        const bool stream_input = is_stream_path(target_path);
+        const bool copy_audio =
+            (task_config.io.output.audio_policy == config::AudioPolicy::Copy) && !stream_input;
+        if (stream_input && task_config.io.output.audio_policy == config::AudioPolicy::Copy) {
+            Logger::get_instance()->warn("[VideoRunner] Piped target: output has no audio");
+        }
+        const double source_fps = reader.get_fps();
 
         VideoParams video_params;
         video_params.width = reader.get_width();
@@ -399,8 +556,12 @@ private:
         if (task_config.io.output.video_quality > 0) {
             video_params.quality = task_config.io.output.video_quality;
         }
+        video_params.threadCount = task_config.resource.get_effective_encoder_thread_count();
+        video_params.threadType = config::to_string(task_config.resource.codec_thread_type);
+        video_params.containerFormat = StreamContainerName(task_config.io.output.stream_format);
+        if (step_output.intermediate) { UseIntermediateFormat(video_params); }
 
-        VideoWriter writer(video_output_path, video_params);
+        VideoWriter writer(output_path, video_params);
 
         PipelineConfig pipeline_config;
         // In strict memory mode, we still respect config but might want to cap it if it's too
@@ -432,6 +593,9 @@ private:
 
         std::atomic<bool> writer_error = false;
         std::string writer_error_msg;
+        int64_t next_frame = start_frame; // Source index of the next written frame
+        int64_t segment_frames = 0;       // Frames in the open segment
+        std::string file_path;            // File the writer has open (output or segment)
 
         std::thread writer_thread([&]() {
             int frame_count = 0;
@@ -451,20 +615,37 @@ private:
                     VideoParams actual_params = video_params;
                     actual_params.width = result_opt->image.cols;
                     actual_params.height = result_opt->image.rows;
-                    writer = VideoWriter(video_output_path, actual_params);
+                    file_path = segments ? segments->next_path() : output_path;
+                    writer = VideoWriter(file_path, actual_params);
+                    if (copy_audio) {
+                        writer.set_audio_source(target_path, FrameTimeMs(next_frame, source_fps));
+                    }
+                    if (task_config.io.output.smart_render && !stream_input) {
+                        writer.enable_smart_render(target_path, next_frame);
+                    }
                     if (!writer.open()) {
                         writer_error = true;
                         writer_error_msg = "Failed to open writer";
                         break;
                     }
                 }
-                if (!writer.write_frame(result_opt->image)) {
+                if (!writer.write_frame(result_opt->image, result_opt->modified)) {
                     writer_error = true;
                     writer_error_msg = "Failed to write frame";
                     if (context.metrics_collector) context.metrics_collector->record_frame_failed();
                     break;
                 }
                 if (context.metrics_collector) context.metrics_collector->record_frame_completed();
+                ++next_frame;
+                if (segments && segments->full(++segment_frames)) {
+                    if (!writer.close()) {
+                        writer_error = true;
+                        writer_error_msg = "Failed to finish segment: " + file_path;
+                        break;
+                    }
+                    segments->add(file_path, next_frame - 1);
+                    segment_frames = 0;
+                }
                 frame_count++;
                 if (progress_callback) {
                     auto now = std::chrono::steady_clock::now();
@@ -472,7 +653,7 @@ private:
                     double fps =
                         (elapsed > 0.0) ? (static_cast<double>(frame_count) / elapsed) : 0.0;
 
-                    progress.current_frame = frame_count;
+                    progress.current_frame = start_frame + frame_count;
                     progress.fps = fps;
                     progress_callback(progress);
                 }
@@ -501,17 +682,6 @@ private:
                     context.metrics_collector->record_gpu_memory(mem_info->used_mb);
                 }
             }
-
-            // Save checkpoint periodically (every 30s)
-            if (ckpt_mgr) {
-                CheckpointData ckpt;
-                ckpt.task_id = task_config.task_info.id;
-                ckpt.config_hash = config_hash;
-                ckpt.last_completed_frame = seq_id - 1;
-                ckpt.total_frames = total_frames;
-                ckpt.output_path = output_path;
-                ckpt_mgr->save(ckpt);
-            }
         }
 
         FrameData eos;
@@ -529,13 +699,26 @@ private:
         }
 
         pipeline->stop();
-        writer.close();
+        if (!writer.close() && !writer_error) {
+            writer_error = true;
+            writer_error_msg = "Failed to finish output: " + file_path;
+        }
         reader.close();
 
+        // The open segment is complete up to the last written frame, also when cancelled
+        if (segments && segment_frames > 0 && !writer_error) {
+            segments->add(file_path, next_frame - 1);
+        }
+
         if (cancelled) {
-            std::filesystem::remove(video_output_path);
-            if (needs_muxing && std::filesystem::exists(output_path))
+            if (segments) {
+                Logger::get_instance()->info(
+                    std::format("[VideoRunner] Cancelled: {} segment(s) kept for resume",
+                                segments->segment_count()));
+            } else if (!task_config.io.output.is_streaming()
+                       && std::filesystem::exists(output_path)) {
                 std::filesystem::remove(output_path);
+            }
             timer.set_result("cancelled");
             return config::Result<void, config::ConfigError>::err(
                 config::ConfigError(config::ErrorCode::E407TaskCancelled, "Task cancelled"));
@@ -546,42 +729,122 @@ private:
                 config::ConfigError(config::ErrorCode::E406OutputWriteFailed, writer_error_msg));
         }
 
-        // Cleanup checkpoint on success
-        if (ckpt_mgr) { ckpt_mgr->cleanup(task_config.task_info.id); }
-
-        if (needs_muxing) {
-            if (Remuxer::merge_av(video_output_path, target_path, output_path)) {
-                std::filesystem::remove(video_output_path);
-            } else {
-                Logger::get_instance()->error(
-                    config::ConfigError(config::ErrorCode::E406OutputWriteFailed,
-                                        "Failed to mux audio")
-                        .formatted());
-                if (std::filesystem::exists(output_path)) std::filesystem::remove(output_path);
-                std::filesystem::rename(video_output_path, output_path);
-            }
+        if (segments) {
+            auto result = FinishSegmentedOutput(*segments, *ckpt_mgr, task_config);
+            timer.set_result(result ? "success" : "error:join_failed");
+            return result;
         }
+
         timer.set_result("success");
         return config::Result<void, config::ConfigError>::ok();
     }
 
     /**
-     * @brief Generate output file path based on task configuration
+     * @brief Muxer for the stdout stream format (empty = chosen from the output path)
      */
-    static std::string GenerateOutputPath(const std::string& input_path,
-                                          const config::TaskConfig& task_config) {
-        namespace fs = std::filesystem;
-        fs::path input(input_path);
-        fs::path output_dir = task_config.io.output.path;
-        if (!fs::exists(output_dir)) fs::create_directories(output_dir);
+    static std::string StreamContainerName(config::StreamFormat format) {
+        switch (format) {
+        case config::StreamFormat::Fmp4: return "mp4";
+        case config::StreamFormat::MpegTs: return "mpegts";
+        case config::StreamFormat::None: break;
+        }
+        return "";
+    }
 
-        std::string filename =
-            task_config.io.output.prefix + input.stem().string() + task_config.io.output.suffix;
-        std::string ext = input.extension().string();
-        if (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp") {
-            ext = "." + task_config.io.output.image_format;
+    /**
+     * @brief Encode an intermediate result losslessly
+     * @details FFV1 in Matroska: BGR frames round-trip exactly through bgr0, and Matroska also
+     *          carries the copied source audio on to the final step.
+     */
+    static void UseIntermediateFormat(foundation::media::ffmpeg::VideoParams& params) {
+        params.videoCodec = "ffv1";
+        params.pixelFormat = "bgr0";
+        params.containerFormat = "matroska";
+        params.extraOptions["level"] = "3"; // Slices: FFV1 level 3 encodes multi-threaded
+    }
+
+    /**
+     * @brief Check if the target is read from or the result written to a pipe (no seeking)
+     */
+    static bool IsStreaming(const std::string& target_path, const config::TaskConfig& task_config) {
+        return task_config.io.output.is_streaming()
+            || foundation::media::ffmpeg::is_stream_path(target_path);
+    }
+
+    /**
+     * @brief Source time (ms) of frame @p frame
+     */
+    static double FrameTimeMs(int64_t frame, double fps) {
+        return fps > 0.0 ? static_cast<double>(frame) * 1000.0 / fps : 0.0;
+    }
+
+    /**
+     * @brief Set up segmented output, keeping the segments of an interrupted run
+     * @details Segments last resource.segment_duration_seconds (60 s if unset). If the
+     *          checkpoint of the task holds finished segments of @p output_path, the reader is
+     *          moved to the first frame after them.
+     * @return Source frame to continue from (0 = start over)
+     */
+    static int64_t BeginSegmentedOutput(const config::TaskConfig& task_config,
+                                        const std::string& output_path,
+                                        foundation::media::ffmpeg::VideoReader& reader,
+                                        CheckpointManager& ckpt_mgr,
+                                        std::optional<SegmentedOutput>& segments) {
+        constexpr int kDefaultSegmentSeconds = 60;
+        const int seconds = task_config.resource.segment_duration_seconds > 0
+                              ? task_config.resource.segment_duration_seconds
+                              : kDefaultSegmentSeconds;
+        const double fps = reader.get_fps() > 0.0 ? reader.get_fps() : 25.0;
+
+        CheckpointData checkpoint;
+        checkpoint.task_id = task_config.task_info.id;
+        checkpoint.config_hash = CalculateConfigHash(task_config);
+        checkpoint.total_frames = reader.get_frame_count();
+        segments.emplace(output_path, std::llround(seconds * fps), checkpoint, ckpt_mgr);
+
+        const auto saved = ckpt_mgr.load(checkpoint.task_id, checkpoint.config_hash);
+        if (!saved || !segments->restore(*saved)) {
+            if (saved) {
+                Logger::get_instance()->info(
+                    "[VideoRunner] Checkpoint has no finished segments of this output, "
+                    "starting from the beginning");
+            }
+            segments->discard(); // Leftovers of a run that never closed a segment
+            return 0;
         }
-        return (output_dir / (filename + ext)).string();
+
+        const int64_t start_frame = saved->last_completed_frame + 1;
+        if (checkpoint.total_frames > 0 && start_frame >= checkpoint.total_frames) {
+            return start_frame; // Only the join is left
+        }
+        if (!reader.seek(start_frame)) {
+            Logger::get_instance()->warn("[VideoRunner] Seek failed, starting from beginning");
+            segments->discard();
+            return 0;
+        }
+        Logger::get_instance()->info(
+            std::format("[VideoRunner] Resuming from frame {}/{} ({} finished segment(s) kept)",
+                        start_frame, checkpoint.total_frames, segments->segment_count()));
+        return start_frame;
+    }
+
+    /**
+     * @brief Join the segments into the output file and drop the checkpoint
+     * @details On failure the segments and the checkpoint stay, so a rerun only retries the
+     *          join.
+     */
+    static config::Result<void, config::ConfigError> FinishSegmentedOutput(
+        SegmentedOutput& segments, CheckpointManager& ckpt_mgr,
+        const config::TaskConfig& task_config) {
+        const size_t count = segments.segment_count();
+        if (count > 0 && !segments.finish()) {
+            return config::Result<void, config::ConfigError>::err(config::ConfigError(
+                config::ErrorCode::E406OutputWriteFailed, "Failed to join the output segments"));
+        }
+        segments.discard();
+        ckpt_mgr.cleanup(task_config.task_info.id);
+        Logger::get_instance()->debug(std::format("[VideoRunner] Joined {} segment(s)", count));
+        return config::Result<void, config::ConfigError>::ok();
     }
 
     /**
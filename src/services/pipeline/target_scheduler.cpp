@@ -0,0 +1,94 @@
+/**
+ * @file target_scheduler.cpp
+ * @brief TargetScheduler implementation
+ */
+module;
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+module services.pipeline.scheduler;
+
+namespace services::pipeline {
+
+TargetScheduler::TargetScheduler(Options options) : m_options(options) {
+    m_options.max_concurrent = std::max<size_t>(m_options.max_concurrent, 1);
+}
+
+TargetBudget TargetScheduler::share(size_t active_jobs) const {
+    const auto jobs = static_cast<int>(std::max<size_t>(active_jobs, 1));
+    TargetBudget budget;
+    budget.worker_threads = std::max(1, m_options.worker_threads / jobs);
+    budget.decoder_threads = std::max(1, m_options.decoder_threads / jobs);
+    budget.encoder_threads = std::max(1, m_options.encoder_threads / jobs);
+    budget.active_jobs = static_cast<size_t>(jobs);
+    return budget;
+}
+
+std::vector<TargetOutcome> TargetScheduler::run(const std::vector<std::string>& targets,
+                                                const Job& job,
+                                                const std::atomic<bool>& cancelled) const {
+    std::vector<TargetOutcome> outcomes(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i) outcomes[i].target = targets[i];
+
+    std::mutex mutex;
+    size_t next = 0;    // Next target to start
+    size_t running = 0; // Targets started and not yet finished
+
+    auto worker = [&] {
+        while (true) {
+            size_t index = 0;
+            TargetBudget budget;
+            {
+                std::lock_guard lock(mutex);
+                if (next >= targets.size() || cancelled) return;
+                index = next++;
+                ++running;
+                // Targets that will share the machine with this one: those running, plus the
+                // ones about to start in the free slots
+                const size_t waiting = targets.size() - next;
+                budget = share(std::min(m_options.max_concurrent, running + waiting));
+            }
+
+            auto& outcome = outcomes[index];
+            outcome.started = true;
+            const auto start = std::chrono::steady_clock::now();
+            try {
+                auto result = job(targets[index], budget);
+                if (!result) outcome.error = result.error();
+            } catch (const std::exception& e) {
+                outcome.error = config::ConfigError(config::ErrorCode::E400RuntimeError,
+                                                    targets[index] + ": " + e.what());
+            } catch (...) {
+                outcome.error = config::ConfigError(config::ErrorCode::E400RuntimeError,
+                                                    targets[index] + ": unknown exception");
+            }
+            outcome.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+
+            std::lock_guard lock(mutex);
+            --running;
+        }
+    };
+
+    const size_t thread_count = std::min(m_options.max_concurrent, targets.size());
+    if (thread_count <= 1) {
+        worker();
+        return outcomes;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) threads.emplace_back(worker);
+    for (auto& thread : threads) thread.join();
+    return outcomes;
+}
+
+} // namespace services::pipeline
@@ -0,0 +1,82 @@
+/**
+ * @file target_scheduler.ixx
+ * @brief Runs the targets of a task side by side under a shared thread budget
+ * @author CodingRookie
+ * @date 2026-02-06
+ */
+module;
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+export module services.pipeline.scheduler;
+
+import config.types;
+
+export namespace services::pipeline {
+
+/**
+ * @brief Threads one target may use while it runs next to others
+ */
+struct TargetBudget {
+    int worker_threads = 1;  ///< Pipeline worker threads
+    int decoder_threads = 1; ///< Video decoder threads
+    int encoder_threads = 1; ///< Video encoder threads
+    size_t active_jobs = 1;  ///< Targets sharing the machine when this one started
+};
+
+/**
+ * @brief Result of one scheduled target
+ */
+struct TargetOutcome {
+    std::string target;
+    std::optional<config::ConfigError> error; ///< Empty if the target succeeded
+    bool started = false;                     ///< false if cancelled before it started
+    std::chrono::milliseconds duration{0};
+};
+
+/**
+ * @brief Runs up to `max_concurrent` targets at once
+ * @details Each target runs its own job on a scheduler thread. The thread budget (pipeline
+ *          workers, decoder and encoder threads of the whole task) is divided evenly between
+ *          the targets that share the machine when a job starts: while K or more targets are
+ *          left each gets 1/K of it, and the last ones of the task get a larger share. A job
+ *          that fails or throws only fails its own target; the others keep running. Jobs not
+ *          yet started are skipped once @p cancelled is set.
+ */
+class TargetScheduler {
+public:
+    using Job = std::function<config::Result<void, config::ConfigError>(const std::string&,
+                                                                        const TargetBudget&)>;
+
+    struct Options {
+        size_t max_concurrent = 1; ///< Targets processed at the same time
+        int worker_threads = 1;    ///< Pipeline worker threads of the whole task
+        int decoder_threads = 1;   ///< Video decoder threads of the whole task
+        int encoder_threads = 1;   ///< Video encoder threads of the whole task
+    };
+
+    explicit TargetScheduler(Options options);
+
+    /**
+     * @brief Run @p job for every target and wait for all of them
+     * @return One outcome per target, in the order of @p targets
+     */
+    std::vector<TargetOutcome> run(const std::vector<std::string>& targets, const Job& job,
+                                   const std::atomic<bool>& cancelled) const;
+
+    /**
+     * @brief Share of the budget for one of @p active_jobs concurrent targets
+     */
+    [[nodiscard]] TargetBudget share(size_t active_jobs) const;
+
+private:
+    Options m_options;
+};
+
+} // namespace services::pipeline
@@ -3,9 +3,16 @@ module;
 #include <string>
 #include <functional>
 #include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 export module services.pipeline.utils;
 
+import foundation.infrastructure.concurrent_crypto;
+
 export namespace services::pipeline {
 
 using IsVideoCheck = std::function<bool(const std::string&)>;
@@ -37,4 +44,101 @@ SortedTargets sort_targets_by_type(const std::vector<std::string>& targets, IsVi
     return result;
 }
 
+/**
+ * @brief Targets with the same file content as one representative target
+ */
+struct DuplicateTargets {
+    std::vector<std::string> targets; ///< In input order, without the representative
+    std::uintmax_t file_size = 0;     ///< Bytes of one copy of the content
+};
+
+/**
+ * @brief Result of grouping targets by file content
+ */
+struct TargetDedupPlan {
+    std::vector<std::string> unique_targets;            ///< First target of each content
+    std::map<std::string, DuplicateTargets> duplicates; ///< Keyed by representative target
+
+    /**
+     * @brief Number of targets that are not processed
+     */
+    [[nodiscard]] size_t duplicate_count() const {
+        size_t count = 0;
+        for (const auto& [target, group] : duplicates) count += group.targets.size();
+        return count;
+    }
+
+    /**
+     * @brief Input bytes that are not processed
+     */
+    [[nodiscard]] std::uintmax_t saved_bytes() const {
+        std::uintmax_t bytes = 0;
+        for (const auto& [target, group] : duplicates) {
+            bytes += group.file_size * group.targets.size();
+        }
+        return bytes;
+    }
+};
+
+/**
+ * @brief Group targets whose files have identical content
+ * @details Only files that share their size with another target are hashed (SHA-1, hashed
+ *          concurrently). Anything that is not a regular file, such as a pipe, and files that
+ *          cannot be hashed stay unique.
+ * @param targets List of target paths
+ * @return Unique targets in input order, and the duplicates of each of them
+ */
+TargetDedupPlan plan_target_dedup(const std::vector<std::string>& targets) {
+    namespace fs = std::filesystem;
+
+    std::unordered_map<std::string, std::uintmax_t> sizes;
+    std::unordered_map<std::uintmax_t, std::unordered_set<std::string>> by_size;
+    for (const auto& path : targets) {
+        std::error_code ec;
+        if (!fs::is_regular_file(path, ec)) continue;
+        const auto size = fs::file_size(path, ec);
+        if (ec) continue;
+        sizes.emplace(path, size);
+        by_size[size].insert(path);
+    }
+
+    // A listed path always duplicates itself; distinct paths need a content hash
+    std::unordered_set<std::string> to_hash;
+    for (const auto& [size, paths] : by_size) {
+        if (paths.size() > 1) to_hash.insert(paths.begin(), paths.end());
+    }
+    std::unordered_map<std::string, std::string> hashes;
+    if (!to_hash.empty()) {
+        std::vector<std::string> hashed(to_hash.begin(), to_hash.end());
+        std::sort(hashed.begin(), hashed.end()); // Order of the sha1_batch results
+        const auto digests = foundation::infrastructure::concurrent_crypto::sha1_batch(to_hash);
+        for (size_t i = 0; i < hashed.size() && i < digests.size(); ++i) {
+            if (!digests[i].empty()) hashes.emplace(hashed[i], digests[i]);
+        }
+    }
+
+    TargetDedupPlan plan;
+    std::unordered_map<std::string, std::string> representative; // content key -> target
+    for (const auto& path : targets) {
+        const auto size = sizes.find(path);
+        if (size == sizes.end()) {
+            plan.unique_targets.push_back(path);
+            continue;
+        }
+        const auto hash = hashes.find(path);
+        const std::string key = std::to_string(size->second) + ":"
+                              + (hash != hashes.end() ? hash->second : "path:" + path);
+
+        const auto [it, inserted] = representative.emplace(key, path);
+        if (inserted) {
+            plan.unique_targets.push_back(path);
+        } else {
+            auto& group = plan.duplicates[it->second];
+            group.targets.push_back(path);
+            group.file_size = size->second;
+        }
+    }
+    return plan;
+}
+
 } // namespace services::pipeline
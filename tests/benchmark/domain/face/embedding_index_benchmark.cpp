@@ -0,0 +1,88 @@
+/**
+ * @file embedding_index_benchmark.cpp
+ * @brief Benchmark of reference gallery matching: per-pair loop vs EmbeddingIndex
+ * @author CodingRookie
+ * @date 2026-10-18
+ */
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+import domain.face;
+import domain.face.embedding_index;
+
+using namespace domain::face::embedding_index;
+
+namespace {
+
+std::vector<float> random_unit_embedding(std::mt19937& rng, size_t dim) {
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> v(dim);
+    double norm = 0.0;
+    for (auto& x : v) {
+        x = dist(rng);
+        norm += static_cast<double>(x) * x;
+    }
+    for (auto& x : v) x /= static_cast<float>(std::sqrt(norm));
+    return v;
+}
+
+} // namespace
+
+TEST(EmbeddingIndexBenchmark, GalleryMatchThroughput) {
+    constexpr size_t kDim = 512;
+    constexpr size_t kQueries = 200;
+    const std::vector<size_t> gallery_sizes = {16, 256, 2048};
+
+    std::mt19937 rng(1234);
+    std::vector<std::vector<float>> queries;
+    for (size_t i = 0; i < kQueries; ++i) queries.push_back(random_unit_embedding(rng, kDim));
+
+    std::cout << "\n=======================================================" << std::endl;
+    std::cout << "[BENCHMARK RESULT] Gallery match (" << kQueries << " queries, dim " << kDim
+              << ")" << std::endl;
+
+    for (size_t gallery_size : gallery_sizes) {
+        std::vector<std::vector<float>> gallery;
+        EmbeddingIndex f32_index;
+        EmbeddingIndex s8_index(Precision::Int8);
+        for (size_t i = 0; i < gallery_size; ++i) {
+            gallery.push_back(random_unit_embedding(rng, kDim));
+            f32_index.add(gallery.back());
+            s8_index.add(gallery.back());
+        }
+
+        // Baseline: the nested inner_product loop used by find_similar_faces before the index
+        float checksum = 0.0f;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& q : queries) {
+            float best = -1.0f;
+            for (const auto& ref : gallery) {
+                best = std::max(best, std::inner_product(q.begin(), q.end(), ref.begin(), 0.0f));
+            }
+            checksum += best;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        const double loop_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+        auto time_index = [&](const EmbeddingIndex& index) {
+            float sum = 0.0f;
+            auto t0 = std::chrono::high_resolution_clock::now();
+            for (const auto& q : queries) sum += index.best_match(q)->similarity;
+            auto t1 = std::chrono::high_resolution_clock::now();
+            EXPECT_NEAR(sum, checksum, 0.05f * kQueries);
+            return std::chrono::duration<double, std::milli>(t1 - t0).count();
+        };
+        const double f32_ms = time_index(f32_index);
+        const double s8_ms = time_index(s8_index);
+
+        std::cout << "gallery " << gallery_size << "\tloop " << loop_ms << " ms\tf32 " << f32_ms
+                  << " ms\tint8 " << s8_ms << " ms" << std::endl;
+    }
+    std::cout << "=======================================================\n" << std::endl;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file face_blend_benchmark.cpp
+ * @brief Benchmark of paste-back: float-plane blend vs fused u8 kernel
+ * @author CodingRookie
+ * @date 2026-10-18
+ */
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+import domain.face.helper;
+
+using namespace domain::face::helper;
+
+namespace {
+
+// Float-plane paste-back used before the fused kernel
+cv::Mat legacy_paste_back(const cv::Mat& frame, const cv::Mat& crop, const cv::Mat& mask,
+                          const cv::Mat& affine) {
+    cv::Mat inverse_matrix;
+    cv::invertAffineTransform(affine, inverse_matrix);
+    cv::Mat inverse_mask;
+    cv::warpAffine(mask, inverse_mask, inverse_matrix, frame.size());
+    inverse_mask.setTo(0, inverse_mask < 0);
+    inverse_mask.setTo(1, inverse_mask > 1);
+    cv::Mat inverse_crop;
+    cv::warpAffine(crop, inverse_crop, inverse_matrix, frame.size(), cv::INTER_LINEAR,
+                   cv::BORDER_REPLICATE);
+
+    std::vector<cv::Mat> crop_bgrs(3);
+    std::vector<cv::Mat> frame_bgrs(3);
+    cv::split(inverse_crop, crop_bgrs);
+    cv::split(frame, frame_bgrs);
+    for (int c = 0; c < 3; ++c) {
+        crop_bgrs[c].convertTo(crop_bgrs[c], CV_32FC1);
+        frame_bgrs[c].convertTo(frame_bgrs[c], CV_32FC1);
+        crop_bgrs[c] = inverse_mask.mul(crop_bgrs[c]) + frame_bgrs[c].mul(1 - inverse_mask);
+    }
+    cv::Mat result;
+    cv::merge(crop_bgrs, result);
+    result.convertTo(result, CV_8UC3);
+    return result;
+}
+
+template <typename Fn> double time_ms(int iterations, Fn&& fn) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    const auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+} // namespace
+
+TEST(FaceBlendBenchmark, PasteBackAndFaceBlend) {
+    constexpr int kIterations = 30;
+    const std::vector<cv::Size> frame_sizes = {{1280, 720}, {1920, 1080}, {3840, 2160}};
+
+    cv::Mat crop(512, 512, CV_8UC3);
+    cv::randu(crop, 0, 256);
+    cv::Mat mask(512, 512, CV_32FC1, cv::Scalar(1.0f));
+    cv::GaussianBlur(mask(cv::Rect(16, 16, 480, 480)), mask(cv::Rect(16, 16, 480, 480)),
+                     cv::Size(31, 31), 0);
+
+    std::cout << "\n=======================================================" << std::endl;
+    std::cout << "[BENCHMARK RESULT] Paste-back of one 512x512 face (ms per call)" << std::endl;
+
+    for (const auto& size : frame_sizes) {
+        cv::Mat frame(size, CV_8UC3);
+        cv::randu(frame, 0, 256);
+        // Face of ~400px near the frame centre
+        cv::Mat affine = cv::getRotationMatrix2D(
+            cv::Point2f(static_cast<float>(size.width) / 2, static_cast<float>(size.height) / 2),
+            10.0, 512.0 / 400.0);
+        affine.at<double>(0, 2) += 256 - size.width / 2.0;
+        affine.at<double>(1, 2) += 256 - size.height / 2.0;
+
+        const double legacy_ms = time_ms(kIterations, [&] {
+            (void)legacy_paste_back(frame, crop, mask, affine);
+        });
+        const double legacy_blend_ms = time_ms(kIterations, [&] {
+            cv::Mat blended;
+            cv::addWeighted(legacy_paste_back(frame, crop, mask, affine), 0.8, frame, 0.2, 0.0,
+                            blended);
+        });
+        const double fused_ms = time_ms(kIterations, [&] {
+            (void)paste_back(frame, crop, mask, affine);
+        });
+        cv::Mat working = frame.clone();
+        const double fused_blend_ms = time_ms(kIterations, [&] {
+            paste_back_into(working, crop, mask, affine, 0.8F);
+        });
+
+        EXPECT_LE(cv::norm(legacy_paste_back(frame, crop, mask, affine),
+                           paste_back(frame, crop, mask, affine), cv::NORM_INF),
+                  1.0);
+
+        std::cout << size.width << "x" << size.height << "\tlegacy " << legacy_ms
+                  << "\tfused " << fused_ms << "\tlegacy+blend " << legacy_blend_ms
+                  << "\tfused in-place+blend " << fused_blend_ms << std::endl;
+    }
+    std::cout << "=======================================================\n" << std::endl;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file codec_threading_benchmark.cpp
+ * @brief Benchmark of decode-only and encode-only throughput per codec threading setting
+ * @author CodingRookie
+ * @date 2026-10-18
+ */
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+import foundation.media.ffmpeg;
+
+using namespace foundation::media::ffmpeg;
+
+namespace {
+
+constexpr int kFrames = 120;
+const cv::Size kFrameSize(1280, 720);
+
+struct Setting {
+    int threads; ///< 0 = FFmpeg auto
+    std::string type;
+};
+
+const std::vector<Setting> kSettings = {{1, "frame"}, {2, "frame"}, {4, "frame"}, {0, "frame"},
+                                        {2, "slice"}, {4, "slice"}, {0, "slice"}, {0, ""}};
+
+std::string describe(const Setting& setting) {
+    return (setting.threads == 0 ? std::string("auto") : std::to_string(setting.threads))
+         + " threads, " + (setting.type.empty() ? std::string("frame+slice") : setting.type);
+}
+
+/// Moving gradient with noise: cheap to generate, not trivial to encode
+std::vector<cv::Mat> make_frames() {
+    std::vector<cv::Mat> frames;
+    cv::Mat noise(kFrameSize, CV_8UC3);
+    cv::randu(noise, 0, 32);
+    for (int i = 0; i < kFrames; ++i) {
+        cv::Mat frame(kFrameSize, CV_8UC3);
+        for (int y = 0; y < frame.rows; ++y) {
+            auto* row = frame.ptr<cv::Vec3b>(y);
+            for (int x = 0; x < frame.cols; ++x) {
+                row[x] = cv::Vec3b(static_cast<uchar>(x + i * 4), static_cast<uchar>(y + i * 2),
+                                   static_cast<uchar>((x + y) / 2));
+            }
+        }
+        frames.push_back(frame + noise);
+    }
+    return frames;
+}
+
+double encode_fps(const std::string& path, const std::vector<cv::Mat>& frames,
+                  const Setting& setting) {
+    VideoParams params;
+    params.width = kFrameSize.width;
+    params.height = kFrameSize.height;
+    params.frameRate = 30.0;
+    params.preset = "veryfast";
+    params.threadCount = setting.threads;
+    params.threadType = setting.type;
+
+    const auto start = std::chrono::steady_clock::now();
+    VideoWriter writer(path, params);
+    if (!writer.open()) return 0.0;
+    for (const auto& frame : frames) writer.write_frame(frame);
+    writer.close(); // Waits for the encoder to drain
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(frames.size()) / elapsed.count();
+}
+
+double decode_fps(const std::string& path, const Setting& setting, int& decoded) {
+    const auto start = std::chrono::steady_clock::now();
+    VideoReader reader(path);
+    reader.set_decoder_threads(setting.threads, setting.type);
+    if (!reader.open()) return 0.0;
+    decoded = 0;
+    while (!reader.read_frame().empty()) ++decoded;
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(decoded) / elapsed.count();
+}
+
+} // namespace
+
+TEST(CodecThreadingBenchmark, DecodeAndEncodeThroughput) {
+    const auto dir = std::filesystem::temp_directory_path() / "codec_threading_benchmark";
+    std::filesystem::create_directories(dir);
+    const std::vector<cv::Mat> frames = make_frames();
+
+    std::cout << "\n=======================================================" << std::endl;
+    std::cout << "[BENCHMARK RESULT] " << kFrameSize.width << "x" << kFrameSize.height
+              << " H.264, " << kFrames << " frames (fps)" << std::endl;
+
+    const std::string reference = (dir / "reference.mp4").string();
+    for (const auto& setting : kSettings) {
+        const std::string path = (dir / "encoded.mp4").string();
+        const double fps = encode_fps(path, frames, setting);
+        EXPECT_GT(fps, 0.0);
+        std::cout << "encode\t" << describe(setting) << "\t" << fps << std::endl;
+        if (!std::filesystem::exists(reference)) std::filesystem::rename(path, reference);
+    }
+
+    for (const auto& setting : kSettings) {
+        int decoded = 0;
+        const double fps = decode_fps(reference, setting, decoded);
+        EXPECT_EQ(decoded, kFrames);
+        std::cout << "decode\t" << describe(setting) << "\t" << fps << std::endl;
+    }
+    std::cout << "=======================================================\n" << std::endl;
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file media_probe.ixx
+ * @brief Packet-level inspection of written media files for tests
+ */
+module;
+#include <algorithm>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+export module tests.helpers.foundation.media_probe;
+
+export namespace tests::helpers::foundation {
+
+enum class StreamType { Video, Audio, Other };
+
+/// One demuxed packet, timestamps in seconds
+struct PacketRecord {
+    StreamType type = StreamType::Other;
+    double pts = 0.0;
+    double dts = 0.0;
+    double duration = 0.0;
+    bool keyframe = false;
+};
+
+/// Every packet of @p path in file order (empty if the file cannot be read)
+std::vector<PacketRecord> read_packets(const std::string& path) {
+    std::vector<PacketRecord> packets;
+    AVFormatContext* ctx = nullptr;
+    if (avformat_open_input(&ctx, path.c_str(), nullptr, nullptr) < 0) return packets;
+    if (avformat_find_stream_info(ctx, nullptr) >= 0) {
+        AVPacket* packet = av_packet_alloc();
+        while (packet && av_read_frame(ctx, packet) >= 0) {
+            const AVStream* stream = ctx->streams[packet->stream_index];
+            const double time_base = av_q2d(stream->time_base);
+            PacketRecord record;
+            switch (stream->codecpar->codec_type) {
+            case AVMEDIA_TYPE_VIDEO: record.type = StreamType::Video; break;
+            case AVMEDIA_TYPE_AUDIO: record.type = StreamType::Audio; break;
+            default: break;
+            }
+            record.pts = static_cast<double>(packet->pts) * time_base;
+            record.dts = static_cast<double>(packet->dts) * time_base;
+            record.duration = static_cast<double>(packet->duration) * time_base;
+            record.keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+            packets.push_back(record);
+            av_packet_unref(packet);
+        }
+        av_packet_free(&packet);
+    }
+    avformat_close_input(&ctx);
+    return packets;
+}
+
+/// Time from the first packet of a @p type stream to the end of its last one, in seconds
+double stream_seconds(const std::vector<PacketRecord>& packets, StreamType type) {
+    double start = 0.0;
+    double end = 0.0;
+    bool found = false;
+    for (const auto& packet : packets) {
+        if (packet.type != type) continue;
+        start = found ? std::min(start, packet.pts) : packet.pts;
+        end = found ? std::max(end, packet.pts + packet.duration) : packet.pts + packet.duration;
+        found = true;
+    }
+    return end - start;
+}
+
+/// Whether the decode timestamps of the @p type stream strictly increase
+bool dts_increasing(const std::vector<PacketRecord>& packets, StreamType type) {
+    bool found = false;
+    double last = 0.0;
+    for (const auto& packet : packets) {
+        if (packet.type != type) continue;
+        if (found && packet.dts <= last) return false;
+        last = packet.dts;
+        found = true;
+    }
+    return true;
+}
+
+} // namespace tests::helpers::foundation
@@ -11,6 +11,7 @@
 #include <vector>
 
 import services.pipeline.runner;
+import foundation.ai.inference_session_registry;
 import config.task;
 import config.merger;
 import domain.ai.model_repository;
@@ -257,6 +258,127 @@ TEST_F(PipelineRunnerImageTest, ProcessImageSequentialMultiStep) {
     verify_face_swap(output_path, source_path);
 }
 
+TEST_F(PipelineRunnerImageTest, ProcessImageStepMajorMatchesSequential) {
+    if (!std::filesystem::exists(source_path)
+        || !std::filesystem::exists(target_image_path_woman)) {
+        GTEST_SKIP() << "Test assets not found.";
+    }
+    using foundation::ai::inference_session::InferenceSessionRegistry;
+
+    config::AppConfig app_config;
+    app_config.temp_directory = (output_dir / "temp").string();
+    auto runner = create_pipeline_runner(app_config);
+
+    auto run = [&](const std::string& id, config::ExecutionOrder order,
+                   config::MemoryStrategy memory) {
+        config::TaskConfig task_config;
+        task_config.config_version = "1.0";
+        task_config.task_info.id = id;
+        task_config.io.source_paths.push_back(source_path.string());
+        task_config.io.target_paths.push_back(target_image_path_woman.string());
+        task_config.io.output.path = output_dir.string();
+        task_config.io.output.prefix = id + "_";
+        task_config.io.output.image_format = "png";
+
+        config::PipelineStep swap;
+        swap.step = "face_swapper";
+        swap.enabled = true;
+        config::FaceSwapperParams swap_params;
+        swap_params.model = "inswapper_128_fp16";
+        swap.params = swap_params;
+        task_config.pipeline.push_back(swap);
+
+        // Fixed tiles: calibration would make the two runs tile the frame differently
+        config::PipelineStep upscale;
+        upscale.step = "frame_enhancer";
+        upscale.enabled = true;
+        config::FrameEnhancerParams upscale_params;
+        upscale_params.model = "real_esrgan_x2_fp16";
+        upscale_params.autotune_tiles = false;
+        upscale.params = upscale_params;
+        task_config.pipeline.push_back(upscale);
+
+        auto merged = config::MergeConfigs(task_config, app_config);
+        merged.resource.execution_order = order;
+        merged.resource.memory_strategy = memory;
+        auto result = runner->run(merged, [](const services::pipeline::TaskProgress&) {});
+        EXPECT_TRUE(result.is_ok()) << (result.is_ok() ? "" : result.error().message);
+        return cv::imread((output_dir / (id + "_woman.png")).string());
+    };
+
+    const cv::Mat sequential = run("image_sequential", config::ExecutionOrder::Sequential,
+                                   config::MemoryStrategy::Tolerant);
+    EXPECT_GT(InferenceSessionRegistry::get_instance()->size(), 0U);
+
+    const cv::Mat batch =
+        run("image_step_major", config::ExecutionOrder::Batch, config::MemoryStrategy::Strict);
+
+    // Strict mode drops every session after each step
+    EXPECT_EQ(InferenceSessionRegistry::get_instance()->size(), 0U);
+    // Intermediate results are gone
+    EXPECT_FALSE(std::filesystem::exists(output_dir / "temp" / "batch_image_step_major"));
+
+    ASSERT_FALSE(sequential.empty());
+    ASSERT_FALSE(batch.empty());
+    ASSERT_EQ(batch.size(), sequential.size());
+    EXPECT_GT(cv::PSNR(batch, sequential), 40.0);
+    verify_face_swap(output_dir / "image_step_major_woman.png", source_path);
+}
+
+TEST_F(PipelineRunnerImageTest, ProcessImageBatchOrderKeepsExpressionSource) {
+    if (!std::filesystem::exists(source_path)
+        || !std::filesystem::exists(target_image_path_woman)) {
+        GTEST_SKIP() << "Test assets not found.";
+    }
+
+    config::AppConfig app_config;
+    app_config.temp_directory = (output_dir / "temp").string();
+    auto runner = create_pipeline_runner(app_config);
+
+    auto run = [&](const std::string& id, config::ExecutionOrder order) {
+        config::TaskConfig task_config;
+        task_config.config_version = "1.0";
+        task_config.task_info.id = id;
+        task_config.io.source_paths.push_back(source_path.string());
+        task_config.io.target_paths.push_back(target_image_path_woman.string());
+        task_config.io.output.path = output_dir.string();
+        task_config.io.output.prefix = id + "_";
+        task_config.io.output.image_format = "png";
+
+        config::PipelineStep swap;
+        swap.step = "face_swapper";
+        swap.enabled = true;
+        config::FaceSwapperParams swap_params;
+        swap_params.model = "inswapper_128_fp16";
+        swap.params = swap_params;
+        task_config.pipeline.push_back(swap);
+
+        config::PipelineStep restore;
+        restore.step = "expression_restorer";
+        restore.enabled = true;
+        config::ExpressionRestorerParams restore_params;
+        restore_params.model = "live_portrait";
+        restore.params = restore_params;
+        task_config.pipeline.push_back(restore);
+
+        auto merged = config::MergeConfigs(task_config, app_config);
+        merged.resource.execution_order = order;
+        auto result = runner->run(merged, [](const services::pipeline::TaskProgress&) {});
+        EXPECT_TRUE(result.is_ok()) << (result.is_ok() ? "" : result.error().message);
+        return cv::imread((output_dir / (id + "_woman.png")).string());
+    };
+
+    // The restorer must see the original expression, not the swapped face it restores, so
+    // batch order may not split it from the swapper
+    const cv::Mat sequential = run("expression_sequential", config::ExecutionOrder::Sequential);
+    const cv::Mat batch = run("expression_batch", config::ExecutionOrder::Batch);
+
+    ASSERT_FALSE(sequential.empty());
+    ASSERT_FALSE(batch.empty());
+    ASSERT_EQ(batch.size(), sequential.size());
+    EXPECT_GT(cv::PSNR(batch, sequential), 40.0);
+}
+
 // ============================================================================
 // Performance & Stress Tests (Merged from E2E)
 // ============================================================================
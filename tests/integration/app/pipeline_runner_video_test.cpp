@@ -6,13 +6,23 @@
  */
 #include <gtest/gtest.h>
 #include <filesystem>
+#include <format>
+#include <fstream>
 #include <iostream>
+#include <thread>
 #include <vector>
 #include <algorithm>
 #include <opencv2/opencv.hpp>
+#ifndef _WIN32
+#include <csignal>
+#include <cstdio>
+#include <unistd.h>
+#endif
 
 import services.pipeline.runner;
+import services.pipeline.checkpoint;
 import config.task;
+import config.types;
 import config.merger;
 import domain.ai.model_repository;
 import tests.helpers.foundation.test_utilities;
@@ -20,8 +30,10 @@ import domain.face;
 import domain.face.analyser;
 import tests.helpers.domain.face_test_helpers;
 import foundation.media.ffmpeg;
+import foundation.infrastructure.logger;
 
 import tests.helpers.foundation.test_constants;
+import tests.helpers.foundation.media_probe;
 
 using namespace services::pipeline;
 using namespace tests::helpers::foundation;
@@ -437,6 +449,218 @@ TEST_F(PipelineRunnerVideoTest, ProcessVideoBatchMutiStep) {
     // Optionally verify second output too, but one is usually enough for pipeline logic check
 }
 
+TEST_F(PipelineRunnerVideoTest, ProcessVideo_ResumesSegmentsAfterCancel) {
+    if (!std::filesystem::exists(video_path) || !std::filesystem::exists(source_path)) {
+        GTEST_SKIP() << "Test assets not found.";
+    }
+
+    config::AppConfig app_config;
+    config::TaskConfig task_config;
+    task_config.task_info.id = "test_video_resume_segments";
+    task_config.task_info.enable_resume = true;
+    task_config.io.source_paths = {source_path.string()};
+    task_config.io.target_paths = {video_path.string()};
+    task_config.io.output.path = output_dir.string();
+    task_config.io.output.prefix = "resume_segments_";
+    task_config.resource.segment_duration_seconds = 2;
+
+    config::PipelineStep step;
+    step.step = "face_swapper";
+    step.enabled = true;
+    config::FaceSwapperParams params;
+    params.model = "inswapper_128_fp16";
+    step.params = params;
+    task_config.pipeline.push_back(step);
+
+    const auto output_path = output_dir / "resume_segments_slideshow_scaled.mp4";
+    CheckpointManager ckpt_mgr("./checkpoints"); // Where the video runner keeps checkpoints
+    ckpt_mgr.cleanup(task_config.task_info.id);
+    std::filesystem::remove(output_path);
+    std::filesystem::remove_all(output_dir / ".resume_segments_slideshow_scaled.mp4.segments");
+    const auto merged_config = config::MergeConfigs(task_config, app_config);
+
+    // 1. Cancel about halfway: the segments closed so far are kept
+    {
+        auto runner = create_pipeline_runner(app_config);
+        auto result = runner->run(merged_config, [&](const services::pipeline::TaskProgress& p) {
+            if (p.current_frame >= 250) runner->cancel();
+        });
+        ASSERT_TRUE(result.is_err());
+        EXPECT_EQ(result.error().code, config::ErrorCode::E407TaskCancelled);
+    }
+    const auto checkpoint = ckpt_mgr.load(task_config.task_info.id);
+    ASSERT_TRUE(checkpoint.has_value());
+    EXPECT_FALSE(checkpoint->segments.empty());
+    EXPECT_FALSE(std::filesystem::exists(output_path));
+
+    // 2. Resume: the remaining frames are rendered and all segments joined
+    {
+        auto runner = create_pipeline_runner(app_config);
+        auto result = runner->run(merged_config, [](const services::pipeline::TaskProgress&) {});
+        if (result.is_err()) std::cerr << "Resume Error: " << result.error().message << std::endl;
+        ASSERT_TRUE(result.is_ok());
+    }
+    ASSERT_TRUE(std::filesystem::exists(output_path));
+    EXPECT_FALSE(ckpt_mgr.exists(task_config.task_info.id));
+
+    // Every source frame once, audio as long as the video, decode order never stepping back
+    auto count_frames = [](const std::filesystem::path& path) {
+        foundation::media::ffmpeg::VideoReader reader(path.string());
+        int count = 0;
+        if (reader.open()) {
+            while (!reader.read_frame().empty()) ++count;
+        }
+        return count;
+    };
+    EXPECT_EQ(count_frames(output_path), count_frames(video_path));
+
+    const auto source_info = get_video_info(video_path);
+    const auto packets = read_packets(output_path.string());
+    const double video_seconds = stream_seconds(packets, StreamType::Video);
+    EXPECT_NEAR(video_seconds, source_info.frame_count / source_info.fps, 0.1);
+    EXPECT_NEAR(stream_seconds(packets, StreamType::Audio), video_seconds, 0.1);
+    EXPECT_TRUE(dts_increasing(packets, StreamType::Video));
+    EXPECT_TRUE(dts_increasing(packets, StreamType::Audio));
+}
+
+#ifndef _WIN32
+TEST_F(PipelineRunnerVideoTest, ProcessVideo_StreamsPipeInputToStdout) {
+    if (!std::filesystem::exists(video_path) || !std::filesystem::exists(source_path)) {
+        GTEST_SKIP() << "Test assets not found.";
+    }
+
+    // As the CLI does for streaming runs: stdout carries nothing but the video
+    foundation::infrastructure::logger::Logger::get_instance()->use_stderr_console();
+    std::signal(SIGPIPE, SIG_IGN); // The runner may stop reading before the feeder is done
+
+    auto count_frames = [](const std::filesystem::path& path) {
+        foundation::media::ffmpeg::VideoReader reader(path.string());
+        int count = 0;
+        if (reader.open()) {
+            while (!reader.read_frame().empty()) ++count;
+        }
+        return count;
+    };
+    const int source_frames = count_frames(video_path);
+
+    // Top-level box types of an MP4 file, empty if the boxes do not tile it exactly
+    auto mp4_boxes = [](const std::string& bytes) {
+        std::vector<std::string> types;
+        size_t offset = 0;
+        while (offset + 8 <= bytes.size()) {
+            const auto* p = reinterpret_cast<const unsigned char*>(bytes.data() + offset);
+            const size_t size = (size_t{p[0]} << 24) | (size_t{p[1]} << 16) | (p[2] << 8) | p[3];
+            if (size < 8 || offset + size > bytes.size()) return std::vector<std::string>{};
+            types.emplace_back(bytes.data() + offset + 4, 4);
+            offset += size;
+        }
+        return offset == bytes.size() ? types : std::vector<std::string>{};
+    };
+
+    const std::pair<config::StreamFormat, std::string> formats[] = {
+        {config::StreamFormat::Fmp4, "mp4"}, {config::StreamFormat::MpegTs, "ts"}};
+    for (const auto& [format, extension] : formats) {
+        SCOPED_TRACE(extension);
+
+        int input[2];
+        int output[2];
+        ASSERT_EQ(::pipe(input), 0);
+        ASSERT_EQ(::pipe(output), 0);
+
+        config::AppConfig app_config;
+        config::TaskConfig task_config;
+        task_config.task_info.id = "test_video_stream_" + extension;
+        task_config.io.source_paths = {source_path.string()};
+        task_config.io.target_paths = {std::format("pipe:{}", input[0])};
+        task_config.io.output.stream_format = format;
+
+        config::PipelineStep step;
+        step.step = "face_swapper";
+        step.enabled = true;
+        config::FaceSwapperParams params;
+        params.model = "inswapper_128_fp16";
+        step.params = params;
+        task_config.pipeline.push_back(step);
+
+        // Feed the clip into the input pipe and collect whatever reaches stdout
+        std::thread feeder([&, fd = input[1]] {
+            std::ifstream in(video_path, std::ios::binary);
+            std::vector<char> buffer(1 << 16);
+            bool open = true;
+            while (open && in) {
+                in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                const char* data = buffer.data();
+                auto left = static_cast<size_t>(in.gcount());
+                while (left > 0) {
+                    const ssize_t written = ::write(fd, data, left);
+                    if (written <= 0) {
+                        open = false;
+                        break;
+                    }
+                    data += written;
+                    left -= static_cast<size_t>(written);
+                }
+            }
+            ::close(fd);
+        });
+        std::string streamed;
+        std::thread drain([&, fd = output[0]] {
+            std::vector<char> buffer(1 << 16);
+            ssize_t n = 0;
+            while ((n = ::read(fd, buffer.data(), buffer.size())) > 0) {
+                streamed.append(buffer.data(), static_cast<size_t>(n));
+            }
+            ::close(fd);
+        });
+
+        std::cout.flush();
+        std::fflush(stdout);
+        const int saved_stdout = ::dup(STDOUT_FILENO);
+        ::dup2(output[1], STDOUT_FILENO);
+        ::close(output[1]);
+
+        auto runner = create_pipeline_runner(app_config);
+        auto result = runner->run(config::MergeConfigs(task_config, app_config),
+                                  [](const services::pipeline::TaskProgress&) {});
+
+        std::cout.flush();
+        std::fflush(stdout);
+        ::dup2(saved_stdout, STDOUT_FILENO); // Drops the last write end: the drain sees EOF
+        ::close(saved_stdout);
+        ::close(input[0]);
+        feeder.join();
+        drain.join();
+
+        if (result.is_err()) std::cerr << "Stream Error: " << result.error().message << std::endl;
+        ASSERT_TRUE(result.is_ok());
+
+        // Any log line or progress output on stdout would break the container framing
+        if (format == config::StreamFormat::MpegTs) {
+            ASSERT_FALSE(streamed.empty());
+            EXPECT_EQ(streamed.size() % 188, 0U);
+            bool synced = true;
+            for (size_t i = 0; i < streamed.size(); i += 188) synced &= streamed[i] == 0x47;
+            EXPECT_TRUE(synced);
+        } else {
+            const auto boxes = mp4_boxes(streamed);
+            ASSERT_FALSE(boxes.empty());
+            EXPECT_EQ(boxes.front(), "ftyp");
+            EXPECT_NE(std::ranges::find(boxes, "moof"), boxes.end()); // Fragmented
+        }
+
+        // The pipe was read once, front to back: nothing was lost to probing or seeking
+        const auto captured = output_dir / ("stream_output." + extension);
+        std::ofstream(captured, std::ios::binary)
+            .write(streamed.data(), static_cast<std::streamsize>(streamed.size()));
+        const auto packets = read_packets(captured.string());
+        const auto video_packets = std::ranges::count_if(
+            packets, [](const PacketRecord& p) { return p.type == StreamType::Video; });
+        EXPECT_EQ(video_packets, source_frames);
+        EXPECT_TRUE(dts_increasing(packets, StreamType::Video));
+    }
+}
+#endif
+
 // ============================================================================
 // Performance Tests (Merged from E2E)
 // ============================================================================
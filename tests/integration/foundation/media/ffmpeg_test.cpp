@@ -8,8 +8,12 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <string>
+#include <format>
+#include <vector>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core.hpp>
 
@@ -18,6 +22,7 @@
 import foundation.media.ffmpeg;
 import foundation.infrastructure.file_system;
 import tests.helpers.foundation.test_utilities;
+import tests.helpers.foundation.media_probe;
 
 namespace fs = std::filesystem;
 using namespace foundation::media::ffmpeg;
@@ -204,6 +209,152 @@ TEST_F(FfmpegTest, VideoWriter_BasicWrite) {
     fs::remove_all(temp_dir);
 }
 
+TEST_F(FfmpegTest, RemuxerConcatJoinsSegments) {
+    auto temp_dir = fs::temp_directory_path() / "facefusion_ffmpeg_test_concat";
+    if (fs::exists(temp_dir)) fs::remove_all(temp_dir);
+    fs::create_directories(temp_dir);
+
+    VideoParams params("");
+    params.width = 320;
+    params.height = 240;
+    params.frameRate = 25;
+    params.videoCodec = "mpeg4";
+
+    // Three closed segments of 20 frames each, as written for a resumable render
+    std::vector<std::string> segments;
+    cv::Mat frame(240, 320, CV_8UC3);
+    for (int segment = 0; segment < 3; ++segment) {
+        segments.push_back((temp_dir / std::format("{:05}.mp4", segment)).string());
+        VideoWriter writer(segments.back(), params);
+        ASSERT_TRUE(writer.open());
+        for (int i = 0; i < 20; ++i) {
+            frame.setTo(cv::Scalar(segment * 80, i * 10, 0));
+            EXPECT_TRUE(writer.write_frame(frame));
+        }
+        writer.close();
+    }
+
+    const auto output_path = (temp_dir / "joined.mp4").string();
+    ASSERT_TRUE(Remuxer::concat(segments, output_path));
+
+    VideoReader reader(output_path);
+    ASSERT_TRUE(reader.open());
+    int read_count = 0;
+    while (!reader.read_frame().empty()) { read_count++; }
+    // As in VideoWriter_BasicWrite, MPEG4 may lose the last frame of each segment
+    EXPECT_GE(read_count, 57);
+    EXPECT_LE(read_count, 60);
+    EXPECT_NEAR(static_cast<double>(reader.get_duration_ms()), 2400.0, 100.0);
+
+    fs::remove_all(temp_dir);
+}
+
+TEST_F(FfmpegTest, VideoWriterCopiesAudioInline) {
+    auto video_path = get_test_data_path("standard_face_test_videos/slideshow_scaled.mp4");
+    if (!fs::exists(video_path)) { GTEST_SKIP() << "Test video not found: " << video_path; }
+    auto temp_dir = fs::temp_directory_path() / "facefusion_ffmpeg_test_inline_audio";
+    if (fs::exists(temp_dir)) fs::remove_all(temp_dir);
+    fs::create_directories(temp_dir);
+
+    VideoReader reader(video_path.string());
+    ASSERT_TRUE(reader.open());
+    constexpr int kFrames = 60;
+
+    // From the start, and from frame 120 as a resumed render would
+    for (const int first_frame : {0, 120}) {
+        ASSERT_TRUE(reader.seek(first_frame));
+        VideoParams params("");
+        params.width = reader.get_width();
+        params.height = reader.get_height();
+        params.frameRate = reader.get_fps();
+        params.videoCodec = "mpeg4";
+
+        const auto output_path = (temp_dir / std::format("from_{}.mp4", first_frame)).string();
+        VideoWriter writer(output_path, params);
+        writer.set_audio_source(video_path.string(), first_frame * 1000.0 / reader.get_fps());
+        ASSERT_TRUE(writer.open());
+        ASSERT_TRUE(writer.has_audio()) << "Test video has no audio track";
+        for (int i = 0; i < kFrames; ++i) {
+            const cv::Mat frame = reader.read_frame();
+            ASSERT_FALSE(frame.empty());
+            EXPECT_TRUE(writer.write_frame(frame));
+        }
+        EXPECT_TRUE(writer.close());
+
+        const auto packets = read_packets(output_path);
+        const double video_seconds = stream_seconds(packets, StreamType::Video);
+        const double audio_seconds = stream_seconds(packets, StreamType::Audio);
+        EXPECT_NEAR(video_seconds, kFrames / reader.get_fps(), 0.05) << "from " << first_frame;
+        // Audio is copied in whole packets (about 23 ms of AAC each)
+        EXPECT_NEAR(audio_seconds, video_seconds, 0.05) << "from " << first_frame;
+    }
+
+    fs::remove_all(temp_dir);
+}
+
+TEST_F(FfmpegTest, VideoWriterSmartRenderSplicesGops) {
+    // x264 source with B-frames and several closed GOPs
+    auto video_path = get_test_data_path("standard_face_test_videos/slideshow_scaled.mp4");
+    if (!fs::exists(video_path)) { GTEST_SKIP() << "Test video not found: " << video_path; }
+    auto temp_dir = fs::temp_directory_path() / "facefusion_ffmpeg_test_smart_render";
+    if (fs::exists(temp_dir)) fs::remove_all(temp_dir);
+    fs::create_directories(temp_dir);
+
+    const auto index = SeekIndex::build(video_path.string());
+    ASSERT_TRUE(index.has_value());
+    if (index->keyframes().size() < 3) { GTEST_SKIP() << "Test video has too few GOPs"; }
+    // Every other GOP is modified: copied and re-encoded GOPs meet in both directions
+    auto gop_modified = [&](int64_t frame) {
+        const auto& keys = index->keyframes();
+        const auto gop = std::ranges::upper_bound(keys, frame) - keys.begin() - 1;
+        return gop % 2 == 1;
+    };
+
+    VideoReader reader(video_path.string());
+    ASSERT_TRUE(reader.open());
+    VideoParams params("");
+    params.width = reader.get_width();
+    params.height = reader.get_height();
+    params.frameRate = reader.get_fps();
+
+    const auto output_path = (temp_dir / "smart.mp4").string();
+    VideoWriter writer(output_path, params);
+    writer.enable_smart_render(video_path.string());
+    ASSERT_TRUE(writer.open());
+    if (!writer.is_smart_render()) {
+        writer.close();
+        fs::remove_all(temp_dir);
+        GTEST_SKIP() << "Smart render unavailable (no libx264 or unsupported source)";
+    }
+    int64_t frame_count = 0;
+    for (cv::Mat frame = reader.read_frame(); !frame.empty(); frame = reader.read_frame()) {
+        const bool modified = gop_modified(frame_count++);
+        if (modified) cv::bitwise_not(frame, frame);
+        EXPECT_TRUE(writer.write_frame(frame, modified));
+    }
+    EXPECT_TRUE(writer.close());
+
+    EXPECT_TRUE(dts_increasing(read_packets(output_path), StreamType::Video));
+
+    // Copied GOPs decode to exactly the source frames
+    VideoReader source(video_path.string());
+    VideoReader output(output_path);
+    ASSERT_TRUE(source.open());
+    ASSERT_TRUE(output.open());
+    int64_t decoded = 0;
+    for (cv::Mat frame = output.read_frame(); !frame.empty(); frame = output.read_frame()) {
+        const cv::Mat expected = source.read_frame();
+        ASSERT_FALSE(expected.empty()) << "More frames than the source";
+        if (!gop_modified(decoded)) {
+            EXPECT_EQ(cv::norm(frame, expected, cv::NORM_INF), 0.0) << "frame " << decoded;
+        }
+        ++decoded;
+    }
+    EXPECT_EQ(decoded, frame_count);
+
+    fs::remove_all(temp_dir);
+}
+
 TEST_F(FfmpegTest, VideoWriterAdvancedParams) {
     auto temp_dir = fs::temp_directory_path() / "facefusion_ffmpeg_test_advanced";
     if (fs::exists(temp_dir)) fs::remove_all(temp_dir);
@@ -122,6 +122,20 @@ TEST_F(ConfigValidatorTest, ValidateInvalidImageFormatReturnsError) {
     EXPECT_EQ(errors[0].yaml_path, "io.output.image_format");
 }
 
+TEST_F(ConfigValidatorTest, ValidateStdinTargetIsAccepted) {
+    valid_task_config.io.target_paths = {"-"};
+    valid_task_config.io.output.stream_format = StreamFormat::MpegTs;
+    EXPECT_TRUE(validator.validate(valid_task_config).empty());
+}
+
+TEST_F(ConfigValidatorTest, ValidateStreamingWithSeveralTargetsReturnsError) {
+    valid_task_config.io.target_paths.push_back("pipe:0");
+    valid_task_config.io.output.stream_format = StreamFormat::Fmp4;
+    auto errors = validator.validate(valid_task_config);
+    ASSERT_EQ(errors.size(), 1U);
+    EXPECT_EQ(errors[0].yaml_path, "io.target_paths");
+}
+
 TEST_F(ConfigValidatorTest, ValidateEmptyPipelineReturnsError) {
     valid_task_config.pipeline.clear();
     auto errors = validator.validate(valid_task_config);
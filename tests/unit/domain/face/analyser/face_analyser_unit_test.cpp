@@ -149,6 +149,41 @@ TEST_F(FaceAnalyserUnitTest, GetManyFaces_FullPipeline) {
     EXPECT_EQ(face.embedding().size(), 512);
 }
 
+TEST_F(FaceAnalyserUnitTest, RoiRefineMapsRedetectionBackToFrame) {
+    options.face_detector_options.roi_refine.enabled = true;
+    options.face_detector_options.roi_refine.min_frame_side = 400;
+
+    DetectionResult coarse;
+    coarse.box = cv::Rect2f(100, 100, 50, 50);
+    coarse.score = 0.9f;
+    coarse.landmarks.assign(5, cv::Point2f(125, 125));
+
+    // ROI around the candidate: side 2 * 50 centred on (125, 125) -> (75, 75, 100, 100)
+    DetectionResult local;
+    local.box = cv::Rect2f(26, 27, 48, 48);
+    local.score = 0.95f;
+    local.landmarks.assign(5, cv::Point2f(50, 50));
+
+    EXPECT_CALL(*mock_detector, detect(_))
+        .WillRepeatedly([&](const cv::Mat& image) -> DetectionResults {
+            if (image.cols == 400) return {coarse};
+            EXPECT_EQ(image.size(), cv::Size(100, 100));
+            return {local};
+        });
+
+    FaceAnalyser analyser(options, mock_detector, mock_landmarker, mock_recognizer,
+                          mock_classifier);
+
+    cv::Mat frame(400, 400, CV_8UC3, cv::Scalar(7, 7, 7));
+    auto faces = analyser.get_many_faces(frame, FaceAnalysisType::Detection);
+
+    ASSERT_EQ(faces.size(), 1);
+    EXPECT_FLOAT_EQ(faces[0].box().x, 101.0f);
+    EXPECT_FLOAT_EQ(faces[0].box().y, 102.0f);
+    EXPECT_NEAR(faces[0].detector_score(), 0.95f, 1e-5);
+    EXPECT_FLOAT_EQ(faces[0].kps()[0].x, 125.0f);
+}
+
 TEST_F(FaceAnalyserUnitTest, GetOneFaceReturnsHighestScore) {
     // Setup Mock Detector returning 2 faces
     DetectionResult f1;
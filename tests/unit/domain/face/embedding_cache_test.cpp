@@ -0,0 +1,100 @@
+/**
+ * @file embedding_cache_test.cpp
+ * @brief Unit tests for the persistent source embedding cache.
+ * @author CodingRookie
+ *
+ * @date 2026-10-18
+ */
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+import domain.face;
+import domain.face.helper;
+import domain.face.embedding_cache;
+
+using namespace domain::face;
+using namespace domain::face::embedding_cache;
+
+namespace fs = std::filesystem;
+
+class EmbeddingCacheTest : public ::testing::Test {
+protected:
+    fs::path cache_dir;
+
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        cache_dir =
+            fs::temp_directory_path() / ("embedding_cache_test_" + std::string(info->name()));
+        fs::remove_all(cache_dir);
+    }
+
+    void TearDown() override { fs::remove_all(cache_dir); }
+};
+
+TEST_F(EmbeddingCacheTest, SaveLoadRoundTrip) {
+    EmbeddingCache cache(cache_dir);
+    CachedEmbedding entry{{0.1f, -0.2f, 0.3f, 0.4f}, 2};
+    const auto key = EmbeddingCache::make_key("abc123", "arcface_w600k_r50");
+
+    ASSERT_TRUE(cache.save(key, entry));
+    auto loaded = cache.load(key);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->face_count, 2u);
+    EXPECT_EQ(loaded->embedding, entry.embedding);
+}
+
+TEST_F(EmbeddingCacheTest, MissingAndCorruptEntriesAreMisses) {
+    EmbeddingCache cache(cache_dir);
+    const auto key = EmbeddingCache::make_key("abc123", "arcface_w600k_r50");
+    EXPECT_FALSE(cache.load(key).has_value());
+
+    ASSERT_TRUE(cache.save(key, {{1.0f, 2.0f}, 1}));
+    for (const auto& file : fs::directory_iterator(cache_dir)) {
+        std::ofstream(file.path(), std::ios::binary | std::ios::trunc) << "garbage";
+    }
+    EXPECT_FALSE(cache.load(key).has_value());
+}
+
+TEST_F(EmbeddingCacheTest, EmptyEntryIsNotSaved) {
+    EmbeddingCache cache(cache_dir);
+    EXPECT_FALSE(cache.save("key", {}));
+    EXPECT_FALSE(fs::exists(cache_dir) && !fs::is_empty(cache_dir));
+}
+
+TEST_F(EmbeddingCacheTest, KeyDependsOnContentAndModel) {
+    const auto key = EmbeddingCache::make_key("abc123", "arcface_w600k_r50");
+    EXPECT_EQ(key, EmbeddingCache::make_key("abc123", "arcface_w600k_r50"));
+    EXPECT_NE(key, EmbeddingCache::make_key("abc124", "arcface_w600k_r50"));
+    EXPECT_NE(key, EmbeddingCache::make_key("abc123", "arcface_simswap"));
+}
+
+TEST_F(EmbeddingCacheTest, CombineMatchesAveragingAllFaces) {
+    const std::vector<std::vector<float>> image_a = {{1.0f, 0.0f, 2.0f}, {3.0f, 1.0f, 0.0f}};
+    const std::vector<std::vector<float>> image_b = {{0.0f, 4.0f, 1.0f}};
+
+    std::vector<Face> all_faces;
+    for (const auto& list : {image_a, image_b}) {
+        for (const auto& emb : list) {
+            Face face;
+            face.set_embedding(emb);
+            all_faces.push_back(face);
+        }
+    }
+    const auto expected = helper::compute_average_embedding(all_faces);
+
+    const auto combined =
+        combine({{helper::calc_average_embedding(image_a), 2},
+                 {helper::calc_average_embedding(image_b), 1}});
+
+    ASSERT_EQ(combined.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) { EXPECT_NEAR(combined[i], expected[i], 1e-5f); }
+}
+
+TEST_F(EmbeddingCacheTest, CombineOfNothingIsEmpty) {
+    EXPECT_TRUE(combine({}).empty());
+    EXPECT_TRUE(combine({CachedEmbedding{}}).empty());
+}
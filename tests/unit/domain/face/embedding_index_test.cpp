@@ -0,0 +1,120 @@
+/**
+ * @file embedding_index_test.cpp
+ * @brief Unit tests for the reference embedding similarity index.
+ * @author CodingRookie
+ *
+ * @date 2026-10-18
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+import domain.face;
+import domain.face.embedding_index;
+
+using namespace domain::face;
+using namespace domain::face::embedding_index;
+
+namespace {
+
+std::vector<float> random_embedding(std::mt19937& rng, size_t dim) {
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> v(dim);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+float reference_cosine(const std::vector<float>& a, const std::vector<float>& b) {
+    double dot = 0.0, na = 0.0, nb = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        dot += static_cast<double>(a[i]) * b[i];
+        na += static_cast<double>(a[i]) * a[i];
+        nb += static_cast<double>(b[i]) * b[i];
+    }
+    return static_cast<float>(dot / (std::sqrt(na) * std::sqrt(nb)));
+}
+
+} // namespace
+
+TEST(EmbeddingIndexTest, SimilaritiesMatchScalarCosine) {
+    std::mt19937 rng(42);
+    EmbeddingIndex index;
+    std::vector<std::vector<float>> refs;
+    for (int i = 0; i < 37; ++i) {
+        refs.push_back(random_embedding(rng, 515)); // Odd dim exercises the padded tail
+        ASSERT_TRUE(index.add(refs.back()));
+    }
+    EXPECT_EQ(index.size(), refs.size());
+    EXPECT_EQ(index.dim(), 515u);
+
+    const auto query = random_embedding(rng, 515);
+    const auto sims = index.similarities(query);
+    ASSERT_EQ(sims.size(), refs.size());
+    for (size_t i = 0; i < refs.size(); ++i) {
+        EXPECT_NEAR(sims[i], reference_cosine(refs[i], query), 1e-5f);
+    }
+}
+
+TEST(EmbeddingIndexTest, Int8StaysWithinTolerance) {
+    std::mt19937 rng(7);
+    EmbeddingIndex exact;
+    EmbeddingIndex quantised(Precision::Int8);
+    for (int i = 0; i < 64; ++i) {
+        const auto emb = random_embedding(rng, 512);
+        exact.add(emb);
+        quantised.add(emb);
+    }
+
+    const auto query = random_embedding(rng, 512);
+    const auto a = exact.similarities(query);
+    const auto b = quantised.similarities(query);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) { EXPECT_NEAR(a[i], b[i], 2e-2f); }
+}
+
+TEST(EmbeddingIndexTest, TopKReturnsBestFirst) {
+    EmbeddingIndex index;
+    index.add({1.0f, 0.0f, 0.0f});
+    index.add({0.0f, 1.0f, 0.0f});
+    index.add({0.8f, 0.6f, 0.0f});
+
+    const auto matches = index.top_k({1.0f, 0.1f, 0.0f}, 2);
+    ASSERT_EQ(matches.size(), 2u);
+    EXPECT_EQ(matches[0].index, 0u);
+    EXPECT_EQ(matches[1].index, 2u);
+    EXPECT_GT(matches[0].similarity, matches[1].similarity);
+
+    EXPECT_EQ(index.top_k({1.0f, 0.0f, 0.0f}, 10).size(), 3u);
+
+    const auto best = index.best_match({0.0f, 2.0f, 0.0f});
+    ASSERT_TRUE(best.has_value());
+    EXPECT_EQ(best->index, 1u);
+    EXPECT_NEAR(best->similarity, 1.0f, 1e-6f);
+}
+
+TEST(EmbeddingIndexTest, RejectsMismatchedAndEmptyInput) {
+    EmbeddingIndex index;
+    EXPECT_FALSE(index.add({}));
+    EXPECT_FALSE(index.add({0.0f, 0.0f}));
+    EXPECT_TRUE(index.add({1.0f, 0.0f}));
+    EXPECT_FALSE(index.add({1.0f, 0.0f, 0.0f}));
+    EXPECT_EQ(index.size(), 1u);
+
+    EXPECT_TRUE(index.similarities({1.0f, 0.0f, 0.0f}).empty());
+    EXPECT_FALSE(index.best_match({}).has_value());
+
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_TRUE(index.add({1.0f, 0.0f, 0.0f}));
+}
+
+TEST(EmbeddingIndexTest, FromFacesSkipsFacesWithoutEmbedding) {
+    Face with;
+    with.set_normed_embedding({0.0f, 1.0f});
+    Face without;
+
+    const auto index = EmbeddingIndex::from_faces({without, with});
+    EXPECT_EQ(index.size(), 1u);
+}
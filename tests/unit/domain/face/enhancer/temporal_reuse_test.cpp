@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+import domain.face.enhancer;
+
+using namespace domain::face::enhancer;
+using domain::face::types::Landmarks;
+
+namespace {
+
+class TemporalReuseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        crop = cv::Mat(256, 256, CV_8UC3);
+        cv::randu(crop, cv::Scalar::all(0), cv::Scalar::all(256));
+        landmarks = {{100, 110}, {156, 110}, {128, 140}, {105, 170}, {150, 170}};
+    }
+
+    cv::Mat run(TemporalCropCache& cache, const cv::Mat& input, const Landmarks& points,
+                std::int64_t frame_index) {
+        return cache.get_or_enhance(input, points, frame_index, [this](const cv::Mat& c) {
+            ++model_calls;
+            return c.clone();
+        });
+    }
+
+    cv::Mat crop;
+    Landmarks landmarks;
+    int model_calls = 0;
+};
+
+} // namespace
+
+TEST_F(TemporalReuseTest, StaticFaceReusesEnhancedCrop) {
+    TemporalCropCache cache;
+    const cv::Mat first = run(cache, crop, landmarks, 0);
+
+    // Sub-threshold noise and a sub-pixel landmark jitter: same face
+    cv::Mat noisy = crop.clone();
+    noisy.at<cv::Vec3b>(10, 10) = cv::Vec3b(0, 0, 0);
+    Landmarks jittered = landmarks;
+    for (auto& point : jittered) point.x += 0.5F;
+
+    const cv::Mat second = run(cache, noisy, jittered, 1);
+    EXPECT_EQ(model_calls, 1);
+    EXPECT_EQ(second.data, first.data);
+
+    const auto stats = cache.stats();
+    EXPECT_EQ(stats.reused, 1U);
+    EXPECT_EQ(stats.enhanced, 1U);
+    EXPECT_DOUBLE_EQ(stats.reuse_rate(), 0.5);
+}
+
+TEST_F(TemporalReuseTest, ChangedFaceIsEnhancedAgain) {
+    TemporalCropCache cache;
+    (void)run(cache, crop, landmarks, 0);
+
+    cv::Mat changed = crop.clone();
+    cv::rectangle(changed, cv::Rect(64, 64, 128, 128), cv::Scalar(255, 255, 255), cv::FILLED);
+    (void)run(cache, changed, landmarks, 1);
+
+    EXPECT_EQ(model_calls, 2);
+    EXPECT_EQ(cache.stats().reused, 0U);
+}
+
+TEST_F(TemporalReuseTest, RefreshIntervalForcesInference) {
+    TemporalCropCache cache({.max_difference = 2.0, .refresh_interval = 3});
+    for (std::int64_t frame = 0; frame < 7; ++frame) { (void)run(cache, crop, landmarks, frame); }
+
+    // Enhanced on frames 0, 3 and 6
+    EXPECT_EQ(model_calls, 3);
+    EXPECT_EQ(cache.stats().reused, 4U);
+}
+
+TEST_F(TemporalReuseTest, DistinctFacesKeepSeparateTracks) {
+    TemporalCropCache cache;
+    Landmarks other = landmarks;
+    for (auto& point : other) point.x += 300.0F;
+    cv::Mat other_crop;
+    cv::flip(crop, other_crop, 1);
+
+    const cv::Mat a0 = run(cache, crop, landmarks, 0);
+    const cv::Mat b0 = run(cache, other_crop, other, 0);
+    const cv::Mat a1 = run(cache, crop, landmarks, 1);
+    const cv::Mat b1 = run(cache, other_crop, other, 1);
+
+    EXPECT_EQ(model_calls, 2);
+    EXPECT_EQ(a1.data, a0.data);
+    EXPECT_EQ(b1.data, b0.data);
+}
@@ -1,11 +1,13 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <cstdint>
 #include <opencv2/core.hpp>
 #include <vector>
 #include <string>
 #include <memory>
 #include <onnxruntime_cxx_api.h>
 
+import domain.face;
 import domain.face.expression;
 import foundation.ai.inference_session;
 import foundation.ai.inference_session_registry;
@@ -151,3 +153,104 @@ TEST_F(LivePortraitTest, LoadModelAndRestoreExpression) {
     EXPECT_EQ(result.cols, 512);
     EXPECT_EQ(result.rows, 512);
 }
+
+TEST_F(LivePortraitTest, TrackReusesFeaturesUntilRefreshInterval) {
+    InferenceSessionRegistry::get_instance()->preload_session("feature_extractor.onnx", Options(),
+                                                              feature_mock);
+    InferenceSessionRegistry::get_instance()->preload_session("motion_extractor.onnx", Options(),
+                                                              motion_mock);
+    InferenceSessionRegistry::get_instance()->preload_session("generator.onnx", Options(),
+                                                              generator_mock);
+
+    TrackCacheOptions cache_options;
+    cache_options.refresh_interval = 10;
+    auto restorer = create_live_portrait_restorer(cache_options);
+
+    const std::vector<std::vector<int64_t>> input_dims = {{1, 3, 256, 256}};
+    ON_CALL(*feature_mock, get_input_node_dims()).WillByDefault(Return(input_dims));
+    ON_CALL(*feature_mock, is_model_loaded()).WillByDefault(Return(true));
+    ON_CALL(*motion_mock, get_input_node_dims()).WillByDefault(Return(input_dims));
+    ON_CALL(*motion_mock, is_model_loaded()).WillByDefault(Return(true));
+    ON_CALL(*motion_mock, get_output_names())
+        .WillByDefault(Return(std::vector<std::string>{"0", "1", "2", "3", "4", "5", "6"}));
+    ON_CALL(*generator_mock, get_output_node_dims())
+        .WillByDefault(Return(std::vector<std::vector<int64_t>>{{1, 3, 64, 64}}));
+    ON_CALL(*generator_mock, get_input_names())
+        .WillByDefault(Return(std::vector<std::string>{"feature_volume", "source", "target"}));
+    ON_CALL(*generator_mock, is_model_loaded()).WillByDefault(Return(true));
+
+    auto feature_data = std::make_shared<std::vector<float>>(1 * 32 * 16 * 64 * 64, 0.1f);
+    EXPECT_CALL(*feature_mock, run(_))
+        .Times(2)
+        .WillRepeatedly([feature_data](const std::vector<Ort::Value>&) {
+            const std::vector<int64_t> shape = {1, 32, 16, 64, 64};
+            auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            std::vector<Ort::Value> outputs;
+            outputs.push_back(Ort::Value::CreateTensor<float>(memory_info, feature_data->data(),
+                                                              feature_data->size(), shape.data(),
+                                                              shape.size()));
+            return outputs;
+        });
+
+    // Constant pose: yaw 0, scale 1, neutral expression
+    auto motion_data = std::make_shared<std::vector<float>>(4 + 3 + 63 + 63, 0.0f);
+    (*motion_data)[3] = 1.0f;
+    // Frame 0 runs source + target, the other frames only the target (static source crop)
+    EXPECT_CALL(*motion_mock, run(_))
+        .Times(5)
+        .WillRepeatedly([motion_data](const std::vector<Ort::Value>&) {
+            auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            const std::vector<int64_t> scalar_shape = {1};
+            const std::vector<int64_t> vec_shape = {1, 3};
+            const std::vector<int64_t> points_shape = {1, 21, 3};
+            float* data = motion_data->data();
+            std::vector<Ort::Value> outputs;
+            for (int i = 0; i < 4; ++i) {
+                outputs.push_back(Ort::Value::CreateTensor<float>(memory_info, data + i, 1,
+                                                                  scalar_shape.data(), 1));
+            }
+            outputs.push_back(
+                Ort::Value::CreateTensor<float>(memory_info, data + 4, 3, vec_shape.data(), 2));
+            for (float* points : {data + 7, data + 70}) { // Expression, canonical keypoints
+                outputs.push_back(Ort::Value::CreateTensor<float>(memory_info, points, 63,
+                                                                  points_shape.data(), 3));
+            }
+            return outputs;
+        });
+
+    auto generator_data = std::make_shared<std::vector<float>>(3 * 64 * 64, 0.5f);
+    EXPECT_CALL(*generator_mock, run(_))
+        .Times(4)
+        .WillRepeatedly([generator_data](const std::vector<Ort::Value>&) {
+            const std::vector<int64_t> shape = {1, 3, 64, 64};
+            auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            std::vector<Ort::Value> outputs;
+            outputs.push_back(Ort::Value::CreateTensor<float>(memory_info, generator_data->data(),
+                                                              generator_data->size(), shape.data(),
+                                                              shape.size()));
+            return outputs;
+        });
+
+    restorer->load_model("feature_extractor.onnx", "motion_extractor.onnx", "generator.onnx",
+                         Options());
+
+    const cv::Mat source(256, 256, CV_8UC3, cv::Scalar(10, 20, 30));
+    const cv::Mat target(256, 256, CV_8UC3, cv::Scalar(30, 20, 10));
+    domain::face::types::Landmarks landmarks = {
+        {100, 100}, {156, 100}, {128, 130}, {105, 160}, {151, 160}};
+
+    // Frames 0-2 share the keyframe features; frame 12 is past the refresh interval
+    for (const std::int64_t frame_index : {0, 1, 2, 12}) {
+        for (auto& point : landmarks) point.x += 1.0F;
+        const cv::Mat result =
+            restorer->restore_expression(source, target, 0.8f, landmarks, frame_index);
+        EXPECT_EQ(result.size(), cv::Size(64, 64));
+    }
+
+    const auto stats = restorer->cache_stats();
+    EXPECT_EQ(stats.feature_hits, 2U);
+    EXPECT_EQ(stats.feature_misses, 2U);
+    EXPECT_EQ(stats.source_motion_hits, 3U);
+    EXPECT_EQ(stats.source_motion_misses, 1U);
+    EXPECT_DOUBLE_EQ(stats.hit_rate(), 0.5);
+}
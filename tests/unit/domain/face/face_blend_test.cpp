@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+import domain.face.helper;
+
+using namespace domain::face::helper;
+
+namespace {
+
+/**
+ * @brief The float-plane paste-back that the fused kernel replaced, kept as the reference
+ */
+cv::Mat legacy_paste_back(const cv::Mat& temp_vision_frame, const cv::Mat& crop_vision_frame,
+                          const cv::Mat& crop_mask, const cv::Mat& affine_matrix) {
+    cv::Mat inverse_matrix;
+    cv::invertAffineTransform(affine_matrix, inverse_matrix);
+    cv::Mat inverse_mask;
+    const cv::Size temp_size(temp_vision_frame.cols, temp_vision_frame.rows);
+    cv::warpAffine(crop_mask, inverse_mask, inverse_matrix, temp_size);
+    inverse_mask.setTo(0, inverse_mask < 0);
+    inverse_mask.setTo(1, inverse_mask > 1);
+    cv::Mat inverse_vision_frame;
+    cv::warpAffine(crop_vision_frame, inverse_vision_frame, inverse_matrix, temp_size,
+                   cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+
+    std::vector<cv::Mat> inverse_bgrs(3);
+    cv::split(inverse_vision_frame, inverse_bgrs);
+    std::vector<cv::Mat> temp_bgrs(3);
+    cv::split(temp_vision_frame, temp_bgrs);
+    std::vector<cv::Mat> channel_mats(3);
+    for (int c = 0; c < 3; c++) {
+        inverse_bgrs[c].convertTo(inverse_bgrs[c], CV_32FC1);
+        temp_bgrs[c].convertTo(temp_bgrs[c], CV_32FC1);
+        channel_mats[c] = inverse_mask.mul(inverse_bgrs[c]) + temp_bgrs[c].mul(1 - inverse_mask);
+    }
+
+    cv::Mat paste_vision_frame;
+    cv::merge(channel_mats, paste_vision_frame);
+    paste_vision_frame.convertTo(paste_vision_frame, CV_8UC3);
+    return paste_vision_frame;
+}
+
+class FaceBlendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        cv::RNG rng(42);
+        frame = cv::Mat(360, 641, CV_8UC3); // odd width exercises the scalar tail
+        rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+        crop = cv::Mat(128, 128, CV_8UC3);
+        rng.fill(crop, cv::RNG::UNIFORM, 0, 256);
+        // Mask with values outside [0, 1] to cover clamping
+        mask = cv::Mat(128, 128, CV_32FC1);
+        rng.fill(mask, cv::RNG::UNIFORM, -0.2, 1.2);
+        cv::GaussianBlur(mask, mask, cv::Size(9, 9), 0);
+
+        // Rotated, scaled crop placement (frame -> crop)
+        affine = cv::getRotationMatrix2D(cv::Point2f(300, 180), 17.0, 0.8);
+        affine.at<double>(0, 2) -= 240;
+        affine.at<double>(1, 2) -= 120;
+    }
+
+    cv::Mat frame;
+    cv::Mat crop;
+    cv::Mat mask;
+    cv::Mat affine;
+};
+
+} // namespace
+
+TEST_F(FaceBlendTest, PasteBackMatchesLegacyImplementation) {
+    const cv::Mat expected = legacy_paste_back(frame, crop, mask, affine);
+    const cv::Mat actual = paste_back(frame, crop, mask, affine);
+
+    ASSERT_EQ(actual.size(), expected.size());
+    ASSERT_EQ(actual.type(), CV_8UC3);
+    EXPECT_LE(cv::norm(actual, expected, cv::NORM_INF), 1.0);
+    // Off-by-one rounding differences must be rare, not systematic
+    cv::Mat diff;
+    cv::absdiff(actual, expected, diff);
+    EXPECT_LT(cv::countNonZero(diff.reshape(1)), static_cast<int>(diff.total()) / 100);
+}
+
+TEST_F(FaceBlendTest, PasteBackLeavesInputUntouched) {
+    const cv::Mat original = frame.clone();
+    (void)paste_back(frame, crop, mask, affine);
+    EXPECT_EQ(cv::norm(frame, original, cv::NORM_INF), 0.0);
+}
+
+TEST_F(FaceBlendTest, GlobalBlendMatchesAddWeighted) {
+    // Legacy enhancer: full paste-back, then addWeighted with the original frame
+    const cv::Mat pasted = legacy_paste_back(frame, crop, mask, affine);
+    cv::Mat expected;
+    cv::addWeighted(pasted, 0.8, frame, 0.2, 0.0, expected);
+
+    cv::Mat actual = frame.clone();
+    paste_back_into(actual, crop, mask, affine, 0.8F);
+    EXPECT_LE(cv::norm(actual, expected, cv::NORM_INF), 2.0);
+}
+
+TEST_F(FaceBlendTest, BlendFrameU8MaskMatchesFloatMask) {
+    const cv::Mat overlay(frame.size(), CV_8UC3, cv::Scalar(10, 200, 90));
+    cv::Mat mask_u8(frame.size(), CV_8UC1);
+    cv::randu(mask_u8, 0, 256);
+    cv::Mat mask_f;
+    mask_u8.convertTo(mask_f, CV_32FC1, 1.0 / 255.0);
+
+    cv::Mat from_u8 = frame.clone();
+    cv::Mat from_f = frame.clone();
+    blend_frame(from_u8, overlay, mask_u8, 0.5F);
+    blend_frame(from_f, overlay, mask_f, 0.5F);
+    EXPECT_LE(cv::norm(from_u8, from_f, cv::NORM_INF), 1.0);
+}
+
+TEST_F(FaceBlendTest, BlendFrameExtremes) {
+    const cv::Mat overlay(frame.size(), CV_8UC3, cv::Scalar(1, 2, 3));
+    cv::Mat result = frame.clone();
+    blend_frame(result, overlay, cv::Mat::ones(frame.size(), CV_32FC1), 1.0F);
+    EXPECT_EQ(cv::norm(result, overlay, cv::NORM_INF), 0.0);
+
+    result = frame.clone();
+    blend_frame(result, overlay, cv::Mat::ones(frame.size(), CV_32FC1), 0.0F);
+    EXPECT_EQ(cv::norm(result, frame, cv::NORM_INF), 0.0);
+}
+
+TEST_F(FaceBlendTest, BlendFrameRejectsMismatchedInputs) {
+    cv::Mat target = frame.clone();
+    EXPECT_THROW(blend_frame(target, crop, mask, 1.0F), std::invalid_argument);
+    const cv::Mat gray(frame.size(), CV_8UC1, cv::Scalar(0));
+    EXPECT_THROW(blend_frame(target, gray, cv::Mat(frame.size(), CV_32FC1), 1.0F),
+                 std::invalid_argument);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+import domain.face.helper;
+import domain.face;
+import foundation.media.ffmpeg;
+import tests.helpers.foundation.test_utilities;
+
+using namespace domain::face::helper;
+
+namespace {
+
+/**
+ * @brief The multi-pass Reinhard transfer that the table-based kernel replaced
+ */
+cv::Mat legacy_color_match(const cv::Mat& target_crop, const cv::Mat& swapped_crop) {
+    cv::Mat target_lab, swapped_lab;
+    cv::cvtColor(target_crop, target_lab, cv::COLOR_BGR2Lab);
+    cv::cvtColor(swapped_crop, swapped_lab, cv::COLOR_BGR2Lab);
+
+    cv::Scalar mean_target, std_target;
+    cv::meanStdDev(target_lab, mean_target, std_target);
+    cv::Scalar mean_swapped, std_swapped;
+    cv::meanStdDev(swapped_lab, mean_swapped, std_swapped);
+
+    std::vector<cv::Mat> channels;
+    cv::split(swapped_lab, channels);
+    for (int i = 0; i < 3; ++i) {
+        channels[i].convertTo(channels[i], CV_32F);
+        double scale = (std_swapped[i] < 1.0e-5) ? 1.0 : (std_target[i] / std_swapped[i]);
+        channels[i] = (channels[i] - mean_swapped[i]) * scale + mean_target[i];
+        cv::threshold(channels[i], channels[i], 0, 0, cv::THRESH_TOZERO);
+        cv::threshold(channels[i], channels[i], 255, 255, cv::THRESH_TRUNC);
+        channels[i].convertTo(channels[i], CV_8U);
+    }
+    cv::Mat result_lab;
+    cv::merge(channels, result_lab);
+    cv::Mat result_bgr;
+    cv::cvtColor(result_lab, result_bgr, cv::COLOR_Lab2BGR);
+    return result_bgr;
+}
+
+cv::Mat random_crop(int seed, cv::Scalar tint) {
+    cv::RNG rng(seed);
+    cv::Mat crop(128, 128, CV_8UC3);
+    rng.fill(crop, cv::RNG::NORMAL, tint, cv::Scalar(30, 30, 30));
+    cv::GaussianBlur(crop, crop, cv::Size(5, 5), 0);
+    return crop;
+}
+
+} // namespace
+
+TEST(FaceColorTest, StatsMatchMeanStdDev) {
+    const cv::Mat crop = random_crop(1, cv::Scalar(90, 120, 160));
+    const ColorStats stats = compute_color_stats(crop);
+
+    cv::Mat lab;
+    cv::cvtColor(crop, lab, cv::COLOR_BGR2Lab);
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(lab, mean, stddev);
+    for (int c = 0; c < 3; ++c) {
+        EXPECT_NEAR(stats.mean[c], mean[c], 1e-6);
+        EXPECT_NEAR(stats.stddev[c], stddev[c], 1e-6);
+    }
+}
+
+TEST(FaceColorTest, ColorMatchMatchesLegacyImplementation) {
+    const cv::Mat target = random_crop(2, cv::Scalar(80, 110, 170));
+    const cv::Mat swapped = random_crop(3, cv::Scalar(140, 140, 120));
+
+    const cv::Mat expected = legacy_color_match(target, swapped);
+    const cv::Mat actual = apply_color_match(target, swapped);
+    ASSERT_EQ(actual.size(), expected.size());
+    ASSERT_EQ(actual.type(), CV_8UC3);
+
+    // Lab rounding may differ by one step, which Lab -> BGR can spread over a few levels
+    EXPECT_LE(cv::norm(actual, expected, cv::NORM_INF), 3.0);
+    cv::Mat diff;
+    cv::absdiff(actual, expected, diff);
+    EXPECT_LT(cv::mean(diff)[0], 0.1);
+}
+
+TEST(FaceColorTest, CacheReusesStatsForUnchangedTrack) {
+    ColorStatsCache cache;
+    const cv::Mat crop = random_crop(4, cv::Scalar(100, 100, 100));
+    domain::face::types::Landmarks landmarks = {{10, 10}, {30, 10}, {20, 20}, {12, 30}, {28, 30}};
+
+    const ColorStats first = cache.get(crop, landmarks);
+    const ColorStats second = cache.get(crop.clone(), landmarks);
+    EXPECT_EQ(cache.misses(), 1U);
+    EXPECT_EQ(cache.hits(), 1U);
+    EXPECT_EQ(first.mean, second.mean);
+
+    // Same track, changed face content: recomputed
+    const cv::Mat changed = random_crop(5, cv::Scalar(140, 100, 70));
+    const ColorStats third = cache.get(changed, landmarks);
+    EXPECT_EQ(cache.misses(), 2U);
+    EXPECT_EQ(third.mean, compute_color_stats(changed).mean);
+
+    // Identical content at a different position is a different track
+    for (auto& point : landmarks) point.x += 100.0F;
+    (void)cache.get(changed, landmarks);
+    EXPECT_EQ(cache.misses(), 3U);
+}
+
+TEST(FaceColorTest, CacheHitsOnConsecutiveVideoFrames) {
+    const auto video_path = tests::helpers::foundation::get_test_data_path(
+        "standard_face_test_videos/slideshow_scaled.mp4");
+    if (!std::filesystem::exists(video_path)) GTEST_SKIP() << "Test video not found";
+    foundation::media::ffmpeg::VideoReader reader(video_path.string());
+    ASSERT_TRUE(reader.open());
+
+    // The same region of consecutive decoded frames: never bit-identical after compression
+    ColorStatsCache cache;
+    const domain::face::types::Landmarks landmarks = {
+        {100, 100}, {160, 100}, {130, 130}, {105, 160}, {155, 160}};
+    constexpr int kFrames = 30;
+    double max_error = 0.0;
+    for (int i = 0; i < kFrames; ++i) {
+        const cv::Mat frame = reader.read_frame();
+        ASSERT_FALSE(frame.empty());
+        const cv::Mat crop = frame(cv::Rect(70, 70, 128, 128)).clone();
+        const ColorStats cached = cache.get(crop, landmarks);
+        const ColorStats exact = compute_color_stats(crop);
+        for (int c = 0; c < 3; ++c) {
+            max_error = std::max(max_error, std::abs(cached.mean[c] - exact.mean[c]));
+        }
+    }
+    EXPECT_GT(cache.hits(), cache.misses());
+    EXPECT_EQ(cache.hits() + cache.misses(), static_cast<std::uint64_t>(kFrames));
+    // Reused statistics stay within the change threshold of the exact ones
+    EXPECT_LE(max_error, 3.0);
+}
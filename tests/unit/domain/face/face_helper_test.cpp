@@ -254,3 +254,30 @@ TEST_F(FaceHelperTest, RotateBoxBack) {
     EXPECT_FLOAT_EQ(res.width, 20.0f);
     EXPECT_FLOAT_EQ(res.height, 20.0f);
 }
+
+// --- Landmark Track Tests ---
+
+TEST_F(FaceHelperTest, TrackRadiusIsQuarterEyeDistance) {
+    const types::Landmarks landmarks = {{100, 100}, {140, 100}, {120, 120}, {105, 140}, {135, 140}};
+    EXPECT_FLOAT_EQ(track_radius(landmarks), 10.0f);
+    EXPECT_FLOAT_EQ(track_radius({{0, 0}, {8, 0}}), 4.0f); // Small faces keep a 4 px floor
+}
+
+TEST_F(FaceHelperTest, MatchTrackPicksClosestWithinRadius) {
+    struct Track {
+        types::Landmarks landmarks;
+    };
+    const types::Landmarks face = {{100, 100}, {140, 100}};
+    std::vector<Track> tracks = {{{{106, 100}, {146, 100}}},
+                                 {{{102, 100}, {142, 100}}},
+                                 {{{300, 100}, {340, 100}}}};
+
+    EXPECT_FLOAT_EQ(landmark_distance(tracks[0].landmarks, face), 6.0f);
+    auto match = match_track(tracks, face, track_radius(face), &Track::landmarks);
+    ASSERT_NE(match, tracks.end());
+    EXPECT_EQ(match - tracks.begin(), 1);
+
+    // A face that moved further than the radius starts a new track
+    EXPECT_EQ(match_track(tracks, {{200, 100}, {240, 100}}, track_radius(face), &Track::landmarks),
+              tracks.end());
+}
@@ -2,9 +2,11 @@
 #include <vector>
 #include <cmath>
 #include <cstdint>
+#include <memory>
 
 import domain.face;
 import domain.face.selector;
+import domain.face.embedding_index;
 import domain.common;
 
 using namespace domain::face;
@@ -251,6 +253,26 @@ TEST_F(FaceSelectorTest, FilterBySimilarityNoReference) {
     EXPECT_EQ(result.size(), 1);
 }
 
+TEST_F(FaceSelectorTest, FilterBySimilarityReferenceIndex) {
+    auto gallery = std::make_shared<domain::face::embedding_index::EmbeddingIndex>();
+    gallery->add({1.0f, 0.0f, 0.0f});
+    gallery->add({0.0f, 1.0f, 0.0f});
+
+    faces = {create_face_with_embedding({0.0f, 0.0f, 1.0f}),
+             create_face_with_embedding({0.0f, 0.9f, 0.1f}), create_face_with_embedding({})};
+
+    Options opts;
+    opts.mode = SelectorMode::Reference;
+    opts.reference_face = create_face_with_embedding({0.0f, 0.0f, 1.0f}); // Ignored
+    opts.reference_index = gallery;
+    opts.similarity_threshold = 0.9f;
+
+    auto result = select_faces(faces, opts);
+
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0].normed_embedding(), std::vector<float>({0.0f, 0.9f, 0.1f}));
+}
+
 // --- Mode Tests ---
 
 TEST_F(FaceSelectorTest, ModeOneReturnsFirstAfterSort) {
@@ -21,7 +21,7 @@ using namespace domain::face::store;
 
 class FaceStoreTest : public ::testing::Test {
 protected:
-    FaceStore store; // Default options: FNV1a, LRU enabled
+    FaceStore store; // Default options: XXH3, LRU enabled
     cv::Mat frame1;
     cv::Mat frame2;
     std::vector<Face> faces1;
@@ -55,6 +55,76 @@ TEST_F(FaceStoreTest, FrameHashConsistency) {
     // Test SHA1 Backwards Compatibility
     std::string sha1_hash = FaceStore::calculate_hash(frame1, HashStrategy::SHA1);
     EXPECT_NE(hash1, sha1_hash);
+
+    // XXH3 and Sampled
+    for (auto strategy : {HashStrategy::XXH3, HashStrategy::Sampled}) {
+        std::string h1 = FaceStore::calculate_hash(frame1, strategy);
+        EXPECT_FALSE(h1.empty());
+        EXPECT_EQ(h1, FaceStore::calculate_hash(frame1, strategy));
+        EXPECT_NE(h1, FaceStore::calculate_hash(frame2, strategy));
+    }
+}
+
+TEST_F(FaceStoreTest, HashIncludesFrameGeometry) {
+    cv::Mat wide = cv::Mat::zeros(50, 200, CV_8UC3);
+    EXPECT_NE(FaceStore::calculate_hash(frame1, HashStrategy::XXH3),
+              FaceStore::calculate_hash(wide, HashStrategy::XXH3));
+    EXPECT_NE(FaceStore::calculate_hash(frame1, HashStrategy::Sampled),
+              FaceStore::calculate_hash(wide, HashStrategy::Sampled));
+}
+
+TEST_F(FaceStoreTest, HashOfRoiMatchesClone) {
+    cv::Mat big(200, 200, CV_8UC3);
+    cv::randu(big, cv::Scalar::all(0), cv::Scalar::all(255));
+    cv::Mat roi = big(cv::Rect(10, 20, 100, 100));
+    ASSERT_FALSE(roi.isContinuous());
+
+    for (auto strategy : {HashStrategy::FNV1a, HashStrategy::SHA1, HashStrategy::XXH3,
+                          HashStrategy::Sampled}) {
+        EXPECT_EQ(FaceStore::calculate_hash(roi, strategy),
+                  FaceStore::calculate_hash(roi.clone(), strategy));
+    }
+}
+
+TEST_F(FaceStoreTest, FrameKeyReuse) {
+    auto key = store.make_key(frame1);
+    ASSERT_FALSE(key.empty());
+    EXPECT_EQ(key.value, store.make_key(frame1).value);
+
+    store.insert_faces(key, faces1);
+    EXPECT_TRUE(store.is_contains(key));
+    EXPECT_TRUE(store.is_contains(frame1)); // Same key whether precomputed or not
+    EXPECT_EQ(store.get_faces(key).size(), 1);
+
+    store.remove_faces(key);
+    EXPECT_FALSE(store.is_contains(frame1));
+}
+
+TEST_F(FaceStoreTest, SampledHashRejectsCollisionsOnUnsampledRows) {
+    FaceStoreOptions opts;
+    opts.hash_strategy = HashStrategy::Sampled;
+    opts.sampled_rows = 10;
+    FaceStore sampled_store(opts);
+
+    // 100 rows / 10 samples -> rows 0,10,20,... are hashed, rows 5,15,25,... verify.
+    cv::Mat a = cv::Mat::zeros(100, 100, CV_8UC3);
+    cv::Mat b = a.clone();
+    b.row(5).setTo(cv::Scalar(255, 255, 255));
+
+    auto key_a = sampled_store.make_key(a);
+    auto key_b = sampled_store.make_key(b);
+    EXPECT_EQ(key_a.value, key_b.value);
+    EXPECT_NE(key_a.verifier, key_b.verifier);
+
+    sampled_store.insert_faces(key_a, faces1);
+    EXPECT_TRUE(sampled_store.is_contains(key_a));
+    EXPECT_FALSE(sampled_store.is_contains(key_b));
+    EXPECT_TRUE(sampled_store.get_faces(key_b).empty());
+
+    // A change on a sampled row changes the key itself
+    cv::Mat c = a.clone();
+    c.row(10).setTo(cv::Scalar(1, 1, 1));
+    EXPECT_NE(key_a.value, sampled_store.make_key(c).value);
 }
 
 TEST_F(FaceStoreTest, InsertAndGetByFrame) {
@@ -202,3 +272,57 @@ TEST_F(FaceStoreTest, ConcurrentReadOnly) {
 
     EXPECT_EQ(total_reads.load(), num_threads * reads_per_thread * 2);
 }
+
+TEST_F(FaceStoreTest, SnapshotsShareStoredFaces) {
+    store.insert_faces("group", faces1);
+
+    auto snap1 = store.get_snapshot("group");
+    auto snap2 = store.get_snapshot("group");
+    ASSERT_TRUE(snap1);
+    EXPECT_EQ(snap1.get(), snap2.get()); // Hits share one vector instead of copying
+    EXPECT_FALSE(store.get_snapshot("missing"));
+
+    // Replacing the entry publishes a new vector; existing snapshots stay valid
+    store.insert_faces("group", faces2);
+    auto snap3 = store.get_snapshot("group");
+    ASSERT_TRUE(snap3);
+    EXPECT_NE(snap1.get(), snap3.get());
+    EXPECT_FLOAT_EQ((*snap1)[0].detector_score(), 0.9f);
+    EXPECT_FLOAT_EQ((*snap3)[0].detector_score(), 0.8f);
+}
+
+TEST_F(FaceStoreTest, StatsCountHitsMissesAndEvictions) {
+    FaceStoreOptions opts;
+    opts.max_capacity = 2;
+    FaceStore small_store(opts);
+
+    small_store.insert_faces("A", faces1);
+    small_store.insert_faces("B", faces1);
+    [[maybe_unused]] auto hit = small_store.get_snapshot("A");
+    [[maybe_unused]] auto miss = small_store.get_snapshot("Z");
+    small_store.insert_faces("C", faces1);
+
+    auto stats = small_store.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.insertions, 3);
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_EQ(stats.size, 2);
+    EXPECT_DOUBLE_EQ(stats.hit_rate(), 0.5);
+}
+
+TEST_F(FaceStoreTest, ShardedCapacityIsBounded) {
+    FaceStoreOptions opts;
+    opts.max_capacity = 256;
+    opts.shard_count = 4;
+    FaceStore sharded_store(opts);
+
+    for (int i = 0; i < 1000; ++i) { sharded_store.insert_faces(std::to_string(i), faces1); }
+
+    auto stats = sharded_store.stats();
+    EXPECT_LE(stats.size, opts.max_capacity);
+    EXPECT_EQ(stats.size + stats.evictions, 1000);
+
+    // Recently inserted keys survive
+    EXPECT_TRUE(sharded_store.is_contains("999"));
+}
@@ -150,3 +150,78 @@ TEST_F(MaskCompositorTest, ComposeEmptyMaskListReturnsOnes) {
     cv::minMaxLoc(result, &minVal, &maxVal);
     EXPECT_NEAR(minVal, 1.0, 1e-6);
 }
+
+TEST_F(MaskCompositorTest, BoxOnlyResultIsMemoised) {
+    input.options.mask_types = {MaskType::Box};
+    input.options.box_mask_blur = 0.3f;
+    input.options.box_mask_padding = {5, 5, 5, 5};
+
+    const cv::Mat first = MaskCompositor::compose(input);
+    const cv::Mat second = MaskCompositor::compose(input);
+    EXPECT_EQ(first.data, second.data);
+
+    input.options.box_mask_padding = {5, 5, 5, 6};
+    const cv::Mat third = MaskCompositor::compose(input);
+    EXPECT_NE(first.data, third.data);
+
+    MaskCompositor::clear_cache();
+    input.options.box_mask_padding = {5, 5, 5, 5};
+    const cv::Mat rebuilt = MaskCompositor::compose(input);
+    EXPECT_NE(first.data, rebuilt.data);
+    EXPECT_EQ(cv::norm(first, rebuilt, cv::NORM_INF), 0.0);
+}
+
+TEST_F(MaskCompositorTest, FusedCompositionMatchesReference) {
+    input.options.mask_types = {MaskType::Box, MaskType::Occlusion, MaskType::Region};
+    input.options.box_mask_blur = 0.0f; // Box = ones with a 1px zero border
+    input.options.box_mask_padding = {0, 0, 0, 0};
+
+    cv::Mat occlusion = cv::Mat::zeros(100, 100, CV_8UC1);
+    cv::circle(occlusion, cv::Point(40, 60), 15, cv::Scalar(255), -1);
+    cv::Mat region(100, 100, CV_8UC1);
+    cv::randu(region, 0, 256);
+
+    // Both models run exactly once per composition
+    EXPECT_CALL(mock_occluder, create_occlusion_mask(_)).WillOnce(Return(occlusion));
+    EXPECT_CALL(mock_region_masker, create_region_mask(_, _)).WillOnce(Return(region));
+    const cv::Mat result = MaskCompositor::compose(input);
+
+    // Reference: separate convert, min and blur steps
+    cv::Mat box = cv::Mat::zeros(100, 100, CV_32FC1);
+    box(cv::Rect(1, 1, 98, 98)) = 1.0f;
+    cv::Mat inverted;
+    cv::subtract(cv::Scalar(255), occlusion, inverted);
+    cv::Mat occ_f;
+    cv::Mat region_f;
+    inverted.convertTo(occ_f, CV_32FC1, 1.0 / 255.0);
+    region.convertTo(region_f, CV_32FC1, 1.0 / 255.0);
+    cv::Mat expected;
+    cv::min(box, occ_f, expected);
+    cv::min(expected, region_f, expected);
+    cv::GaussianBlur(expected, expected, cv::Size(3, 3), 0);
+
+    EXPECT_EQ(result.type(), CV_32FC1);
+    EXPECT_LT(cv::norm(result, expected, cv::NORM_INF), 1e-5);
+
+    // Precomputed masks give the same result
+    auto precomputed = input;
+    precomputed.occlusion_mask = inverted;
+    precomputed.region_mask = region;
+    EXPECT_LT(cv::norm(MaskCompositor::compose(precomputed), expected, cv::NORM_INF), 1e-5);
+}
+
+TEST_F(MaskCompositorTest, PrecomputedMasksSkipModels) {
+    input.options.mask_types = {MaskType::Occlusion, MaskType::Region};
+    input.occlusion_mask = cv::Mat(100, 100, CV_8UC1, cv::Scalar(255));
+    input.region_mask = cv::Mat(100, 100, CV_32FC1, cv::Scalar(0.5f));
+
+    EXPECT_CALL(mock_occluder, create_occlusion_mask(_)).Times(0);
+    EXPECT_CALL(mock_region_masker, create_region_mask(_, _)).Times(0);
+
+    const cv::Mat result = MaskCompositor::compose(input);
+    double min_val = 0.0;
+    double max_val = 0.0;
+    cv::minMaxLoc(result, &min_val, &max_val);
+    EXPECT_NEAR(min_val, 0.5, 1e-5);
+    EXPECT_NEAR(max_val, 0.5, 1e-5);
+}
@@ -105,3 +105,62 @@ TEST_F(RegionMaskerTest, LoadModelAndCreateMask) {
     EXPECT_EQ(mask.at<uint8_t>(256, 256), 255);
     EXPECT_EQ(mask.at<uint8_t>(0, 511), 0); // Flipped TL
 }
+
+TEST_F(RegionMaskerTest, LabelsMatchScalarArgmaxOnUnalignedSize) {
+    std::string model_path = "face_parser_unaligned.onnx";
+    InferenceSessionRegistry::get_instance()->preload_session(model_path, Options(), mock_session);
+    auto masker = create_region_masker(model_path, Options());
+
+    // Odd width exercises the SIMD tail; values are quantised so ties occur
+    const int num_classes = 19;
+    const int h = 37;
+    const int w = 53;
+    std::vector<std::vector<int64_t>> input_dims = {{1, 3, h, w}};
+    EXPECT_CALL(*mock_session, get_input_node_dims()).WillRepeatedly(Return(input_dims));
+    EXPECT_CALL(*mock_session, is_model_loaded()).WillRepeatedly(Return(true));
+
+    std::vector<int64_t> output_shape = {1, num_classes, h, w};
+    std::vector<float> output_data(static_cast<size_t>(num_classes) * h * w);
+    cv::RNG rng(7);
+    for (auto& v : output_data) v = static_cast<float>(rng.uniform(0, 8));
+
+    EXPECT_CALL(*mock_session, run(_)).WillRepeatedly([&](const std::vector<Ort::Value>&) {
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::vector<Ort::Value> outputs;
+        outputs.push_back(Ort::Value::CreateTensor<float>(
+            memory_info, output_data.data(), output_data.size(), output_shape.data(),
+            output_shape.size()));
+        return outputs;
+    });
+
+    const cv::Mat frame = cv::Mat::zeros(h, w, CV_8UC3);
+    const cv::Mat labels = masker->create_region_labels(frame);
+    ASSERT_EQ(labels.size(), cv::Size(w, h));
+    ASSERT_EQ(labels.type(), CV_8UC1);
+
+    const size_t pixels = static_cast<size_t>(h) * w;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const size_t i = static_cast<size_t>(y) * w + x;
+            int expected = 0;
+            for (int c = 1; c < num_classes; ++c) {
+                if (output_data[c * pixels + i] > output_data[expected * pixels + i]) {
+                    expected = c;
+                }
+            }
+            ASSERT_EQ(labels.at<uint8_t>(y, w - 1 - x), expected) << "at " << x << "," << y;
+        }
+    }
+
+    // Region selection from the shared labels matches a full create_region_mask()
+    const std::unordered_set<FaceRegion> regions = {FaceRegion::Skin, FaceRegion::Hair};
+    const cv::Mat selected = masker->select_regions(labels, regions);
+    const cv::Mat direct = masker->create_region_mask(frame, regions);
+    EXPECT_EQ(cv::countNonZero(selected != direct), 0);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const auto label = labels.at<uint8_t>(y, x);
+            EXPECT_EQ(selected.at<uint8_t>(y, x), (label == 1 || label == 17) ? 255 : 0);
+        }
+    }
+}
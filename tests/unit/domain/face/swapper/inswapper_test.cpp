@@ -105,3 +105,42 @@ TEST_F(InSwapperTest, SwapFaceThrowsIfNotLoaded) {
 
     EXPECT_THROW(swapper.swap_face(target_img, source_embedding), std::runtime_error);
 }
+
+TEST_F(InSwapperTest, SwapFaceBatchRunsDynamicBatchOnce) {
+    InSwapper swapper;
+
+    EXPECT_CALL(*mock_session, is_model_loaded()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_session, get_loaded_model_path()).WillRepeatedly(Return(model_path));
+    std::vector<std::vector<int64_t>> input_dims = {{-1, 3, 128, 128}, {-1, 512}};
+    EXPECT_CALL(*mock_session, get_input_node_dims()).WillRepeatedly(Return(input_dims));
+    EXPECT_CALL(*mock_session, get_input_names())
+        .WillRepeatedly(Return(std::vector<std::string>{"source", "target"}));
+
+    // Face n of the batch comes back with value n / 4
+    std::vector<int64_t> output_shape = {3, 3, 128, 128};
+    std::vector<float> output_data(3 * 3 * 128 * 128);
+    for (size_t n = 0; n < 3; ++n) {
+        std::fill_n(output_data.begin() + n * 3 * 128 * 128, 3 * 128 * 128, n / 4.0f);
+    }
+    EXPECT_CALL(*mock_session, run(_)).WillOnce([&](const std::vector<Ort::Value>& inputs) {
+        for (const auto& input : inputs) {
+            EXPECT_EQ(input.GetTensorTypeAndShapeInfo().GetShape()[0], 3);
+        }
+        auto mem = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::vector<Ort::Value> outs;
+        outs.push_back(Ort::Value::CreateTensor<float>(mem, output_data.data(), output_data.size(),
+                                                       output_shape.data(), output_shape.size()));
+        return outs;
+    });
+
+    swapper.load_model(model_path, Options());
+
+    const std::vector<cv::Mat> crops(3, cv::Mat::zeros(128, 128, CV_8UC3));
+    const auto results = swapper.swap_face_batch(crops, std::vector<float>(512, 0.1f));
+
+    ASSERT_EQ(results.size(), 3U);
+    for (size_t n = 0; n < 3; ++n) {
+        EXPECT_EQ(results[n].size(), cv::Size(128, 128));
+        EXPECT_EQ(results[n].at<cv::Vec3b>(64, 64)[0], cv::saturate_cast<uchar>(n / 4.0 * 255));
+    }
+}
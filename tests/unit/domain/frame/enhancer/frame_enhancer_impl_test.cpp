@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <deque>
 #include <opencv2/opencv.hpp>
 #include <onnxruntime_cxx_api.h>
 
@@ -148,3 +149,96 @@ TEST_F(FrameEnhancerImplTest, EnhanceFrameWithTiling) {
     EXPECT_EQ(result.rows, 128);
     EXPECT_EQ(result.cols, 128);
 }
+
+TEST_F(FrameEnhancerImplTest, BatchedTilesReassembleFrameExactly) {
+    // Dynamic batch dimension: tiles are grouped into batches of up to 4
+    EXPECT_CALL(*mock_session, get_input_node_dims())
+        .WillRepeatedly(Return(std::vector<std::vector<int64_t>>{{-1, 3, -1, -1}}));
+
+    // Tile size 64, Padding 8, Overlap 4
+    std::vector<int> tile_size = {64, 8, 4};
+    int model_scale = 2;
+    FrameEnhancerImpl enhancer(model_path, Options(), tile_size, model_scale);
+    EXPECT_EQ(enhancer.schedule().batch_size, 4);
+
+    cv::Mat input_frame(97, 150, CV_8UC3);
+    cv::randu(input_frame, cv::Scalar::all(0), cv::Scalar::all(256));
+    FrameEnhancerInput input{input_frame, 100};
+
+    // Nearest-neighbour 2x "model": any misplaced tile or seam shows up in the result
+    std::vector<std::vector<float>> buffers;
+    std::vector<std::vector<int64_t>> shapes;
+    buffers.reserve(16);
+    shapes.reserve(16);
+    EXPECT_CALL(*mock_session, run(_))
+        .Times(3) // 3 x 3 tiles in batches of 4
+        .WillRepeatedly([&](const std::vector<Ort::Value>& inputs) {
+            const auto shape = inputs[0].GetTensorTypeAndShapeInfo().GetShape();
+            const int64_t n = shape[0];
+            const int h = static_cast<int>(shape[2]);
+            const int w = static_cast<int>(shape[3]);
+            const float* src = inputs[0].GetTensorData<float>();
+
+            auto& out = buffers.emplace_back(static_cast<size_t>(n) * 3 * 4 * h * w);
+            for (int64_t p = 0; p < n * 3; ++p) {
+                for (int y = 0; y < 2 * h; ++y) {
+                    for (int x = 0; x < 2 * w; ++x) {
+                        out[(p * 2 * h + y) * 2 * w + x] = src[(p * h + y / 2) * w + x / 2];
+                    }
+                }
+            }
+            auto& out_shape = shapes.emplace_back(std::vector<int64_t>{n, 3, 2 * h, 2 * w});
+            auto mem = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            std::vector<Ort::Value> outs;
+            outs.push_back(Ort::Value::CreateTensor<float>(mem, out.data(), out.size(),
+                                                           out_shape.data(), out_shape.size()));
+            return outs;
+        });
+
+    cv::Mat result = enhancer.enhance_frame(input);
+
+    cv::Mat expected;
+    cv::resize(input_frame, expected, cv::Size(), 2.0, 2.0, cv::INTER_NEAREST);
+    ASSERT_EQ(result.size(), expected.size());
+    EXPECT_EQ(cv::norm(result, expected, cv::NORM_INF), 0.0);
+}
+
+TEST_F(FrameEnhancerImplTest, CalibratedScheduleIsReusedByNextEnhancer) {
+    EXPECT_CALL(*mock_session, get_input_node_dims())
+        .WillRepeatedly(Return(std::vector<std::vector<int64_t>>{{-1, 3, -1, -1}}));
+
+    // Identity 1x "model" for any batch and tile size
+    std::deque<std::vector<float>> buffers;
+    std::deque<std::vector<int64_t>> shapes;
+    int runs = 0;
+    EXPECT_CALL(*mock_session, run(_)).WillRepeatedly([&](const std::vector<Ort::Value>& inputs) {
+        ++runs;
+        const auto shape = inputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        const float* src = inputs[0].GetTensorData<float>();
+        auto& out = buffers.emplace_back(src, src + shape[0] * shape[1] * shape[2] * shape[3]);
+        auto& out_shape = shapes.emplace_back(shape);
+        auto mem = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::vector<Ort::Value> outs;
+        outs.push_back(Ort::Value::CreateTensor<float>(mem, out.data(), out.size(),
+                                                       out_shape.data(), out_shape.size()));
+        return outs;
+    });
+
+    const std::vector<int> tile_size = {64, 8, 4};
+    cv::Mat input_frame(97, 150, CV_8UC3, cv::Scalar(10, 20, 30));
+    FrameEnhancerInput input{input_frame, 100};
+
+    FrameEnhancerImpl first(model_path, Options(), tile_size, 1, true);
+    (void)first.enhance_frame(input);
+    const int first_runs = runs;
+
+    runs = 0;
+    FrameEnhancerImpl second(model_path, Options(), tile_size, 1, true);
+    cv::Mat result = second.enhance_frame(input);
+
+    // No calibration runs: only the inference calls of the frame itself
+    EXPECT_EQ(second.schedule().tile_size, first.schedule().tile_size);
+    EXPECT_EQ(second.schedule().batch_size, first.schedule().batch_size);
+    EXPECT_LT(runs, first_runs);
+    EXPECT_EQ(cv::norm(result, input_frame, cv::NORM_INF), 0.0);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <opencv2/core.hpp>
+#include <unordered_set>
+#include <vector>
+
+import domain.pipeline;
+import domain.face;
+import domain.face.helper;
+import domain.face.masker;
+
+using namespace domain::pipeline;
+using namespace domain::face::types;
+using domain::face::helper::WarpTemplateType;
+using namespace testing;
+
+namespace {
+
+class MockFaceOccluder : public domain::face::masker::IFaceOccluder {
+public:
+    MOCK_METHOD(cv::Mat, create_occlusion_mask, (const cv::Mat&), (override));
+};
+
+class MockBatchOccluder : public domain::face::masker::IFaceOccluder {
+public:
+    MOCK_METHOD(cv::Mat, create_occlusion_mask, (const cv::Mat&), (override));
+    MOCK_METHOD(std::vector<cv::Mat>, create_occlusion_mask_batch, (const std::vector<cv::Mat>&),
+                (override));
+};
+
+class MockFaceRegionMasker : public domain::face::masker::IFaceRegionMasker {
+public:
+    MOCK_METHOD(cv::Mat, create_region_mask,
+                (const cv::Mat&, const std::unordered_set<FaceRegion>&), (override));
+};
+
+class FaceWorkspaceTest : public Test {
+protected:
+    void SetUp() override {
+        image = cv::Mat(480, 640, CV_8UC3, cv::Scalar(40, 80, 120));
+        landmarks = {{300, 220}, {360, 220}, {330, 260}, {305, 290}, {355, 290}};
+        options.mask_types = {MaskType::Box, MaskType::Occlusion, MaskType::Region};
+
+        ON_CALL(occluder, create_occlusion_mask(_)).WillByDefault([](const cv::Mat& crop) {
+            return cv::Mat(crop.size(), CV_8UC1, cv::Scalar(0));
+        });
+        ON_CALL(region_masker, create_region_mask(_, _))
+            .WillByDefault([](const cv::Mat& crop, const std::unordered_set<FaceRegion>&) {
+                return cv::Mat(crop.size(), CV_8UC1, cv::Scalar(255));
+            });
+    }
+
+    cv::Mat image;
+    Landmarks landmarks;
+    MaskOptions options;
+    NiceMock<MockFaceOccluder> occluder;
+    NiceMock<MockFaceRegionMasker> region_masker;
+    FaceWorkspace workspace;
+};
+
+} // namespace
+
+TEST_F(FaceWorkspaceTest, CropIsCachedUntilInvalidated) {
+    const auto first =
+        workspace.crop(image, landmarks, WarpTemplateType::Arcface128V2, cv::Size(128, 128));
+    const auto second =
+        workspace.crop(image, landmarks, WarpTemplateType::Arcface128V2, cv::Size(128, 128));
+
+    EXPECT_EQ(first.frame.size(), cv::Size(128, 128));
+    EXPECT_EQ(first.frame.data, second.frame.data);
+    EXPECT_EQ(workspace.stats().warps, 1U);
+
+    workspace.invalidate_crops();
+    const auto third =
+        workspace.crop(image, landmarks, WarpTemplateType::Arcface128V2, cv::Size(128, 128));
+    EXPECT_EQ(workspace.stats().warps, 2U);
+    EXPECT_EQ(cv::norm(first.affine, third.affine, cv::NORM_INF), 0.0);
+}
+
+TEST_F(FaceWorkspaceTest, MaskModelsRunOncePerFaceAcrossSteps) {
+    EXPECT_CALL(occluder, create_occlusion_mask(_)).Times(1);
+    EXPECT_CALL(region_masker, create_region_mask(_, _)).Times(1);
+
+    // Swapper-like step, then paste-back, then enhancer-like step on a different template/size
+    const cv::Mat swap_mask = workspace.compose_mask(image, landmarks,
+                                                     WarpTemplateType::Arcface128V2,
+                                                     cv::Size(128, 128), options, &occluder,
+                                                     &region_masker);
+    workspace.invalidate_crops();
+    const cv::Mat enhance_mask =
+        workspace.compose_mask(image, landmarks, WarpTemplateType::Ffhq512, cv::Size(512, 512),
+                               options, &occluder, &region_masker);
+
+    EXPECT_EQ(swap_mask.size(), cv::Size(128, 128));
+    EXPECT_EQ(swap_mask.type(), CV_32FC1);
+    EXPECT_EQ(enhance_mask.size(), cv::Size(512, 512));
+    EXPECT_EQ(workspace.stats().occlusion_inferences, 1U);
+    EXPECT_EQ(workspace.stats().region_inferences, 1U);
+}
+
+TEST_F(FaceWorkspaceTest, ComposedMaskIsReusedForSameOptions) {
+    const cv::Mat first =
+        workspace.compose_mask(image, landmarks, WarpTemplateType::Ffhq512, cv::Size(512, 512),
+                               options, &occluder, &region_masker);
+    const cv::Mat second =
+        workspace.compose_mask(image, landmarks, WarpTemplateType::Ffhq512, cv::Size(512, 512),
+                               options, &occluder, &region_masker);
+    EXPECT_EQ(first.data, second.data);
+
+    options.box_mask_blur = 0.0F;
+    const cv::Mat third =
+        workspace.compose_mask(image, landmarks, WarpTemplateType::Ffhq512, cv::Size(512, 512),
+                               options, &occluder, &region_masker);
+    EXPECT_NE(first.data, third.data);
+    EXPECT_EQ(workspace.stats().occlusion_inferences, 1U);
+}
+
+TEST_F(FaceWorkspaceTest, DistinctFacesAndClearRunModelsAgain) {
+    EXPECT_CALL(occluder, create_occlusion_mask(_)).Times(3);
+
+    options.mask_types = {MaskType::Occlusion};
+    Landmarks other = landmarks;
+    for (auto& point : other) point.x += 150.0F;
+
+    (void)workspace.compose_mask(image, landmarks, WarpTemplateType::Ffhq512, cv::Size(512, 512),
+                                 options, &occluder, nullptr);
+    (void)workspace.compose_mask(image, other, WarpTemplateType::Ffhq512, cv::Size(512, 512),
+                                 options, &occluder, nullptr);
+    workspace.clear();
+    (void)workspace.compose_mask(image, landmarks, WarpTemplateType::Ffhq512, cv::Size(512, 512),
+                                 options, &occluder, nullptr);
+
+    EXPECT_EQ(workspace.stats().occlusion_inferences, 3U);
+}
+
+TEST_F(FaceWorkspaceTest, PrepareMasksBatchesAllFacesThroughEachModel) {
+    NiceMock<MockBatchOccluder> batch_occluder;
+    EXPECT_CALL(batch_occluder, create_occlusion_mask(_)).Times(0);
+    EXPECT_CALL(batch_occluder, create_occlusion_mask_batch(SizeIs(2)))
+        .WillOnce([](const std::vector<cv::Mat>& crops) {
+            std::vector<cv::Mat> masks;
+            for (const auto& crop : crops) masks.emplace_back(crop.size(), CV_8UC1, cv::Scalar(0));
+            return masks;
+        });
+
+    options.mask_types = {MaskType::Box, MaskType::Occlusion};
+    Landmarks other = landmarks;
+    for (auto& point : other) point.x += 150.0F;
+    const std::vector<Landmarks> faces = {landmarks, other};
+
+    workspace.prepare_masks(image, faces, options, &batch_occluder, nullptr);
+    for (const auto& face : faces) {
+        const cv::Mat mask = workspace.compose_mask(image, face, WarpTemplateType::Arcface128V2,
+                                                    cv::Size(128, 128), options, &batch_occluder,
+                                                    nullptr);
+        EXPECT_EQ(mask.size(), cv::Size(128, 128));
+    }
+    // Already prepared: no further model runs
+    workspace.prepare_masks(image, faces, options, &batch_occluder, nullptr);
+
+    EXPECT_EQ(workspace.stats().occlusion_inferences, 2U);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <vector>
+
+import foundation.ai.tensor_postprocess;
+
+using namespace foundation::ai::tensor_postprocess;
+
+namespace {
+
+/**
+ * @brief Planes with values spanning beyond the model range on both sides
+ */
+std::vector<float> make_planes(const cv::Size& size, float low, float high) {
+    std::vector<float> planes(3 * static_cast<size_t>(size.area()));
+    cv::Mat view(1, static_cast<int>(planes.size()), CV_32FC1, planes.data());
+    cv::randu(view, low, high);
+    return planes;
+}
+
+/**
+ * @brief The per-plane clone / scale / clamp / merge / convertTo path the routine replaces
+ */
+cv::Mat reference(const std::vector<float>& planes, const cv::Size& size,
+                  const PlanarOptions& options) {
+    const size_t step = static_cast<size_t>(size.area());
+    std::vector<cv::Mat> channels(3);
+    for (int c = 0; c < 3; ++c) {
+        const int dst = options.order == PlaneOrder::RGB ? 2 - c : c;
+        channels[dst] =
+            cv::Mat(size, CV_32FC1, const_cast<float*>(planes.data()) + c * step).clone();
+    }
+    for (auto& mat : channels) {
+        if (options.range == ValueRange::MinusOneToOne) {
+            cv::max(mat, -1.0F, mat);
+            cv::min(mat, 1.0F, mat);
+            mat = (mat + 1.0F) * 127.5F;
+        } else {
+            mat *= 255.0F;
+        }
+        cv::max(mat, 0.0F, mat);
+        cv::min(mat, 255.0F, mat);
+    }
+    cv::Mat merged;
+    cv::merge(channels, merged);
+    merged.convertTo(merged, CV_8UC3);
+    return merged;
+}
+
+} // namespace
+
+TEST(TensorPostprocessTest, MatchesReferenceForAllRangesAndOrders) {
+    const cv::Size size(131, 37); // Odd width exercises the scalar tail
+    for (const auto range : {ValueRange::ZeroToOne, ValueRange::MinusOneToOne}) {
+        for (const auto order : {PlaneOrder::RGB, PlaneOrder::BGR}) {
+            const PlanarOptions options{range, order};
+            const float low = range == ValueRange::ZeroToOne ? -0.2F : -1.3F;
+            const auto planes = make_planes(size, low, 1.3F);
+
+            const cv::Mat result = planar_to_bgr(planes.data(), size, options);
+            ASSERT_EQ(result.type(), CV_8UC3);
+            ASSERT_EQ(result.size(), size);
+            EXPECT_LE(cv::norm(result, reference(planes, size, options), cv::NORM_INF), 1.0);
+        }
+    }
+}
+
+TEST(TensorPostprocessTest, ReusesMatchingDestination) {
+    const cv::Size size(64, 48);
+    const auto planes = make_planes(size, 0.0F, 1.0F);
+
+    cv::Mat pooled(size, CV_8UC3);
+    const uchar* data = pooled.data;
+    planar_to_bgr(planes.data(), size, pooled);
+    EXPECT_EQ(pooled.data, data);
+
+    // Plane 0 is red: the BGR pixel's last channel comes from the first plane
+    EXPECT_EQ(pooled.at<cv::Vec3b>(0, 0)[2], cv::saturate_cast<uchar>(planes[0] * 255.0F));
+}
@@ -74,6 +74,42 @@ TEST_F(FileSystemTest, CopyFile) {
     EXPECT_EQ(content, "content");
 }
 
+TEST_F(FileSystemTest, MappedFileExposesContents) {
+    using foundation::infrastructure::file_system::MappedFile;
+    create_dummy_file("mapped.bin", "mapped content");
+    create_dummy_file("empty.bin", "");
+
+    auto mapped = MappedFile::open((fs::path(test_dir) / "mapped.bin").string());
+    ASSERT_TRUE(mapped.has_value());
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(mapped->data()), mapped->size()),
+              "mapped content");
+
+    MappedFile moved = std::move(*mapped);
+    EXPECT_EQ(mapped->data(), nullptr);
+    EXPECT_EQ(moved.size(), 14U);
+
+    EXPECT_FALSE(MappedFile::open((fs::path(test_dir) / "empty.bin").string()).has_value());
+    EXPECT_FALSE(MappedFile::open((fs::path(test_dir) / "missing.bin").string()).has_value());
+    EXPECT_FALSE(MappedFile::open(test_dir).has_value());
+}
+
+TEST_F(FileSystemTest, LinkOrCopyFileReplacesDestination) {
+    create_dummy_file("linked_src.txt", "source");
+    create_dummy_file("linked_dst.txt", "stale");
+    std::string src = (fs::path(test_dir) / "linked_src.txt").string();
+    std::string dst = (fs::path(test_dir) / "linked_dst.txt").string();
+
+    foundation::infrastructure::file_system::link_or_copy_file(src, dst);
+
+    std::ifstream ifs(dst);
+    std::string content;
+    ifs >> content;
+    EXPECT_EQ(content, "source");
+    // Linking a file to itself leaves it untouched
+    EXPECT_NO_THROW(foundation::infrastructure::file_system::link_or_copy_file(src, src));
+    EXPECT_TRUE(fs::exists(src));
+}
+
 TEST_F(FileSystemTest, ConcurrentRemoveFiles) {
     std::vector<std::string> files;
     for (int i = 0; i < 5; ++i) {
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+import foundation.media.ffmpeg;
+
+using foundation::media::ffmpeg::SeekIndex;
+
+namespace {
+
+/// 25 fps in a 1/12800 time base, keyframe every 12 frames
+SeekIndex make_index(int frames) {
+    std::vector<std::int64_t> pts;
+    std::vector<std::int64_t> keyframes;
+    for (int i = 0; i < frames; ++i) {
+        pts.push_back(1024 + 512LL * i);
+        if (i % 12 == 0) keyframes.push_back(i);
+    }
+    return {0, 1, 12800, std::move(pts), std::move(keyframes)};
+}
+
+class SeekIndexSidecarTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        video_path =
+            (std::filesystem::temp_directory_path() / "seek_index_test_video.mp4").string();
+        write_video("original contents");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(video_path);
+        std::filesystem::remove(SeekIndex::sidecar_path(video_path));
+    }
+
+    void write_video(const std::string& contents) const {
+        std::ofstream file(video_path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+
+    std::string video_path;
+};
+
+} // namespace
+
+TEST(SeekIndexTest, FrameAndKeyframeLookups) {
+    const SeekIndex index = make_index(100);
+
+    EXPECT_EQ(index.frame_count(), 100);
+    EXPECT_EQ(index.frame_pts(0), 1024);
+    EXPECT_EQ(index.frame_pts(30), 1024 + 512 * 30);
+    EXPECT_FALSE(index.frame_pts(100).has_value());
+    EXPECT_FALSE(index.frame_pts(-1).has_value());
+
+    EXPECT_EQ(index.keyframe_before(0), 0);
+    EXPECT_EQ(index.keyframe_before(11), 0);
+    EXPECT_EQ(index.keyframe_before(12), 12);
+    EXPECT_EQ(index.keyframe_before(99), 96);
+
+    EXPECT_EQ(index.frame_at_pts(1024 + 512 * 30), 30);
+    EXPECT_EQ(index.frame_at_pts(1024 + 512 * 30 - 1), 30);
+    EXPECT_EQ(index.frame_at_pts(0), 0);
+}
+
+TEST_F(SeekIndexSidecarTest, SidecarRoundTrips) {
+    const SeekIndex index = make_index(1000);
+    ASSERT_TRUE(index.save(video_path));
+
+    const auto loaded = SeekIndex::load(video_path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->frame_count(), 1000);
+    EXPECT_EQ(loaded->time_base_den(), 12800);
+    EXPECT_EQ(loaded->keyframes(), index.keyframes());
+    for (std::int64_t i = 0; i < 1000; i += 37) {
+        EXPECT_EQ(loaded->frame_pts(i), index.frame_pts(i));
+    }
+}
+
+TEST_F(SeekIndexSidecarTest, SidecarKeepsGopStructure) {
+    const SeekIndex index(0, 1, 12800, {0, 512, 1024}, {0}, true, 1024);
+    ASSERT_TRUE(index.save(video_path));
+
+    const auto loaded = SeekIndex::load(video_path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_TRUE(loaded->has_open_gops());
+    EXPECT_EQ(loaded->decode_delay(), 1024);
+}
+
+TEST_F(SeekIndexSidecarTest, ChangedVideoInvalidatesSidecar) {
+    ASSERT_TRUE(make_index(10).save(video_path));
+    write_video("different contents!");
+
+    EXPECT_FALSE(SeekIndex::load(video_path).has_value());
+}
@@ -81,3 +81,17 @@ TEST_F(CheckpointManagerTest, IntegrityCheck) {
     auto loaded = mgr->load("test_task");
     EXPECT_FALSE(loaded.has_value());
 }
+
+TEST_F(CheckpointManagerTest, SegmentsRoundTrip) {
+    CheckpointData data;
+    data.task_id = "test_task";
+    data.last_completed_frame = 2999;
+    data.output_path = "output.mp4";
+    data.segments = {"segments/00000.mp4", "segments/00001.mp4"};
+    mgr->force_save(data);
+
+    auto loaded = mgr->load("test_task");
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->segments, data.segments);
+    EXPECT_EQ(loaded->last_completed_frame, 2999);
+}
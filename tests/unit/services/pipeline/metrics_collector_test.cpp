@@ -94,3 +94,53 @@ TEST_F(MetricsCollectorTest, PercentileCalculation) {
     EXPECT_GT(m.step_latency[0].p50_ms, 0.0);
     EXPECT_GE(m.step_latency[0].p99_ms, m.step_latency[0].p50_ms);
 }
+
+TEST_F(MetricsCollectorTest, NamedCounters) {
+    MetricsCollector collector("task_001");
+    collector.set_counter("face_store.hit_rate", 0.5);
+    collector.add_counter("face_store.hits", 2);
+    collector.add_counter("face_store.hits", 3);
+
+    auto m = collector.get_metrics();
+    EXPECT_DOUBLE_EQ(m.counters.at("face_store.hit_rate"), 0.5);
+    EXPECT_DOUBLE_EQ(m.counters.at("face_store.hits"), 5.0);
+
+    json j = json::parse(collector.to_json());
+    EXPECT_DOUBLE_EQ(j["counters"]["face_store.hits"].get<double>(), 5.0);
+}
+
+TEST_F(MetricsCollectorTest, MergeSumsFramesSamplesAndCounters) {
+    MetricsCollector total("task_001");
+    MetricsCollector first("task_001");
+    MetricsCollector second("task_001");
+    first.set_gpu_sample_interval(std::chrono::milliseconds(0));
+    second.set_gpu_sample_interval(std::chrono::milliseconds(0));
+
+    first.set_total_frames(10);
+    first.record_frame_completed();
+    first.record_gpu_memory(100);
+    first.set_counter("face_store.hits", 4);
+    first.set_counter("face_store.hit_rate", 0.8);
+    { ScopedStepTimer timer(first, "face_swapper"); }
+
+    second.set_total_frames(5);
+    second.record_frame_completed();
+    second.record_frame_failed();
+    second.record_gpu_memory(300);
+    second.set_counter("face_store.hits", 1);
+    { ScopedStepTimer timer(second, "face_swapper"); }
+
+    total.merge(first);
+    total.merge(second);
+
+    auto m = total.get_metrics();
+    EXPECT_EQ(m.summary.total_frames, 15);
+    EXPECT_EQ(m.summary.processed_frames, 2);
+    EXPECT_EQ(m.summary.failed_frames, 1);
+    ASSERT_EQ(m.step_latency.size(), 1);
+    EXPECT_EQ(m.step_latency[0].sample_count, 2);
+    EXPECT_EQ(m.gpu_memory.peak_mb, 300);
+    EXPECT_EQ(m.gpu_memory.samples.size(), 2);
+    EXPECT_DOUBLE_EQ(m.counters.at("face_store.hits"), 5.0);
+    EXPECT_FALSE(m.counters.contains("face_store.hit_rate"));
+}
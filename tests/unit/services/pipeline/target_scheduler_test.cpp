@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <latch>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+import services.pipeline.scheduler;
+import config.types;
+
+using namespace services::pipeline;
+
+namespace {
+
+using Result = config::Result<void, config::ConfigError>;
+
+std::vector<std::string> make_targets(size_t count) {
+    std::vector<std::string> targets;
+    for (size_t i = 0; i < count; ++i) targets.push_back("clip_" + std::to_string(i) + ".mp4");
+    return targets;
+}
+
+} // namespace
+
+TEST(TargetSchedulerTest, RunsAtMostMaxConcurrentJobsAtOnce) {
+    TargetScheduler scheduler({.max_concurrent = 3, .worker_threads = 12});
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    std::atomic<bool> cancelled{false};
+
+    const auto outcomes = scheduler.run(
+        make_targets(9),
+        [&](const std::string&, const TargetBudget&) {
+            const int now = ++active;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --active;
+            return Result::ok();
+        },
+        cancelled);
+
+    ASSERT_EQ(outcomes.size(), 9U);
+    EXPECT_LE(peak.load(), 3);
+    EXPECT_GE(peak.load(), 2);
+    for (const auto& outcome : outcomes) {
+        EXPECT_TRUE(outcome.started);
+        EXPECT_FALSE(outcome.error.has_value());
+    }
+}
+
+TEST(TargetSchedulerTest, FailuresStayWithTheirTarget) {
+    TargetScheduler scheduler({.max_concurrent = 2});
+    std::atomic<bool> cancelled{false};
+
+    const auto outcomes = scheduler.run(
+        make_targets(4),
+        [](const std::string& target, const TargetBudget&) {
+            if (target == "clip_1.mp4") {
+                return Result::err(
+                    config::ConfigError(config::ErrorCode::E402VideoOpenFailed, "broken"));
+            }
+            if (target == "clip_2.mp4") throw std::runtime_error("decoder crashed");
+            return Result::ok();
+        },
+        cancelled);
+
+    ASSERT_EQ(outcomes.size(), 4U);
+    EXPECT_EQ(outcomes[0].target, "clip_0.mp4");
+    EXPECT_FALSE(outcomes[0].error.has_value());
+    ASSERT_TRUE(outcomes[1].error.has_value());
+    EXPECT_EQ(outcomes[1].error->code, config::ErrorCode::E402VideoOpenFailed);
+    ASSERT_TRUE(outcomes[2].error.has_value());
+    EXPECT_EQ(outcomes[2].error->code, config::ErrorCode::E400RuntimeError);
+    EXPECT_FALSE(outcomes[3].error.has_value());
+}
+
+TEST(TargetSchedulerTest, BudgetIsSharedBetweenConcurrentTargets) {
+    TargetScheduler scheduler(
+        {.max_concurrent = 4, .worker_threads = 8, .decoder_threads = 4, .encoder_threads = 2});
+
+    const auto quarter = scheduler.share(4);
+    EXPECT_EQ(quarter.worker_threads, 2);
+    EXPECT_EQ(quarter.decoder_threads, 1);
+    EXPECT_EQ(quarter.encoder_threads, 1); // Never below one thread
+
+    const auto single = scheduler.share(1);
+    EXPECT_EQ(single.worker_threads, 8);
+    EXPECT_EQ(single.encoder_threads, 2);
+
+    // Two targets left for four slots: each gets half of the budget
+    std::atomic<bool> cancelled{false};
+    std::vector<int> workers(2, 0);
+    std::latch both_running(2);
+    const auto targets = make_targets(2);
+    (void)scheduler.run(
+        targets,
+        [&](const std::string& target, const TargetBudget& budget) {
+            workers[target == targets[0] ? 0 : 1] = budget.worker_threads;
+            both_running.arrive_and_wait();
+            return Result::ok();
+        },
+        cancelled);
+    EXPECT_EQ(workers, (std::vector<int>{4, 4}));
+}
+
+TEST(TargetSchedulerTest, CancelledTargetsAreNotStarted) {
+    TargetScheduler scheduler({.max_concurrent = 1});
+    std::atomic<bool> cancelled{false};
+
+    const auto outcomes = scheduler.run(
+        make_targets(3),
+        [&](const std::string&, const TargetBudget&) {
+            cancelled = true;
+            return Result::ok();
+        },
+        cancelled);
+
+    EXPECT_TRUE(outcomes[0].started);
+    EXPECT_FALSE(outcomes[1].started);
+    EXPECT_FALSE(outcomes[2].started);
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 #include <vector>
 #include <string>
 
@@ -47,3 +49,30 @@ TEST(TargetSortingTest, PreservesOrderWithinCategories) {
     EXPECT_EQ(result.videos[0], "v1.mp4");
     EXPECT_EQ(result.videos[1], "v2.mp4");
 }
+
+TEST(TargetDedupTest, GroupsIdenticalContentUnderFirstTarget) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "target_dedup_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto write = [&](const std::string& name, const std::string& content) {
+        std::ofstream(dir / name, std::ios::binary) << content;
+        return (dir / name).string();
+    };
+
+    const auto a = write("a.jpg", "same bytes");
+    const auto b = write("b.jpg", "other text"); // Same size, different content
+    const auto c = write("c.jpg", "same bytes");
+    const auto d = write("d.jpg", "unique");
+    const std::string missing = (dir / "missing.jpg").string();
+
+    auto plan = plan_target_dedup({a, b, c, d, a, missing});
+
+    EXPECT_EQ(plan.unique_targets, (std::vector<std::string>{a, b, d, missing}));
+    ASSERT_EQ(plan.duplicates.size(), 1U);
+    EXPECT_EQ(plan.duplicates.at(a).targets, (std::vector<std::string>{c, a}));
+    EXPECT_EQ(plan.duplicate_count(), 2U);
+    EXPECT_EQ(plan.saved_bytes(), 20U);
+
+    fs::remove_all(dir);
+}